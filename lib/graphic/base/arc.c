@@ -26,9 +26,7 @@ static void clearArea(CFBD_GraphicDevice* device, CFBD_GraphicArc* arc)
     int32_t rx = cx + r;
     int32_t by = cy + r;
 
-    uint16_t w = (uint16_t) (rx - lx + 1);
-    uint16_t h = (uint16_t) (by - ty + 1);
-    device->ops->clear_area(device, clamp_u16_from_i32(lx), clamp_u16_from_i32(ty), w, h);
+    CFBDGraphic_DeviceClearBeforeDraw(device, lx, ty, rx, by);
 }
 
 static void updateArea(CFBD_GraphicDevice* device, CFBD_GraphicArc* arc)
@@ -65,6 +63,13 @@ static void updateArea(CFBD_GraphicDevice* device, CFBD_GraphicArc* arc)
         }                                                                                          \
     } while (0)
 
+/* 每个像素只画一次, 异或模式下不会互相抵消 */
+#define DRAW_COLUMN_IF_IN(offsetx, half)                                                           \
+    do {                                                                                           \
+        for (int16_t __j = -(half); __j <= (half); __j++)                                          \
+            DRAW_IF_IN(offsetx, __j);                                                              \
+    } while (0)
+
 void CFBDGraphic_DrawArc(CFBD_GraphicDevice* device, CFBD_GraphicArc* arc)
 {
     PREANNOUNCE;
@@ -80,9 +85,11 @@ void CFBDGraphic_DrawArc(CFBD_GraphicDevice* device, CFBD_GraphicArc* arc)
     const int16_t end_angle = arc->end_degree;
     /*在画圆的每个点时，判断指定点是否在指定角度内，在，则画点，不在，则不做处理*/
     DRAW_IF_IN(x, y);
-    DRAW_IF_IN(-x, -y);
-    DRAW_IF_IN(y, x);
-    DRAW_IF_IN(-y, -x);
+    if (y != 0) {
+        DRAW_IF_IN(-x, -y);
+        DRAW_IF_IN(y, x);
+        DRAW_IF_IN(-y, -x);
+    }
 
     while (x < y) // 遍历X轴的每个点
     {
@@ -96,16 +103,22 @@ void CFBDGraphic_DrawArc(CFBD_GraphicDevice* device, CFBD_GraphicArc* arc)
             y--;
             d += 2 * (x - y) + 1;
         }
+        /*x 越过 y 的这一步只会重复上一步的对称点*/
+        if (x > y)
+            break;
 
         /*在画圆的每个点时，判断指定点是否在指定角度内，在，则画点，不在，则不做处理*/
         DRAW_IF_IN(x, y);
-        DRAW_IF_IN(y, x);
         DRAW_IF_IN(-x, -y);
-        DRAW_IF_IN(-y, -x);
         DRAW_IF_IN(x, -y);
-        DRAW_IF_IN(y, -x);
         DRAW_IF_IN(-x, y);
-        DRAW_IF_IN(-y, x);
+        /*对角线上的点两个八分圆共用*/
+        if (x < y) {
+            DRAW_IF_IN(y, x);
+            DRAW_IF_IN(-y, -x);
+            DRAW_IF_IN(y, -x);
+            DRAW_IF_IN(-y, x);
+        }
     }
 
     if (CFBDGraphic_DeviceRequestUpdateAtOnce(device) && device->ops->update_area) {
@@ -125,23 +138,13 @@ void CFBDGraphic_DrawFilledArc(CFBD_GraphicDevice* device, CFBD_GraphicArc* arc)
     clearArea(device, arc);
     const int16_t start_angle = arc->start_degree;
     const int16_t end_angle = arc->end_degree;
-    __x = x;
-    __y = y;
 
-    /*在画圆的每个点时，判断指定点是否在指定角度内，在，则画点，不在，则不做处理*/
-    DRAW_IF_IN(x, y);
-    DRAW_IF_IN(-x, -y);
-    DRAW_IF_IN(y, x);
-    DRAW_IF_IN(-y, -x);
-
-    /*遍历起始点Y坐标*/
-    for (int16_t j = -y; j < y; j++) {
-        /*在填充圆的每个点时，判断指定点是否在指定角度内，在，则画点，不在，则不做处理*/
-        DRAW_IF_IN(0, j);
-    }
+    /*按列填充: x 列在每一步填充 +-y, y 列在离开该 y 时以最大的 x 填充一次*/
+    DRAW_COLUMN_IF_IN(0, y);
 
-    while (x < y) // 遍历X轴的每个点
-    {
+    for (;;) {
+        const int16_t px = x;
+        const int16_t py = y;
         x++;
         if (d < 0) // 下一个点在当前点东方
         {
@@ -153,29 +156,17 @@ void CFBDGraphic_DrawFilledArc(CFBD_GraphicDevice* device, CFBD_GraphicArc* arc)
             d += 2 * (x - y) + 1;
         }
 
-        /*在画圆的每个点时，判断指定点是否在指定角度内，在，则画点，不在，则不做处理*/
-        DRAW_IF_IN(x, y);
-        DRAW_IF_IN(y, x);
-        DRAW_IF_IN(-x, -y);
-        DRAW_IF_IN(-y, -x);
-        DRAW_IF_IN(x, -y);
-        DRAW_IF_IN(y, -x);
-        DRAW_IF_IN(-x, y);
-        DRAW_IF_IN(-y, x);
-
-        /*遍历中间部分*/
-        for (int16_t j = -y; j < y; j++) {
-            /*在填充圆的每个点时，判断指定点是否在指定角度内，在，则画点，不在，则不做处理*/
-            DRAW_IF_IN(x, j);
-            DRAW_IF_IN(-x, j);
-        }
-
         /*遍历两侧部分*/
-        for (int16_t j = -x; j < x; j++) {
-            /*在填充圆的每个点时，判断指定点是否在指定角度内，在，则画点，不在，则不做处理*/
-            DRAW_IF_IN(y, j);
-            DRAW_IF_IN(-y, j);
+        if ((y != py || x > y) && px < py) {
+            DRAW_COLUMN_IF_IN(py, px);
+            DRAW_COLUMN_IF_IN(-py, px);
         }
+        if (x > y)
+            break;
+
+        /*遍历中间部分*/
+        DRAW_COLUMN_IF_IN(x, y);
+        DRAW_COLUMN_IF_IN(-x, y);
     }
 
     if (CFBDGraphic_DeviceRequestUpdateAtOnce(device) && device->ops->update_area) {
@@ -185,3 +176,4 @@ void CFBDGraphic_DrawFilledArc(CFBD_GraphicDevice* device, CFBD_GraphicArc* arc)
 
 #undef DRAW_OFFSET_POINT
 #undef DRAW_IF_IN
+#undef DRAW_COLUMN_IF_IN
@@ -3,20 +3,153 @@
 #include <assert.h>
 
 #include "base_helpers.h"
+#include "device/graphic_canvas.h"
+#include "device/graphic_clip.h"
 #include "device/graphic_device.h"
 #include "point.h"
 
-#define PREANNOUNCE                                                                                \
-    PointBaseType __x = 0;                                                                         \
-    PointBaseType __y = 0
+/*
+    Pixel and vertical span writers for every raster target. The clipped canvas
+    writers check the canvas clip (per pixel for points, once per span for
+    spans) and are only used when the circle crosses the clip edge; the raw
+    ones run without any check. The device ones rely on the device dropping
+    pixels outside the clip.
+*/
+#define PLOT_DEVICE(target, X, Y) (target)->ops->setPixel((target), (uint16_t) (X), (uint16_t) (Y))
 
-#define DRAW_OFFSET_POINT(offsetx, offsety)                                                        \
+#define VSPAN_DEVICE(target, X, Y0, Y1)                                                            \
     do {                                                                                           \
-        __x = circle->center.x + (offsetx);                                                        \
-        __y = circle->center.y + (offsety);                                                        \
-        setPixel(handler, __x, __y);                                                               \
+        for (int32_t __y = (Y0); __y <= (Y1); __y++)                                               \
+            (target)->ops->setPixel((target), (uint16_t) (X), (uint16_t) __y);                     \
     } while (0)
 
+#define PLOT_CANVAS(target, X, Y, FMT)                                                             \
+    do {                                                                                           \
+        if (CFBDGraphic_CanvasContains((target), (X), (Y)))                                        \
+            CFBDGraphic_CanvasPlot##FMT((target), (X), (Y));                                       \
+    } while (0)
+
+#define VSPAN_CANVAS(target, X, Y0, Y1, FMT)                                                       \
+    do {                                                                                           \
+        int32_t __y0 = (Y0), __y1 = (Y1);                                                          \
+        if (CFBDGraphic_CanvasClipVSpan((target), (X), &__y0, &__y1))                              \
+            CFBDGraphic_CanvasVSpan##FMT((target), (X), __y0, __y1);                               \
+    } while (0)
+
+#define PLOT_CANVAS_1BPP(target, X, Y) PLOT_CANVAS(target, X, Y, 1Bpp)
+#define PLOT_CANVAS_4BPP(target, X, Y) PLOT_CANVAS(target, X, Y, 4Bpp)
+#define VSPAN_CANVAS_1BPP(target, X, Y0, Y1) VSPAN_CANVAS(target, X, Y0, Y1, 1Bpp)
+#define VSPAN_CANVAS_4BPP(target, X, Y0, Y1) VSPAN_CANVAS(target, X, Y0, Y1, 4Bpp)
+
+#define PLOT_RAW_1BPP(target, X, Y) CFBDGraphic_CanvasPlot1Bpp((target), (X), (Y))
+#define PLOT_RAW_4BPP(target, X, Y) CFBDGraphic_CanvasPlot4Bpp((target), (X), (Y))
+#define VSPAN_RAW_1BPP(target, X, Y0, Y1)                                                          \
+    do {                                                                                           \
+        if ((Y0) <= (Y1))                                                                          \
+            CFBDGraphic_CanvasVSpan1Bpp((target), (X), (Y0), (Y1));                                \
+    } while (0)
+#define VSPAN_RAW_4BPP(target, X, Y0, Y1) CFBDGraphic_CanvasVSpan4Bpp((target), (X), (Y0), (Y1))
+
+/* Ref Doc: https://www.cs.montana.edu/courses/spring2009/425/dslectures/Bresenham.pdf*/
+/* Ref Toturial: https://www.bilibili.com/video/BV1VM4y1u7wJ*/
+/*
+    Every pixel is written exactly once, so CFBD_ROP_XOR draws the circle in
+    one pass: the points on the axes and on the diagonal are shared by two
+    octants and go out once, and the step where x passes y is skipped, it
+    only repeats the mirrored points of the step before.
+*/
+#define DEFINE_CIRCLE_OUTLINE(NAME, TARGET_TYPE, PLOT)                                             \
+    static void NAME(TARGET_TYPE target, int32_t cx, int32_t cy, int16_t radius)                   \
+    {                                                                                              \
+        int16_t d = 3 - radius / 4;                                                                \
+        int16_t x = 0;                                                                             \
+        int16_t y = radius;                                                                        \
+                                                                                                   \
+        if (radius <= 0) {                                                                         \
+            if (radius == 0)                                                                       \
+                PLOT(target, cx, cy);                                                              \
+            return;                                                                                \
+        }                                                                                          \
+        PLOT(target, cx + x, cy + y);                                                              \
+        PLOT(target, cx - x, cy - y);                                                              \
+        PLOT(target, cx + y, cy + x);                                                              \
+        PLOT(target, cx - y, cy - x);                                                              \
+                                                                                                   \
+        while (x < y) {                                                                            \
+            x++;                                                                                   \
+            if (d < 0) {                                                                           \
+                d += 2 * x + 1;                                                                    \
+            }                                                                                      \
+            else {                                                                                 \
+                y--;                                                                               \
+                d += 2 * (x - y) + 1;                                                              \
+            }                                                                                      \
+            if (x > y)                                                                             \
+                break;                                                                             \
+            PLOT(target, cx + x, cy + y);                                                          \
+            PLOT(target, cx - x, cy - y);                                                          \
+            PLOT(target, cx + x, cy - y);                                                          \
+            PLOT(target, cx - x, cy + y);                                                          \
+            if (x < y) {                                                                           \
+                PLOT(target, cx + y, cy + x);                                                      \
+                PLOT(target, cx - y, cy - x);                                                      \
+                PLOT(target, cx + y, cy - x);                                                      \
+                PLOT(target, cx - y, cy + x);                                                      \
+            }                                                                                      \
+        }                                                                                          \
+    }
+
+/*
+    Same point set as the outline walk, filled with one vertical span per
+    column so no pixel is written twice: column x spans +-y at every step,
+    column y spans +-x once, with the largest x, when the walk leaves that
+    y. A column reached both ways is only spanned from the x side.
+*/
+#define DEFINE_CIRCLE_FILLED(NAME, TARGET_TYPE, VSPAN)                                             \
+    static void NAME(TARGET_TYPE target, int32_t cx, int32_t cy, int16_t radius)                   \
+    {                                                                                              \
+        int16_t d = 1 - radius;                                                                    \
+        int16_t x = 0;                                                                             \
+        int16_t y = radius;                                                                        \
+                                                                                                   \
+        if (radius < 0)                                                                            \
+            return;                                                                                \
+        VSPAN(target, cx, cy - y, cy + y);                                                         \
+                                                                                                   \
+        for (;;) {                                                                                 \
+            const int16_t px = x;                                                                  \
+            const int16_t py = y;                                                                  \
+            x++;                                                                                   \
+            if (d < 0) {                                                                           \
+                d += 2 * x + 1;                                                                    \
+            }                                                                                      \
+            else {                                                                                 \
+                y--;                                                                               \
+                d += 2 * (x - y) + 1;                                                              \
+            }                                                                                      \
+            if ((y != py || x > y) && px < py) {                                                   \
+                VSPAN(target, cx + py, cy - px, cy + px);                                          \
+                VSPAN(target, cx - py, cy - px, cy + px);                                          \
+            }                                                                                      \
+            if (x > y)                                                                             \
+                break;                                                                             \
+            VSPAN(target, cx + x, cy - y, cy + y);                                                 \
+            VSPAN(target, cx - x, cy - y, cy + y);                                                 \
+        }                                                                                          \
+    }
+
+DEFINE_CIRCLE_OUTLINE(__pvt_circle_device, CFBD_GraphicDevice*, PLOT_DEVICE)
+DEFINE_CIRCLE_OUTLINE(__pvt_circle_canvas_1bpp, CFBDGraphic_Canvas*, PLOT_CANVAS_1BPP)
+DEFINE_CIRCLE_OUTLINE(__pvt_circle_canvas_4bpp, CFBDGraphic_Canvas*, PLOT_CANVAS_4BPP)
+DEFINE_CIRCLE_OUTLINE(__pvt_circle_raw_1bpp, CFBDGraphic_Canvas*, PLOT_RAW_1BPP)
+DEFINE_CIRCLE_OUTLINE(__pvt_circle_raw_4bpp, CFBDGraphic_Canvas*, PLOT_RAW_4BPP)
+
+DEFINE_CIRCLE_FILLED(__pvt_filled_circle_device, CFBD_GraphicDevice*, VSPAN_DEVICE)
+DEFINE_CIRCLE_FILLED(__pvt_filled_circle_canvas_1bpp, CFBDGraphic_Canvas*, VSPAN_CANVAS_1BPP)
+DEFINE_CIRCLE_FILLED(__pvt_filled_circle_canvas_4bpp, CFBDGraphic_Canvas*, VSPAN_CANVAS_4BPP)
+DEFINE_CIRCLE_FILLED(__pvt_filled_circle_raw_1bpp, CFBDGraphic_Canvas*, VSPAN_RAW_1BPP)
+DEFINE_CIRCLE_FILLED(__pvt_filled_circle_raw_4bpp, CFBDGraphic_Canvas*, VSPAN_RAW_4BPP)
+
 static inline void
 circle_calc_bbox(CFBDGraphicCircle* c, int32_t* lx, int32_t* ty, int32_t* rx, int32_t* by)
 {
@@ -30,49 +163,20 @@ static inline void clearBound(CFBD_GraphicDevice* handler, CFBDGraphicCircle* ci
 {
     int32_t lx, ty, rx, by;
     circle_calc_bbox(circle, &lx, &ty, &rx, &by);
-    handler->ops->clear_area(handler,
-                             clamp_u16_from_i32(lx),
-                             clamp_u16_from_i32(ty),
-                             clamp_u16_from_i32(rx - lx + 1),
-                             clamp_u16_from_i32(by - ty + 1));
+    CFBDGraphic_DeviceClearBeforeDraw(handler, lx, ty, rx, by);
 }
 
-void CFBDGraphic_DrawCircle(CFBD_GraphicDevice* handler, CFBDGraphicCircle* circle)
+/* A circle fully inside the clip skips every per pixel check */
+static inline CFBD_Bool circle_inside_clip(const CFBDGraphic_Canvas* canvas,
+                                           CFBDGraphicCircle* circle)
 {
-    PREANNOUNCE;
-    clearBound(handler, circle);
-    CFBD_Bool (*setPixel)(CFBD_GraphicDevice* device, uint16_t x, uint16_t y) =
-            handler->ops->setPixel;
-    /* Ref Doc: https://www.cs.montana.edu/courses/spring2009/425/dslectures/Bresenham.pdf*/
-    /* Ref Toturial: https://www.bilibili.com/video/BV1VM4y1u7wJ*/
-    int16_t d = 3 - circle->radius / 4;
-    int16_t x = 0;
-    int16_t y = circle->radius;
-
-    DRAW_OFFSET_POINT(x, y);
-    DRAW_OFFSET_POINT(-x, -y);
-    DRAW_OFFSET_POINT(y, x);
-    DRAW_OFFSET_POINT(-y, -x);
-
-    while (x < y) {
-        x++;
-        if (d < 0) {
-            d += 2 * x + 1;
-        }
-        else {
-            y--;
-            d += 2 * (x - y) + 1;
-        }
-        DRAW_OFFSET_POINT(x, y);
-        DRAW_OFFSET_POINT(y, x);
-        DRAW_OFFSET_POINT(-x, -y);
-        DRAW_OFFSET_POINT(-y, -x);
-        DRAW_OFFSET_POINT(x, -y);
-        DRAW_OFFSET_POINT(y, -x);
-        DRAW_OFFSET_POINT(-x, y);
-        DRAW_OFFSET_POINT(-y, x);
-    }
+    int32_t lx, ty, rx, by;
+    circle_calc_bbox(circle, &lx, &ty, &rx, &by);
+    return CFBDGraphic_ClipBoundsContainsBox(&canvas->clip, lx, ty, rx, by);
+}
 
+static inline void update_bound(CFBD_GraphicDevice* handler, CFBDGraphicCircle* circle)
+{
     if (CFBDGraphic_DeviceRequestUpdateAtOnce(handler)) {
         int32_t lx, ty, rx, by;
         circle_calc_bbox(circle, &lx, &ty, &rx, &by);
@@ -84,59 +188,69 @@ void CFBDGraphic_DrawCircle(CFBD_GraphicDevice* handler, CFBDGraphicCircle* circ
     }
 }
 
-void CFBDGraphic_DrawFilledCircle(CFBD_GraphicDevice* handler, CFBDGraphicCircle* circle)
+void CFBDGraphic_DrawCircle(CFBD_GraphicDevice* handler, CFBDGraphicCircle* circle)
 {
-    PREANNOUNCE;
-    CFBD_Bool (*setPixel)(CFBD_GraphicDevice* device, uint16_t x, uint16_t y) =
-            handler->ops->setPixel;
-    int16_t d = 1 - circle->radius;
-    int16_t x = 0;
-    int16_t y = circle->radius;
+    const int32_t cx = asInt32_t(circle->center.x);
+    const int32_t cy = asInt32_t(circle->center.y);
+    CFBDGraphic_Canvas canvas;
+
     clearBound(handler, circle);
-    DRAW_OFFSET_POINT(x, y);
-    DRAW_OFFSET_POINT(-x, -y);
-    DRAW_OFFSET_POINT(y, x);
-    DRAW_OFFSET_POINT(-y, -x);
-
-    for (int16_t i = -y; i < y; i++)
-        DRAW_OFFSET_POINT(0, i);
-
-    while (x < y) {
-        x++;
-        if (d < 0) {
-            d += 2 * x + 1;
-        }
-        else {
-            y--;
-            d += 2 * (x - y) + 1;
-        }
-        DRAW_OFFSET_POINT(x, y);
-        DRAW_OFFSET_POINT(y, x);
-        DRAW_OFFSET_POINT(-x, -y);
-        DRAW_OFFSET_POINT(-y, -x);
-        DRAW_OFFSET_POINT(x, -y);
-        DRAW_OFFSET_POINT(y, -x);
-        DRAW_OFFSET_POINT(-x, y);
-        DRAW_OFFSET_POINT(-y, x);
-        for (int16_t i = -y; i < y; i++) {
-            DRAW_OFFSET_POINT(x, i);
-            DRAW_OFFSET_POINT(-x, i);
-        }
-        for (int16_t i = -x; i < x; i++) {
-            DRAW_OFFSET_POINT(y, i);
-            DRAW_OFFSET_POINT(-y, i);
-        }
+    if (!CFBDGraphic_DeviceFetchCanvas(handler, &canvas)) {
+        __pvt_circle_device(handler, cx, cy, circle->radius);
+    }
+    else if (circle_inside_clip(&canvas, circle)) {
+        if (canvas.format == CFBD_CANVAS_1BPP_PAGE)
+            __pvt_circle_raw_1bpp(&canvas, cx, cy, circle->radius);
+        else
+            __pvt_circle_raw_4bpp(&canvas, cx, cy, circle->radius);
+    }
+    else if (canvas.format == CFBD_CANVAS_1BPP_PAGE) {
+        __pvt_circle_canvas_1bpp(&canvas, cx, cy, circle->radius);
+    }
+    else {
+        __pvt_circle_canvas_4bpp(&canvas, cx, cy, circle->radius);
     }
 
-    if (CFBDGraphic_DeviceRequestUpdateAtOnce(handler)) {
-        int32_t lx, ty, rx, by;
-        circle_calc_bbox(circle, &lx, &ty, &rx, &by);
-        handler->ops->update_area(handler,
-                                  clamp_u16_from_i32(lx),
-                                  clamp_u16_from_i32(ty),
-                                  clamp_u16_from_i32(rx - lx + 1),
-                                  clamp_u16_from_i32(by - ty + 1));
+    update_bound(handler, circle);
+}
+
+void CFBDGraphic_DrawFilledCircle(CFBD_GraphicDevice* handler, CFBDGraphicCircle* circle)
+{
+    const int32_t cx = asInt32_t(circle->center.x);
+    const int32_t cy = asInt32_t(circle->center.y);
+    CFBDGraphic_Canvas canvas;
+
+    clearBound(handler, circle);
+    if (!CFBDGraphic_DeviceFetchCanvas(handler, &canvas)) {
+        __pvt_filled_circle_device(handler, cx, cy, circle->radius);
+    }
+    else if (circle_inside_clip(&canvas, circle)) {
+        if (canvas.format == CFBD_CANVAS_1BPP_PAGE)
+            __pvt_filled_circle_raw_1bpp(&canvas, cx, cy, circle->radius);
+        else
+            __pvt_filled_circle_raw_4bpp(&canvas, cx, cy, circle->radius);
+    }
+    else if (canvas.format == CFBD_CANVAS_1BPP_PAGE) {
+        __pvt_filled_circle_canvas_1bpp(&canvas, cx, cy, circle->radius);
     }
+    else {
+        __pvt_filled_circle_canvas_4bpp(&canvas, cx, cy, circle->radius);
+    }
+
+    update_bound(handler, circle);
 }
 
-#undef DRAW_OFFSET_POINT
\ No newline at end of file
+#undef DEFINE_CIRCLE_OUTLINE
+#undef DEFINE_CIRCLE_FILLED
+#undef PLOT_DEVICE
+#undef VSPAN_DEVICE
+#undef PLOT_CANVAS
+#undef VSPAN_CANVAS
+#undef PLOT_CANVAS_1BPP
+#undef PLOT_CANVAS_4BPP
+#undef VSPAN_CANVAS_1BPP
+#undef VSPAN_CANVAS_4BPP
+#undef PLOT_RAW_1BPP
+#undef PLOT_RAW_4BPP
+#undef VSPAN_RAW_1BPP
+#undef VSPAN_RAW_4BPP
@@ -15,6 +15,35 @@
         setPixel(handler, __x, __y);                                                               \
     } while (0)
 
+/* 4 symmetric points, each pixel once: the axis points have only 2 mirrors */
+#define DRAW_SYMMETRIC_POINTS(offsetx, offsety)                                                    \
+    do {                                                                                           \
+        DRAW_OFFSET_POINT(offsetx, offsety);                                                       \
+        if ((offsetx) != 0)                                                                        \
+            DRAW_OFFSET_POINT(-(offsetx), offsety);                                                \
+        if ((offsety) != 0) {                                                                      \
+            DRAW_OFFSET_POINT(offsetx, -(offsety));                                                \
+            if ((offsetx) != 0)                                                                    \
+                DRAW_OFFSET_POINT(-(offsetx), -(offsety));                                         \
+        }                                                                                          \
+    } while (0)
+
+/*
+    Columns +-offsetx from -offsety to offsety. The first outline point of a
+    column is its highest one, later points of the same column lie inside it.
+*/
+#define FILL_COLUMNS_ONCE(offsetx, offsety)                                                        \
+    do {                                                                                           \
+        if ((offsetx) != filled_x) {                                                               \
+            for (int16_t j = -(offsety); j <= (offsety); j++) {                                    \
+                DRAW_OFFSET_POINT(offsetx, j);                                                     \
+                if ((offsetx) != 0)                                                                \
+                    DRAW_OFFSET_POINT(-(offsetx), j);                                              \
+            }                                                                                      \
+            filled_x = (offsetx);                                                                  \
+        }                                                                                          \
+    } while (0)
+
 #define SQUARE(X) ((X) * (X))
 
 static inline void clearBound(CFBD_GraphicDevice* handler,
@@ -53,11 +82,8 @@ void CFBDGraphic_DrawEllipse(CFBD_GraphicDevice* handler, CFBD_GraphicEllipse* e
     // Initial decision variable for the first region of the ellipse
     float d1 = y_radius_square + x_radius_square * (-y_radius + 0.5);
 
-    // Draw initial points on the ellipse (4 points due to symmetry)
-    DRAW_OFFSET_POINT(x, y);
-    DRAW_OFFSET_POINT(-x, -y);
-    DRAW_OFFSET_POINT(-x, y);
-    DRAW_OFFSET_POINT(x, -y);
+    // Draw initial points on the ellipse (up to 4 points due to symmetry)
+    DRAW_SYMMETRIC_POINTS(x, y);
 
     // Draw the middle part of the ellipse (first region)
     while (y_radius_square * (x + 1) < x_radius_square * (y - 0.5)) {
@@ -71,10 +97,7 @@ void CFBDGraphic_DrawEllipse(CFBD_GraphicDevice* handler, CFBD_GraphicEllipse* e
         x++;
 
         // Draw ellipse arc for each point in the current region
-        DRAW_OFFSET_POINT(x, y);
-        DRAW_OFFSET_POINT(-x, -y);
-        DRAW_OFFSET_POINT(-x, y);
-        DRAW_OFFSET_POINT(x, -y);
+        DRAW_SYMMETRIC_POINTS(x, y);
     }
 
     // Draw the two sides of the ellipse (second region)
@@ -92,10 +115,7 @@ void CFBDGraphic_DrawEllipse(CFBD_GraphicDevice* handler, CFBD_GraphicEllipse* e
         y--;
 
         // Draw ellipse arc for each point on the sides
-        DRAW_OFFSET_POINT(x, y);
-        DRAW_OFFSET_POINT(-x, -y);
-        DRAW_OFFSET_POINT(-x, y);
-        DRAW_OFFSET_POINT(x, -y);
+        DRAW_SYMMETRIC_POINTS(x, y);
     }
 
     if (CFBDGraphic_DeviceRequestUpdateAtOnce(handler)) {
@@ -129,18 +149,9 @@ void CFBDGraphic_DrawFilledEllipse(CFBD_GraphicDevice* handler, CFBD_GraphicElli
 
     // Initial decision variable for the first region of the ellipse
     float d1 = y_radius_square + x_radius_square * (-y_radius + 0.5);
-    // Fill the ellipse by drawing vertical lines in the specified range (filled area)
-    for (int16_t j = -y; j < y; j++) {
-        // Draw vertical lines to fill the area of the ellipse
-        DRAW_OFFSET_POINT(0, j);
-        DRAW_OFFSET_POINT(0, j);
-    }
-
-    // Draw initial points on the ellipse (4 points due to symmetry)
-    DRAW_OFFSET_POINT(x, y);
-    DRAW_OFFSET_POINT(-x, -y);
-    DRAW_OFFSET_POINT(-x, y);
-    DRAW_OFFSET_POINT(x, -y);
+    // Fill the ellipse by drawing vertical lines, one per column so XOR stays exact
+    int16_t filled_x = -1;
+    FILL_COLUMNS_ONCE(x, y);
 
     // Draw the middle part of the ellipse (first region)
     while (y_radius_square * (x + 1) < x_radius_square * (y - 0.5)) {
@@ -154,16 +165,7 @@ void CFBDGraphic_DrawFilledEllipse(CFBD_GraphicDevice* handler, CFBD_GraphicElli
         x++;
 
         // Fill the ellipse by drawing vertical lines in the current range
-        for (int16_t j = -y; j < y; j++) {
-            DRAW_OFFSET_POINT(x, j);
-            DRAW_OFFSET_POINT(-x, j);
-        }
-
-        // Draw ellipse arc for each point in the current region
-        DRAW_OFFSET_POINT(x, y);
-        DRAW_OFFSET_POINT(-x, -y);
-        DRAW_OFFSET_POINT(-x, y);
-        DRAW_OFFSET_POINT(x, -y);
+        FILL_COLUMNS_ONCE(x, y);
     }
 
     // Draw the two sides of the ellipse (second region)
@@ -181,16 +183,7 @@ void CFBDGraphic_DrawFilledEllipse(CFBD_GraphicDevice* handler, CFBD_GraphicElli
         y--;
 
         // Fill the ellipse by drawing vertical lines in the current range
-        for (int16_t j = -y; j < y; j++) {
-            DRAW_OFFSET_POINT(x, j);
-            DRAW_OFFSET_POINT(-x, j);
-        }
-
-        // Draw ellipse arc for each point on the sides
-        DRAW_OFFSET_POINT(x, y);
-        DRAW_OFFSET_POINT(-x, -y);
-        DRAW_OFFSET_POINT(-x, y);
-        DRAW_OFFSET_POINT(x, -y);
+        FILL_COLUMNS_ONCE(x, y);
     }
 
     if (CFBDGraphic_DeviceRequestUpdateAtOnce(handler)) {
@@ -208,4 +201,6 @@ void CFBDGraphic_DrawFilledEllipse(CFBD_GraphicDevice* handler, CFBD_GraphicElli
 }
 
 #undef DRAW_OFFSET_POINT
+#undef DRAW_SYMMETRIC_POINTS
+#undef FILL_COLUMNS_ONCE
 #undef SQUARE
\ No newline at end of file
@@ -3,17 +3,11 @@
 #include "base_helpers.h"
 #include "cfbd_define.h"
 #include "cfbd_graphic_define.h"
+#include "device/graphic_canvas.h"
+#include "device/graphic_clip.h"
 #include "device/graphic_device.h"
 #include "point.h"
-
-static inline void swap_int16(int16_t* val1, int16_t* val2)
-{
-    if (*val1 == *val2)
-        return;
-    *val1 ^= *val2;
-    *val2 ^= *val1;
-    *val1 ^= *val2;
-}
+#include "rectangle.h"
 
 static inline uint16_t max_uint16(uint16_t val1, uint16_t val2)
 {
@@ -25,166 +19,397 @@ static inline uint16_t min_uint16(uint16_t val1, uint16_t val2)
     return val1 < val2 ? val1 : val2;
 }
 
-static inline void clearBounds(CFBD_GraphicDevice* handler, CFBDGraphic_Line* line)
+/*
+    Pixel writers for every raster target. The walkers only visit the steps
+    inside the clip, so none of them checks bounds.
+*/
+#define PLOT_DEVICE(target, X, Y) (target)->ops->setPixel((target), (uint16_t) (X), (uint16_t) (Y))
+#define PLOT_CANVAS_1BPP(target, X, Y) CFBDGraphic_CanvasPlot1Bpp((target), (X), (Y))
+#define PLOT_CANVAS_4BPP(target, X, Y) CFBDGraphic_CanvasPlot4Bpp((target), (X), (Y))
+
+/* Walker state at the first step inside the clip */
+typedef struct
+{
+    int32_t x, y;   // pixel of the first visible step
+    int32_t err;    // error term at that step
+    int32_t dx, dy; // |x1 - x0| and -|y1 - y0|
+    int32_t sx, sy; // step directions
+    int32_t steps;  // steps after the first one that stay inside the clip
+} BresenhamSpan;
+
+static inline int64_t ceil_div_i64(int64_t n, int64_t d)
+{
+    return (n >= 0) ? (n + d - 1) / d : -((-n) / d);
+}
+
+/*
+    Steps i of a walk whose coordinate offset along one axis, from the start
+    point, lies in [lo, hi]. The major axis moves every step; the minor axis
+    has moved floor((2 * minor * i + major) / (2 * major)) times after step
+    i, which is exactly when the error term below takes its minor steps.
+*/
+static CFBD_Bool axis_step_range(int64_t major,
+                                 int64_t minor,
+                                 CFBD_Bool is_major,
+                                 int64_t lo,
+                                 int64_t hi,
+                                 int64_t* first,
+                                 int64_t* last)
+{
+    const int64_t length = is_major ? major : minor;
+    if (hi < 0 || lo > length)
+        return CFBD_FALSE;
+    if (is_major) {
+        *first = (lo > 0) ? lo : 0;
+        *last = (hi < major) ? hi : major;
+        return CFBD_TRUE;
+    }
+    *first = (lo > 0) ? ceil_div_i64(2 * major * lo - major, 2 * minor) : 0;
+    *last = (hi < minor) ? (2 * major * hi + major - 1) / (2 * minor) : major;
+    return *first <= *last;
+}
+
+/*
+    Locate the part of the walk from (x0, y0) to (x1, y1) inside @p clip and
+    the walker state there, without stepping through the hidden part. The
+    path is the one of the unclipped walk: re-rounded clipped end points
+    would pick different pixels, and a line split across clip rectangles
+    (bands, dirty regions) must come out identical to the whole one.
+*/
+static CFBD_Bool bresenham_enter_clip(const CFBDGraphic_ClipBounds* clip,
+                                      int32_t x0,
+                                      int32_t y0,
+                                      int32_t x1,
+                                      int32_t y1,
+                                      BresenhamSpan* span)
+{
+    const int64_t a = x1 > x0 ? x1 - x0 : x0 - x1;
+    const int64_t b = y1 > y0 ? y1 - y0 : y0 - y1;
+    const CFBD_Bool x_major = a >= b;
+    const int64_t major = x_major ? a : b;
+    const int64_t minor = x_major ? b : a;
+    span->dx = (int32_t) a;
+    span->dy = (int32_t) -b;
+    span->sx = x0 < x1 ? 1 : -1;
+    span->sy = y0 < y1 ? 1 : -1;
+
+    // offsets from the start point the clip allows on each axis
+    const int64_t x_lo = (span->sx > 0) ? clip->x0 - x0 : x0 - clip->x1;
+    const int64_t x_hi = (span->sx > 0) ? clip->x1 - x0 : x0 - clip->x0;
+    const int64_t y_lo = (span->sy > 0) ? clip->y0 - y0 : y0 - clip->y1;
+    const int64_t y_hi = (span->sy > 0) ? clip->y1 - y0 : y0 - clip->y0;
+
+    int64_t first, last, first_y, last_y;
+    if (!axis_step_range(major, minor, x_major, x_lo, x_hi, &first, &last) ||
+        !axis_step_range(major, minor, !x_major, y_lo, y_hi, &first_y, &last_y))
+        return CFBD_FALSE;
+    if (first_y > first)
+        first = first_y;
+    if (last_y < last)
+        last = last_y;
+    if (first > last)
+        return CFBD_FALSE;
+
+    // moves along both axes at step first, then the error term there
+    const int64_t minor_moves = major ? (2 * minor * first + major) / (2 * major) : 0;
+    const int64_t x_moves = x_major ? first : minor_moves;
+    const int64_t y_moves = x_major ? minor_moves : first;
+    span->x = x0 + span->sx * (int32_t) x_moves;
+    span->y = y0 + span->sy * (int32_t) y_moves;
+    span->err = (int32_t) (a * (1 + y_moves) - b * (1 + x_moves));
+    span->steps = (int32_t) (last - first);
+    return CFBD_TRUE;
+}
+
+/* Rows CFBDGraphic_DrawLineUnion() collects per pass, every line enters the clip once per band */
+#define LINE_UNION_BAND_ROWS (16)
+
+/*
+    Row runs of a line union inside one band, sorted by left end per row.
+    A walk leaves a row as soon as it takes a minor step, so each line adds
+    at most one run per row.
+*/
+typedef struct
+{
+    int32_t y0;                                            // first row of the band
+    uint8_t runs[LINE_UNION_BAND_ROWS];                    // runs collected per row
+    uint16_t lo[LINE_UNION_BAND_ROWS][CFBD_LINE_UNION_MAX]; // left ends
+    uint16_t hi[LINE_UNION_BAND_ROWS][CFBD_LINE_UNION_MAX]; // right ends
+    int32_t y, run_lo, run_hi;                             // run of the line being walked
+} LineUnionBand;
+
+static void line_union_add_run(LineUnionBand* band)
 {
-    int32_t lx = asInt32_t(line->p_left.x);
-    int32_t rx = asInt32_t(line->p_right.x);
-    int32_t ty = asInt32_t(line->p_left.y);
-    int32_t by = asInt32_t(line->p_right.y);
+    const int32_t row = band->y - band->y0;
+    uint8_t at = band->runs[row]++;
+    for (; at > 0 && band->lo[row][at - 1] > band->run_lo; at--) {
+        band->lo[row][at] = band->lo[row][at - 1];
+        band->hi[row][at] = band->hi[row][at - 1];
+    }
+    band->lo[row][at] = (uint16_t) band->run_lo;
+    band->hi[row][at] = (uint16_t) band->run_hi;
+}
 
-    if (lx > rx) {
-        int32_t t = lx;
-        lx = rx;
-        rx = t;
+static inline void line_union_collect(LineUnionBand* band, int32_t x, int32_t y)
+{
+    if (y != band->y) {
+        line_union_add_run(band);
+        band->y = y;
+        band->run_lo = band->run_hi = x;
+    }
+    else if (x < band->run_lo) {
+        band->run_lo = x;
     }
-    if (ty > by) {
-        int32_t t = ty;
-        ty = by;
-        by = t;
+    else if (x > band->run_hi) {
+        band->run_hi = x;
     }
 }
 
+#define PLOT_ROW_RUN(target, X, Y) line_union_collect((target), (X), (Y))
+
+// Bresenham's Line Algorithm, designed to avoid floating point calculations
+// References: https://www.cs.montana.edu/courses/spring2009/425/dslectures/Bresenham.pdf
+// https://www.bilibili.com/video/BV1364y1d7Lo
+// The error term form below walks all eight octants without coordinate
+// mirroring, so one body serves every target; the macro stamps out one walker
+// per pixel writer so the inner loop never calls through a pointer.
+// The walk starts at the first visible step (see bresenham_enter_clip) and
+// stops after the last one, so the loop carries no bounds test.
+#define DEFINE_BRESENHAM_WALKER(NAME, TARGET_TYPE, PLOT)                                           \
+    static void NAME(TARGET_TYPE target, const BresenhamSpan* span)                                \
+    {                                                                                              \
+        int32_t x = span->x;                                                                       \
+        int32_t y = span->y;                                                                       \
+        int32_t err = span->err;                                                                   \
+        for (int32_t left = span->steps;; left--) {                                                \
+            PLOT(target, x, y);                                                                    \
+            if (left == 0)                                                                         \
+                break;                                                                             \
+            const int32_t e2 = 2 * err;                                                            \
+            if (e2 >= span->dy) {                                                                  \
+                err += span->dy;                                                                   \
+                x += span->sx;                                                                     \
+            }                                                                                      \
+            if (e2 <= span->dx) {                                                                  \
+                err += span->dx;                                                                   \
+                y += span->sy;                                                                     \
+            }                                                                                      \
+        }                                                                                          \
+    }
+
+DEFINE_BRESENHAM_WALKER(__pvt_bresenham_device, CFBD_GraphicDevice*, PLOT_DEVICE)
+DEFINE_BRESENHAM_WALKER(__pvt_bresenham_canvas_1bpp, CFBDGraphic_Canvas*, PLOT_CANVAS_1BPP)
+DEFINE_BRESENHAM_WALKER(__pvt_bresenham_canvas_4bpp, CFBDGraphic_Canvas*, PLOT_CANVAS_4BPP)
+DEFINE_BRESENHAM_WALKER(__pvt_bresenham_row_runs, LineUnionBand*, PLOT_ROW_RUN)
+
+#undef DEFINE_BRESENHAM_WALKER
+
 /*
     draw the lines that matches the equal x
+    canvas->clip holds the visible region even when has_canvas is false
 */
-static void __on_handle_vertical_line(CFBD_GraphicDevice* handler, CFBDGraphic_Line* line)
+static void __on_handle_vertical_line(CFBD_GraphicDevice* handler,
+                                      CFBDGraphic_Canvas* canvas,
+                                      CFBD_Bool has_canvas,
+                                      CFBDGraphic_Line* line)
 {
-    PointBaseType max_y = max_uint16(line->p_left.y, line->p_right.y);
-    PointBaseType min_y = min_uint16(line->p_left.y, line->p_right.y);
+    int32_t max_y = max_uint16(line->p_left.y, line->p_right.y);
+    int32_t min_y = min_uint16(line->p_left.y, line->p_right.y);
     PointBaseType x = line->p_left.x;
-    PointBaseType y;
+
+    // clip once for the whole span instead of per pixel
+    if (!CFBDGraphic_CanvasClipVSpan(canvas, x, &min_y, &max_y))
+        return;
+
+    if (has_canvas) {
+        if (canvas->format == CFBD_CANVAS_1BPP_PAGE)
+            CFBDGraphic_CanvasVSpan1Bpp(canvas, x, min_y, max_y);
+        else
+            CFBDGraphic_CanvasVSpan4Bpp(canvas, x, min_y, max_y);
+        return;
+    }
+
     CFBD_Bool (*setpixel)(CFBD_GraphicDevice* device, uint16_t x, uint16_t y) =
             handler->ops->setPixel;
-    for (PointBaseType i = min_y; i <= max_y; i++) {
-        y = i;
-        setpixel(handler, x, y);
+    for (int32_t i = min_y; i <= max_y; i++) {
+        setpixel(handler, x, (PointBaseType) i);
     }
 }
 
-static void __on_handle_horizental_line(CFBD_GraphicDevice* handler, CFBDGraphic_Line* line)
+static void __on_handle_horizental_line(CFBD_GraphicDevice* handler,
+                                        CFBDGraphic_Canvas* canvas,
+                                        CFBD_Bool has_canvas,
+                                        CFBDGraphic_Line* line)
 {
+    int32_t max_x = max_uint16(line->p_left.x, line->p_right.x);
+    int32_t min_x = min_uint16(line->p_left.x, line->p_right.x);
+    PointBaseType y = line->p_left.y;
+
+    if (!CFBDGraphic_CanvasClipHSpan(canvas, &min_x, &max_x, y))
+        return;
+
+    if (has_canvas) {
+        if (canvas->format == CFBD_CANVAS_1BPP_PAGE)
+            CFBDGraphic_CanvasHSpan1Bpp(canvas, min_x, max_x, y);
+        else
+            CFBDGraphic_CanvasHSpan4Bpp(canvas, min_x, max_x, y);
+        return;
+    }
+
     CFBD_Bool (*setPixel)(CFBD_GraphicDevice* device, uint16_t x, uint16_t y) =
             handler->ops->setPixel;
-    PointBaseType max_x = max_uint16(line->p_left.x, line->p_right.x);
-    PointBaseType min_x = min_uint16(line->p_left.x, line->p_right.x);
-    PointBaseType x;
-    PointBaseType y = line->p_left.y;
-    for (PointBaseType i = min_x; i <= max_x; i++) {
-        x = i;
-        setPixel(handler, x, y);
+    for (int32_t i = min_x; i <= max_x; i++) {
+        setPixel(handler, (PointBaseType) i, y);
     }
 }
 
-// Bresenham's Line Algorithm, designed to avoid floating point calculations
-// References: https://www.cs.montana.edu/courses/spring2009/425/dslectures/Bresenham.pdf
-// https://www.bilibili.com/video/BV1364y1d7Lo
-void __pvt_BresenhamMethod_line(CFBD_GraphicDevice* handler, CFBDGraphic_Line* line)
+void __pvt_BresenhamMethod_line(CFBD_GraphicDevice* handler,
+                                CFBDGraphic_Canvas* canvas,
+                                CFBD_Bool has_canvas,
+                                CFBDGraphic_Line* line)
 {
-    CFBD_Bool (*setPixel)(CFBD_GraphicDevice* device, uint16_t x, uint16_t y) =
-            handler->ops->setPixel;
+    // exact pixel path test: the geometric segment may miss a clip corner its pixels touch
+    BresenhamSpan span;
+    if (!bresenham_enter_clip(&canvas->clip,
+                              asInt32_t(line->p_left.x),
+                              asInt32_t(line->p_left.y),
+                              asInt32_t(line->p_right.x),
+                              asInt32_t(line->p_right.y),
+                              &span))
+        return;
 
-#define __pvt_fast_draw_point(X, Y)                                                                \
-    do {                                                                                           \
-        setPixel(handler, X, Y);                                                                   \
-    } while (0)
-
-    // Define initial points for the line: p_left and p_right represent the endpoints
-    int16_t startX = line->p_left.x;
-    int16_t startY = line->p_left.y;
-    int16_t endX = line->p_right.x;
-    int16_t endY = line->p_right.y;
-
-    // Flags to indicate transformations of coordinates
-    uint8_t isYInverted = 0, isXYInverted = 0;
-    {
-        // If the start point's X coordinate is greater than the end point's X, swap the points
-        if (startX > endX) {
-            // Swap the X and Y coordinates for the start and end points
-            swap_int16(&startX, &endX);
-            swap_int16(&startY, &endY);
-        }
+    if (!has_canvas) {
+        __pvt_bresenham_device(handler, &span);
+        return;
+    }
 
-        // If the start point's Y coordinate is greater than the end point's Y, invert the Y
-        // coordinates
-        if (startY > endY) {
-            // Invert Y coordinates to make the line direction consistent in the first quadrant
-            startY = -startY;
-            endY = -endY;
-            // Set the flag indicating Y coordinates were inverted
-            isYInverted = 1;
-        }
+    switch (canvas->format) {
+        case CFBD_CANVAS_1BPP_PAGE:
+            __pvt_bresenham_canvas_1bpp(canvas, &span);
+            break;
+        case CFBD_CANVAS_4BPP_PACKED:
+            __pvt_bresenham_canvas_4bpp(canvas, &span);
+            break;
+    }
+}
 
-        // If the line's slope (dy/dx) is greater than 1, swap X and Y coordinates for a shallower
-        // slope
-        if (endY - startY > endX - startX) {
-            // Swap X and Y coordinates for both points
-            swap_int16(&startX, &startY);
-            swap_int16(&endX, &endY);
-            // Set the flag indicating both X and Y coordinates were swapped
-            isXYInverted = 1;
-        }
+/* Walk the part of @p line inside @p clip once, adding its row runs to @p band */
+static void line_union_walk(LineUnionBand* band,
+                            const CFBDGraphic_ClipBounds* clip,
+                            const CFBDGraphic_Line* line)
+{
+    BresenhamSpan span;
+    if (!bresenham_enter_clip(clip,
+                              asInt32_t(line->p_left.x),
+                              asInt32_t(line->p_left.y),
+                              asInt32_t(line->p_right.x),
+                              asInt32_t(line->p_right.y),
+                              &span))
+        return;
 
-        // Calculate differences (dx, dy) and the decision variables for Bresenham's algorithm
-        const int16_t dx = endX - startX;
-        const int16_t dy = endY - startY;
-        const int16_t incrE = 2 * dy;         // Increment for eastward movement
-        const int16_t incrNE = 2 * (dy - dx); // Increment for northeastward movement
+    band->y = span.y;
+    band->run_lo = band->run_hi = span.x;
+    __pvt_bresenham_row_runs(band, &span);
+    line_union_add_run(band);
+}
+
+static void write_row_run(CFBD_GraphicDevice* handler,
+                          CFBDGraphic_Canvas* canvas,
+                          CFBD_Bool has_canvas,
+                          int32_t lo,
+                          int32_t hi,
+                          int32_t y)
+{
+    if (!has_canvas) {
+        for (int32_t x = lo; x <= hi; x++)
+            handler->ops->setPixel(handler, (uint16_t) x, (uint16_t) y);
+    }
+    else if (canvas->format == CFBD_CANVAS_1BPP_PAGE) {
+        CFBDGraphic_CanvasHSpan1Bpp(canvas, lo, hi, y);
+    }
+    else {
+        CFBDGraphic_CanvasHSpan4Bpp(canvas, lo, hi, y);
+    }
+}
 
-        int16_t decision = 2 * dy - dx; // Initial decision variable
-        int16_t x = startX;             // Starting X coordinate
-        int16_t y = startY;             // Starting Y coordinate
+void CFBDGraphic_DrawLineUnion(CFBD_GraphicDevice* handler,
+                               const CFBDGraphic_Line* lines,
+                               uint8_t count)
+{
+    if (count > CFBD_LINE_UNION_MAX)
+        count = CFBD_LINE_UNION_MAX;
 
-        // Draw the starting point and handle coordinate transformations based on flags
-        if (isYInverted && isXYInverted) {
-            __pvt_fast_draw_point(y, -x);
-        }
-        else if (isYInverted) {
-            __pvt_fast_draw_point(x, -y);
-        }
-        else if (isXYInverted) {
-            __pvt_fast_draw_point(y, x);
-        }
-        else {
-            __pvt_fast_draw_point(x, y);
+    CFBDGraphic_Canvas canvas;
+    const CFBD_Bool has_canvas = CFBDGraphic_DeviceFetchCanvas(handler, &canvas);
+    if (!has_canvas)
+        CFBDGraphic_FetchClipBounds(handler, &canvas.clip);
+    if (count == 0 || CFBDGraphic_ClipBoundsIsEmpty(&canvas.clip))
+        return;
+
+    int32_t top = canvas.clip.y1, bottom = canvas.clip.y0;
+    for (uint8_t i = 0; i < count; i++) {
+        const int32_t y0 = min_uint16(lines[i].p_left.y, lines[i].p_right.y);
+        const int32_t y1 = max_uint16(lines[i].p_left.y, lines[i].p_right.y);
+        top = (y0 < top) ? y0 : top;
+        bottom = (y1 > bottom) ? y1 : bottom;
+    }
+    top = (top < canvas.clip.y0) ? canvas.clip.y0 : top;
+    bottom = (bottom > canvas.clip.y1) ? canvas.clip.y1 : bottom;
+
+    // 按行带收集: 每条线每个行带只定位一次, 逐步记下各行的像素段
+    // 再把每行的像素段按左端合并, 共享像素只写一次
+    LineUnionBand band;
+    for (int32_t y0 = top; y0 <= bottom; y0 += LINE_UNION_BAND_ROWS) {
+        const int32_t y1 =
+                (bottom - y0 < LINE_UNION_BAND_ROWS) ? bottom : y0 + LINE_UNION_BAND_ROWS - 1;
+        const CFBDGraphic_ClipBounds band_clip = {
+                canvas.clip.x0, (uint16_t) y0, canvas.clip.x1, (uint16_t) y1};
+        band.y0 = y0;
+        for (int32_t row = 0; row <= y1 - y0; row++)
+            band.runs[row] = 0;
+        for (uint8_t i = 0; i < count; i++) {
+            if (max_uint16(lines[i].p_left.y, lines[i].p_right.y) < y0 ||
+                min_uint16(lines[i].p_left.y, lines[i].p_right.y) > y1)
+                continue;
+            line_union_walk(&band, &band_clip, &lines[i]);
         }
 
-        // Iterate through the X-axis to draw the rest of the line
-        while (x < endX) {
-            x++; // Increment X coordinate
-            if (decision < 0) {
-                decision += incrE; // Move eastward if decision variable is negative
-            }
-            else {
-                y++; // Move northeastward if decision variable is positive or zero
-                decision += incrNE;
-            }
+        for (int32_t row = 0; row <= y1 - y0; row++) {
+            const uint8_t runs = band.runs[row];
+            if (runs == 0)
+                continue;
 
-            // Draw each point along the line with coordinate transformation as needed
-            if (isYInverted && isXYInverted) {
-                __pvt_fast_draw_point(y, -x);
-            }
-            else if (isYInverted) {
-                __pvt_fast_draw_point(x, -y);
-            }
-            else if (isXYInverted) {
-                __pvt_fast_draw_point(y, x);
-            }
-            else {
-                __pvt_fast_draw_point(x, y);
+            const uint16_t* lo = band.lo[row];
+            const uint16_t* hi = band.hi[row];
+            int32_t run_lo = lo[0], run_hi = hi[0];
+            for (uint8_t i = 1; i < runs; i++) {
+                if (lo[i] > run_hi + 1) {
+                    write_row_run(handler, &canvas, has_canvas, run_lo, run_hi, y0 + row);
+                    run_lo = lo[i];
+                }
+                run_hi = (hi[i] > run_hi) ? hi[i] : run_hi;
             }
+            write_row_run(handler, &canvas, has_canvas, run_lo, run_hi, y0 + row);
         }
     }
 }
 
 void CFBDGraphic_DrawLine(CFBD_GraphicDevice* handler, CFBDGraphic_Line* line)
 {
-    clearBounds(handler, line);
-    // test if the vertical
-    if (line->p_left.x == line->p_right.x)
-        __on_handle_vertical_line(handler, line);
-    if (line->p_left.y == line->p_right.y)
-        __on_handle_horizental_line(handler, line);
-    __pvt_BresenhamMethod_line(handler, line);
+    CFBDGraphic_Canvas canvas;
+    const CFBD_Bool has_canvas = CFBDGraphic_DeviceFetchCanvas(handler, &canvas);
+    if (!has_canvas)
+        CFBDGraphic_FetchClipBounds(handler, &canvas.clip);
+
+    // axis aligned lines are plain spans, everything else walks Bresenham
+    if (!CFBDGraphic_ClipBoundsIsEmpty(&canvas.clip)) {
+        if (line->p_left.x == line->p_right.x)
+            __on_handle_vertical_line(handler, &canvas, has_canvas, line);
+        else if (line->p_left.y == line->p_right.y)
+            __on_handle_horizental_line(handler, &canvas, has_canvas, line);
+        else
+            __pvt_BresenhamMethod_line(handler, &canvas, has_canvas, line);
+    }
 
     if (CFBDGraphic_DeviceRequestUpdateAtOnce(handler)) {
         int32_t lx = asInt32_t(line->p_left.x);
@@ -209,4 +434,9 @@ void CFBDGraphic_DrawLine(CFBD_GraphicDevice* handler, CFBDGraphic_Line* line)
                                   clamp_u16_from_i32(rx - lx + 1),
                                   clamp_u16_from_i32(by - ty + 1));
     }
-}
\ No newline at end of file
+}
+
+#undef PLOT_DEVICE
+#undef PLOT_CANVAS_1BPP
+#undef PLOT_CANVAS_4BPP
+#undef PLOT_ROW_RUN
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include "cfbd_define.h"
 #include "point.h"
 
 /**
@@ -99,4 +100,28 @@ typedef struct
  */
 void CFBDGraphic_DrawLine(CFBD_GraphicDevice* handler, CFBDGraphic_Line* line);
 
+/**
+ * @def CFBD_LINE_UNION_MAX
+ * @brief Most lines CFBDGraphic_DrawLineUnion() draws in one call.
+ */
+#define CFBD_LINE_UNION_MAX (4)
+
+/**
+ * @brief Draw several lines, writing every pixel they cover once.
+ *
+ * @details Each line lights the same pixels as with CFBDGraphic_DrawLine().
+ *          Pixels shared by two lines (corners, overlapping edges) are
+ *          written once, which CFBD_ROP_XOR needs for outlines made of
+ *          several lines. Each line is walked once, collecting its row runs
+ *          a band of rows at a time; the runs of a row are merged and
+ *          written as spans. No flush is requested.
+ *
+ * @param handler Target device.
+ * @param lines Lines, their point order matters as for drawing.
+ * @param count Number of lines, at most CFBD_LINE_UNION_MAX.
+ */
+void CFBDGraphic_DrawLineUnion(CFBD_GraphicDevice* handler,
+                               const CFBDGraphic_Line* lines,
+                               uint8_t count);
+
 /** @} */ // End of Line_Module group
@@ -4,6 +4,8 @@
 #include <stdint.h>
 #include <stdlib.h>
 
+#include "device/graphic_canvas.h"
+#include "device/graphic_clip.h"
 #include "device/graphic_device.h"
 
 typedef enum
@@ -14,6 +16,67 @@ typedef enum
     CS_TOP = 1 << 3
 } ____CSCode;
 
+/* Limit the inclusive box [lx, rx] x [ty, by] to the clip, CFBD_FALSE if nothing is left */
+static CFBD_Bool clip_box(const CFBDGraphic_ClipBounds* clip,
+                          int32_t* lx,
+                          int32_t* ty,
+                          int32_t* rx,
+                          int32_t* by)
+{
+    if (*lx < clip->x0)
+        *lx = clip->x0;
+    if (*ty < clip->y0)
+        *ty = clip->y0;
+    if (*rx > clip->x1)
+        *rx = clip->x1;
+    if (*by > clip->y1)
+        *by = clip->y1;
+    return *lx <= *rx && *ty <= *by;
+}
+
+/*
+    Fill the inclusive box [lx, rx] x [ty, by] after clipping it once.
+    canvas->clip holds the visible region even when has_canvas is false.
+*/
+static void fill_box(CFBD_GraphicDevice* device,
+                     CFBDGraphic_Canvas* canvas,
+                     CFBD_Bool has_canvas,
+                     int32_t lx,
+                     int32_t ty,
+                     int32_t rx,
+                     int32_t by)
+{
+    if (!clip_box(&canvas->clip, &lx, &ty, &rx, &by))
+        return;
+
+    if (!has_canvas) {
+        for (int32_t y = ty; y <= by; ++y) {
+            for (int32_t x = lx; x <= rx; ++x) {
+                device->ops->setPixel(device, (uint16_t) x, (uint16_t) y);
+            }
+        }
+    }
+    else if (canvas->format == CFBD_CANVAS_1BPP_PAGE) {
+        /* 页格式按列写，每页一个掩码 */
+        for (int32_t x = lx; x <= rx; ++x) {
+            CFBDGraphic_CanvasVSpan1Bpp(canvas, x, ty, by);
+        }
+    }
+    else {
+        for (int32_t y = ty; y <= by; ++y) {
+            CFBDGraphic_CanvasHSpan4Bpp(canvas, lx, rx, y);
+        }
+    }
+}
+
+static CFBD_Bool fetch_target(CFBD_GraphicDevice* device, CFBDGraphic_Canvas* canvas)
+{
+    const CFBD_Bool has_canvas = CFBDGraphic_DeviceFetchCanvas(device, canvas);
+    if (!has_canvas)
+        CFBDGraphic_FetchClipBounds(device, &canvas->clip);
+    return has_canvas;
+}
+
 void CFBDGraphic_DrawRect(CFBD_GraphicDevice* device, CFBDGraphicRect* rect)
 {
     if (device == NULL || rect == NULL)
@@ -34,25 +97,19 @@ void CFBDGraphic_DrawRect(CFBD_GraphicDevice* device, CFBDGraphicRect* rect)
 
     uint16_t w = (uint16_t) (rx - lx + 1);
     uint16_t h = (uint16_t) (by - ty + 1);
-    device->ops->clear_area(device, clamp_u16_from_i32(lx), clamp_u16_from_i32(ty), w, h);
-
-    if (lx == rx && ty == by) {
-        device->ops->setPixel(device, clamp_u16_from_i32(lx), clamp_u16_from_i32(ty));
-    }
-    else {
-        /* 顶边与底边（水平）: x = lx..rx */
-        for (int32_t x = lx; x <= rx; ++x) {
-            device->ops->setPixel(device, clamp_u16_from_i32(x), clamp_u16_from_i32(ty));
-            if (by != ty) /* 如果高度>1 再画底边，防止重复画同一行 */
-                device->ops->setPixel(device, clamp_u16_from_i32(x), clamp_u16_from_i32(by));
-        }
-        if (by - ty >= 2) {
-            for (int32_t y = ty + 1; y <= by - 1; ++y) {
-                device->ops->setPixel(device, clamp_u16_from_i32(lx), clamp_u16_from_i32(y));
-                if (rx != lx)
-                    device->ops->setPixel(device, clamp_u16_from_i32(rx), clamp_u16_from_i32(y));
-            }
-        }
+    CFBDGraphic_DeviceClearBeforeDraw(device, lx, ty, rx, by);
+
+    CFBDGraphic_Canvas canvas;
+    const CFBD_Bool has_canvas = fetch_target(device, &canvas);
+
+    /* 顶边与底边（水平）: x = lx..rx，高度>1 再画底边，防止重复画同一行 */
+    fill_box(device, &canvas, has_canvas, lx, ty, rx, ty);
+    if (by != ty)
+        fill_box(device, &canvas, has_canvas, lx, by, rx, by);
+    if (by - ty >= 2) {
+        fill_box(device, &canvas, has_canvas, lx, ty + 1, lx, by - 1);
+        if (rx != lx)
+            fill_box(device, &canvas, has_canvas, rx, ty + 1, rx, by - 1);
     }
 
     if (CFBDGraphic_DeviceRequestUpdateAtOnce(device)) {
@@ -70,13 +127,11 @@ void CFBDGraphic_FillRect(CFBD_GraphicDevice* device, CFBDGraphicRect* rect)
 
     uint16_t w = (uint16_t) (rx - lx + 1);
     uint16_t h = (uint16_t) (by - ty + 1);
-    device->ops->clear_area(device, clamp_u16_from_i32(lx), clamp_u16_from_i32(ty), w, h);
+    CFBDGraphic_DeviceClearBeforeDraw(device, lx, ty, rx, by);
 
-    for (int32_t y = ty; y <= by; ++y) {
-        for (int32_t x = lx; x <= rx; ++x) {
-            device->ops->setPixel(device, clamp_u16_from_i32(x), clamp_u16_from_i32(y));
-        }
-    }
+    CFBDGraphic_Canvas canvas;
+    const CFBD_Bool has_canvas = fetch_target(device, &canvas);
+    fill_box(device, &canvas, has_canvas, lx, ty, rx, by);
 
     if (CFBDGraphic_DeviceRequestUpdateAtOnce(device)) {
         device->ops->update_area(device, clamp_u16_from_i32(lx), clamp_u16_from_i32(ty), w, h);
@@ -59,9 +59,7 @@ static void clearBound(CFBD_GraphicDevice* handle, CFBDGraphic_Triangle* triangl
     if (by < ty)
         by = ty;
 
-    uint16_t w = (uint16_t) (rx - lx + 1);
-    uint16_t h = (uint16_t) (by - ty + 1);
-    handle->ops->clear_area(handle, clamp_u16_from_i32(lx), clamp_u16_from_i32(ty), w, h);
+    CFBDGraphic_DeviceClearBeforeDraw(handle, lx, ty, rx, by);
 }
 
 static void update_requests(CFBD_GraphicDevice* handle, CFBDGraphic_Triangle* triangle)
@@ -105,15 +103,12 @@ static void update_requests(CFBD_GraphicDevice* handle, CFBDGraphic_Triangle* tr
 void CCGraphic_DrawTriangle(CFBD_GraphicDevice* handle, CFBDGraphic_Triangle* triangle)
 {
     clearBound(handle, triangle);
-    CFBDGraphic_Line line;
-    line.p_left = triangle->p1;
-    line.p_right = triangle->p2;
-    CFBDGraphic_DrawLine(handle, &line);
-    line.p_left = triangle->p2;
-    line.p_right = triangle->p3;
-    CFBDGraphic_DrawLine(handle, &line);
-    line.p_left = triangle->p1;
-    CFBDGraphic_DrawLine(handle, &line);
+    const CFBDGraphic_Line edges[3] = {{triangle->p1, triangle->p2},
+                                       {triangle->p2, triangle->p3},
+                                       {triangle->p1, triangle->p3}};
+
+    // 三条边的公共像素 (顶点, 重合的边) 只写一次, CFBD_ROP_XOR 才不会互相抵消
+    CFBDGraphic_DrawLineUnion(handle, edges, 3);
 
     if (CFBDGraphic_DeviceRequestUpdateAtOnce(handle)) {
         update_requests(handle, triangle);
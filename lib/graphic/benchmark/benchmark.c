@@ -5,71 +5,258 @@
 #include "base/point.h"
 #include "base/size.h"
 #include "config/system_settings.h"
+#include "device/graphic_canvas.h"
 #include "device/graphic_device.h"
+#include "display_list/band_renderer.h"
+#include "display_list/display_list.h"
 #include "sys_clock/system_clock.h"
+#include "widget/animation/frame_pacer.h"
 #include "widget/text.h"
 #include "widget/text_config.h"
+#include "widget/text_font.h"
 
-// FPS性能测试 - 在OLED屏幕上显示刷新率
+#define FPS_BENCH_DURATION_MS (30000)
+#define FPS_BENCH_INTERVAL_MS (20) // 50 fps
+
+typedef struct
+{
+    CFBD_GraphicDevice* handler;
+    CFBDGraphic_Text text;
+    uint32_t test_start;
+    uint32_t window_start; // 当前 FPS 统计窗口的起点
+    uint32_t window_frames;
+    uint32_t fps_x10;
+    char buffer[64];
+} FpsBench;
+
+static CFBD_Bool fps_bench_frame(void* user_data, uint32_t now_ms)
+{
+    FpsBench* bench = user_data;
+    bench->window_frames++;
+    const uint32_t elapsed = now_ms - bench->window_start;
+
+    // 每 500ms 更新一次 FPS
+    if (elapsed >= 500) {
+        // fps_x10 = frame_count * 1000 * 10 / elapsed
+        bench->fps_x10 = (bench->window_frames * 10000U) / elapsed;
+
+        bench->window_frames = 0;
+        bench->window_start = now_ms;
+    }
+
+    snprintf(bench->buffer,
+             sizeof(bench->buffer),
+             "FPS: %lu.%lu "
+             "Time: %lus",
+             bench->fps_x10 / 10,
+             bench->fps_x10 % 10,
+             (now_ms - bench->test_start) / 1000);
+    CFBDGraphic_SetText(&bench->text, bench->buffer);
+    CFBDGraphic_DrawText(bench->handler, &bench->text, CCGraphic_AsciiTextItem_RequestOldPoint);
+    return (now_ms - bench->test_start) < FPS_BENCH_DURATION_MS;
+}
+
+// FPS性能测试 - 按帧位节拍刷新, 在OLED屏幕上显示刷新率和帧时间
 static void test_fps_benchmark(CFBD_GraphicDevice* handler)
 {
     CFBDGraphicSize screen_size;
     CFBDGraphic_GetScreenSize(handler, &screen_size);
 
-    CFBDGraphic_Text fps_text;
+    FpsBench bench;
     CFBDGraphic_Point p = {0, 0};
-    CFBDGraphic_InitText(&fps_text, p, screen_size, ASCII_8x16);
-
-    uint32_t frame_count = 0;
-    uint32_t last_time = HAL_GetTick();
+    bench.handler = handler;
+    CFBDGraphic_InitText(&bench.text, p, screen_size, ASCII_8x16);
+    // 只重绘变化的数字
+    char fps_shadow[32];
+    CFBDGraphic_SetTextIncremental(&bench.text, fps_shadow, sizeof(fps_shadow));
 
-    uint32_t fps_x10 = 0;
-    char buffer[64];
+    CFBD_FramePacer pacer;
+    CFBD_InitFramePacer(&pacer, HAL_GetTick, FPS_BENCH_INTERVAL_MS);
+    bench.test_start = HAL_GetTick();
+    bench.window_start = bench.test_start;
+    bench.window_frames = 0;
+    bench.fps_x10 = 0;
+    CFBD_FramePacerRun(&pacer, fps_bench_frame, NULL, &bench);
 
-    uint32_t test_start = HAL_GetTick();
-    uint32_t test_duration = 30000;
-
-    while ((HAL_GetTick() - test_start) < test_duration) {
-        // CFBDGraphic_DeviceClearImmediate(handler);
-
-        frame_count++;
-        uint32_t current_time = HAL_GetTick();
-        uint32_t elapsed = current_time - last_time;
-
-        // 每 500ms 更新一次 FPS
-        if (elapsed >= 500) {
-            // fps_x10 = frame_count * 1000 * 10 / elapsed
-            fps_x10 = (frame_count * 10000U) / elapsed;
-
-            frame_count = 0;
-            last_time = current_time;
-        }
-
-        snprintf(buffer,
-                 sizeof(buffer),
-                 "FPS: %lu.%lu "
-                 "Time: %lus",
-                 fps_x10 / 10,
-                 fps_x10 % 10,
-                 (HAL_GetTick() - test_start) / 1000);
-        // CFBDGraphic_DeviceClearImmediate(handler);
-        CFBDGraphic_SetText(&fps_text, buffer);
-        CFBDGraphic_DrawText(handler, &fps_text, CCGraphic_AsciiTextItem_RequestOldPoint);
-    }
+    // 帧数按实际耗时折算, 跳过的帧位不计入
+    const CFBD_FrameStats* stats = &pacer.stats;
+    const uint32_t total = HAL_GetTick() - bench.test_start;
+    const uint32_t fps_x10 = total ? (stats->frames * 10000U) / total : 0;
 
     CFBDGraphic_DeviceClearImmediate(handler);
-    snprintf(buffer,
-             sizeof(buffer),
-             "Test Complete! "
-             "Final FPS: %lu.%lu",
+    CFBDGraphic_InvalidateText(&bench.text);
+    snprintf(bench.buffer,
+             sizeof(bench.buffer),
+             "FPS: %lu.%lu "
+             "Avg:%lums Max:%lums "
+             "Skip:%lu Over:%lu",
              fps_x10 / 10,
-             fps_x10 % 10);
+             fps_x10 % 10,
+             CFBD_FramePacerAverageMs(stats),
+             stats->max_ms,
+             stats->skipped,
+             stats->overruns);
 
-    CFBDGraphic_SetText(&fps_text, buffer);
-    CFBDGraphic_DrawText(handler, &fps_text, CCGraphic_AsciiTextItem_RequestOldPoint);
+    CFBDGraphic_SetText(&bench.text, bench.buffer);
+    CFBDGraphic_DrawText(handler, &bench.text, CCGraphic_AsciiTextItem_RequestOldPoint);
 }
 
 void test_fps(CFBD_GraphicDevice* handler)
 {
     test_fps_benchmark(handler);
-}
\ No newline at end of file
+}
+
+#define BAND_BENCH_FRAMES (20)
+#define BAND_BENCH_MAX_WIDTH (128)
+
+// 构造一帧测试内容：边框、对角线、圆和文字
+static void record_band_bench_frame(CFBDGraphic_DisplayList* list, CFBDGraphicSize* screen)
+{
+    const uint16_t w = screen->width;
+    const uint16_t h = screen->height;
+    CFBDGraphicRect frame = {{0, 0}, {w - 1, h - 1}};
+    CFBDGraphic_Line diag1 = {{0, 0}, {w - 1, h - 1}};
+    CFBDGraphic_Line diag2 = {{0, h - 1}, {w - 1, 0}};
+    CFBDGraphicCircle ring = {h / 3, {w / 2, h / 2}};
+    CFBDGraphicCircle dot = {h / 8, {w / 4, h / 2}};
+    CFBDGraphic_Point caption = {4, 4};
+
+    CFBDGraphic_DisplayListRect(list, &frame);
+    CFBDGraphic_DisplayListLine(list, &diag1);
+    CFBDGraphic_DisplayListLine(list, &diag2);
+    CFBDGraphic_DisplayListCircle(list, &ring);
+    CFBDGraphic_DisplayListFilledCircle(list, &dot);
+    CFBDGraphic_DisplayListText(list, &caption, "Band bench", ASCII_6x8);
+}
+
+// 全帧缓冲模式：清屏、回放、整屏刷新
+static uint32_t bench_full_frame(CFBD_GraphicDevice* handler, CFBDGraphic_DisplayList* list)
+{
+    const CFBD_Bool immediate = CFBDGraphic_DeviceRequestUpdateAtOnce(handler);
+    CFBDGraphic_DeviceSetIfRequestUpdateAtOnce(handler, CFBD_FALSE);
+
+    uint32_t start = HAL_GetTick();
+    for (uint16_t i = 0; i < BAND_BENCH_FRAMES; i++) {
+        handler->ops->clear(handler);
+        CFBDGraphic_DisplayListReplay(handler, list, NULL);
+        handler->ops->update(handler);
+    }
+    uint32_t elapsed = HAL_GetTick() - start;
+
+    CFBDGraphic_DeviceSetIfRequestUpdateAtOnce(handler, immediate);
+    return elapsed;
+}
+
+static uint32_t bench_banded(CFBD_GraphicDevice* handler,
+                             CFBDGraphic_DisplayList* list,
+                             uint8_t* band,
+                             uint16_t band_rows)
+{
+    uint32_t start = HAL_GetTick();
+    for (uint16_t i = 0; i < BAND_BENCH_FRAMES; i++) {
+        if (!CFBDGraphic_BandRender(handler, list, band, band_rows))
+            return 0;
+    }
+    return HAL_GetTick() - start;
+}
+
+void test_band_render(CFBD_GraphicDevice* handler)
+{
+    static uint8_t storage[160];
+    static uint8_t band[CFBDGraphic_BAND_BYTES(BAND_BENCH_MAX_WIDTH, 32)];
+
+    CFBDGraphicSize screen;
+    CFBDGraphic_GetScreenSize(handler, &screen);
+    if (screen.width > BAND_BENCH_MAX_WIDTH)
+        return;
+
+    CFBDGraphic_DisplayList list;
+    CFBDGraphic_DisplayListInit(&list, storage, sizeof(storage));
+    record_band_bench_frame(&list, &screen);
+
+    // 全帧模式的显存占用取自设备画布
+    uint32_t full_ram = 0;
+    CFBDGraphic_Canvas canvas;
+    if (CFBDGraphic_DeviceFetchCanvas(handler, &canvas)) {
+        full_ram = (canvas.format == CFBD_CANVAS_1BPP_PAGE)
+                           ? (uint32_t) canvas.stride * ((canvas.height + 7) / 8)
+                           : (uint32_t) canvas.stride * canvas.height;
+    }
+
+    const uint32_t full_ms = bench_full_frame(handler, &list);
+    const uint32_t band8_ms = bench_banded(handler, &list, band, 8);
+    const uint32_t band32_ms = bench_banded(handler, &list, band, 32);
+
+    char buffer[96];
+    snprintf(buffer,
+             sizeof(buffer),
+             "full %luB %lums "
+             "b8 %luB %lums "
+             "b32 %luB %lums",
+             (unsigned long) full_ram,
+             (unsigned long) (full_ms / BAND_BENCH_FRAMES),
+             (unsigned long) CFBDGraphic_BAND_BYTES(screen.width, 8),
+             (unsigned long) (band8_ms / BAND_BENCH_FRAMES),
+             (unsigned long) CFBDGraphic_BAND_BYTES(screen.width, 32),
+             (unsigned long) (band32_ms / BAND_BENCH_FRAMES));
+
+    CFBDGraphic_Text result;
+    CFBDGraphic_Point p = {0, 0};
+    CFBDGraphic_InitText(&result, p, screen, ASCII_6x8);
+    CFBDGraphic_DeviceClearImmediate(handler);
+    CFBDGraphic_SetText(&result, buffer);
+    CFBDGraphic_DrawText(handler, &result, CCGraphic_AsciiTextItem_RequestOldPoint);
+    handler->ops->update(handler);
+}
+
+#define TEXT_BENCH_ROUNDS (200)
+
+// 文字吞吐: 只测渲染 (延迟刷新模式), 不含总线传输
+void test_text_throughput(CFBD_GraphicDevice* handler)
+{
+    static const char* const lines[] = {"The quick brown", "fox jumps over", "the lazy dog 42"};
+
+    CFBDGraphicSize screen;
+    CFBDGraphic_GetScreenSize(handler, &screen);
+
+    CFBDGraphic_Text text;
+    CFBDGraphic_Point p = {0, 0};
+    CFBDGraphic_InitText(&text, p, screen, ASCII_8x16);
+
+    const CFBD_Bool immediate = CFBDGraphic_DeviceRequestUpdateAtOnce(handler);
+    CFBDGraphic_DeviceSetIfRequestUpdateAtOnce(handler, CFBD_FALSE);
+
+    CFBDGraphic_GlyphCacheStats cache;
+    CFBDGraphic_FetchGlyphCacheStats(&cache, CFBD_TRUE);
+
+    uint32_t glyphs = 0;
+    uint32_t start = HAL_GetTick();
+    for (uint16_t round = 0; round < TEXT_BENCH_ROUNDS; round++) {
+        const char* line = lines[round % (sizeof(lines) / sizeof(lines[0]))];
+        CFBDGraphic_SetText(&text, (char*) line);
+        CFBDGraphic_DrawText(handler, &text, CCGraphic_AsciiTextItem_RequestOldPoint);
+        glyphs += strlen(line);
+    }
+    uint32_t elapsed = HAL_GetTick() - start;
+    CFBDGraphic_FetchGlyphCacheStats(&cache, CFBD_FALSE);
+
+    CFBDGraphic_DeviceSetIfRequestUpdateAtOnce(handler, immediate);
+
+    char buffer[96];
+    snprintf(buffer,
+             sizeof(buffer),
+             "8x16 %s "
+             "%lu glyph/s "
+             "cache %lu/%lu",
+             ENABLE_ASCII_8x16_COMPRESSED ? "rle" : "raw",
+             (unsigned long) (elapsed ? (glyphs * 1000U) / elapsed : 0),
+             (unsigned long) cache.hits,
+             (unsigned long) (cache.hits + cache.misses));
+
+    CFBDGraphic_Text result;
+    CFBDGraphic_InitText(&result, p, screen, ASCII_6x8);
+    CFBDGraphic_DeviceClearImmediate(handler);
+    CFBDGraphic_SetText(&result, buffer);
+    CFBDGraphic_DrawText(handler, &result, CCGraphic_AsciiTextItem_RequestOldPoint);
+    handler->ops->update(handler);
+}
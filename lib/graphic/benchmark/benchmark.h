@@ -1,4 +1,34 @@
 #pragma once
 #include "cfbd_graphic_define.h"
 
-void test_fps(CFBD_GraphicDevice* handler);
\ No newline at end of file
+/**
+ * @brief Measure the refresh rate of a changing text line.
+ *
+ * @details
+ * Redraws an FPS line for 30 s through a frame pacer at 50 fps, then shows
+ * the achieved FPS, the average and the longest frame time (ms) and how
+ * many frame slots were skipped or overrun.
+ */
+void test_fps(CFBD_GraphicDevice* handler);
+
+/**
+ * @brief Compare full frame buffer rendering with band rendering.
+ *
+ * @details
+ * Renders the same display list frame in full buffer mode and with 8 and
+ * 32 row bands, then shows RAM use (bytes) and time per frame (ms) of each
+ * mode on the screen.
+ */
+void test_band_render(CFBD_GraphicDevice* handler);
+
+
+/**
+ * @brief Measure text rendering throughput.
+ *
+ * @details
+ * Draws a few lines of 8x16 text without flushing and shows glyphs per
+ * second together with the glyph cache hit count. Build once with
+ * ENABLE_ASCII_8x16_COMPRESSED set to 0 and once with 1 to compare the plain
+ * and the RLE font.
+ */
+void test_text_throughput(CFBD_GraphicDevice* handler);
@@ -1,10 +1,12 @@
 #include "graphic_device.h"
+#include "memory/memory_graphic_device.h"
 #include "oled/oled_graphic_device.h"
 
 void CFBDGraphic_BindDevice(CFBD_GraphicDevice* device,
                             CFBDGraphic_DeviceType device_type,
                             /*
                              * OLED -> CFBD_OLED*
+                             * MEMORY -> CFBDGraphic_MemoryCanvas*
                              */
                             CFBDGraphicDeviceHandle internal_handle)
 {
@@ -14,6 +16,9 @@ void CFBDGraphic_BindDevice(CFBD_GraphicDevice* device,
         case OLED:
             CFBDGraphic_BindOLEDAsDevice(device, internal_handle);
             return;
+        case MEMORY:
+            CFBDGraphic_BindMemoryAsDevice(device, internal_handle);
+            return;
         default:
             return;
         break;
@@ -0,0 +1,167 @@
+#include "graphic_canvas.h"
+
+#include "graphic_clip.h"
+
+static inline CFBD_Bool source_bit(const uint8_t* source, uint16_t stride, uint16_t x, uint16_t y)
+{
+    return (source[(y >> 3) * stride + x] >> (y & 7)) & 0x01;
+}
+
+/* Combine the masked ink bits into a destination byte, COPY also clears the paper under mask */
+static inline void apply_masked(const CFBDGraphic_Canvas* canvas,
+                                uint8_t* dst,
+                                uint8_t ink,
+                                uint8_t mask)
+{
+    if (canvas->rop == CFBD_ROP_COPY)
+        *dst = (uint8_t) ((*dst & (uint8_t) ~mask) | ink);
+    else
+        CFBDGraphic_CanvasApply(canvas, dst, ink);
+}
+
+/*
+    Page aligned blit: every source byte holds 8 rows of one column, it is
+    shifted once into the (at most two) destination pages it straddles.
+    Clipped rows are masked off, so no per-pixel test is left.
+*/
+static void blit_1bpp(CFBDGraphic_Canvas* canvas,
+                      uint16_t vx,
+                      uint16_t vy,
+                      uint16_t vw,
+                      uint16_t vh,
+                      const uint8_t* source,
+                      uint16_t sx0,
+                      uint16_t sy0,
+                      uint16_t stride)
+{
+    const uint16_t sy1 = sy0 + vh - 1;
+    const int32_t y = (int32_t) vy - sy0; // destination row of source row 0, may be negative
+    const uint8_t shift = y & 7;
+
+    for (uint16_t k = sy0 >> 3; k <= (sy1 >> 3); k++) {
+        uint8_t visible = 0xFF;
+        if (k == (sy0 >> 3))
+            visible &= (uint8_t) (0xFFu << (sy0 & 7));
+        if (k == (sy1 >> 3))
+            visible &= (uint8_t) (0xFFu >> (7 - (sy1 & 7)));
+
+        // the low page may lie above a band when only the high part is visible
+        const int32_t page = (y + k * 8 - canvas->origin_y) >> 3;
+        const uint8_t lo_mask = (uint8_t) (visible << shift);
+        const uint8_t hi_mask = shift ? (uint8_t) (visible >> (8 - shift)) : 0;
+        const uint8_t* src = &source[k * stride + sx0];
+
+        if (lo_mask) {
+            uint8_t* lo = &canvas->buffer[page * canvas->stride + vx];
+            for (uint16_t i = 0; i < vw; i++) {
+                apply_masked(canvas, &lo[i], (uint8_t) (src[i] << shift) & lo_mask, lo_mask);
+            }
+        }
+        if (hi_mask) {
+            uint8_t* hi = &canvas->buffer[(page + 1) * canvas->stride + vx];
+            for (uint16_t i = 0; i < vw; i++) {
+                apply_masked(canvas, &hi[i], (uint8_t) (src[i] >> (8 - shift)) & hi_mask, hi_mask);
+            }
+        }
+    }
+}
+
+static void blit_4bpp(CFBDGraphic_Canvas* canvas,
+                      uint16_t vx,
+                      uint16_t vy,
+                      uint16_t vw,
+                      uint16_t vh,
+                      const uint8_t* source,
+                      uint16_t sx0,
+                      uint16_t sy0,
+                      uint16_t stride)
+{
+    const CFBD_Bool copy = canvas->rop == CFBD_ROP_COPY;
+    for (uint16_t j = 0; j < vh; j++) {
+        const uint16_t dy = vy + j;
+        uint8_t* row = &canvas->buffer[(dy - canvas->origin_y) * canvas->stride];
+        for (uint16_t i = 0; i < vw; i++) {
+            const uint16_t dx = vx + i;
+            if (source_bit(source, stride, sx0 + i, sy0 + j))
+                CFBDGraphic_CanvasPlot4Bpp(canvas, dx, dy);
+            else if (copy)
+                row[dx >> 1] &= (dx & 1) ? 0xF0 : 0x0F;
+        }
+    }
+}
+
+void CFBDGraphic_CanvasBlitWindow(CFBDGraphic_Canvas* canvas,
+                                  uint16_t x,
+                                  uint16_t y,
+                                  const CFBDGraphic_BlitSource* source)
+{
+    uint16_t vx = x, vy = y, vw = source->width, vh = source->height;
+    if (vw == 0 || vh == 0)
+        return;
+    if (!CFBDGraphic_ClipBoundsIntersectArea(&canvas->clip, &vx, &vy, &vw, &vh))
+        return;
+
+    const uint16_t sx0 = source->x + (vx - x);
+    const uint16_t sy0 = source->y + (vy - y);
+    if (canvas->format == CFBD_CANVAS_1BPP_PAGE)
+        blit_1bpp(canvas, vx, vy, vw, vh, source->bitmap, sx0, sy0, source->stride);
+    else
+        blit_4bpp(canvas, vx, vy, vw, vh, source->bitmap, sx0, sy0, source->stride);
+}
+
+void CFBDGraphic_CanvasBlit(CFBDGraphic_Canvas* canvas,
+                            uint16_t x,
+                            uint16_t y,
+                            uint16_t width,
+                            uint16_t height,
+                            const uint8_t* source)
+{
+    const CFBDGraphic_BlitSource whole = {source, width, 0, 0, width, height};
+    CFBDGraphic_CanvasBlitWindow(canvas, x, y, &whole);
+}
+
+/* Devices without a frame buffer: COPY clears the window, ink goes through setPixel */
+static void blit_by_pixels(CFBD_GraphicDevice* device,
+                           const CFBDGraphic_BlitSource* source,
+                           uint16_t vx,
+                           uint16_t vy,
+                           uint16_t vw,
+                           uint16_t vh,
+                           uint16_t sx0,
+                           uint16_t sy0)
+{
+    if (device->rop == CFBD_ROP_COPY)
+        device->ops->clear_area(device, vx, vy, vw, vh);
+    for (uint16_t i = 0; i < vw; i++) {
+        for (uint16_t j = 0; j < vh; j++) {
+            if (source_bit(source->bitmap, source->stride, sx0 + i, sy0 + j))
+                device->ops->setPixel(device, vx + i, vy + j);
+        }
+    }
+}
+
+CFBD_Bool CFBDGraphic_DeviceBlit(CFBD_GraphicDevice* device,
+                                 const CFBDGraphic_BlitSource* source,
+                                 uint16_t x,
+                                 uint16_t y,
+                                 CFBDGraphic_RasterOp rop)
+{
+    CFBDGraphic_ClipBounds visible;
+    if (!CFBDGraphic_FetchClipBounds(device, &visible))
+        return CFBD_FALSE;
+
+    uint16_t vx = x, vy = y, vw = source->width, vh = source->height;
+    if (!CFBDGraphic_ClipBoundsIntersectArea(&visible, &vx, &vy, &vw, &vh))
+        return CFBD_FALSE;
+
+    if (device->ops->blit == NULL || !device->ops->blit(device, source, x, y, rop)) {
+        const CFBDGraphic_RasterOp saved = CFBDGraphic_DeviceGetRasterOp(device);
+        CFBDGraphic_DeviceSetRasterOp(device, rop);
+        blit_by_pixels(device, source, vx, vy, vw, vh, source->x + (vx - x), source->y + (vy - y));
+        CFBDGraphic_DeviceSetRasterOp(device, saved);
+    }
+
+    if (CFBDGraphic_DeviceRequestUpdateAtOnce(device))
+        device->ops->update_area(device, vx, vy, vw, vh);
+    return CFBD_TRUE;
+}
@@ -0,0 +1,314 @@
+/**
+ * @file graphic_canvas.h
+ * @brief Direct frame buffer access (canvas fast path) for graphics primitives.
+ * @ingroup Graphics_Device
+ *
+ * @details
+ * Every call to `ops->setPixel()` costs two indirect calls, a property
+ * fetch and a bounds check inside the backend. For primitives that touch
+ * hundreds of pixels (lines, circles, filled shapes) that overhead dominates
+ * the actual bit twiddling.
+ *
+ * A canvas describes the device's local frame buffer (raw pointer, stride
+ * and pixel format) so that primitives can write pixels themselves through
+ * the small `static inline` writers below. Writers are specialized per
+ * pixel format; callers pick the writer once per primitive and run their
+ * inner loop without any indirect call or per-pixel format switch.
+ *
+ * Devices without a local frame buffer simply do not answer the "canvas"
+ * property, and primitives fall back to `ops->setPixel()`.
+ *
+ * @see CFBDGraphic_DeviceFetchCanvas()
+ */
+
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#include "cfbd_define.h"
+#include "device/graphic_device.h"
+
+/**
+ * @defgroup Graphics_Canvas Canvas Fast Path
+ * @ingroup Graphics_Device
+ * @brief Raw frame buffer descriptors and per-format pixel writers.
+ * @{
+ */
+
+/**
+ * @enum CFBDGraphic_CanvasFormat
+ * @brief Pixel layouts a canvas can describe.
+ */
+typedef enum
+{
+    /** SSD130x page layout: byte `buffer[(y / 8) * stride + x]`, bit `y % 8` */
+    CFBD_CANVAS_1BPP_PAGE,
+    /** SSD132x packed grey scale: byte `buffer[y * stride + x / 2]`, even x high nibble */
+    CFBD_CANVAS_4BPP_PACKED
+} CFBDGraphic_CanvasFormat;
+
+/**
+ * @struct CFBDGraphic_Canvas
+ * @brief Description of a writable pixel buffer.
+ *
+ * @note The writers below do NOT check bounds; use CFBDGraphic_CanvasContains()
+ *       (or clip the primitive against @ref clip beforehand) when coordinates
+ *       may leave the visible region.
+ */
+typedef struct
+{
+    uint8_t* buffer;                 /**< First byte of the pixel buffer */
+    uint16_t stride;                 /**< Bytes per page (1bpp) or per row (4bpp) */
+    uint16_t width;                  /**< Width in pixels */
+    uint16_t height;                 /**< Height in pixels, counted from row 0 */
+    uint16_t origin_y;               /**< Row held by the first buffer row (bands), else 0 */
+    CFBDGraphic_CanvasFormat format; /**< Pixel layout of @ref buffer */
+    uint8_t color;                   /**< Grey level (0-15) used by 4bpp writers */
+    CFBDGraphic_ClipBounds clip;     /**< Writable region: device clip limited to the canvas */
+    CFBDGraphic_RasterOp rop;        /**< Raster op of the device */
+    uint8_t rop_keep;                /**< See CFBDGraphic_RasterOpMasks() */
+    uint8_t rop_flip;                /**< See CFBDGraphic_RasterOpMasks() */
+} CFBDGraphic_Canvas;
+
+/**
+ * @brief Fetch the canvas of a device, if it has one.
+ *
+ * @details
+ * The canvas clip is the device's active clip rectangle limited to the
+ * canvas size, so writers guarded by the helpers below honor the clip stack.
+ *
+ * Band buffers only hold rows `origin_y .. height - 1`; the clip never
+ * reaches above `origin_y`. Devices that do not render in bands leave
+ * `origin_y` untouched, it defaults to 0.
+ *
+ * The device raster op is copied as well, the writers apply it to every
+ * pixel they touch.
+ *
+ * @param device Graphics device.
+ * @param canvas Output canvas description.
+ * @return CFBD_TRUE if the device exposes its frame buffer, CFBD_FALSE if the
+ *         caller must stay on the `ops->setPixel()` path.
+ */
+static inline CFBD_Bool CFBDGraphic_DeviceFetchCanvas(CFBD_GraphicDevice* device,
+                                                      CFBDGraphic_Canvas* canvas)
+{
+    canvas->origin_y = 0;
+    if (!device->ops->self_consult(device, "canvas", NULL, canvas))
+        return CFBD_FALSE;
+
+    CFBDGraphic_DeviceEffectiveClip(device, canvas->width, canvas->height, &canvas->clip);
+    if (canvas->clip.y0 < canvas->origin_y)
+        canvas->clip.y0 = canvas->origin_y;
+    canvas->rop = device->rop;
+    CFBDGraphic_RasterOpMasks(device->rop, &canvas->rop_keep, &canvas->rop_flip);
+    return CFBD_TRUE;
+}
+
+/**
+ * @brief Use @p rop instead of the device raster op for the writes to @p canvas.
+ */
+static inline void CFBDGraphic_CanvasSetRasterOp(CFBDGraphic_Canvas* canvas,
+                                                 CFBDGraphic_RasterOp rop)
+{
+    canvas->rop = rop;
+    CFBDGraphic_RasterOpMasks(rop, &canvas->rop_keep, &canvas->rop_flip);
+}
+
+/**
+ * @brief Check whether a (possibly negative) coordinate lies inside the canvas clip.
+ */
+static inline CFBD_Bool CFBDGraphic_CanvasContains(const CFBDGraphic_Canvas* canvas,
+                                                   int32_t x,
+                                                   int32_t y)
+{
+    return x >= canvas->clip.x0 && x <= canvas->clip.x1 && y >= canvas->clip.y0 &&
+           y <= canvas->clip.y1;
+}
+
+/**
+ * @brief Clip the inclusive vertical span [y0, y1] at column x to the canvas clip.
+ * @return CFBD_FALSE if nothing of the span is left to draw.
+ */
+static inline CFBD_Bool
+CFBDGraphic_CanvasClipVSpan(const CFBDGraphic_Canvas* canvas, int32_t x, int32_t* y0, int32_t* y1)
+{
+    if (x < canvas->clip.x0 || x > canvas->clip.x1)
+        return CFBD_FALSE;
+    if (*y0 < canvas->clip.y0)
+        *y0 = canvas->clip.y0;
+    if (*y1 > canvas->clip.y1)
+        *y1 = canvas->clip.y1;
+    return *y0 <= *y1;
+}
+
+/**
+ * @brief Clip the inclusive horizontal span [x0, x1] on row y to the canvas clip.
+ * @return CFBD_FALSE if nothing of the span is left to draw.
+ */
+static inline CFBD_Bool
+CFBDGraphic_CanvasClipHSpan(const CFBDGraphic_Canvas* canvas, int32_t* x0, int32_t* x1, int32_t y)
+{
+    if (y < canvas->clip.y0 || y > canvas->clip.y1)
+        return CFBD_FALSE;
+    if (*x0 < canvas->clip.x0)
+        *x0 = canvas->clip.x0;
+    if (*x1 > canvas->clip.x1)
+        *x1 = canvas->clip.x1;
+    return *x0 <= *x1;
+}
+
+/**
+ * @brief Apply the canvas raster op to the bits of @p mask in @p dst.
+ */
+static inline void CFBDGraphic_CanvasApply(const CFBDGraphic_Canvas* canvas,
+                                           uint8_t* dst,
+                                           uint8_t mask)
+{
+    *dst = (uint8_t) ((*dst & (uint8_t) (~mask | canvas->rop_keep)) ^ (mask & canvas->rop_flip));
+}
+
+/* ---------- 1bpp page layout (origin_y is a multiple of 8) ---------- */
+
+static inline void CFBDGraphic_CanvasPlot1Bpp(CFBDGraphic_Canvas* canvas, int32_t x, int32_t y)
+{
+    CFBDGraphic_CanvasApply(canvas,
+                            &canvas->buffer[((y - canvas->origin_y) >> 3) * canvas->stride + x],
+                            (uint8_t) (1u << (y & 7)));
+}
+
+/**
+ * @brief Set the inclusive vertical span [y0, y1] at column x, one mask per page.
+ */
+static inline void
+CFBDGraphic_CanvasVSpan1Bpp(CFBDGraphic_Canvas* canvas, int32_t x, int32_t y0, int32_t y1)
+{
+    int32_t page = (y0 - canvas->origin_y) >> 3;
+    const int32_t last_page = (y1 - canvas->origin_y) >> 3;
+    uint8_t* dst = &canvas->buffer[page * canvas->stride + x];
+    uint8_t mask = (uint8_t) (0xFFu << (y0 & 7));
+
+    while (page < last_page) {
+        CFBDGraphic_CanvasApply(canvas, dst, mask);
+        dst += canvas->stride;
+        mask = 0xFF;
+        page++;
+    }
+    CFBDGraphic_CanvasApply(canvas, dst, mask & (uint8_t) (0xFFu >> (7 - (y1 & 7))));
+}
+
+/**
+ * @brief Set the inclusive horizontal span [x0, x1] on row y.
+ */
+static inline void
+CFBDGraphic_CanvasHSpan1Bpp(CFBDGraphic_Canvas* canvas, int32_t x0, int32_t x1, int32_t y)
+{
+    uint8_t* dst = &canvas->buffer[((y - canvas->origin_y) >> 3) * canvas->stride + x0];
+    const uint8_t bit = (uint8_t) (1u << (y & 7));
+    for (int32_t x = x0; x <= x1; x++) {
+        CFBDGraphic_CanvasApply(canvas, dst++, bit);
+    }
+}
+
+/* ---------- 4bpp packed layout ---------- */
+
+static inline void CFBDGraphic_CanvasPlot4Bpp(CFBDGraphic_Canvas* canvas, int32_t x, int32_t y)
+{
+    uint8_t* dst = &canvas->buffer[(y - canvas->origin_y) * canvas->stride + (x >> 1)];
+    const uint8_t mask = (x & 1) ? 0x0F : 0xF0;
+    const uint8_t value = (x & 1) ? canvas->color : (uint8_t) (canvas->color << 4);
+    *dst = (uint8_t) ((*dst & (uint8_t) (~mask | canvas->rop_keep)) ^ (value & canvas->rop_flip));
+}
+
+static inline void
+CFBDGraphic_CanvasVSpan4Bpp(CFBDGraphic_Canvas* canvas, int32_t x, int32_t y0, int32_t y1)
+{
+    uint8_t* dst = &canvas->buffer[(y0 - canvas->origin_y) * canvas->stride + (x >> 1)];
+    const uint8_t keep = (uint8_t) (((x & 1) ? 0xF0 : 0x0F) | canvas->rop_keep);
+    const uint8_t ink = (x & 1) ? canvas->color : (uint8_t) (canvas->color << 4);
+    const uint8_t value = ink & canvas->rop_flip;
+    for (int32_t y = y0; y <= y1; y++) {
+        *dst = (uint8_t) ((*dst & keep) ^ value);
+        dst += canvas->stride;
+    }
+}
+
+static inline void
+CFBDGraphic_CanvasHSpan4Bpp(CFBDGraphic_Canvas* canvas, int32_t x0, int32_t x1, int32_t y)
+{
+    for (int32_t x = x0; x <= x1; x++) {
+        CFBDGraphic_CanvasPlot4Bpp(canvas, x, y);
+    }
+}
+
+/* ---------- blit ---------- */
+
+/**
+ * @brief Blit 1bpp page-layout pixels (the setArea() layout) onto the canvas.
+ *
+ * @details
+ * The area is clipped against the canvas clip. Set source bits are ink and
+ * go through the raster op; clear bits are paper and are only written by
+ * CFBD_ROP_COPY. 4bpp canvases draw ink with the canvas grey level.
+ *
+ * @param canvas Target canvas.
+ * @param x X coordinate of the area's top-left corner.
+ * @param y Y coordinate of the area's top-left corner.
+ * @param width Width of the area in pixels, also the source page stride.
+ * @param height Height of the area in pixels.
+ * @param source Source pixels.
+ */
+void CFBDGraphic_CanvasBlit(CFBDGraphic_Canvas* canvas,
+                            uint16_t x,
+                            uint16_t y,
+                            uint16_t width,
+                            uint16_t height,
+                            const uint8_t* source);
+
+/**
+ * @brief Blit a window of a larger bitmap onto the canvas.
+ *
+ * @details
+ * Same rules as CFBDGraphic_CanvasBlit(), the window's top-left pixel lands
+ * on (@p x, @p y). Source bytes are shifted straight into the destination
+ * pages, whatever the window offset.
+ *
+ * @param canvas Target canvas.
+ * @param x X coordinate of the destination.
+ * @param y Y coordinate of the destination.
+ * @param source Bitmap window to copy.
+ */
+void CFBDGraphic_CanvasBlitWindow(CFBDGraphic_Canvas* canvas,
+                                  uint16_t x,
+                                  uint16_t y,
+                                  const CFBDGraphic_BlitSource* source);
+
+/**
+ * @brief Blit a bitmap window onto a device, flushing at most once.
+ *
+ * @details
+ * Uses `ops->blit` when the device has one, else pixel writes through
+ * `setPixel()` (COPY clears the window first). In immediate mode the
+ * visible part of the destination is flushed with a single
+ * update_area(). The device raster op is left untouched.
+ *
+ * @param device Target device.
+ * @param source Bitmap window to copy.
+ * @param x X coordinate of the destination.
+ * @param y Y coordinate of the destination.
+ * @param rop How the window combines with the device pixels.
+ * @return CFBD_FALSE if nothing of the window is visible.
+ *
+ * @example
+ * @code
+ * // draw the right half of a 48x48 icon at the left screen edge
+ * CFBDGraphic_BlitSource half = {icon, 48, 24, 0, 24, 48};
+ * CFBDGraphic_DeviceBlit(device, &half, 0, 8, CFBD_ROP_COPY);
+ * @endcode
+ */
+CFBD_Bool CFBDGraphic_DeviceBlit(CFBD_GraphicDevice* device,
+                                 const CFBDGraphic_BlitSource* source,
+                                 uint16_t x,
+                                 uint16_t y,
+                                 CFBDGraphic_RasterOp rop);
+
+/** @} */ // end of Graphics_Canvas group
@@ -0,0 +1,106 @@
+#include "graphic_clip.h"
+
+#include <stddef.h>
+
+#include "base/size.h"
+
+static void rect_as_bounds(const CFBDGraphicRect* rect, CFBDGraphic_ClipBounds* bounds)
+{
+    CFBDGraphicRect n = rect_normalize(*rect);
+    bounds->x0 = n.tl.x;
+    bounds->y0 = n.tl.y;
+    bounds->x1 = n.br.x;
+    bounds->y1 = n.br.y;
+}
+
+static void intersect_bounds(CFBDGraphic_ClipBounds* dst, const CFBDGraphic_ClipBounds* with)
+{
+    if (with->x0 > dst->x0)
+        dst->x0 = with->x0;
+    if (with->y0 > dst->y0)
+        dst->y0 = with->y0;
+    if (with->x1 < dst->x1)
+        dst->x1 = with->x1;
+    if (with->y1 < dst->y1)
+        dst->y1 = with->y1;
+}
+
+void CFBDGraphic_ResetClip(CFBD_GraphicDevice* device)
+{
+    device->clip.depth = 0;
+}
+
+CFBD_Bool CFBDGraphic_PushClip(CFBD_GraphicDevice* device, const CFBDGraphicRect* rect)
+{
+    if (device == NULL || rect == NULL)
+        return CFBD_FALSE;
+    if (device->clip.depth >= CFBD_GRAPHIC_CLIP_STACK_DEPTH)
+        return CFBD_FALSE;
+
+    CFBDGraphic_ClipBounds* entry = &device->clip.bounds[device->clip.depth];
+    rect_as_bounds(rect, entry);
+    if (device->clip.depth != 0)
+        intersect_bounds(entry, &device->clip.bounds[device->clip.depth - 1]);
+
+    device->clip.depth++;
+    return CFBD_TRUE;
+}
+
+void CFBDGraphic_PopClip(CFBD_GraphicDevice* device)
+{
+    if (device != NULL && device->clip.depth != 0)
+        device->clip.depth--;
+}
+
+void CFBDGraphic_IntersectClip(CFBD_GraphicDevice* device, const CFBDGraphicRect* rect)
+{
+    if (device == NULL || rect == NULL)
+        return;
+    if (device->clip.depth == 0) {
+        CFBDGraphic_PushClip(device, rect);
+        return;
+    }
+
+    CFBDGraphic_ClipBounds with;
+    rect_as_bounds(rect, &with);
+    intersect_bounds(&device->clip.bounds[device->clip.depth - 1], &with);
+}
+
+CFBD_Bool CFBDGraphic_FetchClipBounds(CFBD_GraphicDevice* device, CFBDGraphic_ClipBounds* bounds)
+{
+    CFBDGraphicSize screen;
+    CFBDGraphic_GetScreenSize(device, &screen);
+    return CFBDGraphic_DeviceEffectiveClip(device, screen.width, screen.height, bounds);
+}
+
+CFBD_Bool CFBDGraphic_ClipBoundsIntersectArea(const CFBDGraphic_ClipBounds* bounds,
+                                              uint16_t* x,
+                                              uint16_t* y,
+                                              uint16_t* width,
+                                              uint16_t* height)
+{
+    if (*width == 0 || *height == 0)
+        return CFBD_FALSE;
+
+    int32_t lx = *x;
+    int32_t ty = *y;
+    int32_t rx = lx + *width - 1;
+    int32_t by = ty + *height - 1;
+
+    if (lx < bounds->x0)
+        lx = bounds->x0;
+    if (ty < bounds->y0)
+        ty = bounds->y0;
+    if (rx > bounds->x1)
+        rx = bounds->x1;
+    if (by > bounds->y1)
+        by = bounds->y1;
+    if (rx < lx || by < ty)
+        return CFBD_FALSE;
+
+    *x = (uint16_t) lx;
+    *y = (uint16_t) ty;
+    *width = (uint16_t) (rx - lx + 1);
+    *height = (uint16_t) (by - ty + 1);
+    return CFBD_TRUE;
+}
@@ -0,0 +1,118 @@
+/**
+ * @file graphic_clip.h
+ * @brief Clip rectangle stack of a graphics device.
+ * @ingroup Graphics_Device
+ *
+ * @details
+ * Widgets that draw inside a viewport (menus, scrolling lists) push the
+ * viewport as clip rectangle, draw freely and pop it again. Primitives clip
+ * once per segment or span against the active clip, the OLED device adapter
+ * drops pixels and areas outside of it for everything else.
+ *
+ * Clip rectangles use inclusive corners, just like rect_clip_line() and
+ * rect_intersects(): `{{0, 0}, {127, 63}}` covers a whole 128x64 panel.
+ *
+ * @example
+ * @code
+ * CFBDGraphicRect viewport = {{0, 16}, {127, 47}};
+ * if (CFBDGraphic_PushClip(device, &viewport)) {
+ *     draw_list_rows(device);  // rows partially outside get cut at the edges
+ *     CFBDGraphic_PopClip(device);
+ * }
+ * @endcode
+ */
+
+#pragma once
+#include "base/rectangle.h"
+#include "cfbd_define.h"
+#include "device/graphic_device.h"
+
+/**
+ * @defgroup Graphics_Clip Clip Stack
+ * @ingroup Graphics_Device
+ * @brief Push / pop / intersect clip rectangles on a device.
+ * @{
+ */
+
+/**
+ * @brief Drop every clip rectangle, the whole device becomes visible again.
+ */
+void CFBDGraphic_ResetClip(CFBD_GraphicDevice* device);
+
+/**
+ * @brief Push a clip rectangle, intersected with the currently active one.
+ *
+ * @param device Graphics device.
+ * @param rect Clip rectangle with inclusive corners (any corner order).
+ * @return CFBD_FALSE if the stack is full (CFBD_GRAPHIC_CLIP_STACK_DEPTH);
+ *         nothing is pushed and the caller must not pop.
+ */
+CFBD_Bool CFBDGraphic_PushClip(CFBD_GraphicDevice* device, const CFBDGraphicRect* rect);
+
+/**
+ * @brief Restore the clip that was active before the last successful push.
+ */
+void CFBDGraphic_PopClip(CFBD_GraphicDevice* device);
+
+/**
+ * @brief Narrow the active clip in place without pushing a new entry.
+ *
+ * @details
+ * With an empty stack the rectangle becomes the first entry.
+ */
+void CFBDGraphic_IntersectClip(CFBD_GraphicDevice* device, const CFBDGraphicRect* rect);
+
+/**
+ * @brief Fetch the visible region of the device (active clip limited to the screen).
+ *
+ * @param device Graphics device.
+ * @param bounds Output inclusive bounds.
+ * @return CFBD_FALSE if nothing is visible.
+ */
+CFBD_Bool CFBDGraphic_FetchClipBounds(CFBD_GraphicDevice* device, CFBDGraphic_ClipBounds* bounds);
+
+/**
+ * @brief Check whether clip bounds leave nothing visible.
+ */
+static inline CFBD_Bool CFBDGraphic_ClipBoundsIsEmpty(const CFBDGraphic_ClipBounds* bounds)
+{
+    return bounds->x0 > bounds->x1 || bounds->y0 > bounds->y1;
+}
+
+/**
+ * @brief Convert inclusive clip bounds into a rectangle usable by rect_clip_line().
+ */
+static inline CFBDGraphicRect CFBDGraphic_ClipBoundsAsRect(const CFBDGraphic_ClipBounds* bounds)
+{
+    CFBDGraphicRect r = {{bounds->x0, bounds->y0}, {bounds->x1, bounds->y1}};
+    return r;
+}
+
+/**
+ * @brief Check whether the inclusive box [lx, rx] x [ty, by] is fully visible.
+ *
+ * @details
+ * Primitives use this once to decide if their inner loop may skip the
+ * per-pixel clip test.
+ */
+static inline CFBD_Bool CFBDGraphic_ClipBoundsContainsBox(const CFBDGraphic_ClipBounds* bounds,
+                                                          int32_t lx,
+                                                          int32_t ty,
+                                                          int32_t rx,
+                                                          int32_t by)
+{
+    return lx >= bounds->x0 && rx <= bounds->x1 && ty >= bounds->y0 && by <= bounds->y1;
+}
+
+/**
+ * @brief Limit an area to the clip bounds.
+ *
+ * @return CFBD_FALSE if nothing of the area is visible; the outputs are then undefined.
+ */
+CFBD_Bool CFBDGraphic_ClipBoundsIntersectArea(const CFBDGraphic_ClipBounds* bounds,
+                                              uint16_t* x,
+                                              uint16_t* y,
+                                              uint16_t* width,
+                                              uint16_t* height);
+
+/** @} */ // end of Graphics_Clip group
@@ -167,6 +167,41 @@ typedef CFBD_Bool (*GraphicOLED_PropertySetsOperation)(CFBD_GraphicDevice* devic
                                                        void* args,
                                                        void* request_data);
 
+/**
+ * @enum CFBDGraphic_RasterOp
+ * @brief How drawn pixels combine with the pixels already on the device.
+ *
+ * @details
+ * Primitives only produce ink pixels, for them COPY and SET are the same.
+ * Blits (`setArea()`) also carry paper (0) pixels, which only COPY writes.
+ */
+typedef enum
+{
+    CFBD_ROP_COPY,  /**< Ink sets, blit paper clears: the historical behavior (default) */
+    CFBD_ROP_SET,   /**< Ink sets, everything else is kept (transparent blits) */
+    CFBD_ROP_CLEAR, /**< Ink clears the pixel */
+    CFBD_ROP_XOR    /**< Ink toggles the pixel, drawing the same shape twice restores it */
+} CFBDGraphic_RasterOp;
+
+/**
+ * @struct CFBDGraphic_BlitSource
+ * @brief Window of a 1bpp page-layout bitmap (the setArea() layout).
+ *
+ * @details
+ * Only the @ref width x @ref height pixels at (@ref x, @ref y) of the
+ * bitmap are copied, so a partly visible image needs no repacking. The
+ * window must lie inside the bitmap.
+ */
+typedef struct
+{
+    const uint8_t* bitmap; /**< Source pixels, page layout */
+    uint16_t stride;       /**< Bitmap width in pixels, bytes per page */
+    uint16_t x;            /**< Left column of the window */
+    uint16_t y;            /**< Top row of the window */
+    uint16_t width;        /**< Window width in pixels */
+    uint16_t height;       /**< Window height in pixels */
+} CFBDGraphic_BlitSource;
+
 /**
  * @struct CFBD_GraphicDeviceOperation
  * @brief Virtual operation table for graphics device functionality.
@@ -286,6 +321,40 @@ typedef struct
      */
     GraphicAreaOperations revert_area;
 
+    /**
+     * @brief Write 1bpp page-layout pixels straight to the display.
+     *
+     * @details
+     * Bypasses (and leaves untouched) the local frame buffer. Used by the
+     * band renderer on devices that cannot afford a full frame buffer.
+     * @p source uses the setArea() layout; @p y and @p height must be
+     * multiples of 8. Optional, may be NULL.
+     */
+    CFBD_Bool (*stream_area)(CFBD_GraphicDevice* device,
+                             uint16_t x,
+                             uint16_t y,
+                             uint16_t width,
+                             uint16_t height,
+                             const uint8_t* source);
+
+    /**
+     * @brief Copy a bitmap window into the local frame buffer.
+     *
+     * @details
+     * Places the window described by @p source with its top-left pixel at
+     * (@p x, @p y) and combines it with @p rop. Source bytes are shifted
+     * into the destination pages on the fly, no intermediate buffer is
+     * used. The clip stack is honored and nothing is flushed. Returns
+     * CFBD_FALSE when the device has no frame buffer to blit into.
+     * Optional, may be NULL; use CFBDGraphic_DeviceBlit() which falls
+     * back to pixel writes.
+     */
+    CFBD_Bool (*blit)(CFBD_GraphicDevice* device,
+                      const CFBDGraphic_BlitSource* source,
+                      uint16_t x,
+                      uint16_t y,
+                      CFBDGraphic_RasterOp rop);
+
     /**
      * @brief Open/enable the graphics device.
      *
@@ -310,12 +379,20 @@ typedef struct
      * - "width" (uint16_t): Display width in pixels
      * - "height" (uint16_t): Display height in pixels
      * - "rgb" (CFBD_Bool): RGB color support indicator
+     * - "canvas" (CFBDGraphic_Canvas): Local frame buffer for direct writes,
+     *   optional (see graphic_canvas.h)
      */
     GraphicOLED_QueryOperation self_consult;
 
     /**
      * @brief Set the properties for devices supports
      *  - "color": if the devices supports color, thats it :)
+     *  - "transform" (CFBDGraphic_Transform): let the controller mirror or
+     *    turn the panel, see graphic_transform.h
+     *  - "scroll" (CFBDGraphic_HardwareScroll): continuous hardware scroll,
+     *    see graphic_scroll.h
+     *  - "contrast" (uint8_t): panel brightness, also queried through
+     *    self_consult; used by the fade transition
      */
     GraphicOLED_PropertySetsOperation self_sets;
 } CFBD_GraphicDeviceOperation;
@@ -331,7 +408,8 @@ typedef struct
  */
 typedef enum
 {
-    OLED /**< OLED display device */
+    OLED,  /**< OLED display device */
+    MEMORY /**< Offscreen memory canvas, see memory_graphic_device.h */
 } CFBDGraphic_DeviceType;
 
 /**
@@ -340,6 +418,45 @@ typedef enum
  */
 typedef void* CFBDGraphicDeviceHandle;
 
+/**
+ * @def CFBD_GRAPHIC_CLIP_STACK_DEPTH
+ * @brief Maximum number of nested clip rectangles a device can hold.
+ */
+#ifndef CFBD_GRAPHIC_CLIP_STACK_DEPTH
+#define CFBD_GRAPHIC_CLIP_STACK_DEPTH (4)
+#endif
+
+/**
+ * @struct CFBDGraphic_ClipBounds
+ * @brief Inclusive pixel bounds of a clip rectangle.
+ *
+ * @details
+ * Both corners are part of the region. The region is empty when
+ * `x0 > x1` or `y0 > y1`.
+ */
+typedef struct
+{
+    uint16_t x0; /**< Left-most visible column */
+    uint16_t y0; /**< Top-most visible row */
+    uint16_t x1; /**< Right-most visible column */
+    uint16_t y1; /**< Bottom-most visible row */
+} CFBDGraphic_ClipBounds;
+
+/**
+ * @struct CFBDGraphic_ClipStack
+ * @brief Stack of clip rectangles, the top entry is the active clip.
+ *
+ * @details
+ * Every pushed entry is already intersected with the entry below it, so
+ * the top alone describes the visible region. An empty stack means the
+ * whole device is visible. Manipulate it through graphic_clip.h.
+ */
+typedef struct
+{
+    CFBDGraphic_ClipBounds bounds[CFBD_GRAPHIC_CLIP_STACK_DEPTH]; /**< Pushed clip entries */
+    uint8_t depth;                                                /**< Number of valid entries */
+} CFBDGraphic_ClipStack;
+
 /**
  * @struct CFBD_GraphicDevice
  * @brief The main graphics device object.
@@ -402,6 +519,38 @@ typedef struct _CFBD_GraphicDevice
      * visual updates.
      */
     CFBD_Bool immediate_draw;
+
+    /**
+     * @brief Active clip rectangles.
+     *
+     * @details
+     * Pixels outside the top entry are never written, whatever primitive
+     * draws them. Reset by the bind functions, driven by graphic_clip.h.
+     */
+    CFBDGraphic_ClipStack clip;
+
+    /**
+     * @brief Raster operation applied by every primitive and blit.
+     *
+     * @details
+     * Honored inside the pixel writers, so an XOR cursor or an overlay is a
+     * single pass. Bind functions reset it to CFBD_ROP_COPY.
+     *
+     * @note Every primitive writes each pixel it covers once, shared corners
+     *       and octant seams included, so drawing a shape twice with
+     *       CFBD_ROP_XOR restores what was underneath.
+     */
+    CFBDGraphic_RasterOp rop;
+
+    /**
+     * @brief Clear the bounding box of outline and filled shapes before drawing.
+     *
+     * @details
+     * CFBD_TRUE (the bind default) keeps the historical look where a shape
+     * wipes what was underneath. Turn it off to draw over existing content,
+     * which also saves the clear pass.
+     */
+    CFBD_Bool clear_before_draw;
 } CFBD_GraphicDevice;
 
 /**
@@ -459,6 +608,166 @@ static inline void CFBDGraphic_DeviceSetIfRequestUpdateAtOnce(CFBD_GraphicDevice
     device->immediate_draw = requests;
 }
 
+/**
+ * @brief Select the raster operation used by subsequent drawing.
+ *
+ * @example
+ * @code
+ * // toggle a cursor: draw once to show it, draw again to hide it
+ * CFBDGraphic_DeviceSetRasterOp(&device, CFBD_ROP_XOR);
+ * CFBDGraphic_DeviceSetClearBeforeDraw(&device, CFBD_FALSE);
+ * CFBDGraphic_FillRect(&device, &cursor);
+ * @endcode
+ */
+static inline void CFBDGraphic_DeviceSetRasterOp(CFBD_GraphicDevice* device,
+                                                 CFBDGraphic_RasterOp rop)
+{
+    device->rop = rop;
+}
+
+/**
+ * @brief Raster operation currently used by drawing.
+ *
+ * @see CFBDGraphic_DeviceSetRasterOp() to change it
+ */
+static inline CFBDGraphic_RasterOp CFBDGraphic_DeviceGetRasterOp(const CFBD_GraphicDevice* device)
+{
+    return device->rop;
+}
+
+/**
+ * @brief Enable or disable the bounding box clear of shapes.
+ */
+static inline void CFBDGraphic_DeviceSetClearBeforeDraw(CFBD_GraphicDevice* device,
+                                                        CFBD_Bool clear)
+{
+    device->clear_before_draw = clear;
+}
+
+/**
+ * @brief Whether shapes clear their bounding box before drawing.
+ *
+ * @see CFBDGraphic_DeviceSetClearBeforeDraw() to change it
+ */
+static inline CFBD_Bool CFBDGraphic_DeviceGetClearBeforeDraw(const CFBD_GraphicDevice* device)
+{
+    return device->clear_before_draw;
+}
+
+/**
+ * @brief Restore the default drawing state: CFBD_ROP_COPY, clear before draw.
+ */
+static inline void CFBDGraphic_DeviceResetDrawState(CFBD_GraphicDevice* device)
+{
+    device->rop = CFBD_ROP_COPY;
+    device->clear_before_draw = CFBD_TRUE;
+}
+
+/**
+ * @brief Clear the bounding box of a shape about to be drawn, if the device asks for it.
+ *
+ * @details
+ * The box may reach past the top-left corner of the device; only its
+ * on-screen part is cleared.
+ *
+ * @param device Pointer to the CFBD_GraphicDevice instance.
+ * @param lx, ty, rx, by Inclusive box corners.
+ */
+static inline void CFBDGraphic_DeviceClearBeforeDraw(CFBD_GraphicDevice* device,
+                                                     int32_t lx,
+                                                     int32_t ty,
+                                                     int32_t rx,
+                                                     int32_t by)
+{
+    if (!device->clear_before_draw)
+        return;
+    if (lx < 0)
+        lx = 0;
+    if (ty < 0)
+        ty = 0;
+    if (rx < lx || by < ty || lx > 0xFFFF || ty > 0xFFFF)
+        return;
+
+    const int32_t w = rx - lx + 1, h = by - ty + 1;
+    device->ops->clear_area(device,
+                            (uint16_t) lx,
+                            (uint16_t) ty,
+                            (uint16_t) (w > 0xFFFF ? 0xFFFF : w),
+                            (uint16_t) (h > 0xFFFF ? 0xFFFF : h));
+}
+
+/**
+ * @brief Byte masks implementing a raster op on a masked group of 1bpp bits
+ *        or a 4bpp nibble: `dst = (dst & (~mask | keep)) ^ (ink & flip)`.
+ *
+ * @param rop Raster operation.
+ * @param keep Output: 0xFF if the old pixel takes part (XOR), else 0x00.
+ * @param flip Output: 0xFF if ink is written (COPY, SET, XOR), else 0x00.
+ */
+static inline void
+CFBDGraphic_RasterOpMasks(CFBDGraphic_RasterOp rop, uint8_t* keep, uint8_t* flip)
+{
+    *keep = (rop == CFBD_ROP_XOR) ? 0xFF : 0x00;
+    *flip = (rop == CFBD_ROP_CLEAR) ? 0x00 : 0xFF;
+}
+
+/**
+ * @brief Check whether a pixel lies inside the device's active clip.
+ *
+ * @param device Pointer to the CFBD_GraphicDevice instance.
+ * @param x X coordinate of the pixel.
+ * @param y Y coordinate of the pixel.
+ * @return CFBD_Bool CFBD_TRUE if the pixel may be written.
+ */
+static inline CFBD_Bool
+CFBDGraphic_DeviceClipContains(const CFBD_GraphicDevice* device, uint16_t x, uint16_t y)
+{
+    if (device->clip.depth == 0)
+        return CFBD_TRUE;
+
+    const CFBDGraphic_ClipBounds* top = &device->clip.bounds[device->clip.depth - 1];
+    return x >= top->x0 && x <= top->x1 && y >= top->y0 && y <= top->y1;
+}
+
+/**
+ * @brief Compute the visible bounds of a device: the active clip limited
+ *        to a width x height surface.
+ *
+ * @param device Pointer to the CFBD_GraphicDevice instance.
+ * @param width Surface width in pixels.
+ * @param height Surface height in pixels.
+ * @param bounds Output inclusive bounds, possibly empty.
+ * @return CFBD_Bool CFBD_FALSE if nothing is visible.
+ */
+static inline CFBD_Bool CFBDGraphic_DeviceEffectiveClip(const CFBD_GraphicDevice* device,
+                                                        uint16_t width,
+                                                        uint16_t height,
+                                                        CFBDGraphic_ClipBounds* bounds)
+{
+    bounds->x0 = 0;
+    bounds->y0 = 0;
+    bounds->x1 = width ? width - 1 : 0;
+    bounds->y1 = height ? height - 1 : 0;
+    if (width == 0 || height == 0) {
+        bounds->x0 = 1;
+        return CFBD_FALSE;
+    }
+
+    if (device->clip.depth != 0) {
+        const CFBDGraphic_ClipBounds* top = &device->clip.bounds[device->clip.depth - 1];
+        if (top->x0 > bounds->x0)
+            bounds->x0 = top->x0;
+        if (top->y0 > bounds->y0)
+            bounds->y0 = top->y0;
+        if (top->x1 < bounds->x1)
+            bounds->x1 = top->x1;
+        if (top->y1 < bounds->y1)
+            bounds->y1 = top->y1;
+    }
+
+    return bounds->x0 <= bounds->x1 && bounds->y0 <= bounds->y1;
+}
+
 /**
  * @brief Convenience function to clear and immediately update the display.
  *
@@ -499,6 +808,7 @@ static inline void CFBDGraphic_DeviceClearImmediate(CFBD_GraphicDevice* device)
  * @param device_type The type of graphics hardware (e.g., OLED).
  * @param internal_handle Device-specific handle or state pointer.
  *                        For OLED devices: pass pointer to CFBD_OLED*.
+ *                        For MEMORY devices: pass pointer to CFBDGraphic_MemoryCanvas*.
  *
  * @note The internal_handle must remain valid for the device lifetime.
  *
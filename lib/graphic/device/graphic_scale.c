@@ -0,0 +1,148 @@
+#include "graphic_scale.h"
+
+#include "device/graphic_canvas.h"
+#include "device/graphic_clip.h"
+
+/* Destination columns produced per blit, one page row high */
+#define CFBD_SCALE_CHUNK (32)
+
+/* Bit n of the index doubled into bits 2n and 2n + 1 */
+static const uint8_t double_bits[16] = {0x00, 0x03, 0x0C, 0x0F, 0x30, 0x33, 0x3C, 0x3F,
+                                        0xC0, 0xC3, 0xCC, 0xCF, 0xF0, 0xF3, 0xFC, 0xFF};
+
+/* Bit n of the index repeated into bits 4n .. 4n + 3 */
+static const uint8_t quadruple_bits[4] = {0x00, 0x0F, 0xF0, 0xFF};
+
+typedef struct
+{
+    const CFBDGraphic_BlitSource* source;
+    uint16_t width;   // scaled size
+    uint16_t height;
+    uint32_t step_x;  // source pixels per destination pixel, 16.16
+    uint32_t step_y;
+    uint8_t factor;   // 2 or 4 on the lookup table path, else 0
+} ScaleJob;
+
+/* Rows 8 * page .. 8 * page + 7 of window column @p column */
+static uint8_t window_byte(const CFBDGraphic_BlitSource* source, uint16_t column, uint16_t page)
+{
+    const uint16_t top = source->y + page * 8;
+    const uint8_t shift = top & 7;
+    const uint8_t* bytes = source->bitmap + (top >> 3) * source->stride + source->x + column;
+
+    uint8_t value = bytes[0] >> shift;
+    if (shift && page * 8 + 8 - shift < source->height)
+        value |= (uint8_t) (bytes[source->stride] << (8 - shift));
+    return value;
+}
+
+/* Lookup table path: one source byte feeds @p factor pages and @p factor columns */
+static void expand_chunk(const ScaleJob* job,
+                         uint16_t page,
+                         uint16_t left,
+                         uint16_t columns,
+                         uint8_t* chunk)
+{
+    const uint8_t factor = job->factor;
+    const uint8_t part = page % factor;
+    uint16_t i = 0;
+    while (i < columns) {
+        const uint16_t u = left + i;
+        const uint8_t b = window_byte(job->source, u / factor, page / factor);
+        const uint8_t value = (factor == 2) ? double_bits[(b >> (part * 4)) & 0x0F]
+                                            : quadruple_bits[(b >> (part * 2)) & 0x03];
+        // 同一源列在目标中重复 factor 次
+        for (uint16_t k = u % factor; k < factor && i < columns; k++)
+            chunk[i++] = value;
+    }
+}
+
+/* Generic path: nearest source pixel at the center of every destination pixel */
+static void sample_chunk(const ScaleJob* job,
+                         uint16_t page,
+                         uint16_t left,
+                         uint16_t columns,
+                         uint8_t* chunk)
+{
+    const CFBDGraphic_BlitSource* source = job->source;
+    uint16_t row_offset[8];
+    uint8_t row_shift[8];
+    uint8_t rows = 0;
+
+    // 每页只计算一次 8 行对应的源行
+    for (; rows < 8 && page * 8 + rows < job->height; rows++) {
+        const uint32_t v = page * 8 + rows;
+        const uint16_t sy = source->y + (uint16_t) ((v * job->step_y + job->step_y / 2) >> 16);
+        row_offset[rows] = (sy >> 3) * source->stride;
+        row_shift[rows] = sy & 7;
+    }
+
+    uint32_t fx = left * job->step_x + job->step_x / 2;
+    for (uint16_t i = 0; i < columns; i++, fx += job->step_x) {
+        const uint8_t* column = source->bitmap + source->x + (fx >> 16);
+        uint8_t value = 0;
+        for (uint8_t j = 0; j < rows; j++)
+            value |= (uint8_t) (((column[row_offset[j]] >> row_shift[j]) & 0x01) << j);
+        chunk[i] = value;
+    }
+}
+
+CFBD_Bool CFBDGraphic_DeviceBlitScaled(CFBD_GraphicDevice* device,
+                                       const CFBDGraphic_BlitSource* source,
+                                       uint16_t x,
+                                       uint16_t y,
+                                       uint16_t width,
+                                       uint16_t height,
+                                       CFBDGraphic_RasterOp rop)
+{
+    if (width == 0 || height == 0 || source->width == 0 || source->height == 0)
+        return CFBD_FALSE;
+    if (width == source->width && height == source->height)
+        return CFBDGraphic_DeviceBlit(device, source, x, y, rop);
+
+    CFBDGraphic_ClipBounds visible;
+    if (!CFBDGraphic_FetchClipBounds(device, &visible))
+        return CFBD_FALSE;
+    uint16_t vx = x, vy = y, vw = width, vh = height;
+    if (!CFBDGraphic_ClipBoundsIntersectArea(&visible, &vx, &vy, &vw, &vh))
+        return CFBD_FALSE;
+
+    ScaleJob job = {source,
+                    width,
+                    height,
+                    ((uint32_t) source->width << 16) / width,
+                    ((uint32_t) source->height << 16) / height,
+                    0};
+    if (width == 2 * source->width && height == 2 * source->height)
+        job.factor = 2;
+    else if (width == 4 * source->width && height == 4 * source->height)
+        job.factor = 4;
+
+    // 分块绘制期间不刷新, 结束后统一刷新一次
+    const CFBD_Bool immediate = CFBDGraphic_DeviceRequestUpdateAtOnce(device);
+    CFBDGraphic_DeviceSetIfRequestUpdateAtOnce(device, CFBD_FALSE);
+
+    uint8_t chunk[CFBD_SCALE_CHUNK];
+    const uint16_t first_page = (vy - y) / 8;
+    const uint16_t last_page = (vy - y + vh - 1) / 8;
+    for (uint16_t page = first_page; page <= last_page; page++) {
+        const uint16_t rows = (height - page * 8 < 8) ? (height - page * 8) : 8;
+        for (uint16_t left = vx - x; left < vx - x + vw; left += CFBD_SCALE_CHUNK) {
+            uint16_t columns = vx - x + vw - left;
+            if (columns > CFBD_SCALE_CHUNK)
+                columns = CFBD_SCALE_CHUNK;
+            if (job.factor)
+                expand_chunk(&job, page, left, columns, chunk);
+            else
+                sample_chunk(&job, page, left, columns, chunk);
+
+            const CFBDGraphic_BlitSource piece = {chunk, CFBD_SCALE_CHUNK, 0, 0, columns, rows};
+            CFBDGraphic_DeviceBlit(device, &piece, x + left, y + page * 8, rop);
+        }
+    }
+
+    CFBDGraphic_DeviceSetIfRequestUpdateAtOnce(device, immediate);
+    if (CFBDGraphic_DeviceRequestUpdateAtOnce(device))
+        device->ops->update_area(device, vx, vy, vw, vh);
+    return CFBD_TRUE;
+}
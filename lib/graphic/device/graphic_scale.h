@@ -0,0 +1,65 @@
+/**
+ * @file graphic_scale.h
+ * @brief Scaled blits of page-layout bitmaps.
+ * @ingroup Graphics_Device
+ *
+ * @details
+ * One bitmap can be drawn at several sizes instead of storing every size
+ * in flash. Scaling picks the nearest source pixel with 16.16 fixed-point
+ * steps, so no division runs per pixel. Exact 2x and 4x enlargements take
+ * a faster path: each source byte is expanded through a lookup table into
+ * two or four destination pages and repeated horizontally, a byte at a
+ * time.
+ *
+ * The scaled bitmap is produced one page row at a time in small chunks
+ * handed to CFBDGraphic_DeviceBlit(), which writes them into the frame
+ * buffer; nothing of the size of the scaled result is allocated.
+ *
+ * @example
+ * @code
+ * // a 16x16 icon drawn at 32x32 (LUT path) and at 24x24 (nearest neighbour)
+ * CFBDGraphic_BlitSource icon = {icon16, 16, 0, 0, 16, 16};
+ * CFBDGraphic_DeviceBlitScaled(device, &icon, 0, 0, 32, 32, CFBD_ROP_COPY);
+ * CFBDGraphic_DeviceBlitScaled(device, &icon, 40, 4, 24, 24, CFBD_ROP_COPY);
+ * @endcode
+ */
+
+#pragma once
+#include <stdint.h>
+
+#include "cfbd_define.h"
+#include "device/graphic_device.h"
+
+/**
+ * @addtogroup Graphics_Device
+ * @{
+ */
+
+/**
+ * @brief Blit a bitmap window stretched to @p width x @p height.
+ *
+ * @details
+ * Nearest neighbour sampling at pixel centers, any ratio in either
+ * direction. When the target is exactly 2x or 4x the window in both
+ * directions the lookup table path is used. Chunks outside the visible
+ * region are skipped before they are computed. In immediate mode the
+ * visible part is flushed with a single update_area().
+ *
+ * @param device Target device.
+ * @param source Bitmap window to scale.
+ * @param x X coordinate of the scaled bitmap.
+ * @param y Y coordinate of the scaled bitmap.
+ * @param width Scaled width in pixels.
+ * @param height Scaled height in pixels.
+ * @param rop How the scaled bitmap combines with the device pixels.
+ * @return CFBD_FALSE if nothing is visible or a size is 0.
+ */
+CFBD_Bool CFBDGraphic_DeviceBlitScaled(CFBD_GraphicDevice* device,
+                                       const CFBDGraphic_BlitSource* source,
+                                       uint16_t x,
+                                       uint16_t y,
+                                       uint16_t width,
+                                       uint16_t height,
+                                       CFBDGraphic_RasterOp rop);
+
+/** @} */
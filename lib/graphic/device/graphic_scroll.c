@@ -0,0 +1,228 @@
+#include "graphic_scroll.h"
+
+#include <string.h>
+
+#include "device/graphic_canvas.h"
+#include "device/graphic_clip.h"
+
+/* Bits of page @p page (rows relative to the buffer) that lie in [top, bottom] */
+static uint8_t page_rows(int32_t page, int32_t top, int32_t bottom)
+{
+    const int32_t first = (top > page * 8) ? top - page * 8 : 0;
+    const int32_t last = (bottom < page * 8 + 7) ? bottom - page * 8 : 7;
+    if (first > last)
+        return 0;
+    return (uint8_t) ((0xFFu << first) & (0xFFu >> (7 - last)));
+}
+
+/*
+    Each destination page row is assembled from the (at most two) source
+    page rows dy rows away. Pages are visited away from the direction of
+    the move, so every source page is read before it is overwritten.
+*/
+static void scroll_rows_1bpp(CFBDGraphic_Canvas* canvas,
+                             uint16_t x,
+                             uint16_t width,
+                             int32_t top,
+                             int32_t bottom,
+                             int32_t dy)
+{
+    const int32_t first = top >> 3;
+    const int32_t last = bottom >> 3;
+
+    for (int32_t i = 0; i <= last - first; i++) {
+        const int32_t page = (dy > 0) ? last - i : first + i;
+        const uint8_t mask = page_rows(page, top, bottom);
+
+        // rows of this page come from rows src .. src + 7, only rows inside the area count
+        const int32_t src = page * 8 - dy;
+        const int32_t src_page = (src >= 0) ? src >> 3 : -((7 - src) >> 3);
+        const uint8_t shift = (uint8_t) (src - src_page * 8);
+        const uint8_t lo_rows = page_rows(src_page, top, bottom);
+        const uint8_t hi_rows = page_rows(src_page + 1, top, bottom);
+        const uint8_t keep = (uint8_t) (((lo_rows >> shift) |
+                                         (shift ? (uint8_t) (hi_rows << (8 - shift)) : 0)) &
+                                        mask);
+
+        uint8_t* dst = &canvas->buffer[page * canvas->stride + x];
+        const uint8_t* lo = lo_rows ? &canvas->buffer[src_page * canvas->stride + x] : NULL;
+        const uint8_t* hi =
+                (shift && hi_rows) ? &canvas->buffer[(src_page + 1) * canvas->stride + x] : NULL;
+
+        for (uint16_t k = 0; k < width; k++) {
+            uint8_t value = lo ? (uint8_t) (lo[k] >> shift) : 0;
+            if (hi)
+                value |= (uint8_t) (hi[k] << (8 - shift));
+            dst[k] = (uint8_t) ((dst[k] & (uint8_t) ~mask) | (value & keep));
+        }
+    }
+}
+
+static inline void put_nibble(uint8_t* row, uint16_t x, uint8_t value)
+{
+    uint8_t* dst = &row[x >> 1];
+    *dst = (x & 1) ? (uint8_t) ((*dst & 0xF0) | value) : (uint8_t) ((*dst & 0x0F) | (value << 4));
+}
+
+static inline uint8_t get_nibble(const uint8_t* row, uint16_t x)
+{
+    return (x & 1) ? (uint8_t) (row[x >> 1] & 0x0F) : (uint8_t) (row[x >> 1] >> 4);
+}
+
+/* Rows are contiguous: whole bytes move with memmove, odd edge columns nibble by nibble */
+static void scroll_rows_4bpp(CFBDGraphic_Canvas* canvas,
+                             uint16_t x,
+                             uint16_t width,
+                             int32_t top,
+                             int32_t bottom,
+                             int32_t dy)
+{
+    const uint16_t x1 = x + width - 1;
+    const uint16_t lead = (x & 1) ? x : 0xFFFF;       // lone low nibble on the left
+    const uint16_t tail = (x1 & 1) ? 0xFFFF : x1;     // lone high nibble on the right
+    const uint16_t bx0 = (x + 1) >> 1;
+    const uint16_t bx1 = (x1 & 1) ? (x1 >> 1) + 1 : (x1 >> 1);
+
+    for (int32_t i = 0; i <= bottom - top; i++) {
+        const int32_t row = (dy > 0) ? bottom - i : top + i;
+        const int32_t src = row - dy;
+        uint8_t* dst = &canvas->buffer[row * canvas->stride];
+
+        if (src < top || src > bottom) {
+            if (bx1 > bx0)
+                memset(&dst[bx0], 0, bx1 - bx0);
+            if (lead != 0xFFFF)
+                put_nibble(dst, lead, 0);
+            if (tail != 0xFFFF)
+                put_nibble(dst, tail, 0);
+            continue;
+        }
+
+        const uint8_t* from = &canvas->buffer[src * canvas->stride];
+        if (bx1 > bx0)
+            memmove(&dst[bx0], &from[bx0], bx1 - bx0);
+        if (lead != 0xFFFF)
+            put_nibble(dst, lead, get_nibble(from, lead));
+        if (tail != 0xFFFF)
+            put_nibble(dst, tail, get_nibble(from, tail));
+    }
+}
+
+CFBD_Bool CFBDGraphic_DeviceScrollRows(CFBD_GraphicDevice* device,
+                                       uint16_t x,
+                                       uint16_t y,
+                                       uint16_t width,
+                                       uint16_t height,
+                                       int16_t dy)
+{
+    CFBDGraphic_Canvas canvas;
+    if (!CFBDGraphic_DeviceFetchCanvas(device, &canvas))
+        return CFBD_FALSE;
+    if (dy == 0 || !CFBDGraphic_ClipBoundsIntersectArea(&canvas.clip, &x, &y, &width, &height))
+        return CFBD_TRUE;
+
+    // 行号相对于缓冲区首行 (band)
+    const int32_t top = y - canvas.origin_y;
+    const int32_t bottom = top + height - 1;
+    if (canvas.format == CFBD_CANVAS_4BPP_PACKED)
+        scroll_rows_4bpp(&canvas, x, width, top, bottom, dy);
+    else
+        scroll_rows_1bpp(&canvas, x, width, top, bottom, dy);
+    return CFBD_TRUE;
+}
+
+/* One page row of the area, bits outside @p mask (rows not in the area) are kept */
+static void scroll_page_1bpp(uint8_t* row, uint16_t width, int32_t dx, uint8_t mask)
+{
+    const uint16_t moved = (uint16_t) (width - (dx < 0 ? -dx : dx));
+    uint8_t* exposed = (dx > 0) ? row : row + moved;
+    uint8_t* dst = (dx > 0) ? row + dx : row;
+    const uint8_t* src = (dx > 0) ? row : row - dx;
+
+    if (mask == 0xFF) {
+        memmove(dst, src, moved);
+        memset(exposed, 0, width - moved);
+        return;
+    }
+
+    // 部分页: 逐列合并, 与移动方向相反地遍历
+    for (uint16_t i = 0; i < moved; i++) {
+        const uint16_t k = (dx > 0) ? moved - 1 - i : i;
+        dst[k] = (uint8_t) ((dst[k] & (uint8_t) ~mask) | (src[k] & mask));
+    }
+    for (uint16_t k = 0; k < width - moved; k++)
+        exposed[k] &= (uint8_t) ~mask;
+}
+
+static void scroll_columns_4bpp(CFBDGraphic_Canvas* canvas,
+                                uint16_t x,
+                                uint16_t width,
+                                int32_t top,
+                                int32_t bottom,
+                                int32_t dx)
+{
+    const uint16_t moved = (uint16_t) (width - (dx < 0 ? -dx : dx));
+    const uint16_t first = (dx > 0) ? x + dx : x;      // destination of the moved columns
+    const uint16_t exposed = (dx > 0) ? x : x + moved; // first cleared column
+    const CFBD_Bool bytes = ((x | width | dx) & 1) == 0;
+
+    for (int32_t row = top; row <= bottom; row++) {
+        uint8_t* line = &canvas->buffer[row * canvas->stride];
+        if (bytes) {
+            memmove(&line[first >> 1], &line[(first - dx) >> 1], moved >> 1);
+            memset(&line[exposed >> 1], 0, (width - moved) >> 1);
+            continue;
+        }
+        for (uint16_t i = 0; i < moved; i++) {
+            const uint16_t k = (dx > 0) ? first + moved - 1 - i : first + i;
+            put_nibble(line, k, get_nibble(line, (uint16_t) (k - dx)));
+        }
+        for (uint16_t k = exposed; k < exposed + width - moved; k++)
+            put_nibble(line, k, 0);
+    }
+}
+
+CFBD_Bool CFBDGraphic_DeviceScrollColumns(CFBD_GraphicDevice* device,
+                                          uint16_t x,
+                                          uint16_t y,
+                                          uint16_t width,
+                                          uint16_t height,
+                                          int16_t dx)
+{
+    CFBDGraphic_Canvas canvas;
+    if (!CFBDGraphic_DeviceFetchCanvas(device, &canvas))
+        return CFBD_FALSE;
+    if (dx == 0 || !CFBDGraphic_ClipBoundsIntersectArea(&canvas.clip, &x, &y, &width, &height))
+        return CFBD_TRUE;
+
+    int32_t shift = dx;
+    if (shift > width)
+        shift = width;
+    else if (shift < -(int32_t) width)
+        shift = -(int32_t) width;
+
+    const int32_t top = y - canvas.origin_y;
+    const int32_t bottom = top + height - 1;
+    if (canvas.format == CFBD_CANVAS_4BPP_PACKED) {
+        scroll_columns_4bpp(&canvas, x, width, top, bottom, shift);
+        return CFBD_TRUE;
+    }
+    for (int32_t page = top >> 3; page <= bottom >> 3; page++)
+        scroll_page_1bpp(&canvas.buffer[page * canvas.stride + x],
+                         width,
+                         shift,
+                         page_rows(page, top, bottom));
+    return CFBD_TRUE;
+}
+
+CFBD_Bool CFBDGraphic_DeviceStartHardwareScroll(CFBD_GraphicDevice* device,
+                                                const CFBDGraphic_HardwareScroll* scroll)
+{
+    return device->ops->self_sets(device, "scroll", NULL, (void*) scroll);
+}
+
+CFBD_Bool CFBDGraphic_DeviceStopHardwareScroll(CFBD_GraphicDevice* device)
+{
+    CFBDGraphic_HardwareScroll stop = {CFBD_HW_SCROLL_STOP};
+    return CFBDGraphic_DeviceStartHardwareScroll(device, &stop);
+}
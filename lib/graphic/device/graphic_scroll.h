@@ -0,0 +1,140 @@
+/**
+ * @file graphic_scroll.h
+ * @brief Move frame buffer content inside an area instead of redrawing it.
+ * @ingroup Graphics_Device
+ *
+ * @details
+ * A scrolling list only needs a few new pixel rows per step, the rest of
+ * the viewport is already in the frame buffer one step away. Scrolling
+ * shifts those pixels in place, a whole page row of bytes at a time, and
+ * clears the rows it exposes so the caller can draw just the strip that
+ * came into view. Horizontal carousels do the same with columns: every
+ * page row of the area is one memmove().
+ *
+ * Nothing is flushed: the caller draws the exposed strip and then flushes
+ * the area once.
+ *
+ * Panels whose controller scrolls by itself (SSD130x, SSD132x) can also
+ * run a continuous hardware scroll with CFBDGraphic_DeviceStartHardwareScroll():
+ * a ticker or a wrapping banner then costs no bus traffic at all while it
+ * moves. The frame buffer is left untouched, the next flush of the device
+ * stops the scroll and puts the unscrolled picture back.
+ *
+ * @example
+ * @code
+ * // list viewport at rows 16..63, content moves up by 12 rows
+ * if (CFBDGraphic_DeviceScrollRows(device, 0, 16, 128, 48, -12)) {
+ *     draw_rows_between(52, 63);
+ *     device->ops->update_area(device, 0, 16, 128, 48);
+ * }
+ * @endcode
+ */
+
+#pragma once
+#include <stdint.h>
+
+#include "cfbd_define.h"
+#include "device/graphic_device.h"
+
+/**
+ * @addtogroup Graphics_Device
+ * @{
+ */
+
+/**
+ * @enum CFBDGraphic_HardwareScrollDirection
+ * @brief Direction of a continuous hardware scroll.
+ */
+typedef enum
+{
+    CFBD_HW_SCROLL_STOP,  /**< Stop, the panel shows the frame buffer again */
+    CFBD_HW_SCROLL_LEFT,  /**< Content moves left, wrapping around */
+    CFBD_HW_SCROLL_RIGHT, /**< Content moves right, wrapping around */
+} CFBDGraphic_HardwareScrollDirection;
+
+/**
+ * @struct CFBDGraphic_HardwareScroll
+ * @brief Area and speed of a continuous hardware scroll.
+ */
+typedef struct
+{
+    CFBDGraphic_HardwareScrollDirection direction; /**< Which way the content moves */
+    uint16_t x;                                    /**< X coordinate of the area */
+    uint16_t y;                                    /**< Y coordinate of the area */
+    uint16_t width;                                /**< Width of the area in pixels */
+    uint16_t height;                               /**< Height of the area in pixels */
+    uint16_t frames;                               /**< Panel frames per one column step */
+    uint8_t rows;                                  /**< Rows per step upwards, 0 if none */
+} CFBDGraphic_HardwareScroll;
+
+/**
+ * @brief Shift the pixels of an area by @p dy rows and clear the exposed rows.
+ *
+ * @details
+ * The area is first limited to the visible region (clip stack included);
+ * pixels outside of it are never touched, pixels moved out of it are
+ * dropped. Works on 1bpp page and 4bpp packed frame buffers.
+ *
+ * @param device Device with a local frame buffer.
+ * @param x X coordinate of the area.
+ * @param y Y coordinate of the area.
+ * @param width Width of the area in pixels.
+ * @param height Height of the area in pixels.
+ * @param dy Rows to move by: positive moves content down, negative up.
+ * @return CFBD_FALSE if the device exposes no frame buffer, the caller then
+ *         has to redraw the whole area.
+ */
+CFBD_Bool CFBDGraphic_DeviceScrollRows(CFBD_GraphicDevice* device,
+                                       uint16_t x,
+                                       uint16_t y,
+                                       uint16_t width,
+                                       uint16_t height,
+                                       int16_t dy);
+
+/**
+ * @brief Shift the pixels of an area by @p dx columns and clear the exposed columns.
+ *
+ * @details
+ * Same rules as CFBDGraphic_DeviceScrollRows(). Full page rows of a 1bpp
+ * area and byte aligned moves of a 4bpp area are moved with memmove().
+ *
+ * @param device Device with a local frame buffer.
+ * @param x X coordinate of the area.
+ * @param y Y coordinate of the area.
+ * @param width Width of the area in pixels.
+ * @param height Height of the area in pixels.
+ * @param dx Columns to move by: positive moves content right, negative left.
+ * @return CFBD_FALSE if the device exposes no frame buffer.
+ */
+CFBD_Bool CFBDGraphic_DeviceScrollColumns(CFBD_GraphicDevice* device,
+                                          uint16_t x,
+                                          uint16_t y,
+                                          uint16_t width,
+                                          uint16_t height,
+                                          int16_t dx);
+
+/**
+ * @brief Let the panel controller scroll an area continuously.
+ *
+ * @details
+ * Goes through the device's "scroll" property. The controller rounds the
+ * area and the speed to what it supports: SSD130x parts scroll whole
+ * pages (the SSD1306 also the full width) and only they support @ref
+ * CFBDGraphic_HardwareScroll::rows, SSD132x parts scroll column pairs.
+ * Starting a scroll ends the one before.
+ *
+ * @param device Panel device.
+ * @param scroll Area, direction and speed.
+ * @return CFBD_FALSE if the device has no hardware scroll or rejects the area.
+ */
+CFBD_Bool CFBDGraphic_DeviceStartHardwareScroll(CFBD_GraphicDevice* device,
+                                                const CFBDGraphic_HardwareScroll* scroll);
+
+/**
+ * @brief Stop the hardware scroll and show the frame buffer again.
+ * @param device Panel device.
+ * @return CFBD_FALSE if the device has no hardware scroll.
+ */
+CFBD_Bool CFBDGraphic_DeviceStopHardwareScroll(CFBD_GraphicDevice* device);
+
+/** @} */
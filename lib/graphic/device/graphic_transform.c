@@ -0,0 +1,179 @@
+#include "graphic_transform.h"
+
+#include "device/graphic_canvas.h"
+#include "device/graphic_clip.h"
+
+/* Destination columns produced per blit, one page row high */
+#define CFBD_TRANSFORM_CHUNK (32)
+
+void CFBDGraphic_TransposeBlock8x8(uint8_t block[8])
+{
+    uint32_t lo = block[0] | (uint32_t) block[1] << 8 | (uint32_t) block[2] << 16 |
+                  (uint32_t) block[3] << 24;
+    uint32_t hi = block[4] | (uint32_t) block[5] << 8 | (uint32_t) block[6] << 16 |
+                  (uint32_t) block[7] << 24;
+    uint32_t t;
+
+    // 依次交换 2x2, 4x4 子块, 最后交换两个 4x4 半块
+    t = (lo ^ (lo >> 7)) & 0x00AA00AAu;
+    lo ^= t ^ (t << 7);
+    t = (hi ^ (hi >> 7)) & 0x00AA00AAu;
+    hi ^= t ^ (t << 7);
+
+    t = (lo ^ (lo >> 14)) & 0x0000CCCCu;
+    lo ^= t ^ (t << 14);
+    t = (hi ^ (hi >> 14)) & 0x0000CCCCu;
+    hi ^= t ^ (t << 14);
+
+    t = ((lo >> 4) ^ hi) & 0x0F0F0F0Fu;
+    hi ^= t;
+    lo ^= t << 4;
+
+    for (uint8_t i = 0; i < 4; i++) {
+        block[i] = (uint8_t) (lo >> (8 * i));
+        block[i + 4] = (uint8_t) (hi >> (8 * i));
+    }
+}
+
+static inline uint8_t reverse_bits(uint8_t b)
+{
+    b = (uint8_t) ((b & 0xF0) >> 4 | (b & 0x0F) << 4);
+    b = (uint8_t) ((b & 0xCC) >> 2 | (b & 0x33) << 2);
+    return (uint8_t) ((b & 0xAA) >> 1 | (b & 0x55) << 1);
+}
+
+/*
+    Eight rows of window column @p column starting at window row @p row,
+    which may lie up to 7 rows above the window. Rows outside the window
+    read as 0 and are never fetched from the bitmap.
+*/
+static uint8_t fetch_column(const CFBDGraphic_BlitSource* source, int32_t column, int32_t row)
+{
+    if (column < 0 || column >= source->width)
+        return 0;
+    const int32_t first = (row < 0) ? 0 : row;
+    const int32_t last = (row + 8 > source->height) ? source->height : row + 8;
+    if (first >= last)
+        return 0;
+
+    const uint8_t* bytes = source->bitmap + source->x + column;
+    const int32_t top = source->y + row;
+    const int32_t page = (top + 8) / 8 - 1;
+    const uint8_t shift = (uint8_t) (top - page * 8);
+
+    uint8_t value = 0;
+    if (page * 8 + 7 >= source->y + first)
+        value = bytes[page * source->stride] >> shift;
+    if (shift && (page + 1) * 8 < source->y + last)
+        value |= (uint8_t) (bytes[(page + 1) * source->stride] << (8 - shift));
+
+    const uint8_t mask = (uint8_t) (((1u << (last - first)) - 1) << (first - row));
+    return value & mask;
+}
+
+/*
+    Produce the destination 8x8 block whose top-left pixel is (u, v) in
+    transformed coordinates. Byte i is destination column u + i.
+*/
+static void transform_block(const CFBDGraphic_BlitSource* source,
+                            CFBDGraphic_Transform transform,
+                            int32_t u,
+                            int32_t v,
+                            uint8_t block[8])
+{
+    const int32_t w = source->width;
+    const int32_t h = source->height;
+
+    switch (transform) {
+        case CFBD_TRANSFORM_ROTATE_90:
+            // 源列 v..v+7 转置后逆序
+            for (uint8_t k = 0; k < 8; k++)
+                block[k] = fetch_column(source, v + k, h - 8 - u);
+            CFBDGraphic_TransposeBlock8x8(block);
+            for (uint8_t k = 0; k < 4; k++) {
+                const uint8_t t = block[k];
+                block[k] = block[7 - k];
+                block[7 - k] = t;
+            }
+            break;
+        case CFBD_TRANSFORM_ROTATE_270:
+            for (uint8_t k = 0; k < 8; k++)
+                block[k] = fetch_column(source, w - 1 - v - k, u);
+            CFBDGraphic_TransposeBlock8x8(block);
+            break;
+        case CFBD_TRANSFORM_ROTATE_180:
+            for (uint8_t k = 0; k < 8; k++)
+                block[k] = reverse_bits(fetch_column(source, w - 1 - u - k, h - 8 - v));
+            break;
+        case CFBD_TRANSFORM_MIRROR_X:
+            for (uint8_t k = 0; k < 8; k++)
+                block[k] = fetch_column(source, w - 1 - u - k, v);
+            break;
+        case CFBD_TRANSFORM_MIRROR_Y:
+            for (uint8_t k = 0; k < 8; k++)
+                block[k] = reverse_bits(fetch_column(source, u + k, h - 8 - v));
+            break;
+        default:
+            for (uint8_t k = 0; k < 8; k++)
+                block[k] = fetch_column(source, u + k, v);
+            break;
+    }
+}
+
+CFBD_Bool CFBDGraphic_DeviceBlitTransformed(CFBD_GraphicDevice* device,
+                                            const CFBDGraphic_BlitSource* source,
+                                            uint16_t x,
+                                            uint16_t y,
+                                            CFBDGraphic_Transform transform,
+                                            CFBDGraphic_RasterOp rop)
+{
+    if (transform == CFBD_TRANSFORM_NONE)
+        return CFBDGraphic_DeviceBlit(device, source, x, y, rop);
+
+    const CFBD_Bool swap = CFBDGraphic_TransformSwapsAxes(transform);
+    const uint16_t width = swap ? source->height : source->width;
+    const uint16_t height = swap ? source->width : source->height;
+
+    CFBDGraphic_ClipBounds visible;
+    if (!CFBDGraphic_FetchClipBounds(device, &visible))
+        return CFBD_FALSE;
+    uint16_t vx = x, vy = y, vw = width, vh = height;
+    if (!CFBDGraphic_ClipBoundsIntersectArea(&visible, &vx, &vy, &vw, &vh))
+        return CFBD_FALSE;
+
+    // 分块绘制期间不刷新, 结束后统一刷新一次
+    const CFBD_Bool immediate = CFBDGraphic_DeviceRequestUpdateAtOnce(device);
+    CFBDGraphic_DeviceSetIfRequestUpdateAtOnce(device, CFBD_FALSE);
+
+    uint8_t chunk[CFBD_TRANSFORM_CHUNK];
+    const uint16_t first_page = (vy - y) / 8;
+    const uint16_t last_page = (vy - y + vh - 1) / 8;
+    const uint16_t first_column = (vx - x) & ~7u;
+    for (uint16_t page = first_page; page <= last_page; page++) {
+        const uint16_t top = page * 8;
+        const uint16_t rows = (height - top < 8) ? (height - top) : 8;
+        for (uint16_t left = first_column; left < vx - x + vw; left += CFBD_TRANSFORM_CHUNK) {
+            uint16_t columns = width - left;
+            if (columns > CFBD_TRANSFORM_CHUNK)
+                columns = CFBD_TRANSFORM_CHUNK;
+            for (uint16_t i = 0; i < columns; i += 8)
+                transform_block(source, transform, left + i, top, &chunk[i]);
+
+            const CFBDGraphic_BlitSource piece = {chunk, CFBD_TRANSFORM_CHUNK, 0, 0, columns, rows};
+            CFBDGraphic_DeviceBlit(device, &piece, x + left, y + top, rop);
+        }
+    }
+
+    CFBDGraphic_DeviceSetIfRequestUpdateAtOnce(device, immediate);
+    if (CFBDGraphic_DeviceRequestUpdateAtOnce(device))
+        device->ops->update_area(device, vx, vy, vw, vh);
+    return CFBD_TRUE;
+}
+
+CFBD_Bool CFBDGraphic_DeviceSetPanelTransform(CFBD_GraphicDevice* device,
+                                              CFBDGraphic_Transform transform)
+{
+    if (CFBDGraphic_TransformSwapsAxes(transform))
+        return CFBD_FALSE;
+    return device->ops->self_sets(device, "transform", NULL, &transform);
+}
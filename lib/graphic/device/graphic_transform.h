@@ -0,0 +1,121 @@
+/**
+ * @file graphic_transform.h
+ * @brief Rotation and mirroring of page-layout bitmaps and panels.
+ * @ingroup Graphics_Device
+ *
+ * @details
+ * Panels get mounted upside down or on their side. Two paths cover that:
+ *
+ * - CFBDGraphic_DeviceSetPanelTransform() asks the controller to remap its
+ *   segments and COM lines. It costs nothing per frame but only the 180
+ *   degree and mirror cases exist in hardware.
+ * - CFBDGraphic_DeviceBlitTransformed() rotates or mirrors a bitmap while
+ *   blitting it. Source data is processed as 8x8 blocks: a quarter turn is a
+ *   bit-matrix transpose of the block plus a reversed byte order, a mirror
+ *   is a byte or bit reversal. Every source byte is read once, so the cost
+ *   stays close to a plain CFBDGraphic_DeviceBlit().
+ *
+ * For a panel mounted at 90 or 270 degrees, render the frame into a memory
+ * device of the rotated size and present it with the software path.
+ *
+ * @example
+ * @code
+ * // 64x128 portrait UI on a 128x64 panel
+ * static uint8_t portrait[CFBDGraphic_MEMORY_CANVAS_BYTES(64, 128)];
+ * CFBDGraphic_MemoryCanvas frame = {portrait, 64, 128};
+ * CFBDGraphic_BindMemoryAsDevice(&offscreen, &frame);
+ * draw_ui(&offscreen);
+ * CFBDGraphic_BlitSource whole = {portrait, 64, 0, 0, 64, 128};
+ * CFBDGraphic_DeviceBlitTransformed(panel, &whole, 0, 0, CFBD_TRANSFORM_ROTATE_90, CFBD_ROP_COPY);
+ * @endcode
+ */
+
+#pragma once
+#include <stdint.h>
+
+#include "cfbd_define.h"
+#include "device/graphic_device.h"
+
+/**
+ * @addtogroup Graphics_Device
+ * @{
+ */
+
+/**
+ * @enum CFBDGraphic_Transform
+ * @brief Orientation change applied to a bitmap or a panel.
+ *
+ * @note Rotations turn clockwise. The quarter turns swap width and height.
+ */
+typedef enum
+{
+    CFBD_TRANSFORM_NONE,       /**< Keep the bitmap as is */
+    CFBD_TRANSFORM_ROTATE_90,  /**< Quarter turn clockwise */
+    CFBD_TRANSFORM_ROTATE_180, /**< Half turn */
+    CFBD_TRANSFORM_ROTATE_270, /**< Quarter turn counter clockwise */
+    CFBD_TRANSFORM_MIRROR_X,   /**< Left and right swapped */
+    CFBD_TRANSFORM_MIRROR_Y    /**< Top and bottom swapped */
+} CFBDGraphic_Transform;
+
+/**
+ * @brief Check whether @p transform swaps width and height.
+ */
+static inline CFBD_Bool CFBDGraphic_TransformSwapsAxes(CFBDGraphic_Transform transform)
+{
+    return transform == CFBD_TRANSFORM_ROTATE_90 || transform == CFBD_TRANSFORM_ROTATE_270;
+}
+
+/**
+ * @brief Transpose an 8x8 block of page-layout pixels in place.
+ *
+ * @details
+ * On input byte `i` holds column `i` (bit `j` = row `j`), on output byte `j`
+ * holds what was row `j`. Runs as a handful of shift/xor steps on two 32 bit
+ * words instead of 64 single bit moves.
+ *
+ * @param block Eight bytes, one per column.
+ */
+void CFBDGraphic_TransposeBlock8x8(uint8_t block[8]);
+
+/**
+ * @brief Blit a bitmap window rotated or mirrored, flushing at most once.
+ *
+ * @details
+ * The transformed window (width and height swapped for the quarter turns)
+ * has its top-left pixel at (@p x, @p y). It is produced one page row at a
+ * time in small chunks that go through CFBDGraphic_DeviceBlit(), chunks
+ * outside the visible region are skipped before they are transformed. In
+ * immediate mode the visible part is flushed with a single update_area().
+ *
+ * @param device Target device.
+ * @param source Bitmap window to copy.
+ * @param x X coordinate of the transformed window.
+ * @param y Y coordinate of the transformed window.
+ * @param transform Rotation or mirroring to apply.
+ * @param rop How the window combines with the device pixels.
+ * @return CFBD_FALSE if nothing of the window is visible.
+ */
+CFBD_Bool CFBDGraphic_DeviceBlitTransformed(CFBD_GraphicDevice* device,
+                                            const CFBDGraphic_BlitSource* source,
+                                            uint16_t x,
+                                            uint16_t y,
+                                            CFBDGraphic_Transform transform,
+                                            CFBDGraphic_RasterOp rop);
+
+/**
+ * @brief Let the panel controller display everything transformed.
+ *
+ * @details
+ * Maps the transform to the controller's segment remap (columns) and COM
+ * scan direction (rows) through the device's "transform" property. Drawing
+ * code keeps using unchanged coordinates. The quarter turns have no
+ * hardware equivalent, use CFBDGraphic_DeviceBlitTransformed() for them.
+ *
+ * @param device Panel device.
+ * @param transform CFBD_TRANSFORM_NONE, _ROTATE_180, _MIRROR_X or _MIRROR_Y.
+ * @return CFBD_FALSE if the device or the transform is not supported.
+ */
+CFBD_Bool CFBDGraphic_DeviceSetPanelTransform(CFBD_GraphicDevice* device,
+                                              CFBDGraphic_Transform transform);
+
+/** @} */
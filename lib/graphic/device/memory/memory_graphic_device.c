@@ -0,0 +1,424 @@
+#include "memory_graphic_device.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#include "cfbd_define.h"
+#include "device/graphic_canvas.h"
+#include "device/graphic_clip.h"
+
+static inline CFBDGraphic_MemoryCanvas* _get_canvas(CFBD_GraphicDevice* device)
+{
+    return (CFBDGraphic_MemoryCanvas*) device->internal_handle;
+}
+
+static inline uint8_t* _page_byte(CFBDGraphic_MemoryCanvas* canvas, uint16_t x, uint16_t y)
+{
+    return &canvas->buffer[((y - canvas->origin_y) >> 3) * canvas->width + x];
+}
+
+static inline uint16_t _bottom(CFBDGraphic_MemoryCanvas* canvas)
+{
+    return canvas->origin_y + canvas->height;
+}
+
+static inline CFBD_Bool _is_4bpp(const CFBDGraphic_MemoryCanvas* canvas)
+{
+    return canvas->format == CFBD_CANVAS_4BPP_PACKED;
+}
+
+static inline uint16_t _stride(const CFBDGraphic_MemoryCanvas* canvas)
+{
+    return _is_4bpp(canvas) ? (uint16_t) ((canvas->width + 1) / 2) : canvas->width;
+}
+
+static inline size_t _bytes(const CFBDGraphic_MemoryCanvas* canvas)
+{
+    return _is_4bpp(canvas) ? CFBDGraphic_MEMORY_CANVAS_4BPP_BYTES(canvas->width, canvas->height)
+                            : CFBDGraphic_MEMORY_CANVAS_BYTES(canvas->width, canvas->height);
+}
+
+static inline uint8_t _grey(const CFBDGraphic_MemoryCanvas* canvas)
+{
+    return canvas->color ? (uint8_t) (canvas->color & 0x0F) : 0x0F;
+}
+
+static inline uint8_t* _row_byte(CFBDGraphic_MemoryCanvas* canvas, uint16_t x, uint16_t y)
+{
+    return &canvas->buffer[(y - canvas->origin_y) * _stride(canvas) + (x >> 1)];
+}
+
+/* Limit an area to the rows held by the canvas and the active clip */
+static CFBD_Bool
+_visible_area(CFBD_GraphicDevice* device, uint16_t* x, uint16_t* y, uint16_t* w, uint16_t* h)
+{
+    CFBDGraphic_MemoryCanvas* canvas = _get_canvas(device);
+    CFBDGraphic_ClipBounds bounds;
+    if (!CFBDGraphic_DeviceEffectiveClip(device, canvas->width, _bottom(canvas), &bounds))
+        return CFBD_FALSE;
+    if (bounds.y0 < canvas->origin_y)
+        bounds.y0 = canvas->origin_y;
+    return CFBDGraphic_ClipBoundsIntersectArea(&bounds, x, y, w, h);
+}
+
+/* ---------- init ---------- */
+
+static int graphic_memory_init(CFBD_GraphicDevice* device, void* init_args)
+{
+    return 0;
+}
+
+/* ---------- pixel ---------- */
+
+static CFBD_Bool graphic_memory_setPixel(CFBD_GraphicDevice* device, uint16_t x, uint16_t y)
+{
+    CFBDGraphic_MemoryCanvas* canvas = _get_canvas(device);
+    if (x >= canvas->width || y < canvas->origin_y || y >= _bottom(canvas))
+        return CFBD_TRUE;
+    if (!CFBDGraphic_DeviceClipContains(device, x, y))
+        return CFBD_TRUE;
+
+    uint8_t keep, flip;
+    CFBDGraphic_RasterOpMasks(device->rop, &keep, &flip);
+    if (_is_4bpp(canvas)) {
+        uint8_t* dst = _row_byte(canvas, x, y);
+        const uint8_t mask = (x & 1) ? 0x0F : 0xF0;
+        const uint8_t value = (x & 1) ? _grey(canvas) : (uint8_t) (_grey(canvas) << 4);
+        *dst = (uint8_t) ((*dst & (uint8_t) (~mask | keep)) ^ (value & flip));
+        return CFBD_TRUE;
+    }
+
+    uint8_t* dst = _page_byte(canvas, x, y);
+    const uint8_t bit = (uint8_t) (1u << (y & 7));
+    *dst = (uint8_t) ((*dst & (uint8_t) (~bit | keep)) ^ (bit & flip));
+    return CFBD_TRUE;
+}
+
+static CFBD_Bool graphic_memory_setArea(CFBD_GraphicDevice* device,
+                                        uint16_t x,
+                                        uint16_t y,
+                                        uint16_t width,
+                                        uint16_t height,
+                                        uint8_t* source)
+{
+    // the canvas carries the clip and the raster op
+    CFBDGraphic_Canvas canvas;
+    CFBDGraphic_DeviceFetchCanvas(device, &canvas);
+    CFBDGraphic_CanvasBlit(&canvas, x, y, width, height, source);
+    return CFBD_TRUE;
+}
+
+static CFBD_Bool graphic_memory_blit(CFBD_GraphicDevice* device,
+                                     const CFBDGraphic_BlitSource* source,
+                                     uint16_t x,
+                                     uint16_t y,
+                                     CFBDGraphic_RasterOp rop)
+{
+    CFBDGraphic_Canvas canvas;
+    CFBDGraphic_DeviceFetchCanvas(device, &canvas);
+    CFBDGraphic_CanvasSetRasterOp(&canvas, rop);
+    CFBDGraphic_CanvasBlitWindow(&canvas, x, y, source);
+    return CFBD_TRUE;
+}
+
+/* ---------- frame ---------- */
+
+static CFBD_Bool graphic_memory_nop(CFBD_GraphicDevice* device)
+{
+    return CFBD_TRUE;
+}
+
+static CFBD_Bool graphic_memory_clear(CFBD_GraphicDevice* device)
+{
+    CFBDGraphic_MemoryCanvas* canvas = _get_canvas(device);
+    memset(canvas->buffer, 0, _bytes(canvas));
+    return CFBD_TRUE;
+}
+
+static CFBD_Bool graphic_memory_revert(CFBD_GraphicDevice* device)
+{
+    CFBDGraphic_MemoryCanvas* canvas = _get_canvas(device);
+    const size_t bytes = _bytes(canvas);
+    for (size_t i = 0; i < bytes; i++) {
+        canvas->buffer[i] ^= 0xFF;
+    }
+    return CFBD_TRUE;
+}
+
+/* ---------- area ---------- */
+
+static CFBD_Bool graphic_memory_update_area(CFBD_GraphicDevice* device,
+                                            uint16_t x,
+                                            uint16_t y,
+                                            uint16_t w,
+                                            uint16_t h)
+{
+    return CFBD_TRUE;
+}
+
+static CFBD_Bool
+graphic_memory_clear_area(CFBD_GraphicDevice* device, uint16_t x, uint16_t y, uint16_t w, uint16_t h)
+{
+    CFBDGraphic_MemoryCanvas* canvas = _get_canvas(device);
+    if (!_visible_area(device, &x, &y, &w, &h))
+        return CFBD_TRUE;
+
+    if (_is_4bpp(canvas)) {
+        for (uint16_t j = y; j < y + h; j++) {
+            uint8_t* row = _row_byte(canvas, 0, j);
+            for (uint16_t i = x; i < x + w; i++) {
+                row[i >> 1] &= (i & 1) ? 0xF0 : 0x0F;
+            }
+        }
+        return CFBD_TRUE;
+    }
+
+    for (uint16_t j = y; j < y + h; j++) {
+        const uint8_t keep = (uint8_t) ~(1u << (j & 7));
+        uint8_t* dst = _page_byte(canvas, x, j);
+        for (uint16_t i = 0; i < w; i++) {
+            dst[i] &= keep;
+        }
+    }
+    return CFBD_TRUE;
+}
+
+static CFBD_Bool graphic_memory_revert_area(CFBD_GraphicDevice* device,
+                                            uint16_t x,
+                                            uint16_t y,
+                                            uint16_t w,
+                                            uint16_t h)
+{
+    CFBDGraphic_MemoryCanvas* canvas = _get_canvas(device);
+    if (!_visible_area(device, &x, &y, &w, &h))
+        return CFBD_TRUE;
+
+    if (_is_4bpp(canvas)) {
+        for (uint16_t j = y; j < y + h; j++) {
+            uint8_t* row = _row_byte(canvas, 0, j);
+            for (uint16_t i = x; i < x + w; i++) {
+                row[i >> 1] ^= (i & 1) ? 0x0F : 0xF0;
+            }
+        }
+        return CFBD_TRUE;
+    }
+
+    for (uint16_t j = y; j < y + h; j++) {
+        const uint8_t bit = (uint8_t) (1u << (j & 7));
+        uint8_t* dst = _page_byte(canvas, x, j);
+        for (uint16_t i = 0; i < w; i++) {
+            dst[i] ^= bit;
+        }
+    }
+    return CFBD_TRUE;
+}
+
+/* ---------- query ---------- */
+
+static CFBD_Bool graphic_memory_self_consult(CFBD_GraphicDevice* device,
+                                             const char* property,
+                                             void* args,
+                                             void* request_data)
+{
+    CFBDGraphic_MemoryCanvas* memory = _get_canvas(device);
+    if (strcmp("rgb", property) == 0) {
+        *(CFBD_Bool*) request_data = CFBD_FALSE;
+        return CFBD_TRUE;
+    }
+
+    if (strcmp("width", property) == 0) {
+        *(uint16_t*) request_data = memory->width;
+        return CFBD_TRUE;
+    }
+
+    if (strcmp("height", property) == 0) {
+        *(uint16_t*) request_data = _bottom(memory);
+        return CFBD_TRUE;
+    }
+
+    if (strcmp("canvas", property) == 0) {
+        CFBDGraphic_Canvas* canvas = (CFBDGraphic_Canvas*) request_data;
+        canvas->buffer = memory->buffer;
+        canvas->stride = _stride(memory);
+        canvas->width = memory->width;
+        canvas->height = _bottom(memory);
+        canvas->origin_y = memory->origin_y;
+        canvas->format = memory->format;
+        canvas->color = _is_4bpp(memory) ? _grey(memory) : 1;
+        return CFBD_TRUE;
+    }
+
+    if (strcmp("color", property) == 0 && _is_4bpp(memory)) {
+        *(uint8_t*) request_data = _grey(memory);
+        return CFBD_TRUE;
+    }
+
+    return CFBD_FALSE;
+}
+
+static CFBD_Bool graphic_memory_self_sets(CFBD_GraphicDevice* device,
+                                          const char* property,
+                                          void* args,
+                                          void* request_data)
+{
+    CFBDGraphic_MemoryCanvas* memory = _get_canvas(device);
+    if (strcmp("color", property) == 0 && _is_4bpp(memory)) {
+        memory->color = *(uint8_t*) request_data & 0x0F;
+        return CFBD_TRUE;
+    }
+
+    return CFBD_FALSE;
+}
+
+static CFBD_GraphicDeviceOperation graphic_memory_ops = {.init = graphic_memory_init,
+                                                         .setPixel = graphic_memory_setPixel,
+                                                         .setArea = graphic_memory_setArea,
+
+                                                         .update = graphic_memory_nop,
+                                                         .clear = graphic_memory_clear,
+                                                         .revert = graphic_memory_revert,
+
+                                                         .update_area = graphic_memory_update_area,
+                                                         .clear_area = graphic_memory_clear_area,
+                                                         .revert_area = graphic_memory_revert_area,
+                                                         .blit = graphic_memory_blit,
+
+                                                         .open = graphic_memory_nop,
+                                                         .close = graphic_memory_nop,
+
+                                                         .self_consult = graphic_memory_self_consult,
+                                                         .self_sets = graphic_memory_self_sets};
+
+void CFBDGraphic_BindMemoryAsDevice(CFBD_GraphicDevice* device, CFBDGraphic_MemoryCanvas* canvas)
+{
+    if (device == NULL || canvas == NULL || canvas->buffer == NULL)
+        return;
+
+    device->ops = &graphic_memory_ops;
+    device->device_type = MEMORY;
+    device->internal_handle = (CFBDGraphicDeviceHandle) canvas;
+    CFBDGraphic_DeviceSetIfRequestUpdateAtOnce(device, CFBD_FALSE);
+    CFBDGraphic_ResetClip(device);
+    CFBDGraphic_DeviceResetDrawState(device);
+}
+
+void CFBDGraphic_MemoryCanvasAsImage(CFBDGraphic_MemoryCanvas* canvas,
+                                     const CFBDGraphic_Point* tl_point,
+                                     CCGraphic_Image* image)
+{
+    image->point = *tl_point;
+    image->image_size.width = canvas->width;
+    image->image_size.height = canvas->height;
+    image->sources_register = _is_4bpp(canvas) ? NULL : canvas->buffer;
+    image->encoding = CFBD_IMAGE_RAW;
+}
+
+/* ---------- composition ---------- */
+
+static inline uint8_t _nibble(const uint8_t* row, uint16_t x)
+{
+    return (x & 1) ? (uint8_t) (row[x >> 1] & 0x0F) : (uint8_t) (row[x >> 1] >> 4);
+}
+
+static inline void _put_nibble(uint8_t* row, uint16_t x, uint8_t value)
+{
+    uint8_t* dst = &row[x >> 1];
+    *dst = (x & 1) ? (uint8_t) ((*dst & 0xF0) | value) : (uint8_t) ((*dst & 0x0F) | (value << 4));
+}
+
+/* COPY of @p n pixels when source and destination columns share their parity */
+static void _copy_row(const uint8_t* src, uint16_t sx, uint8_t* dst, uint16_t dx, uint16_t n)
+{
+    if (sx & 1) {
+        _put_nibble(dst, dx++, _nibble(src, sx++));
+        n--;
+    }
+    memcpy(&dst[dx >> 1], &src[sx >> 1], n >> 1);
+    if (n & 1)
+        _put_nibble(dst, dx + n - 1, _nibble(src, sx + n - 1));
+}
+
+static void _compose_row(const uint8_t* src,
+                         uint16_t sx,
+                         uint8_t* dst,
+                         uint16_t dx,
+                         uint16_t n,
+                         CFBDGraphic_RasterOp rop)
+{
+    for (uint16_t i = 0; i < n; i++) {
+        const uint8_t ink = _nibble(src, sx + i);
+        switch (rop) {
+            case CFBD_ROP_SET:
+                if (ink)
+                    _put_nibble(dst, dx + i, ink);
+                break;
+            case CFBD_ROP_CLEAR:
+                if (ink)
+                    _put_nibble(dst, dx + i, 0);
+                break;
+            case CFBD_ROP_XOR:
+                _put_nibble(dst, dx + i, _nibble(dst, dx + i) ^ ink);
+                break;
+            default:
+                _put_nibble(dst, dx + i, ink);
+                break;
+        }
+    }
+}
+
+/* 4bpp canvas window (sx, sy) onward onto a 4bpp frame buffer at (x, y) */
+static CFBD_Bool _draw_canvas_4bpp(CFBD_GraphicDevice* device,
+                                   const CFBDGraphic_MemoryCanvas* canvas,
+                                   uint16_t sx,
+                                   uint16_t sy,
+                                   uint16_t x,
+                                   uint16_t y,
+                                   CFBDGraphic_RasterOp rop)
+{
+    CFBDGraphic_Canvas target;
+    if (!CFBDGraphic_DeviceFetchCanvas(device, &target) ||
+        target.format != CFBD_CANVAS_4BPP_PACKED)
+        return CFBD_FALSE;
+
+    uint16_t vx = x, vy = y, vw = canvas->width - sx, vh = canvas->height - sy;
+    if (!CFBDGraphic_ClipBoundsIntersectArea(&target.clip, &vx, &vy, &vw, &vh))
+        return CFBD_FALSE;
+
+    const uint16_t left = sx + (vx - x);
+    const uint16_t top = sy + (vy - y);
+    const uint16_t stride = _stride(canvas);
+    // 列奇偶一致时整字节拷贝
+    const CFBD_Bool bytewise = rop == CFBD_ROP_COPY && ((left ^ vx) & 1) == 0;
+    for (uint16_t j = 0; j < vh; j++) {
+        const uint8_t* src = canvas->buffer + (top + j) * stride;
+        uint8_t* dst = target.buffer + (vy + j - target.origin_y) * target.stride;
+        if (bytewise)
+            _copy_row(src, left, dst, vx, vw);
+        else
+            _compose_row(src, left, dst, vx, vw, rop);
+    }
+
+    if (CFBDGraphic_DeviceRequestUpdateAtOnce(device))
+        device->ops->update_area(device, vx, vy, vw, vh);
+    return CFBD_TRUE;
+}
+
+CFBD_Bool CFBDGraphic_DrawMemoryCanvas(CFBD_GraphicDevice* device,
+                                       const CFBDGraphic_MemoryCanvas* canvas,
+                                       int16_t x,
+                                       int16_t y,
+                                       CFBDGraphic_RasterOp rop)
+{
+    // 负偏移: 只取与屏幕重叠的窗口
+    const uint16_t sx = (x < 0) ? (uint16_t) -x : 0;
+    const uint16_t sy = (y < 0) ? (uint16_t) -y : 0;
+    if (sx >= canvas->width || sy >= canvas->height)
+        return CFBD_FALSE;
+
+    if (_is_4bpp(canvas))
+        return _draw_canvas_4bpp(device, canvas, sx, sy, x + sx, y + sy, rop);
+
+    const CFBDGraphic_BlitSource window = {
+            canvas->buffer, canvas->width, sx, sy, canvas->width - sx, canvas->height - sy};
+    return CFBDGraphic_DeviceBlit(device, &window, x + sx, y + sy, rop);
+}
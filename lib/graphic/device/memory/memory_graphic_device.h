@@ -0,0 +1,138 @@
+/**
+ * @file memory_graphic_device.h
+ * @brief Offscreen graphics device backed by a plain memory canvas.
+ * @ingroup Graphics_Device
+ *
+ * @details
+ * A memory device renders into a caller owned buffer laid out like the
+ * SSD130x GRAM (1bpp pages, one byte per column per page) or, for grey
+ * scale panels, like the SSD132x GRAM (4bpp packed rows). Every primitive
+ * and widget draws into it unchanged, because it implements the full
+ * CFBD_GraphicDeviceOperation table and exposes its buffer as "canvas".
+ *
+ * The 1bpp layout is exactly the one expected by `setArea()`, so a
+ * finished memory canvas can be handed to any device as an image.
+ * CFBDGraphic_DrawMemoryCanvas() composes a canvas of either format onto a
+ * device at any offset, e.g. to slide a pre-rendered page in.
+ *
+ * @example
+ * @code
+ * static uint8_t chrome_pixels[CFBDGraphic_MEMORY_CANVAS_BYTES(128, 16)];
+ * CFBDGraphic_MemoryCanvas chrome = {chrome_pixels, 128, 16};
+ * CFBD_GraphicDevice offscreen;
+ *
+ * CFBDGraphic_BindMemoryAsDevice(&offscreen, &chrome);
+ * offscreen.ops->clear(&offscreen);
+ * CFBDGraphic_DrawRect(&offscreen, &frame);
+ *
+ * // later, once per frame
+ * CCGraphic_Image img;
+ * CFBDGraphic_MemoryCanvasAsImage(&chrome, &origin, &img);
+ * CFBDGraphic_DrawImage(panel, &img);
+ *
+ * // grey scale page rendered once, then slid in from the right
+ * static uint8_t page_pixels[CFBDGraphic_MEMORY_CANVAS_4BPP_BYTES(128, 96)];
+ * CFBDGraphic_MemoryCanvas page = {page_pixels, 128, 96, 0, CFBD_CANVAS_4BPP_PACKED};
+ * CFBDGraphic_DrawMemoryCanvas(panel, &page, 128 - step * 16, 0, CFBD_ROP_COPY);
+ * @endcode
+ */
+
+#pragma once
+#include <stdint.h>
+
+#include "base/point.h"
+#include "device/graphic_canvas.h"
+#include "device/graphic_device.h"
+#include "widget/base_support/image.h"
+
+/**
+ * @defgroup Graphics_Memory Memory Graphics Device
+ * @ingroup Graphics_Device
+ * @brief Render targets that live in RAM.
+ * @{
+ */
+
+/**
+ * @def CFBDGraphic_MEMORY_CANVAS_BYTES
+ * @brief Bytes needed by a width x height 1bpp memory canvas.
+ */
+#define CFBDGraphic_MEMORY_CANVAS_BYTES(width, height) ((((height) + 7) / 8) * (width))
+
+/**
+ * @def CFBDGraphic_MEMORY_CANVAS_4BPP_BYTES
+ * @brief Bytes needed by a width x height 4bpp memory canvas.
+ */
+#define CFBDGraphic_MEMORY_CANVAS_4BPP_BYTES(width, height) ((((width) + 1) / 2) * (height))
+
+/**
+ * @struct CFBDGraphic_MemoryCanvas
+ * @brief Caller owned pixel storage of a memory device.
+ */
+typedef struct
+{
+    uint8_t* buffer;   /**< CFBDGraphic_MEMORY_CANVAS_BYTES() (or _4BPP_BYTES()) bytes */
+    uint16_t width;    /**< Width in pixels, also the 1bpp page stride in bytes */
+    uint16_t height;   /**< Rows held by @ref buffer */
+    uint16_t origin_y; /**< Device row of the first buffer row, a multiple of 8; 0 unless banding */
+    CFBDGraphic_CanvasFormat format; /**< Pixel layout, 1bpp pages when left 0 */
+    uint8_t color;                   /**< 4bpp drawing grey level, 0 means full (0x0F) */
+} CFBDGraphic_MemoryCanvas;
+
+/**
+ * @brief Bind a memory canvas to a graphics device.
+ *
+ * @details
+ * `update()` and `update_area()` do nothing, there is no panel behind the
+ * buffer. The device starts in deferred mode with an empty clip stack.
+ *
+ * With a non-zero `origin_y` the buffer is a band: the device reports a
+ * height of `origin_y + height` and silently drops every row above the band,
+ * so primitives keep using panel coordinates.
+ *
+ * A 4bpp canvas answers the "color" property like a grey scale panel.
+ *
+ * @param device Graphics device to populate.
+ * @param canvas Pixel storage, must outlive the device.
+ */
+void CFBDGraphic_BindMemoryAsDevice(CFBD_GraphicDevice* device, CFBDGraphic_MemoryCanvas* canvas);
+
+/**
+ * @brief Describe a memory canvas as an image placed at @p tl_point.
+ *
+ * @details Images are 1bpp; a 4bpp canvas yields an image without pixels,
+ *          draw it with CFBDGraphic_DrawMemoryCanvas() instead.
+ *
+ * @param canvas Memory canvas to wrap (borrowed, not copied).
+ * @param tl_point Where the image is drawn.
+ * @param image Output image.
+ */
+void CFBDGraphic_MemoryCanvasAsImage(CFBDGraphic_MemoryCanvas* canvas,
+                                     const CFBDGraphic_Point* tl_point,
+                                     CCGraphic_Image* image);
+
+/**
+ * @brief Compose a memory canvas onto a device with its top-left at (@p x, @p y).
+ *
+ * @details
+ * The offset may be negative or reach past the screen, only the overlapping
+ * window is copied. A 1bpp canvas goes through CFBDGraphic_DeviceBlit() and
+ * works with every device. A 4bpp canvas needs a 4bpp frame buffer behind
+ * @p device; COPY with matching column parity copies whole bytes per row.
+ * For 4bpp sources SET writes the non-zero pixels only, CLEAR blanks the
+ * pixels under them and XOR toggles grey levels. In immediate mode the
+ * visible part is flushed with a single update_area().
+ *
+ * @param device Target device, e.g. the panel.
+ * @param canvas Pre-rendered canvas.
+ * @param x X coordinate of the canvas's top-left pixel.
+ * @param y Y coordinate of the canvas's top-left pixel.
+ * @param rop How the canvas combines with the device pixels.
+ * @return CFBD_FALSE if nothing is visible or the formats cannot be combined.
+ */
+CFBD_Bool CFBDGraphic_DrawMemoryCanvas(CFBD_GraphicDevice* device,
+                                       const CFBDGraphic_MemoryCanvas* canvas,
+                                       int16_t x,
+                                       int16_t y,
+                                       CFBDGraphic_RasterOp rop);
+
+/** @} */ // end of Graphics_Memory group
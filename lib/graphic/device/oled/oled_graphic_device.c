@@ -1,14 +1,24 @@
 #include "oled_graphic_device.h"
 
 #include <stddef.h>
+#include <string.h>
 
 #include "cfbd_define.h"
+#include "device/graphic_canvas.h"
+#include "device/graphic_clip.h"
+#include "device/graphic_scroll.h"
+#include "device/graphic_transform.h"
 
 static inline CFBD_OLED* _get_oled(CFBD_GraphicDevice* device)
 {
     return (CFBD_OLED*) device->internal_handle;
 }
 
+static inline const CFBDGraphic_ClipBounds* _active_clip(CFBD_GraphicDevice* device)
+{
+    return device->clip.depth ? &device->clip.bounds[device->clip.depth - 1] : NULL;
+}
+
 /* ---------- init ---------- */
 
 static int graphic_oled_init(CFBD_GraphicDevice* device, void* init_args)
@@ -22,7 +32,17 @@ static int graphic_oled_init(CFBD_GraphicDevice* device, void* init_args)
 static CFBD_Bool graphic_oled_setPixel(CFBD_GraphicDevice* device, uint16_t x, uint16_t y)
 {
     CFBD_OLED* oled = _get_oled(device);
-    return oled->ops->setPixel(oled, x, y);
+    if (!CFBDGraphic_DeviceClipContains(device, x, y))
+        return CFBD_TRUE;
+
+    switch (device->rop) {
+        case CFBD_ROP_CLEAR:
+            return oled->ops->clear_area(oled, x, y, 1, 1);
+        case CFBD_ROP_XOR:
+            return oled->ops->revert_area(oled, x, y, 1, 1);
+        default:
+            return oled->ops->setPixel(oled, x, y);
+    }
 }
 
 static CFBD_Bool graphic_oled_drawArea(CFBD_GraphicDevice* device,
@@ -33,8 +53,55 @@ static CFBD_Bool graphic_oled_drawArea(CFBD_GraphicDevice* device,
                                        uint8_t* source)
 {
     CFBD_OLED* oled = _get_oled(device);
-    return oled->ops->setArea(oled, x, y, width, height, source);
+    const CFBDGraphic_ClipBounds* clip = _active_clip(device);
+    if (clip == NULL && device->rop == CFBD_ROP_COPY)
+        return oled->ops->setArea(oled, x, y, width, height, source);
+
+    // combine with the frame buffer directly, the backend can only copy
+    CFBDGraphic_Canvas canvas;
+    if (CFBDGraphic_DeviceFetchCanvas(device, &canvas)) {
+        CFBDGraphic_CanvasBlit(&canvas, x, y, width, height, source);
+        return CFBD_TRUE;
+    }
+    if (clip == NULL)
+        return oled->ops->setArea(oled, x, y, width, height, source);
+
+    uint16_t vx = x, vy = y, vw = width, vh = height;
+    if (!CFBDGraphic_ClipBoundsIntersectArea(clip, &vx, &vy, &vw, &vh))
+        return CFBD_TRUE;
+    if (vx == x && vy == y && vw == width && vh == height)
+        return oled->ops->setArea(oled, x, y, width, height, source);
+
+    // partially visible: copy only the visible window of the source
+    if (device->rop == CFBD_ROP_COPY)
+        oled->ops->clear_area(oled, vx, vy, vw, vh);
+    for (uint16_t i = 0; i < vw; i++) {
+        const uint16_t sx = vx - x + i;
+        for (uint16_t j = 0; j < vh; j++) {
+            const uint16_t sy = vy - y + j;
+            if ((source[(sy / 8) * width + sx] >> (sy % 8)) & 0x01)
+                graphic_oled_setPixel(device, vx + i, vy + j);
+        }
+    }
+    return CFBD_TRUE;
 }
+
+static CFBD_Bool graphic_oled_blit(CFBD_GraphicDevice* device,
+                                   const CFBDGraphic_BlitSource* source,
+                                   uint16_t x,
+                                   uint16_t y,
+                                   CFBDGraphic_RasterOp rop)
+{
+    // without a local frame buffer CFBDGraphic_DeviceBlit() falls back to setPixel()
+    CFBDGraphic_Canvas canvas;
+    if (!CFBDGraphic_DeviceFetchCanvas(device, &canvas))
+        return CFBD_FALSE;
+
+    CFBDGraphic_CanvasSetRasterOp(&canvas, rop);
+    CFBDGraphic_CanvasBlitWindow(&canvas, x, y, source);
+    return CFBD_TRUE;
+}
+
 /* ---------- frame ---------- */
 
 static CFBD_Bool graphic_oled_update(CFBD_GraphicDevice* device)
@@ -63,15 +130,34 @@ graphic_oled_update_area(CFBD_GraphicDevice* device, uint16_t x, uint16_t y, uin
 static CFBD_Bool
 graphic_oled_clear_area(CFBD_GraphicDevice* device, uint16_t x, uint16_t y, uint16_t w, uint16_t h)
 {
+    const CFBDGraphic_ClipBounds* clip = _active_clip(device);
+    if (clip != NULL && !CFBDGraphic_ClipBoundsIntersectArea(clip, &x, &y, &w, &h))
+        return CFBD_TRUE;
     return _get_oled(device)->ops->clear_area(_get_oled(device), x, y, w, h);
 }
 
 static CFBD_Bool
 graphic_oled_revert_area(CFBD_GraphicDevice* device, uint16_t x, uint16_t y, uint16_t w, uint16_t h)
 {
+    const CFBDGraphic_ClipBounds* clip = _active_clip(device);
+    if (clip != NULL && !CFBDGraphic_ClipBoundsIntersectArea(clip, &x, &y, &w, &h))
+        return CFBD_TRUE;
     return _get_oled(device)->ops->revert_area(_get_oled(device), x, y, w, h);
 }
 
+static CFBD_Bool graphic_oled_stream_area(CFBD_GraphicDevice* device,
+                                          uint16_t x,
+                                          uint16_t y,
+                                          uint16_t w,
+                                          uint16_t h,
+                                          const uint8_t* source)
+{
+    CFBD_OLED* oled = _get_oled(device);
+    if (oled->ops->stream_area == NULL)
+        return CFBD_FALSE;
+    return oled->ops->stream_area(oled, x, y, w, h, source);
+}
+
 /* ---------- lifecycle ---------- */
 
 static CFBD_Bool graphic_oled_open(CFBD_GraphicDevice* device)
@@ -86,19 +172,95 @@ static CFBD_Bool graphic_oled_close(CFBD_GraphicDevice* device)
 
 /* ---------- query ---------- */
 
+static CFBD_Bool graphic_oled_fetch_canvas(CFBD_GraphicDevice* device, CFBDGraphic_Canvas* canvas)
+{
+    CFBD_OLEDFrameBuffer fb;
+    if (!_get_oled(device)->ops->self_consult(_get_oled(device), "framebuffer", NULL, &fb))
+        return CFBD_FALSE;
+
+    switch (fb.bits_per_pixel) {
+        case 1:
+            canvas->format = CFBD_CANVAS_1BPP_PAGE;
+            break;
+        case 4:
+            canvas->format = CFBD_CANVAS_4BPP_PACKED;
+            break;
+        default:
+            return CFBD_FALSE;
+    }
+
+    canvas->buffer = fb.gram;
+    canvas->stride = fb.stride;
+    canvas->width = fb.width;
+    canvas->height = fb.height;
+    canvas->color = fb.color;
+    return CFBD_TRUE;
+}
+
 static CFBD_Bool graphic_oled_self_consult(CFBD_GraphicDevice* device,
                                            const char* property,
                                            void* args,
                                            void* request_data)
 {
+    if (strcmp("canvas", property) == 0)
+        return graphic_oled_fetch_canvas(device, (CFBDGraphic_Canvas*) request_data);
+
     return _get_oled(device)->ops->self_consult(_get_oled(device), property, args, request_data);
 }
 
+static CFBD_Bool graphic_oled_set_transform(CFBD_GraphicDevice* device,
+                                             CFBDGraphic_Transform transform)
+{
+    uint8_t remap;
+    switch (transform) {
+        case CFBD_TRANSFORM_NONE:
+            remap = 0;
+            break;
+        case CFBD_TRANSFORM_MIRROR_X:
+            remap = CFBD_OLED_REMAP_SEGMENT;
+            break;
+        case CFBD_TRANSFORM_MIRROR_Y:
+            remap = CFBD_OLED_REMAP_COM;
+            break;
+        case CFBD_TRANSFORM_ROTATE_180:
+            remap = CFBD_OLED_REMAP_SEGMENT | CFBD_OLED_REMAP_COM;
+            break;
+        default:
+            return CFBD_FALSE;
+    }
+    return _get_oled(device)->ops->self_property_setter(_get_oled(device), "remap", NULL, &remap);
+}
+
+static CFBD_Bool graphic_oled_set_scroll(CFBD_GraphicDevice* device,
+                                          const CFBDGraphic_HardwareScroll* scroll)
+{
+    CFBD_OLEDScroll oled_scroll = {CFBD_OLED_SCROLL_STOP,
+                                   scroll->x,
+                                   scroll->y,
+                                   scroll->width,
+                                   scroll->height,
+                                   scroll->frames,
+                                   scroll->rows};
+    if (scroll->direction == CFBD_HW_SCROLL_LEFT)
+        oled_scroll.direction = CFBD_OLED_SCROLL_LEFT;
+    else if (scroll->direction == CFBD_HW_SCROLL_RIGHT)
+        oled_scroll.direction = CFBD_OLED_SCROLL_RIGHT;
+    return _get_oled(device)->ops->self_property_setter(_get_oled(device),
+                                                        "scroll",
+                                                        NULL,
+                                                        &oled_scroll);
+}
+
 static CFBD_Bool graphic_oled_self_sets(CFBD_GraphicDevice* device,
                                         const char* property,
                                         void* args,
                                         void* request_data)
 {
+    if (strcmp("transform", property) == 0)
+        return graphic_oled_set_transform(device, *(CFBDGraphic_Transform*) request_data);
+    if (strcmp("scroll", property) == 0)
+        return graphic_oled_set_scroll(device, (const CFBDGraphic_HardwareScroll*) request_data);
+
     return _get_oled(device)->ops->self_property_setter(_get_oled(device),
                                                         property,
                                                         args,
@@ -116,6 +278,8 @@ static CFBD_GraphicDeviceOperation graphic_oled_ops = {.init = graphic_oled_init
                                                        .update_area = graphic_oled_update_area,
                                                        .clear_area = graphic_oled_clear_area,
                                                        .revert_area = graphic_oled_revert_area,
+                                                       .stream_area = graphic_oled_stream_area,
+                                                       .blit = graphic_oled_blit,
 
                                                        .open = graphic_oled_open,
                                                        .close = graphic_oled_close,
@@ -131,4 +295,6 @@ void CFBDGraphic_BindOLEDAsDevice(CFBD_GraphicDevice* device, CFBD_OLED* oled)
     device->ops = &graphic_oled_ops;
     device->device_type = OLED;
     device->internal_handle = (CFBDGraphicDeviceHandle) oled;
+    CFBDGraphic_ResetClip(device);
+    CFBDGraphic_DeviceResetDrawState(device);
 }
\ No newline at end of file
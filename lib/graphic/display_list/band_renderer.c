@@ -0,0 +1,46 @@
+#include "band_renderer.h"
+
+#include <stddef.h>
+
+#include "base/rectangle.h"
+#include "base/size.h"
+
+CFBD_Bool CFBDGraphic_BandRender(CFBD_GraphicDevice* panel,
+                                 const CFBDGraphic_DisplayList* list,
+                                 uint8_t* band,
+                                 uint16_t band_rows)
+{
+    if (panel == NULL || list == NULL || band == NULL)
+        return CFBD_FALSE;
+    if (panel->ops->stream_area == NULL || band_rows == 0 || band_rows % 8 != 0)
+        return CFBD_FALSE;
+
+    CFBDGraphicSize screen;
+    CFBDGraphic_GetScreenSize(panel, &screen);
+
+    CFBDGraphic_MemoryCanvas canvas = {.buffer = band,
+                                       .width = screen.width,
+                                       .height = band_rows,
+                                       .origin_y = 0,
+                                       .format = CFBD_CANVAS_1BPP_PAGE};
+    CFBD_GraphicDevice offscreen;
+    CFBDGraphic_BindMemoryAsDevice(&offscreen, &canvas);
+    // 带缓冲按面板的绘制状态回放，与直接绘制一致
+    CFBDGraphic_DeviceSetRasterOp(&offscreen, CFBDGraphic_DeviceGetRasterOp(panel));
+    CFBDGraphic_DeviceSetClearBeforeDraw(&offscreen, CFBDGraphic_DeviceGetClearBeforeDraw(panel));
+
+    for (uint16_t top = 0; top < screen.height; top += band_rows) {
+        // 带缓冲保存 top 起的若干行，图元仍使用屏幕坐标
+        canvas.origin_y = top;
+        canvas.height = (screen.height - top < band_rows) ? (screen.height - top) : band_rows;
+        offscreen.ops->clear(&offscreen);
+
+        CFBDGraphicRect rows = {{0, top}, {screen.width - 1, top + canvas.height - 1}};
+        CFBDGraphic_DisplayListReplay(&offscreen, list, &rows);
+
+        if (!panel->ops->stream_area(panel, 0, top, screen.width, canvas.height, band))
+            return CFBD_FALSE;
+    }
+
+    return CFBD_TRUE;
+}
@@ -0,0 +1,68 @@
+/**
+ * @file band_renderer.h
+ * @brief Frame buffer-less rendering: replay a display list band by band.
+ * @ingroup Graphics_DisplayList
+ *
+ * @details
+ * A full frame costs 1 KB on SSD130x panels and 6 KB on a 128x96 SSD132x
+ * panel, which is more than the smallest parts can spare. The band renderer
+ * keeps only a few rows in RAM: for every band it clears the band buffer,
+ * replays the commands of the frame that touch those rows into it, and
+ * streams the band straight to the panel through `ops->stream_area`.
+ *
+ * CPU time grows with the number of bands (every band decodes the list
+ * header of each command once), RAM shrinks to
+ * CFBDGraphic_BAND_BYTES(width, rows). Combine with CFBD_OLED_LOCAL_GRAM = 0
+ * to drop the backend frame buffer altogether.
+ *
+ * @example
+ * @code
+ * static uint8_t band[CFBDGraphic_BAND_BYTES(128, 8)];  // one page: 128 bytes
+ *
+ * CFBDGraphic_DisplayListReset(&frame);
+ * record_status_screen(&frame);
+ * CFBDGraphic_BandRender(device, &frame, band, 8);
+ * @endcode
+ */
+
+#pragma once
+#include <stdint.h>
+
+#include "cfbd_define.h"
+#include "device/graphic_device.h"
+#include "device/memory/memory_graphic_device.h"
+#include "display_list.h"
+
+/**
+ * @addtogroup Graphics_DisplayList
+ * @{
+ */
+
+/**
+ * @def CFBDGraphic_BAND_BYTES
+ * @brief Bytes needed by a band of @p rows rows (a multiple of 8).
+ */
+#define CFBDGraphic_BAND_BYTES(width, rows) CFBDGraphic_MEMORY_CANVAS_BYTES(width, rows)
+
+/**
+ * @brief Render a whole frame band by band and stream it to the panel.
+ *
+ * @details
+ * Every pixel of the panel is written, rows not covered by any command
+ * come out blank. The local frame buffer of the panel is not touched.
+ * Bands are drawn with the raster op and clear-before-draw setting of
+ * @p panel, so the frame matches a direct replay onto a cleared panel.
+ *
+ * @param panel Device implementing `ops->stream_area`.
+ * @param list Commands making up the frame.
+ * @param band Band storage, CFBDGraphic_BAND_BYTES(panel width, band_rows) bytes.
+ * @param band_rows Rows per band, a non-zero multiple of 8.
+ * @return CFBD_FALSE if the panel cannot stream, @p band_rows is invalid or a
+ *         band transfer failed.
+ */
+CFBD_Bool CFBDGraphic_BandRender(CFBD_GraphicDevice* panel,
+                                 const CFBDGraphic_DisplayList* list,
+                                 uint8_t* band,
+                                 uint16_t band_rows);
+
+/** @} */
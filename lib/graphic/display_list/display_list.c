@@ -0,0 +1,398 @@
+#include "display_list.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#include "base/size.h"
+#include "device/graphic_clip.h"
+#include "widget/text.h"
+#include "widget/text_font.h"
+
+#define DISPLAY_HEADER_SIZE (10)
+
+typedef struct
+{
+    uint8_t opcode;
+    CFBDGraphic_ClipBounds box;
+    const uint8_t* payload;
+} DisplayCommand;
+
+static inline void put_u16(uint8_t* dst, uint16_t v)
+{
+    dst[0] = (uint8_t) (v & 0xFF);
+    dst[1] = (uint8_t) (v >> 8);
+}
+
+static inline uint16_t get_u16(const uint8_t* src)
+{
+    return (uint16_t) (src[0] | (src[1] << 8));
+}
+
+static inline int32_t clamp_box_low(int32_t v)
+{
+    return v < 0 ? 0 : v;
+}
+
+static inline int32_t clamp_box_high(int32_t v)
+{
+    return v > UINT16_MAX ? UINT16_MAX : v;
+}
+
+static void set_empty_bounds(CFBDGraphic_ClipBounds* bounds)
+{
+    bounds->x0 = UINT16_MAX;
+    bounds->y0 = UINT16_MAX;
+    bounds->x1 = 0;
+    bounds->y1 = 0;
+}
+
+static inline CFBD_Bool
+boxes_overlap(const CFBDGraphic_ClipBounds* a, const CFBDGraphic_ClipBounds* b)
+{
+    return a->x0 <= b->x1 && b->x0 <= a->x1 && a->y0 <= b->y1 && b->y0 <= a->y1;
+}
+
+/* Reserve a command, write its header and return the payload, NULL if full */
+static uint8_t* begin_command(CFBDGraphic_DisplayList* list,
+                              CFBDGraphic_DisplayOpcode opcode,
+                              uint16_t payload_size,
+                              int32_t lx,
+                              int32_t ty,
+                              int32_t rx,
+                              int32_t by)
+{
+    const uint16_t size = DISPLAY_HEADER_SIZE + payload_size;
+    if (size > UINT8_MAX || list->capacity - list->used < size) {
+        list->overflow = CFBD_TRUE;
+        return NULL;
+    }
+
+    CFBDGraphic_ClipBounds box = {(uint16_t) clamp_box_low(lx),
+                                  (uint16_t) clamp_box_low(ty),
+                                  (uint16_t) clamp_box_high(rx),
+                                  (uint16_t) clamp_box_high(by)};
+
+    uint8_t* cmd = &list->buffer[list->used];
+    cmd[0] = (uint8_t) opcode;
+    cmd[1] = (uint8_t) size;
+    put_u16(&cmd[2], box.x0);
+    put_u16(&cmd[4], box.y0);
+    put_u16(&cmd[6], box.x1);
+    put_u16(&cmd[8], box.y1);
+
+    if (box.x0 < list->bounds.x0)
+        list->bounds.x0 = box.x0;
+    if (box.y0 < list->bounds.y0)
+        list->bounds.y0 = box.y0;
+    if (box.x1 > list->bounds.x1)
+        list->bounds.x1 = box.x1;
+    if (box.y1 > list->bounds.y1)
+        list->bounds.y1 = box.y1;
+
+    list->used += size;
+    list->count++;
+    return &cmd[DISPLAY_HEADER_SIZE];
+}
+
+void CFBDGraphic_DisplayListInit(CFBDGraphic_DisplayList* list, uint8_t* buffer, uint16_t capacity)
+{
+    list->buffer = buffer;
+    list->capacity = capacity;
+    CFBDGraphic_DisplayListReset(list);
+}
+
+void CFBDGraphic_DisplayListReset(CFBDGraphic_DisplayList* list)
+{
+    list->used = 0;
+    list->count = 0;
+    list->overflow = CFBD_FALSE;
+    set_empty_bounds(&list->bounds);
+}
+
+/* ---------- recording ---------- */
+
+CFBD_Bool CFBDGraphic_DisplayListLine(CFBDGraphic_DisplayList* list, const CFBDGraphic_Line* line)
+{
+    const CFBDGraphic_Point* a = &line->p_left;
+    const CFBDGraphic_Point* b = &line->p_right;
+    uint8_t* payload = begin_command(list,
+                                     CFBD_DISPLAY_LINE,
+                                     8,
+                                     a->x < b->x ? a->x : b->x,
+                                     a->y < b->y ? a->y : b->y,
+                                     a->x > b->x ? a->x : b->x,
+                                     a->y > b->y ? a->y : b->y);
+    if (payload == NULL)
+        return CFBD_FALSE;
+
+    put_u16(&payload[0], a->x);
+    put_u16(&payload[2], a->y);
+    put_u16(&payload[4], b->x);
+    put_u16(&payload[6], b->y);
+    return CFBD_TRUE;
+}
+
+static CFBD_Bool record_rect(CFBDGraphic_DisplayList* list,
+                             CFBDGraphic_DisplayOpcode opcode,
+                             const CFBDGraphicRect* rect)
+{
+    CFBDGraphicRect n = rect_normalize(*rect);
+    return begin_command(list, opcode, 0, n.tl.x, n.tl.y, n.br.x, n.br.y) != NULL;
+}
+
+CFBD_Bool CFBDGraphic_DisplayListRect(CFBDGraphic_DisplayList* list, const CFBDGraphicRect* rect)
+{
+    return record_rect(list, CFBD_DISPLAY_RECT, rect);
+}
+
+CFBD_Bool CFBDGraphic_DisplayListFillRect(CFBDGraphic_DisplayList* list,
+                                          const CFBDGraphicRect* rect)
+{
+    return record_rect(list, CFBD_DISPLAY_FILL_RECT, rect);
+}
+
+static CFBD_Bool record_circle(CFBDGraphic_DisplayList* list,
+                               CFBDGraphic_DisplayOpcode opcode,
+                               const CFBDGraphicCircle* circle)
+{
+    const int32_t cx = circle->center.x;
+    const int32_t cy = circle->center.y;
+    const int32_t r = circle->radius;
+    uint8_t* payload = begin_command(list, opcode, 6, cx - r, cy - r, cx + r, cy + r);
+    if (payload == NULL)
+        return CFBD_FALSE;
+
+    put_u16(&payload[0], circle->center.x);
+    put_u16(&payload[2], circle->center.y);
+    put_u16(&payload[4], circle->radius);
+    return CFBD_TRUE;
+}
+
+CFBD_Bool CFBDGraphic_DisplayListCircle(CFBDGraphic_DisplayList* list,
+                                        const CFBDGraphicCircle* circle)
+{
+    return record_circle(list, CFBD_DISPLAY_CIRCLE, circle);
+}
+
+CFBD_Bool CFBDGraphic_DisplayListFilledCircle(CFBDGraphic_DisplayList* list,
+                                              const CFBDGraphicCircle* circle)
+{
+    return record_circle(list, CFBD_DISPLAY_FILLED_CIRCLE, circle);
+}
+
+CFBD_Bool CFBDGraphic_DisplayListText(CFBDGraphic_DisplayList* list,
+                                      const CFBDGraphic_Point* tl_point,
+                                      const char* text,
+                                      Ascii_Font_Size font)
+{
+    const size_t len = strlen(text);
+    if (len == 0)
+        return CFBD_TRUE;
+    if (len > CFBD_DISPLAY_LIST_MAX_TEXT) {
+        list->overflow = CFBD_TRUE;
+        return CFBD_FALSE;
+    }
+
+    // one cell per code point, not per byte
+    int32_t cells = 0;
+    for (const char* cursor = text; CFBDGraphic_DecodeUTF8(&cursor) != 0;)
+        cells++;
+
+    const CFBDGraphicSize glyph = __fetch_font_size(font);
+    const int32_t lx = tl_point->x;
+    const int32_t ty = tl_point->y;
+    uint8_t* payload = begin_command(list,
+                                     CFBD_DISPLAY_TEXT,
+                                     (uint16_t) (len + 2),
+                                     lx,
+                                     ty,
+                                     lx + cells * glyph.width - 1,
+                                     ty + glyph.height - 1);
+    if (payload == NULL)
+        return CFBD_FALSE;
+
+    payload[0] = (uint8_t) font;
+    memcpy(&payload[1], text, len + 1);
+    return CFBD_TRUE;
+}
+
+CFBD_Bool CFBDGraphic_DisplayListImage(CFBDGraphic_DisplayList* list, const CCGraphic_Image* image)
+{
+    const int32_t lx = image->point.x;
+    const int32_t ty = image->point.y;
+    if (image->sources_register == NULL || image->image_size.width == 0 ||
+        image->image_size.height == 0)
+        return CFBD_TRUE;
+
+    uint8_t* payload = begin_command(list,
+                                     CFBD_DISPLAY_IMAGE,
+                                     5 + sizeof(const uint8_t*),
+                                     lx,
+                                     ty,
+                                     lx + image->image_size.width - 1,
+                                     ty + image->image_size.height - 1);
+    if (payload == NULL)
+        return CFBD_FALSE;
+
+    put_u16(&payload[0], image->image_size.width);
+    put_u16(&payload[2], image->image_size.height);
+    payload[4] = image->encoding;
+    const uint8_t* bitmap = image->sources_register;
+    memcpy(&payload[5], &bitmap, sizeof(bitmap));
+    return CFBD_TRUE;
+}
+
+/* ---------- replay ---------- */
+
+/*
+    Draw one command shifted by (-dx, -dy). Every coordinate of a command is
+    at least its box corner, so shifting by the list origin never underflows.
+*/
+static void draw_command(CFBD_GraphicDevice* device,
+                         const DisplayCommand* cmd,
+                         uint16_t dx,
+                         uint16_t dy)
+{
+    const uint8_t* p = cmd->payload;
+    CFBDGraphicRect rect = {{cmd->box.x0 - dx, cmd->box.y0 - dy},
+                            {cmd->box.x1 - dx, cmd->box.y1 - dy}};
+
+    switch (cmd->opcode) {
+        case CFBD_DISPLAY_LINE: {
+            CFBDGraphic_Line line = {{get_u16(&p[0]) - dx, get_u16(&p[2]) - dy},
+                                     {get_u16(&p[4]) - dx, get_u16(&p[6]) - dy}};
+            CFBDGraphic_DrawLine(device, &line);
+        } break;
+        case CFBD_DISPLAY_RECT:
+            CFBDGraphic_DrawRect(device, &rect);
+            break;
+        case CFBD_DISPLAY_FILL_RECT:
+            CFBDGraphic_FillRect(device, &rect);
+            break;
+        case CFBD_DISPLAY_CIRCLE:
+        case CFBD_DISPLAY_FILLED_CIRCLE: {
+            CFBDGraphicCircle circle = {.radius = get_u16(&p[4]),
+                                        .center = {get_u16(&p[0]) - dx, get_u16(&p[2]) - dy}};
+            if (cmd->opcode == CFBD_DISPLAY_CIRCLE)
+                CFBDGraphic_DrawCircle(device, &circle);
+            else
+                CFBDGraphic_DrawFilledCircle(device, &circle);
+        } break;
+        case CFBD_DISPLAY_TEXT: {
+            CFBDGraphic_Text text;
+            CFBDGraphicSize area = {rect.br.x - rect.tl.x + 1, rect.br.y - rect.tl.y + 1};
+            CFBDGraphic_InitText(&text, rect.tl, area, (Ascii_Font_Size) p[0]);
+            text.no_wrap = CFBD_TRUE;
+            CFBDGraphic_SetText(&text, (char*) &p[1]);
+            CFBDGraphic_DrawText(device, &text, CCGraphic_AsciiTextItem_AppendContinously);
+        } break;
+        case CFBD_DISPLAY_IMAGE: {
+            CCGraphic_Image image;
+            image.point = rect.tl;
+            image.image_size.width = get_u16(&p[0]);
+            image.image_size.height = get_u16(&p[2]);
+            image.encoding = p[4];
+            memcpy(&image.sources_register, &p[5], sizeof(uint8_t*));
+            CFBDGraphic_DrawImage(device, &image);
+        } break;
+        default:
+            break;
+    }
+}
+
+/* visible is given in list coordinates */
+static uint16_t replay_commands(CFBD_GraphicDevice* device,
+                                const CFBDGraphic_DisplayList* list,
+                                const CFBDGraphic_ClipBounds* visible,
+                                uint16_t dx,
+                                uint16_t dy)
+{
+    uint16_t drawn = 0;
+    uint16_t offset = 0;
+    while (offset + DISPLAY_HEADER_SIZE <= list->used) {
+        const uint8_t* raw = &list->buffer[offset];
+        DisplayCommand cmd = {raw[0],
+                              {get_u16(&raw[2]), get_u16(&raw[4]), get_u16(&raw[6]), get_u16(&raw[8])},
+                              &raw[DISPLAY_HEADER_SIZE]};
+        offset += raw[1];
+
+        if (!boxes_overlap(&cmd.box, visible))
+            continue;
+        draw_command(device, &cmd, dx, dy);
+        drawn++;
+    }
+    return drawn;
+}
+
+uint16_t CFBDGraphic_DisplayListReplay(CFBD_GraphicDevice* device,
+                                       const CFBDGraphic_DisplayList* list,
+                                       const CFBDGraphicRect* region)
+{
+    if (device == NULL || list == NULL || list->count == 0)
+        return 0;
+
+    // 先以区域压栈，越过区域边缘的命令由裁剪栈截断
+    const CFBD_Bool pushed = region != NULL && CFBDGraphic_PushClip(device, region);
+    CFBDGraphic_ClipBounds visible;
+    uint16_t drawn = 0;
+
+    if (CFBDGraphic_FetchClipBounds(device, &visible)) {
+        if (region != NULL && !pushed) {
+            // 裁剪栈已满：仍按区域剔除，只是不截断跨边界的命令
+            CFBDGraphicRect n = rect_normalize(*region);
+            if (n.tl.x > visible.x0)
+                visible.x0 = n.tl.x;
+            if (n.tl.y > visible.y0)
+                visible.y0 = n.tl.y;
+            if (n.br.x < visible.x1)
+                visible.x1 = n.br.x;
+            if (n.br.y < visible.y1)
+                visible.y1 = n.br.y;
+        }
+
+        const CFBD_Bool immediate = CFBDGraphic_DeviceRequestUpdateAtOnce(device);
+        CFBDGraphic_DeviceSetIfRequestUpdateAtOnce(device, CFBD_FALSE);
+        if (!CFBDGraphic_ClipBoundsIsEmpty(&visible))
+            drawn = replay_commands(device, list, &visible, 0, 0);
+        CFBDGraphic_DeviceSetIfRequestUpdateAtOnce(device, immediate);
+
+        // 整个列表只刷新一次
+        uint16_t x = visible.x0, y = visible.y0;
+        uint16_t w = visible.x1 - visible.x0 + 1, h = visible.y1 - visible.y0 + 1;
+        if (immediate && drawn != 0 &&
+            CFBDGraphic_ClipBoundsIntersectArea(&list->bounds, &x, &y, &w, &h)) {
+            device->ops->update_area(device, x, y, w, h);
+        }
+    }
+
+    if (pushed)
+        CFBDGraphic_PopClip(device);
+    return drawn;
+}
+
+CFBD_Bool CFBDGraphic_DisplayListBake(const CFBDGraphic_DisplayList* list,
+                                      CFBDGraphic_MemoryCanvas* canvas,
+                                      CCGraphic_Image* baked)
+{
+    if (list == NULL || canvas == NULL || canvas->buffer == NULL || list->count == 0)
+        return CFBD_FALSE;
+    if (canvas->format != CFBD_CANVAS_1BPP_PAGE)
+        return CFBD_FALSE;
+
+    CFBD_GraphicDevice offscreen;
+    canvas->origin_y = 0;
+    CFBDGraphic_BindMemoryAsDevice(&offscreen, canvas);
+    offscreen.ops->clear(&offscreen);
+
+    const uint16_t dx = list->bounds.x0;
+    const uint16_t dy = list->bounds.y0;
+    const CFBDGraphic_ClipBounds visible = {dx,
+                                            dy,
+                                            (uint16_t) clamp_box_high(dx + canvas->width - 1),
+                                            (uint16_t) clamp_box_high(dy + canvas->height - 1)};
+    replay_commands(&offscreen, list, &visible, dx, dy);
+
+    CFBDGraphic_Point origin = {dx, dy};
+    CFBDGraphic_MemoryCanvasAsImage(canvas, &origin, baked);
+    return CFBD_TRUE;
+}
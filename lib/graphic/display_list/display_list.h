@@ -0,0 +1,175 @@
+/**
+ * @file display_list.h
+ * @brief Recorded display lists: capture draw calls once, replay them many times.
+ * @ingroup Graphics_DisplayList
+ *
+ * @details
+ * Static UI chrome (frames, separators, captions, icons) is usually redrawn
+ * every frame by calling dozens of `CFBDGraphic_Draw*` functions. A display
+ * list records those calls into a compact byte-coded buffer instead. Every
+ * command carries its precomputed bounding box, so replaying the list
+ * against a dirty or clip region skips everything outside of it without
+ * decoding the primitive.
+ *
+ * A list can also be baked once into a memory canvas
+ * (see memory_graphic_device.h); drawing the static part of a screen then
+ * costs a single image blit per frame.
+ *
+ * Command encoding (little endian):
+ * | bytes | content                                   |
+ * |-------|-------------------------------------------|
+ * | 1     | opcode (CFBDGraphic_DisplayOpcode)        |
+ * | 1     | total command size in bytes               |
+ * | 8     | bounding box x0, y0, x1, y1 (inclusive)   |
+ * | n     | opcode specific payload                   |
+ *
+ * @example
+ * @code
+ * static uint8_t chrome_storage[256];
+ * CFBDGraphic_DisplayList chrome;
+ *
+ * CFBDGraphic_DisplayListInit(&chrome, chrome_storage, sizeof(chrome_storage));
+ * CFBDGraphic_DisplayListRect(&chrome, &frame);
+ * CFBDGraphic_DisplayListText(&chrome, &title_pos, "Settings", ASCII_6x8);
+ *
+ * // every frame: only the commands touching the dirty rows are drawn
+ * CFBDGraphic_DisplayListReplay(device, &chrome, &dirty);
+ * @endcode
+ */
+
+#pragma once
+#include <stdint.h>
+
+#include "base/circle.h"
+#include "base/line.h"
+#include "base/rectangle.h"
+#include "cfbd_define.h"
+#include "device/graphic_device.h"
+#include "device/memory/memory_graphic_device.h"
+#include "widget/base_support/image.h"
+#include "widget/text_config.h"
+
+/**
+ * @defgroup Graphics_DisplayList Display Lists
+ * @ingroup Graphics
+ * @brief Record, cull and replay primitive draw calls.
+ * @{
+ */
+
+/**
+ * @def CFBD_DISPLAY_LIST_MAX_TEXT
+ * @brief Longest string a single text command can hold.
+ */
+#define CFBD_DISPLAY_LIST_MAX_TEXT (200)
+
+/**
+ * @enum CFBDGraphic_DisplayOpcode
+ * @brief Commands a display list can hold.
+ */
+typedef enum
+{
+    CFBD_DISPLAY_LINE = 1,        /**< payload: x0, y0, x1, y1 */
+    CFBD_DISPLAY_RECT,            /**< payload: none, the box is the rectangle */
+    CFBD_DISPLAY_FILL_RECT,       /**< payload: none, the box is the rectangle */
+    CFBD_DISPLAY_CIRCLE,          /**< payload: cx, cy, radius */
+    CFBD_DISPLAY_FILLED_CIRCLE,   /**< payload: cx, cy, radius */
+    CFBD_DISPLAY_TEXT,            /**< payload: font, zero terminated string */
+    CFBD_DISPLAY_IMAGE            /**< payload: width, height, encoding, bitmap pointer */
+} CFBDGraphic_DisplayOpcode;
+
+/**
+ * @struct CFBDGraphic_DisplayList
+ * @brief Byte-coded command buffer plus the union of all command boxes.
+ */
+typedef struct
+{
+    uint8_t* buffer;               /**< Caller owned command storage */
+    uint16_t capacity;             /**< Size of @ref buffer in bytes */
+    uint16_t used;                 /**< Bytes holding recorded commands */
+    uint16_t count;                /**< Number of recorded commands */
+    CFBD_Bool overflow;            /**< Set once a command did not fit */
+    CFBDGraphic_ClipBounds bounds; /**< Union of every command box, empty if count is 0 */
+} CFBDGraphic_DisplayList;
+
+/**
+ * @brief Attach storage to a display list and empty it.
+ */
+void CFBDGraphic_DisplayListInit(CFBDGraphic_DisplayList* list, uint8_t* buffer, uint16_t capacity);
+
+/**
+ * @brief Drop every recorded command, the storage is kept.
+ */
+void CFBDGraphic_DisplayListReset(CFBDGraphic_DisplayList* list);
+
+/**
+ * @name Recording
+ * Each recorder returns CFBD_FALSE (and sets @ref CFBDGraphic_DisplayList::overflow)
+ * when the command does not fit into the remaining storage.
+ * @{
+ */
+CFBD_Bool CFBDGraphic_DisplayListLine(CFBDGraphic_DisplayList* list, const CFBDGraphic_Line* line);
+CFBD_Bool CFBDGraphic_DisplayListRect(CFBDGraphic_DisplayList* list, const CFBDGraphicRect* rect);
+CFBD_Bool CFBDGraphic_DisplayListFillRect(CFBDGraphic_DisplayList* list,
+                                          const CFBDGraphicRect* rect);
+CFBD_Bool CFBDGraphic_DisplayListCircle(CFBDGraphic_DisplayList* list,
+                                        const CFBDGraphicCircle* circle);
+CFBD_Bool CFBDGraphic_DisplayListFilledCircle(CFBDGraphic_DisplayList* list,
+                                              const CFBDGraphicCircle* circle);
+
+/**
+ * @brief Record a single line of text.
+ *
+ * @details
+ * The string is copied into the list (at most CFBD_DISPLAY_LIST_MAX_TEXT
+ * characters) and replayed without wrapping.
+ */
+CFBD_Bool CFBDGraphic_DisplayListText(CFBDGraphic_DisplayList* list,
+                                      const CFBDGraphic_Point* tl_point,
+                                      const char* text,
+                                      Ascii_Font_Size font);
+
+/**
+ * @brief Record an image.
+ *
+ * @note Only the bitmap pointer is stored, the bitmap must outlive the list.
+ */
+CFBD_Bool CFBDGraphic_DisplayListImage(CFBDGraphic_DisplayList* list, const CCGraphic_Image* image);
+/** @} */
+
+/**
+ * @brief Replay a display list onto a device.
+ *
+ * @details
+ * Commands whose bounding box misses the visible region (@p region limited
+ * by the device clip) are skipped without being decoded further. Commands
+ * that cross the region edge are clipped to it. Immediate mode is suspended
+ * during the replay and the touched area is flushed once at the end.
+ *
+ * @param device Target device.
+ * @param list Recorded commands.
+ * @param region Dirty region with inclusive corners, NULL for the whole device.
+ * @return Number of commands actually drawn.
+ */
+uint16_t CFBDGraphic_DisplayListReplay(CFBD_GraphicDevice* device,
+                                       const CFBDGraphic_DisplayList* list,
+                                       const CFBDGraphicRect* region);
+
+/**
+ * @brief Render a display list into a memory canvas once.
+ *
+ * @details
+ * The canvas origin is placed at the top-left corner of the list bounds, so
+ * the canvas only needs to be as large as the recorded content. The
+ * returned image places the canvas back at that corner; drawing it with
+ * CFBDGraphic_DrawImage() reproduces the list in one blit.
+ *
+ * @param list Recorded commands.
+ * @param canvas Offscreen 1bpp storage, content beyond its size is cut.
+ * @param baked Output image referencing @p canvas.
+ * @return CFBD_FALSE if the list is empty or @p canvas is not 1bpp.
+ */
+CFBD_Bool CFBDGraphic_DisplayListBake(const CFBDGraphic_DisplayList* list,
+                                      CFBDGraphic_MemoryCanvas* canvas,
+                                      CCGraphic_Image* baked);
+
+/** @} */ // end of Graphics_DisplayList group
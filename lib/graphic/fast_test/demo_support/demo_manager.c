@@ -3,6 +3,28 @@
 #include "device/graphic_device.h"
 #include "sys_clock/system_clock.h"
 
+static CFBDGraphic_TransitionEffect demo_transition = CFBD_TRANSITION_FADE;
+static CFBD_BaseAnimation demo_transition_timing = {.anim_frames = 8, .anim_frame_delay_ms = 25};
+
+void CFBD_DemoManager_SetTransition(CFBDGraphic_TransitionEffect effect,
+                                    const CFBD_BaseAnimation* timing)
+{
+    demo_transition = effect;
+    demo_transition_timing = *timing;
+}
+
+/* Blank the screen for the next demo, only the first one starts from clear() + update() */
+static void blank_screen(CFBD_GraphicDevice* dev, CFBD_Bool first)
+{
+    if (first || demo_transition_timing.anim_frames == 0) {
+        dev->ops->clear(dev);
+        dev->ops->update(dev);
+        return;
+    }
+    // 过渡到空白页, 只发送变化的列
+    CFBDGraphic_PlayTransition(dev, demo_transition, NULL, 0, 0, &demo_transition_timing);
+}
+
 /**
  * @brief Run demo list according to mode
  */
@@ -23,8 +45,7 @@ void CFBD_DemoManager_Run(CFBD_GraphicDevice* dev,
 
         case CFBD_DEMO_RUN_QUEUE:
             for (uint32_t i = 0; i < demo_count; ++i) {
-                dev->ops->clear(dev);
-                dev->ops->update(dev);
+                blank_screen(dev, i == 0);
                 demos[i].entry(dev);
                 if (demos[i].duration > 0) {
                     system_delay_ms(demos[i].duration);
@@ -32,17 +53,18 @@ void CFBD_DemoManager_Run(CFBD_GraphicDevice* dev,
             }
             break;
 
-        case CFBD_DEMO_RUN_LOOP:
+        case CFBD_DEMO_RUN_LOOP: {
+            CFBD_Bool first = CFBD_TRUE;
             while (1) {
                 for (uint32_t i = 0; i < demo_count; ++i) {
-                    dev->ops->clear(dev);
-                    dev->ops->update(dev);
+                    blank_screen(dev, first);
+                    first = CFBD_FALSE;
                     demos[i].entry(dev);
                     if (demos[i].duration > 0) {
                         system_delay_ms(demos[i].duration);
                     }
                 }
             }
-            break;
+        } break;
     }
 }
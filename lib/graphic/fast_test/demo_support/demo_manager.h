@@ -10,6 +10,8 @@
  *  - Run a single specified demo
  *  - Run demos sequentially (queue mode)
  *  - Run demos in circular rotation (loop mode)
+ *  - Switch between queued demos with a screen transition instead of a
+ *    blank frame (see transition.h)
  *
  * Design goals:
  *  - No dynamic memory allocation
@@ -20,6 +22,7 @@
 #include <stdint.h>
 
 #include "cfbd_graphic_define.h"
+#include "widget/animation/transition.h"
 
 
 typedef void (*CFBD_DemoEntry)(CFBD_GraphicDevice* dev);
@@ -44,6 +47,19 @@ typedef enum
     CFBD_DEMO_RUN_LOOP    /**< Run demos continuously in loop */
 } CFBD_DemoRunMode;
 
+/**
+ * @brief Choose how queued demos hand over the screen to the next one.
+ *
+ * @details The finished demo is transitioned to a blank screen before the
+ *          next one starts drawing. Defaults to a fade, 8 frames of 25 ms;
+ *          0 frames falls back to clear() + update().
+ *
+ * @param effect Transition effect.
+ * @param timing Frame count and frame delay, copied.
+ */
+void CFBD_DemoManager_SetTransition(CFBDGraphic_TransitionEffect effect,
+                                    const CFBD_BaseAnimation* timing);
+
 /**
  * @brief Run demos according to selected mode
  *
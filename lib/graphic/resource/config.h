@@ -165,6 +165,21 @@
 
 #endif // for the _USE_NO_DEFAULT_SOURCES
 
+/**
+ * @def ENABLE_ASCII_8x16_COMPRESSED
+ * @brief Build the 8x16 ASCII font from its RLE table.
+ *
+ * @details
+ * When set to 1 the 8x16 font is linked from resource/default/ascii8x16.rle.c
+ * (about 1.1 KB) instead of the plain 1.5 KB table. Glyphs are decoded on
+ * first use into the glyph cache, see CFBD_GLYPH_CACHE_SLOTS.
+ *
+ * Default: 0 (plain table)
+ */
+#ifndef ENABLE_ASCII_8x16_COMPRESSED
+#define ENABLE_ASCII_8x16_COMPRESSED 0
+#endif
+
 #endif // for the no-repeative include guard
 
 /** @} */ // end of Graphics_Resources group
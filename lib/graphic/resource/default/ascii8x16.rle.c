@@ -0,0 +1,119 @@
+// Generated by cfbd_rle.py, do not edit.
+// cfbd_rle.py font ascii8x16.source.c --glyph-bytes 16 --width 8 --height 16 --name ascii8x16 --guard 'ENABLE_ASCII_8x16_SOURCES && ENABLE_ASCII_8x16_COMPRESSED' -o ascii8x16.rle.c
+#include <stdint.h>
+
+#include "resource/config.h"
+
+/*
+    sources should be externed copy this for
+    the usage in application level
+*/
+
+// ---------------------------------------------
+// extern const uint8_t ascii8x16_rle[];
+// extern const uint16_t ascii8x16_rle_blocks[];
+// ---------------------------------------------
+#if ENABLE_ASCII_8x16_SOURCES && ENABLE_ASCII_8x16_COMPRESSED
+
+// 95 glyphs of 8x16, 8 per block: 1520 -> 1107 bytes (+24 bytes block table)
+const uint8_t ascii8x16_rle[] = {
+    0x52, 0x00, 0xF8, 0xF9, 0x33, 0x30, 0xE1, 0x16, 0x0E, 0xC9, 0x16, 0x0E,
+    0x49, 0x06, 0x40, 0xC0, 0x78, 0x40, 0xC0, 0x78, 0x40, 0xCE, 0x04, 0x3F,
+    0x04, 0x04, 0x3F, 0x04, 0x04, 0xD4, 0x70, 0x88, 0xFC, 0x08, 0x30, 0xDC,
+    0x18, 0x20, 0xFF, 0x21, 0x1E, 0xD2, 0xF0, 0x08, 0xF0, 0xC9, 0xE0, 0x18,
+    0xDD, 0x21, 0x1C, 0x03, 0x1E, 0x21, 0x1E, 0xD3, 0xF0, 0x08, 0x88, 0x70,
+    0xDF, 0x1E, 0x21, 0x23, 0x24, 0x19, 0x27, 0x21, 0x10, 0xD9, 0x16, 0x0E,
+    0x4A, 0xDB, 0xE0, 0x18, 0x04, 0x02, 0xE3, 0x07, 0x18, 0x20, 0x40, 0xD3,
+    0x02, 0x04, 0x18, 0xE0, 0xE3, 0x40, 0x20, 0x18, 0x07, 0xDE, 0x40, 0x40,
+    0x80, 0xF0, 0x80, 0x40, 0x40, 0xCE, 0x02, 0x02, 0x01, 0x0F, 0x01, 0x02,
+    0x02, 0xE0, 0xF0, 0x43, 0x81, 0x01, 0x00, 0x1F, 0x81, 0x01, 0x49, 0x01,
+    0xB0, 0x70, 0x4D, 0x85, 0x01, 0x48, 0x01, 0x30, 0x30, 0x48, 0x03, 0x80,
+    0x60, 0x18, 0x04, 0xCB, 0x60, 0x18, 0x06, 0x01, 0x42, 0xCD, 0xE0, 0x10,
+    0x08, 0x08, 0x10, 0xE0, 0xD5, 0x0F, 0x10, 0x20, 0x20, 0x10, 0x0F, 0xD2,
+    0x10, 0x10, 0xF8, 0xEC, 0x20, 0x20, 0x3F, 0x20, 0x20, 0xD8, 0x70, 0x81,
+    0x08, 0x01, 0x88, 0x70, 0xD5, 0x30, 0x28, 0x24, 0x22, 0x21, 0x30, 0xD5,
+    0x30, 0x08, 0x88, 0x88, 0x48, 0x30, 0xD0, 0x18, 0x81, 0x20, 0x01, 0x11,
+    0x0E, 0xDB, 0xC0, 0x20, 0x10, 0xF8, 0xDD, 0x07, 0x04, 0x24, 0x24, 0x3F,
+    0x24, 0xD5, 0xF8, 0x08, 0x88, 0x88, 0x08, 0x08, 0xD5, 0x19, 0x21, 0x20,
+    0x20, 0x11, 0x0E, 0xD4, 0xE0, 0x10, 0x88, 0x88, 0x18, 0xDD, 0x0F, 0x11,
+    0x20, 0x20, 0x11, 0x0E, 0xD5, 0x38, 0x08, 0x08, 0xC8, 0x38, 0x08, 0xE0,
+    0x3F, 0x43, 0xCD, 0x70, 0x88, 0x08, 0x08, 0x88, 0x70, 0xD5, 0x1C, 0x22,
+    0x21, 0x21, 0x22, 0x1C, 0xD5, 0xE0, 0x10, 0x08, 0x08, 0x10, 0xE0, 0xDC,
+    0x31, 0x22, 0x22, 0x11, 0x0F, 0xE1, 0xC0, 0xC0, 0xF1, 0x30, 0x30, 0xF1,
+    0xC0, 0xC0, 0xEA, 0x80, 0xB0, 0x70, 0xEC, 0x80, 0x40, 0x20, 0x10, 0x08,
+    0xD5, 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x85, 0x40, 0x40, 0x85,
+    0x04, 0xD4, 0x08, 0x10, 0x20, 0x40, 0x80, 0xDD, 0x20, 0x10, 0x08, 0x04,
+    0x02, 0x01, 0xD1, 0x70, 0x48, 0x81, 0x08, 0x00, 0xF0, 0xE2, 0x30, 0x36,
+    0x01, 0x41, 0x06, 0xC0, 0x30, 0xC8, 0x28, 0xE8, 0x10, 0xE0, 0xCE, 0x07,
+    0x18, 0x27, 0x24, 0x23, 0x14, 0x0B, 0xDA, 0xC0, 0x38, 0xE0, 0xDF, 0x20,
+    0x3C, 0x23, 0x02, 0x02, 0x27, 0x38, 0x20, 0x01, 0x08, 0xF8, 0x81, 0x88,
+    0x00, 0x70, 0xD1, 0x20, 0x3F, 0x81, 0x20, 0x01, 0x11, 0x0E, 0xC9, 0xC0,
+    0x30, 0x82, 0x08, 0x00, 0x38, 0xC9, 0x07, 0x18, 0x81, 0x20, 0x01, 0x10,
+    0x08, 0xC9, 0x08, 0xF8, 0x81, 0x08, 0x01, 0x10, 0xE0, 0xC9, 0x20, 0x3F,
+    0x81, 0x20, 0x01, 0x10, 0x0F, 0xCE, 0x08, 0xF8, 0x88, 0x88, 0xE8, 0x08,
+    0x10, 0xCE, 0x20, 0x3F, 0x20, 0x20, 0x23, 0x20, 0x18, 0xCE, 0x08, 0xF8,
+    0x88, 0x88, 0xE8, 0x08, 0x10, 0xCA, 0x20, 0x3F, 0x20, 0xC8, 0x03, 0xD9,
+    0xC0, 0x30, 0x81, 0x08, 0x00, 0x38, 0xD6, 0x07, 0x18, 0x20, 0x20, 0x22,
+    0x1E, 0x02, 0x40, 0x02, 0x08, 0xF8, 0x08, 0xD7, 0x08, 0xF8, 0x08, 0x20,
+    0x3F, 0x21, 0x01, 0x01, 0x02, 0x21, 0x3F, 0x20, 0xCC, 0x08, 0x08, 0xF8,
+    0x08, 0x08, 0xDC, 0x20, 0x20, 0x3F, 0x20, 0x20, 0xE4, 0x08, 0x08, 0xF8,
+    0x08, 0x08, 0xC8, 0xC0, 0x81, 0x80, 0x00, 0x7F, 0xDE, 0x08, 0xF8, 0x88,
+    0xC0, 0x28, 0x18, 0x08, 0xCE, 0x20, 0x3F, 0x20, 0x01, 0x26, 0x38, 0x20,
+    0xCA, 0x08, 0xF8, 0x08, 0xE9, 0x20, 0x3F, 0x82, 0x20, 0x00, 0x30, 0xCA,
+    0x08, 0xF8, 0xF8, 0xCA, 0xF8, 0xF8, 0x08, 0xC9, 0x20, 0x3F, 0xC8, 0x3F,
+    0xC9, 0x3F, 0x20, 0xCB, 0x08, 0xF8, 0x30, 0xC0, 0xCD, 0x08, 0xF8, 0x08,
+    0x20, 0x3F, 0x20, 0xCA, 0x07, 0x18, 0x3F, 0xC9, 0xE0, 0x10, 0x81, 0x08,
+    0x01, 0x10, 0xE0, 0xC9, 0x0F, 0x10, 0x81, 0x20, 0x01, 0x10, 0x0F, 0x40,
+    0x01, 0x08, 0xF8, 0x82, 0x08, 0x00, 0xF0, 0xCA, 0x20, 0x3F, 0x21, 0x81,
+    0x01, 0xD1, 0xE0, 0x10, 0x81, 0x08, 0x01, 0x10, 0xE0, 0xCE, 0x0F, 0x18,
+    0x24, 0x24, 0x38, 0x50, 0x4F, 0xC9, 0x08, 0xF8, 0x82, 0x88, 0x00, 0x70,
+    0xCA, 0x20, 0x3F, 0x20, 0xCB, 0x03, 0x0C, 0x30, 0x20, 0xC9, 0x70, 0x88,
+    0x81, 0x08, 0x00, 0x38, 0xD5, 0x38, 0x20, 0x21, 0x21, 0x22, 0x1C, 0xCE,
+    0x18, 0x08, 0x08, 0xF8, 0x08, 0x08, 0x18, 0xDA, 0x20, 0x3F, 0x20, 0xDA,
+    0x08, 0xF8, 0x08, 0xD2, 0x08, 0xF8, 0x08, 0xC8, 0x1F, 0x82, 0x20, 0x00,
+    0x1F, 0xCA, 0x08, 0x78, 0x88, 0xD2, 0xC8, 0x38, 0x08, 0xD3, 0x07, 0x38,
+    0x0E, 0x01, 0xD1, 0xF8, 0x08, 0xC8, 0xF8, 0xC9, 0x08, 0xF8, 0xCA, 0x03,
+    0x3C, 0x07, 0xCA, 0x07, 0x3C, 0x03, 0x40, 0x12, 0x08, 0x18, 0x68, 0x80,
+    0x80, 0x68, 0x18, 0x08, 0x20, 0x30, 0x2C, 0x03, 0x03, 0x2C, 0x30, 0x20,
+    0x08, 0x38, 0xC8, 0xCA, 0xC8, 0x38, 0x08, 0xDA, 0x20, 0x3F, 0x20, 0xD8,
+    0x10, 0x81, 0x08, 0x02, 0xC8, 0x38, 0x08, 0xCE, 0x20, 0x38, 0x26, 0x21,
+    0x20, 0x20, 0x18, 0xE0, 0xFE, 0x81, 0x02, 0xE0, 0x7F, 0x81, 0x40, 0xD2,
+    0x0C, 0x30, 0xC0, 0xFB, 0x01, 0x06, 0x38, 0xC0, 0x41, 0x81, 0x02, 0x00,
+    0xFE, 0x43, 0x81, 0x40, 0x00, 0x7F, 0xE6, 0x20, 0x10, 0x08, 0x04, 0x08,
+    0x10, 0x20, 0x4F, 0x86, 0x80, 0xCA, 0x02, 0x04, 0x08, 0x4D, 0x82, 0x80,
+    0xD9, 0x19, 0x24, 0x81, 0x22, 0x03, 0x3F, 0x20, 0x08, 0xF8, 0xC9, 0x80,
+    0x80, 0xE5, 0x3F, 0x11, 0x20, 0x20, 0x11, 0x0E, 0x43, 0x81, 0x80, 0xD9,
+    0x0E, 0x11, 0x81, 0x20, 0x00, 0x11, 0xE3, 0x80, 0x80, 0x88, 0xF8, 0xD6,
+    0x0E, 0x11, 0x20, 0x20, 0x10, 0x3F, 0x20, 0x41, 0x82, 0x80, 0xD8, 0x1F,
+    0x82, 0x22, 0x00, 0x13, 0xD2, 0x80, 0x80, 0xF0, 0x81, 0x88, 0x00, 0x18,
+    0xCC, 0x20, 0x20, 0x3F, 0x20, 0x20, 0x43, 0x83, 0x80, 0xD0, 0x6B, 0x81,
+    0x94, 0x01, 0x93, 0x60, 0x40, 0x01, 0x08, 0xF8, 0x40, 0x81, 0x80, 0xD2,
+    0x20, 0x3F, 0x21, 0xD2, 0x20, 0x3F, 0x20, 0xCA, 0x80, 0x98, 0x98, 0xEC,
+    0x20, 0x20, 0x3F, 0x20, 0x20, 0xEA, 0x80, 0x98, 0x98, 0xD8, 0xC0, 0x81,
+    0x80, 0x00, 0x7F, 0xD1, 0x08, 0xF8, 0x41, 0x81, 0x80, 0xCE, 0x20, 0x3F,
+    0x24, 0x02, 0x2D, 0x30, 0x20, 0xD2, 0x08, 0x08, 0xF8, 0xEC, 0x20, 0x20,
+    0x3F, 0x20, 0x20, 0x41, 0x85, 0x80, 0xCA, 0x20, 0x3F, 0x20, 0xC9, 0x3F,
+    0x20, 0xC8, 0x3F, 0xC9, 0x80, 0x80, 0xC9, 0x80, 0x80, 0xDA, 0x20, 0x3F,
+    0x21, 0xCA, 0x20, 0x3F, 0x20, 0x41, 0x82, 0x80, 0xD8, 0x1F, 0x82, 0x20,
+    0x00, 0x1F, 0x40, 0x01, 0x80, 0x80, 0xC9, 0x80, 0x80, 0xDE, 0x80, 0xFF,
+    0xA1, 0x20, 0x20, 0x11, 0x0E, 0x43, 0x82, 0x80, 0xD5, 0x0E, 0x11, 0x20,
+    0x20, 0xA0, 0xFF, 0x82, 0x80, 0x40, 0x81, 0x80, 0xCC, 0x20, 0x20, 0x3F,
+    0x21, 0x20, 0xC8, 0x01, 0x42, 0x83, 0x80, 0xD0, 0x33, 0x82, 0x24, 0x00,
+    0x19, 0xD4, 0x80, 0x80, 0xE0, 0x80, 0x80, 0xEA, 0x1F, 0x20, 0x20, 0xD1,
+    0x80, 0x80, 0xD9, 0x80, 0x80, 0xD0, 0x1F, 0x81, 0x20, 0x02, 0x10, 0x3F,
+    0x20, 0x81, 0x80, 0x41, 0x81, 0x80, 0xCD, 0x01, 0x0E, 0x30, 0x08, 0x06,
+    0x01, 0xC9, 0x80, 0x80, 0xC8, 0x80, 0x40, 0x81, 0x80, 0x06, 0x0F, 0x30,
+    0x0C, 0x03, 0x0C, 0x30, 0x0F, 0x40, 0xC9, 0x80, 0x80, 0x40, 0x81, 0x80,
+    0xD5, 0x20, 0x31, 0x2E, 0x0E, 0x31, 0x20, 0x40, 0x81, 0x80, 0x41, 0x82,
+    0x80, 0x05, 0x81, 0x8E, 0x70, 0x18, 0x06, 0x01, 0x41, 0x84, 0x80, 0xD5,
+    0x21, 0x30, 0x2C, 0x22, 0x21, 0x30, 0xEB, 0x80, 0x7C, 0x02, 0x02, 0xEA,
+    0x3F, 0x40, 0x40, 0xE0, 0xFF, 0xF8, 0xFF, 0xE3, 0x02, 0x02, 0x7C, 0x80,
+    0xE2, 0x40, 0x40, 0x3F, 0xEB, 0x80, 0x40, 0x40, 0x80, 0xD0, 0x80, 0xE9,
+    0x01, 0x01, 0x40,
+};
+
+const uint16_t ascii8x16_rle_blocks[] = {
+    0, 73, 141, 242, 326, 447, 564, 679,
+    761, 845, 939, 1038,
+};
+#endif
@@ -14,7 +14,7 @@
 // ---------------------------------------------
 // extern const uint8_t ascii8x16_sources[][16];
 // ---------------------------------------------
-#if ENABLE_ASCII_8x16_SOURCES
+#if ENABLE_ASCII_8x16_SOURCES && !ENABLE_ASCII_8x16_COMPRESSED
 const uint8_t ascii8x16_sources[][16] =
 {
 	{0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
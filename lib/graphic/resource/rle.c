@@ -0,0 +1,68 @@
+#include "rle.h"
+
+#include <stddef.h>
+#include <string.h>
+
+void CFBDGraphic_RleOpen(CFBDGraphic_RleStream* stream, const uint8_t* data)
+{
+    stream->cursor = data;
+    stream->zeros = 0;
+    stream->repeats = 0;
+    stream->value = 0;
+    stream->literals = 0;
+}
+
+static void next_token(CFBDGraphic_RleStream* stream)
+{
+    const uint8_t token = *stream->cursor++;
+    switch (token >> 6) {
+        case 0:
+            stream->literals = (token & 0x3F) + 1;
+            break;
+        case 1:
+            stream->zeros = (token & 0x3F) + 1;
+            break;
+        case 2:
+            stream->repeats = (token & 0x3F) + 2;
+            stream->value = *stream->cursor++;
+            break;
+        default:
+            stream->zeros = (token >> 3) & 0x07;
+            stream->literals = (token & 0x07) + 1;
+            break;
+    }
+}
+
+void CFBDGraphic_RleRead(CFBDGraphic_RleStream* stream, uint8_t* out, uint16_t count)
+{
+    while (count > 0) {
+        if (stream->zeros == 0 && stream->repeats == 0 && stream->literals == 0)
+            next_token(stream);
+
+        uint8_t n;
+        if (stream->zeros) {
+            n = (stream->zeros < count) ? stream->zeros : (uint8_t) count;
+            if (out)
+                memset(out, 0, n);
+            stream->zeros -= n;
+        }
+        else if (stream->repeats) {
+            n = (stream->repeats < count) ? stream->repeats : (uint8_t) count;
+            if (out)
+                memset(out, stream->value, n);
+            stream->repeats -= n;
+        }
+        else {
+            // 合并令牌先输出零字节, 再输出字面量
+            n = (stream->literals < count) ? stream->literals : (uint8_t) count;
+            if (out)
+                memcpy(out, stream->cursor, n);
+            stream->cursor += n;
+            stream->literals -= n;
+        }
+
+        if (out)
+            out += n;
+        count -= n;
+    }
+}
@@ -0,0 +1,64 @@
+/**
+ * @file rle.h
+ * @brief Streaming decoder for RLE compressed bitmaps and fonts
+ * @ingroup Graphics_Resources
+ *
+ * @details
+ * Compressed resources hold the same bytes a setArea() bitmap would (1bpp
+ * pages, one byte per column per page), packed into tokens that favour the
+ * zero bytes dominating OLED artwork:
+ *
+ * | Token      | Meaning                                      |
+ * |------------|----------------------------------------------|
+ * | `00nnnnnn` | n + 1 literal bytes follow                   |
+ * | `01nnnnnn` | n + 1 zero bytes                             |
+ * | `10nnnnnn` | n + 2 copies of the byte that follows        |
+ * | `11zzzlll` | zzz zero bytes, then lll + 1 literal bytes   |
+ *
+ * The stream is decoded on demand, a reader keeps five bytes of state and
+ * never needs the decompressed resource in RAM. Resources are produced by
+ * `resource/tools/cfbd_rle.py`.
+ *
+ * @see CFBDGraphic_InitCompressedImage
+ * @see CFBDGraphic_Font
+ */
+
+#pragma once
+#include <stdint.h>
+
+/**
+ * @addtogroup Graphics_Resources
+ * @{
+ */
+
+/**
+ * @struct CFBDGraphic_RleStream
+ * @brief Read position inside a compressed resource
+ */
+typedef struct
+{
+    const uint8_t* cursor; /**< Next compressed byte */
+    uint8_t zeros;         /**< Zero bytes left in the current token */
+    uint8_t repeats;       /**< Copies of @ref value left in the current token */
+    uint8_t value;         /**< Byte repeated by a run token */
+    uint8_t literals;      /**< Literal bytes left, read from @ref cursor */
+} CFBDGraphic_RleStream;
+
+/**
+ * @brief Start decoding a compressed resource
+ * @param[out] stream - Reader to initialize
+ * @param[in] data - First token of the resource
+ */
+void CFBDGraphic_RleOpen(CFBDGraphic_RleStream* stream, const uint8_t* data);
+
+/**
+ * @brief Decode the next bytes of a stream
+ * @param[in,out] stream - Reader
+ * @param[out] out - Destination of @p count bytes, or NULL to skip them
+ * @param[in] count - Bytes to produce
+ * @note Reading past the encoded length is undefined, callers know the
+ *       decoded size of the resource.
+ */
+void CFBDGraphic_RleRead(CFBDGraphic_RleStream* stream, uint8_t* out, uint16_t count);
+
+/** @} */
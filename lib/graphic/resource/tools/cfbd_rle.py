@@ -0,0 +1,423 @@
+#!/usr/bin/env python3
+"""
+Offline converter for CFBD RLE resources (see resource/rle.h).
+
+Input bitmaps use the setArea() layout: 1bpp pages, one byte per column per
+page. The converter emits C arrays that the firmware decodes while drawing.
+
+    # font: pack an existing glyph table, 8 glyphs per block
+    cfbd_rle.py font ascii8x16.source.c --glyph-bytes 16 --width 8 --height 16 \
+        --name ascii8x16 --first 0x20 -o ascii8x16.rle.c
+
+    # image: pack a PBM file (P1 or P4) or a C array of the given size
+    cfbd_rle.py image logo.pbm --name logo -o logo.rle.c
+    cfbd_rle.py image icon.c --width 24 --height 24 --name icon -o icon.rle.c
+
+    # sprite: delta encode animation frames (PBM files, or one C array)
+    cfbd_rle.py sprite busy0.pbm busy1.pbm busy2.pbm --name busy -o busy.sprite.c
+    cfbd_rle.py sprite busy.c --width 16 --height 16 --frames 8 --name busy
+
+Token format, one control byte followed by its payload:
+
+    00nnnnnn            n + 1 literal bytes follow
+    01nnnnnn            n + 1 zero bytes
+    10nnnnnn v          n + 2 copies of byte v
+    11zzzlll            zzz zero bytes, then lll + 1 literal bytes follow
+
+Sprite deltas (widget/animation/sprite_animation.h) are plain runs instead:
+
+    skip count v...     skip unchanged bytes, then count new byte values
+"""
+
+import argparse
+import re
+import shlex
+import sys
+
+MAX_LITERALS = 64
+MAX_ZEROS = 64
+MAX_REPEATS = 65
+MAX_COMBO_ZEROS = 7
+MAX_COMBO_LITERALS = 8
+
+
+def _run_length(data, i, limit):
+    j = i
+    while j < len(data) and data[j] == data[i] and j - i < limit:
+        j += 1
+    return j - i
+
+
+def _starts_run(data, i):
+    return i + 2 < len(data) and data[i] == data[i + 1] == data[i + 2]
+
+
+def encode(data):
+    out = bytearray()
+    pending = []
+
+    def flush():
+        while pending:
+            chunk = pending[:MAX_LITERALS]
+            del pending[:MAX_LITERALS]
+            out.append(len(chunk) - 1)
+            out.extend(chunk)
+
+    i = 0
+    while i < len(data):
+        if data[i] == 0:
+            zeros = _run_length(data, i, MAX_ZEROS)
+            # a short zero run glued to the literals after it costs one byte
+            if zeros <= MAX_COMBO_ZEROS:
+                k = i + zeros
+                tail = []
+                while (k < len(data) and len(tail) < MAX_COMBO_LITERALS and data[k] != 0
+                       and not _starts_run(data, k)):
+                    tail.append(data[k])
+                    k += 1
+                if tail:
+                    flush()
+                    out.append(0xC0 | (zeros << 3) | (len(tail) - 1))
+                    out.extend(tail)
+                    i = k
+                    continue
+            flush()
+            out.append(0x40 | (zeros - 1))
+            i += zeros
+            continue
+
+        repeats = _run_length(data, i, MAX_REPEATS)
+        if repeats >= 3:
+            flush()
+            out.append(0x80 | (repeats - 2))
+            out.append(data[i])
+            i += repeats
+            continue
+
+        pending.append(data[i])
+        i += 1
+
+    flush()
+    return bytes(out)
+
+
+def decode(packed, count):
+    """Reference decoder, used to verify every emitted stream."""
+    out = bytearray()
+    i = 0
+    while len(out) < count:
+        token = packed[i]
+        i += 1
+        kind = token >> 6
+        if kind == 0:
+            n = (token & 0x3F) + 1
+            out.extend(packed[i:i + n])
+            i += n
+        elif kind == 1:
+            out.extend(b"\x00" * ((token & 0x3F) + 1))
+        elif kind == 2:
+            out.extend(bytes([packed[i]]) * ((token & 0x3F) + 2))
+            i += 1
+        else:
+            n = (token & 0x07) + 1
+            out.extend(b"\x00" * ((token >> 3) & 0x07))
+            out.extend(packed[i:i + n])
+            i += n
+    return bytes(out[:count])
+
+
+# gaps up to this many unchanged bytes are sent again rather than opening a run
+MAX_DELTA_GAP = 2
+
+
+def delta_runs(prev, cur, width):
+    """(offset, bytes) runs that turn prev into cur, never crossing a page row."""
+    runs = []
+    i = 0
+    while i < len(cur):
+        if prev[i] == cur[i]:
+            i += 1
+            continue
+        start = i
+        row_end = (i // width + 1) * width
+        end = i + 1
+        j = end
+        while j < row_end and j - end <= MAX_DELTA_GAP:
+            if prev[j] != cur[j]:
+                end = j + 1
+            j += 1
+        runs.append((start, cur[start:end]))
+        i = end
+    return runs
+
+
+def encode_delta(prev, cur, width):
+    out = bytearray()
+    position = 0
+    for offset, data in delta_runs(prev, cur, width):
+        skip = offset - position
+        while skip > 255:
+            out.extend((255, 0))
+            skip -= 255
+        for k in range(0, len(data), 255):
+            piece = data[k:k + 255]
+            out.extend((skip, len(piece)))
+            out.extend(piece)
+            skip = 0
+        position = offset + len(data)
+    return bytes(out)
+
+
+def apply_delta(frame, delta):
+    """Reference player, used to verify every emitted delta."""
+    frame = bytearray(frame)
+    i = 0
+    position = 0
+    while i < len(delta):
+        position += delta[i]
+        count = delta[i + 1]
+        frame[position:position + count] = delta[i + 2:i + 2 + count]
+        position += count
+        i += 2 + count
+    return bytes(frame)
+
+
+def read_c_array(path):
+    text = open(path, encoding="utf-8", errors="replace").read()
+    body = text[text.index("=") + 1:] if "=" in text else text
+    body = re.sub(r"//[^\n]*|/\*.*?\*/", "", body, flags=re.S)
+    return bytes(int(v, 0) & 0xFF for v in re.findall(r"0[xX][0-9a-fA-F]+|\b\d+\b", body))
+
+
+def _pbm_tokens(raw):
+    for line in raw.split(b"\n"):
+        for token in line.split(b"#", 1)[0].split():
+            yield token
+
+
+def read_pbm(path):
+    """Return (width, height, page layout bytes) of a P1 or P4 bitmap."""
+    raw = open(path, "rb").read()
+    magic = raw[:2]
+    if magic == b"P1":
+        tokens = _pbm_tokens(raw[2:])
+        width, height = int(next(tokens)), int(next(tokens))
+        bits = b"".join(tokens).replace(b" ", b"")
+        pixel = lambda x, y: bits[y * width + x] == ord("1")
+    elif magic == b"P4":
+        fields = raw[2:].split(None, 2)
+        width, height = int(fields[0]), int(fields[1])
+        data = fields[2]
+        row = (width + 7) // 8
+        pixel = lambda x, y: (data[y * row + x // 8] >> (7 - x % 8)) & 1
+    else:
+        raise SystemExit("%s: only P1 and P4 bitmaps are supported" % path)
+
+    pages = bytearray()
+    for page in range((height + 7) // 8):
+        for x in range(width):
+            byte = 0
+            for bit in range(8):
+                y = page * 8 + bit
+                if y < height and pixel(x, y):
+                    byte |= 1 << bit
+            pages.append(byte)
+    return width, height, bytes(pages)
+
+
+def emit_array(out, ctype, name, values, per_line=12, fmt="0x%02X"):
+    out.write("const %s %s[] = {\n" % (ctype, name))
+    for i in range(0, len(values), per_line):
+        out.write("    " + ", ".join(fmt % v for v in values[i:i + per_line]) + ",\n")
+    out.write("};\n")
+
+
+def emit_header(out, args, extern_lines):
+    out.write("// Generated by cfbd_rle.py, do not edit.\n")
+    out.write("// cfbd_rle.py %s\n" % " ".join(shlex.quote(arg) for arg in sys.argv[1:]))
+    out.write("#include <stdint.h>\n")
+    if args.guard:
+        out.write('\n#include "resource/config.h"\n')
+    out.write("\n/*\n    sources should be externed copy this for\n    the usage in application level\n*/\n\n")
+    out.write("// ---------------------------------------------\n")
+    for line in extern_lines:
+        out.write("// %s\n" % line)
+    out.write("// ---------------------------------------------\n")
+    if args.guard:
+        out.write("#if %s\n" % args.guard)
+
+
+def convert_font(args):
+    table = read_c_array(args.input)
+    if len(table) % args.glyph_bytes:
+        raise SystemExit("table size %d is not a multiple of %d" % (len(table), args.glyph_bytes))
+    glyphs = [table[i:i + args.glyph_bytes] for i in range(0, len(table), args.glyph_bytes)]
+
+    packed = bytearray()
+    blocks = []
+    for b in range(0, len(glyphs), args.block):
+        plain = b"".join(glyphs[b:b + args.block])
+        stream = encode(plain)
+        assert decode(stream, len(plain)) == plain
+        blocks.append(len(packed))
+        packed.extend(stream)
+    if len(packed) > 0xFFFF:
+        raise SystemExit("compressed font exceeds 64 KB, split it into several fonts")
+
+    name = args.name
+    out = open(args.output, "w") if args.output else sys.stdout
+    emit_header(out, args, ["extern const uint8_t %s_rle[];" % name,
+                            "extern const uint16_t %s_rle_blocks[];" % name])
+    out.write("\n// %d glyphs of %dx%d, %d per block: %d -> %d bytes (+%d bytes block table)\n"
+              % (len(glyphs), args.width, args.height, args.block, len(table), len(packed),
+                 2 * len(blocks)))
+    emit_array(out, "uint8_t", name + "_rle", packed)
+    out.write("\n")
+    emit_array(out, "uint16_t", name + "_rle_blocks", blocks, per_line=8, fmt="%d")
+
+    if args.descriptor:
+        last = args.first + len(glyphs) - 1
+        out.write("\n/*\n")
+        head = "const CFBDGraphic_Font %s_font = {" % name
+        pad = " " * len(head)
+        fields = [".width = %d" % args.width, ".height = %d" % args.height,
+                  ".glyph_bytes = %d" % args.glyph_bytes, ".first = 0x%X" % args.first,
+                  ".last = 0x%X" % last, ".glyphs = %s_rle" % name,
+                  ".blocks = %s_rle_blocks" % name, ".block_glyphs = %d" % args.block,
+                  ".fallback = '?'"]
+        out.write(head + (",\n" + pad).join(fields) + "};\n")
+        out.write("*/\n")
+
+    if args.guard:
+        out.write("#endif\n")
+    sys.stderr.write("%s: %d -> %d bytes\n" % (name, len(table), len(packed) + 2 * len(blocks)))
+
+
+def convert_image(args):
+    if args.input.endswith((".pbm", ".PBM")):
+        width, height, plain = read_pbm(args.input)
+    else:
+        if not args.width or not args.height:
+            raise SystemExit("--width and --height are required for C array input")
+        width, height = args.width, args.height
+        plain = read_c_array(args.input)
+        expected = width * ((height + 7) // 8)
+        if len(plain) < expected:
+            raise SystemExit("expected %d bytes, found %d" % (expected, len(plain)))
+        plain = plain[:expected]
+
+    packed = encode(plain)
+    assert decode(packed, len(plain)) == plain
+
+    name = args.name
+    out = open(args.output, "w") if args.output else sys.stdout
+    emit_header(out, args, ["extern const uint8_t %s_rle[];" % name])
+    out.write("\n// %dx%d: %d -> %d bytes\n" % (width, height, len(plain), len(packed)))
+    out.write("// CFBDGraphic_InitCompressedImage(&image, &point, &(CFBDGraphicSize){%d, %d}, %s_rle);\n"
+              % (width, height, name))
+    emit_array(out, "uint8_t", name + "_rle", packed)
+    if args.guard:
+        out.write("#endif\n")
+    sys.stderr.write("%s: %d -> %d bytes\n" % (name, len(plain), len(packed)))
+
+
+def convert_sprite(args):
+    if all(path.endswith((".pbm", ".PBM")) for path in args.input):
+        frames = []
+        for path in args.input:
+            width, height, plain = read_pbm(path)
+            if frames and (width, height) != (frames[0][0], frames[0][1]):
+                raise SystemExit("%s: every frame must be %dx%d" % (path, frames[0][0], frames[0][1]))
+            frames.append((width, height, plain))
+        width, height = frames[0][0], frames[0][1]
+        frames = [plain for _, _, plain in frames]
+    else:
+        if len(args.input) != 1 or not (args.width and args.height and args.frames):
+            raise SystemExit("C array input needs one file and --width, --height and --frames")
+        width, height = args.width, args.height
+        size = width * ((height + 7) // 8)
+        table = read_c_array(args.input[0])
+        if len(table) < size * args.frames:
+            raise SystemExit("expected %d bytes, found %d" % (size * args.frames, len(table)))
+        frames = [table[k * size:(k + 1) * size] for k in range(args.frames)]
+    if not 1 <= len(frames) <= 255:
+        raise SystemExit("a sprite sheet holds 1..255 frames")
+
+    blank = bytes(len(frames[0]))
+    # delta 0 draws frame 0 on a blank area, the last one loops back to frame 0
+    steps = [(blank, frames[0])]
+    steps += [(frames[k - 1], frames[k]) for k in range(1, len(frames))]
+    steps.append((frames[-1], frames[0]))
+
+    packed = bytearray()
+    offsets = []
+    for prev, cur in steps:
+        delta = encode_delta(prev, cur, width)
+        assert apply_delta(prev, delta) == cur
+        offsets.append(len(packed))
+        packed.extend(delta)
+    offsets.append(len(packed))
+    if len(packed) > 0xFFFF:
+        raise SystemExit("sprite sheet exceeds 64 KB, split the animation")
+
+    name = args.name
+    out = open(args.output, "w") if args.output else sys.stdout
+    emit_header(out, args, ["extern const uint8_t %s_deltas[];" % name,
+                            "extern const uint16_t %s_frames[];" % name])
+    out.write("\n// %d frames of %dx%d: %d -> %d bytes (+%d bytes frame table)\n"
+              % (len(frames), width, height, len(blank) * len(frames), len(packed),
+                 2 * len(offsets)))
+    out.write("// const CFBDGraphic_SpriteSheet %s = {%d, %d, %d, %s_deltas, %s_frames};\n"
+              % (name, width, height, len(frames), name, name))
+    emit_array(out, "uint8_t", name + "_deltas", packed)
+    out.write("\n")
+    emit_array(out, "uint16_t", name + "_frames", offsets, per_line=8, fmt="%d")
+    if args.guard:
+        out.write("#endif\n")
+    sys.stderr.write("%s: %d -> %d bytes\n" % (name, len(blank) * len(frames), len(packed)))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Convert bitmaps to CFBD RLE C sources")
+    sub = parser.add_subparsers(dest="kind", required=True)
+
+    font = sub.add_parser("font", help="compress a glyph table")
+    font.add_argument("input", help="C source holding the glyph table")
+    font.add_argument("--glyph-bytes", type=int, required=True)
+    font.add_argument("--width", type=int, required=True)
+    font.add_argument("--height", type=int, required=True)
+    font.add_argument("--first", type=lambda v: int(v, 0), default=0x20,
+                      help="code point of the first glyph (default 0x20)")
+    font.add_argument("--block", type=int, default=8, help="glyphs per block (default 8)")
+    font.add_argument("--descriptor", action="store_true",
+                      help="append a CFBDGraphic_Font template as a comment")
+
+    image = sub.add_parser("image", help="compress a bitmap")
+    image.add_argument("input", help="PBM file or C source holding page layout bytes")
+    image.add_argument("--width", type=int)
+    image.add_argument("--height", type=int)
+
+    sprite = sub.add_parser("sprite", help="delta encode animation frames")
+    sprite.add_argument("input", nargs="+", help="PBM frames in order, or one C source")
+    sprite.add_argument("--width", type=int)
+    sprite.add_argument("--height", type=int)
+    sprite.add_argument("--frames", type=int, help="frames in the C array")
+
+    for p in (font, image, sprite):
+        p.add_argument("--name", required=True, help="C identifier prefix")
+        p.add_argument("--guard", help="wrap the arrays in #if GUARD (resource/config.h)")
+        p.add_argument("-o", "--output", help="output file (default stdout)")
+
+    args = parser.parse_args()
+    if args.kind == "font":
+        if args.block < 1 or args.block > 255:
+            raise SystemExit("--block must be 1..255")
+        convert_font(args)
+    elif args.kind == "sprite":
+        convert_sprite(args)
+    else:
+        convert_image(args)
+
+
+if __name__ == "__main__":
+    main()
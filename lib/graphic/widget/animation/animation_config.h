@@ -52,3 +52,15 @@
  * @endcode
  */
 #define CFBD_BASEANIMATION_DELAY_MS (0)
+
+/**
+ * @def CFBD_ANIMATION_MAX_TWEENS
+ * @brief Tweens a CFBD_AnimationEngine can run at the same time.
+ *
+ * @details
+ * Every slot costs one CFBD_Tween in the engine structure. A screen rarely
+ * animates more than a handful of values at once.
+ */
+#ifndef CFBD_ANIMATION_MAX_TWEENS
+#define CFBD_ANIMATION_MAX_TWEENS (8)
+#endif
@@ -0,0 +1,118 @@
+#include "animation_engine.h"
+
+void CFBD_InitAnimationEngine(CFBD_AnimationEngine* engine, CFBD_GraphicDevice* device)
+{
+    engine->device = device;
+    for (uint8_t i = 0; i < CFBD_ANIMATION_MAX_TWEENS; i++) {
+        engine->tweens[i].apply = NULL;
+    }
+}
+
+CFBD_Tween* CFBD_AnimationStart(CFBD_AnimationEngine* engine,
+                                const CFBD_BaseAnimation* timing,
+                                int32_t from,
+                                int32_t to,
+                                CFBD_EasingCurve curve,
+                                CFBD_TweenApply apply,
+                                void* user_data,
+                                uint32_t now_ms)
+{
+    if (apply == NULL)
+        return NULL;
+
+    for (uint8_t i = 0; i < CFBD_ANIMATION_MAX_TWEENS; i++) {
+        CFBD_Tween* tween = &engine->tweens[i];
+        if (tween->apply != NULL)
+            continue;
+
+        tween->apply = apply;
+        tween->user_data = user_data;
+        tween->timing = *timing;
+        tween->curve = curve;
+        tween->from = from;
+        tween->to = to;
+        tween->value = from;
+        tween->start_ms = now_ms;
+        tween->frame = 0;
+        return tween;
+    }
+    return NULL;
+}
+
+void CFBD_TweenRetarget(CFBD_Tween* tween, int32_t to, uint32_t now_ms)
+{
+    tween->from = tween->value;
+    tween->to = to;
+    tween->start_ms = now_ms;
+    tween->frame = 0;
+}
+
+void CFBD_TweenCancel(CFBD_Tween* tween)
+{
+    tween->apply = NULL;
+}
+
+/* Apply the frame due at now_ms; CFBD_TRUE if @p dirty was filled */
+static CFBD_Bool advance(CFBD_GraphicDevice* device,
+                         CFBD_Tween* tween,
+                         uint32_t now_ms,
+                         CFBDGraphicRect* dirty)
+{
+    const uint8_t frames = tween->timing.anim_frames ? tween->timing.anim_frames : 1;
+    if (!CFBD_AnimationAdvanceFrame(&tween->frame,
+                                    frames,
+                                    tween->timing.anim_frame_delay_ms,
+                                    now_ms - tween->start_ms))
+        return CFBD_FALSE;
+    const uint8_t due = tween->frame;
+
+    const int32_t eased = CFBD_EaseQ16(tween->curve, CFBD_EaseProgressQ16(due, frames));
+    const int32_t value =
+            (due == frames) ? tween->to : CFBD_EaseLerp(tween->from, tween->to, eased);
+
+    CFBD_Bool drawn = CFBD_FALSE;
+    if (value != tween->value) {
+        tween->value = value;
+        drawn = tween->apply(device, value, tween->user_data, dirty);
+    }
+    if (due == frames)
+        tween->apply = NULL;
+    return drawn;
+}
+
+CFBD_Bool CFBD_AnimationTick(CFBD_AnimationEngine* engine, uint32_t now_ms)
+{
+    CFBD_GraphicDevice* device = engine->device;
+    CFBDGraphicRect bounds;
+    CFBD_Bool any_drawn = CFBD_FALSE;
+    CFBD_Bool running = CFBD_FALSE;
+
+    // 所有补间共用一次刷新
+    const CFBD_Bool immediate = CFBDGraphic_DeviceRequestUpdateAtOnce(device);
+    CFBDGraphic_DeviceSetIfRequestUpdateAtOnce(device, CFBD_FALSE);
+
+    for (uint8_t i = 0; i < CFBD_ANIMATION_MAX_TWEENS; i++) {
+        CFBD_Tween* tween = &engine->tweens[i];
+        if (tween->apply == NULL)
+            continue;
+
+        CFBDGraphicRect dirty;
+        if (advance(device, tween, now_ms, &dirty)) {
+            dirty = rect_normalize(dirty);
+            bounds = any_drawn ? rect_union(&bounds, &dirty) : dirty;
+            any_drawn = CFBD_TRUE;
+        }
+        if (tween->apply != NULL)
+            running = CFBD_TRUE;
+    }
+
+    CFBDGraphic_DeviceSetIfRequestUpdateAtOnce(device, immediate);
+    if (any_drawn) {
+        device->ops->update_area(device,
+                                 bounds.tl.x,
+                                 bounds.tl.y,
+                                 bounds.br.x - bounds.tl.x + 1,
+                                 bounds.br.y - bounds.tl.y + 1);
+    }
+    return running;
+}
@@ -0,0 +1,161 @@
+/**
+ * @file animation_engine.h
+ * @brief Pool of tweens advanced together, one flush per frame.
+ * @ingroup Graphics_Animation
+ *
+ * @details
+ * A tween moves one integer value from `from` to `to` along an easing
+ * curve, using the frame count and frame delay of a CFBD_BaseAnimation.
+ * On every frame it calls its apply callback, which draws the widget for
+ * the new value and reports the region it changed.
+ *
+ * CFBD_AnimationTick() advances every running tween of an engine with
+ * drawing deferred, then flushes the bounding box of all changed regions
+ * with a single update_area(): three widgets animating together cost one
+ * transfer per frame, not three. Late ticks jump to the frame that is due.
+ *
+ * @example
+ * @code
+ * static CFBD_Bool apply_slider(CFBD_GraphicDevice* device,
+ *                               int32_t value,
+ *                               void* user_data,
+ *                               CFBDGraphicRect* dirty)
+ * {
+ *     Slider* s = user_data;
+ *     slider_draw(device, s, value);   // deferred, no flush
+ *     *dirty = slider_bounds(s);
+ *     return CFBD_TRUE;
+ * }
+ *
+ * CFBD_AnimationEngine engine;
+ * CFBD_InitAnimationEngine(&engine, device);
+ * CFBD_Tween* t = CFBD_AnimationStart(&engine, &timing, 0, 100, CFBD_EASE_OUT,
+ *                                     apply_slider, &slider, millis());
+ * // main loop
+ * CFBD_AnimationTick(&engine, millis());
+ * @endcode
+ */
+
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#include "animation.h"
+#include "animation_config.h"
+#include "base/rectangle.h"
+#include "cfbd_define.h"
+#include "device/graphic_device.h"
+#include "easing.h"
+
+/**
+ * @addtogroup Graphics_Animation
+ * @{
+ */
+
+/**
+ * @brief Draw the animated widget for @p value.
+ * @param device Device of the engine, drawing is deferred during the call.
+ * @param value Current tween value.
+ * @param user_data Tween user data.
+ * @param dirty Receives the changed region (inclusive corners).
+ * @return CFBD_FALSE if nothing was drawn (@p dirty is then ignored).
+ */
+typedef CFBD_Bool (*CFBD_TweenApply)(CFBD_GraphicDevice* device,
+                                     int32_t value,
+                                     void* user_data,
+                                     CFBDGraphicRect* dirty);
+
+/**
+ * @struct CFBD_Tween
+ * @brief One animated value, lives in a CFBD_AnimationEngine slot.
+ */
+typedef struct
+{
+    CFBD_TweenApply apply;     /**< Draw callback, NULL marks a free slot */
+    void* user_data;           /**< Passed to @ref apply */
+    CFBD_BaseAnimation timing; /**< Frame count and frame delay */
+    CFBD_EasingCurve curve;    /**< Easing of the progress */
+    int32_t from;              /**< Value at frame 0 */
+    int32_t to;                /**< Value at the last frame */
+    int32_t value;             /**< Value last applied */
+    uint32_t start_ms;         /**< Tick of frame 0 */
+    uint8_t frame;             /**< Frame last applied */
+} CFBD_Tween;
+
+/**
+ * @struct CFBD_AnimationEngine
+ * @brief Running tweens of one device.
+ */
+typedef struct
+{
+    CFBD_GraphicDevice* device;
+    CFBD_Tween tweens[CFBD_ANIMATION_MAX_TWEENS];
+} CFBD_AnimationEngine;
+
+/**
+ * @brief Prepare an engine without any tween.
+ */
+void CFBD_InitAnimationEngine(CFBD_AnimationEngine* engine, CFBD_GraphicDevice* device);
+
+/**
+ * @brief Start moving a value from @p from to @p to.
+ *
+ * @details
+ * Frame 0 (@p from) is assumed to be on screen already, the first tick
+ * after one frame delay draws frame 1. With a frame delay of 0 every tick
+ * draws the next frame.
+ *
+ * @param engine Engine to run the tween.
+ * @param timing Frame count and delay, copied.
+ * @param from Start value.
+ * @param to End value.
+ * @param curve Easing curve.
+ * @param apply Draw callback.
+ * @param user_data Passed to @p apply.
+ * @param now_ms Current tick in milliseconds.
+ * @return The tween, NULL if all CFBD_ANIMATION_MAX_TWEENS slots are busy.
+ */
+CFBD_Tween* CFBD_AnimationStart(CFBD_AnimationEngine* engine,
+                                const CFBD_BaseAnimation* timing,
+                                int32_t from,
+                                int32_t to,
+                                CFBD_EasingCurve curve,
+                                CFBD_TweenApply apply,
+                                void* user_data,
+                                uint32_t now_ms);
+
+/**
+ * @brief Send a running tween to a new end value, starting from where it is now.
+ */
+void CFBD_TweenRetarget(CFBD_Tween* tween, int32_t to, uint32_t now_ms);
+
+/**
+ * @brief Stop a tween where it is and free its slot.
+ */
+void CFBD_TweenCancel(CFBD_Tween* tween);
+
+/**
+ * @brief Check whether a tween still occupies its slot.
+ * @note The slot may have been reused by a later CFBD_AnimationStart().
+ */
+static inline CFBD_Bool CFBD_TweenRunning(const CFBD_Tween* tween)
+{
+    return tween->apply != NULL;
+}
+
+/**
+ * @brief Draw the due frame of every running tween and flush once.
+ *
+ * @details
+ * Tweens whose value did not change since their last frame are not
+ * applied. Finished tweens free their slot after drawing their last value.
+ * The bounding box of the reported regions is flushed with one
+ * update_area(), whatever the immediate mode.
+ *
+ * @param engine Engine to advance.
+ * @param now_ms Current tick in milliseconds, wrapping is fine.
+ * @return CFBD_TRUE while at least one tween is running.
+ */
+CFBD_Bool CFBD_AnimationTick(CFBD_AnimationEngine* engine, uint32_t now_ms);
+
+/** @} */
@@ -0,0 +1,49 @@
+#include "easing.h"
+
+#define CFBD_EASE_LUT_STEPS (32)
+
+/* f(i / 32) in Q16, i = 0 .. 32 */
+static const int32_t smoothstep_lut[CFBD_EASE_LUT_STEPS + 1] = {
+        0,     188,   736,   1620,  2816,  4300,  6048,  8036,  10240, 12636, 15200,
+        17908, 20736, 23660, 26656, 29700, 32768, 35836, 38880, 41876, 44800, 47628,
+        50336, 52900, 55296, 57500, 59488, 61236, 62720, 63916, 64800, 65348, 65536};
+
+/* 1 - (1 - t)^3 */
+static const int32_t ease_out_lut[CFBD_EASE_LUT_STEPS + 1] = {
+        0,     5954,  11536, 16758, 21632, 26170, 30384, 34286, 37888, 41202, 44240,
+        47014, 49536, 51818, 53872, 55710, 57344, 58786, 60048, 61142, 62080, 62874,
+        63536, 64078, 64512, 64850, 65104, 65286, 65408, 65482, 65520, 65534, 65536};
+
+/* 1 - e^(-5t) * cos(2.5 * pi * t) */
+static const int32_t spring_lut[CFBD_EASE_LUT_STEPS + 1] = {
+        0,     11160, 23250, 35149, 46047, 55428, 63020, 68757, 72721, 75103, 76155,
+        76158, 75393, 74122, 72572, 70931, 69340, 67902, 66678, 65701, 64974, 64483,
+        64200, 64089, 64112, 64232, 64414, 64628, 64850, 65062, 65251, 65411, 65536};
+
+int32_t CFBD_EaseQ16(CFBD_EasingCurve curve, int32_t t)
+{
+    if (t <= 0)
+        return 0;
+    if (t >= CFBD_EASE_ONE)
+        return CFBD_EASE_ONE;
+
+    const int32_t* lut;
+    switch (curve) {
+        case CFBD_EASE_SMOOTHSTEP:
+            lut = smoothstep_lut;
+            break;
+        case CFBD_EASE_OUT:
+            lut = ease_out_lut;
+            break;
+        case CFBD_EASE_SPRING:
+            lut = spring_lut;
+            break;
+        default:
+            return t;
+    }
+
+    // 32 段, 每段 2048 (Q16), 段内线性插值
+    const int32_t index = t >> 11;
+    const int32_t frac = t & 0x7FF;
+    return lut[index] + (((lut[index + 1] - lut[index]) * frac) >> 11);
+}
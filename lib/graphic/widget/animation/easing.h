@@ -0,0 +1,117 @@
+/**
+ * @file easing.h
+ * @brief Fixed-point easing curves shared by all animated widgets.
+ * @ingroup Graphics_Animation
+ *
+ * @details
+ * A curve maps the progress of an animation (0 at the first frame, 1 at
+ * the last one) to the fraction of the way travelled. Progress and result
+ * are Q16 fixed-point numbers, `CFBD_EASE_ONE` being 1.0; Q8 wrappers are
+ * provided for callers that work with small frame counts. Non-linear
+ * curves are tabulated at 33 points and interpolated linearly, so easing
+ * costs one multiplication and no floating point.
+ *
+ * The spring curve overshoots (up to about 1.16) before it settles, every
+ * curve returns exactly 0 and 1 at both ends.
+ *
+ * @example
+ * @code
+ * // value of frame f out of frames
+ * int32_t p = CFBD_EaseQ16(CFBD_EASE_OUT, CFBD_EaseProgressQ16(f, frames));
+ * int32_t x = CFBD_EaseLerp(from_x, to_x, p);
+ * @endcode
+ */
+
+#pragma once
+#include <stdint.h>
+
+#include "cfbd_define.h"
+
+/**
+ * @addtogroup Graphics_Animation
+ * @{
+ */
+
+/**
+ * @def CFBD_EASE_ONE
+ * @brief 1.0 in Q16.
+ */
+#define CFBD_EASE_ONE (65536)
+
+/**
+ * @enum CFBD_EasingCurve
+ * @brief Available easing curves.
+ */
+typedef enum
+{
+    CFBD_EASE_LINEAR,     /**< Constant speed */
+    CFBD_EASE_SMOOTHSTEP, /**< 3t^2 - 2t^3: slow start and slow end */
+    CFBD_EASE_OUT,        /**< Cubic ease out: fast start, slow end */
+    CFBD_EASE_SPRING      /**< Damped spring: overshoots, then settles */
+} CFBD_EasingCurve;
+
+/**
+ * @brief Ease a Q16 progress value.
+ * @param curve Curve to apply.
+ * @param t Progress in Q16, clamped to [0, CFBD_EASE_ONE].
+ * @return Eased fraction in Q16, may exceed CFBD_EASE_ONE for CFBD_EASE_SPRING.
+ */
+int32_t CFBD_EaseQ16(CFBD_EasingCurve curve, int32_t t);
+
+/**
+ * @brief Ease a Q8 progress value (0 - 256), result in Q8.
+ */
+static inline int32_t CFBD_EaseQ8(CFBD_EasingCurve curve, int32_t t)
+{
+    return CFBD_EaseQ16(curve, t << 8) >> 8;
+}
+
+/**
+ * @brief Progress of frame @p frame out of @p frames in Q16.
+ */
+static inline int32_t CFBD_EaseProgressQ16(uint8_t frame, uint8_t frames)
+{
+    if (frames == 0 || frame >= frames)
+        return CFBD_EASE_ONE;
+    return (int32_t) (((uint32_t) frame << 16) / frames);
+}
+
+/**
+ * @brief Move an animation to the frame that is due.
+ *
+ * @details
+ * Frame n of @p frames (0 counts as 1) is due @p delay_ms * n after the
+ * start. Late calls jump straight to the frame that is due; @p elapsed_ms
+ * is now - start, the unsigned subtraction stays right when the tick wraps.
+ * With a delay of 0 every call advances one frame.
+ *
+ * @param frame Frame on screen, moved to the frame that is due.
+ * @param frames Frame count of the animation.
+ * @param delay_ms Frame delay.
+ * @param elapsed_ms Time since the animation started.
+ * @return CFBD_TRUE if @p frame moved and has to be drawn.
+ */
+static inline CFBD_Bool CFBD_AnimationAdvanceFrame(uint8_t* frame,
+                                                   uint8_t frames,
+                                                   uint32_t delay_ms,
+                                                   uint32_t elapsed_ms)
+{
+    const uint32_t last = frames ? frames : 1;
+    uint32_t due = delay_ms ? elapsed_ms / delay_ms : (uint32_t) *frame + 1;
+    if (due > last)
+        due = last;
+    if (due == *frame)
+        return CFBD_FALSE;
+    *frame = (uint8_t) due;
+    return CFBD_TRUE;
+}
+
+/**
+ * @brief Interpolate between @p from and @p to by a Q16 fraction.
+ */
+static inline int32_t CFBD_EaseLerp(int32_t from, int32_t to, int32_t fraction)
+{
+    return (int32_t) (from + ((((int64_t) to - from) * fraction) >> 16));
+}
+
+/** @} */
@@ -0,0 +1,120 @@
+#include "frame_pacer.h"
+
+#include <stddef.h>
+
+#include "sys_clock/system_clock.h"
+
+/* Signed distance from @p now to @p deadline, correct across tick wrap */
+static inline int32_t ticks_until(uint32_t deadline, uint32_t now)
+{
+    return (int32_t) (deadline - now);
+}
+
+void CFBD_InitFramePacer(CFBD_FramePacer* pacer, CFBD_ClockTickProvider tick, uint32_t interval_ms)
+{
+    pacer->tick = tick;
+    pacer->next_ms = 0;
+    pacer->frame_start = 0;
+    pacer->started = CFBD_FALSE;
+    CFBD_FramePacerSetInterval(pacer, interval_ms);
+    CFBD_FramePacerResetStats(pacer);
+}
+
+void CFBD_FramePacerSetInterval(CFBD_FramePacer* pacer, uint32_t interval_ms)
+{
+    pacer->interval_ms = interval_ms ? interval_ms : 1;
+}
+
+void CFBD_FramePacerResetStats(CFBD_FramePacer* pacer)
+{
+    CFBD_FrameStats* stats = &pacer->stats;
+    stats->frames = 0;
+    stats->skipped = 0;
+    stats->overruns = 0;
+    stats->last_ms = 0;
+    stats->min_ms = UINT32_MAX;
+    stats->max_ms = 0;
+    stats->total_ms = 0;
+}
+
+CFBD_Bool CFBD_FramePacerBegin(CFBD_FramePacer* pacer, uint32_t* now_ms)
+{
+    const uint32_t now = pacer->tick();
+    if (pacer->started && ticks_until(pacer->next_ms, now) > 0)
+        return CFBD_FALSE;
+
+    pacer->frame_start = now;
+    if (now_ms != NULL)
+        *now_ms = now;
+    return CFBD_TRUE;
+}
+
+void CFBD_FramePacerEnd(CFBD_FramePacer* pacer)
+{
+    const uint32_t end = pacer->tick();
+    const uint32_t spent = end - pacer->frame_start;
+    const uint32_t interval = pacer->interval_ms;
+
+    CFBD_FrameStats* stats = &pacer->stats;
+    stats->frames++;
+    stats->last_ms = spent;
+    stats->total_ms += spent;
+    if (spent < stats->min_ms)
+        stats->min_ms = spent;
+    if (spent > stats->max_ms)
+        stats->max_ms = spent;
+    if (spent > interval)
+        stats->overruns++;
+
+    // 第一帧确定时间网格的相位
+    if (!pacer->started) {
+        pacer->next_ms = pacer->frame_start;
+        pacer->started = CFBD_TRUE;
+    }
+    pacer->next_ms += interval;
+
+    // 已经错过的帧位直接丢弃, 不连续补帧
+    // 恰好在帧位上结束的帧没有错过该帧位
+    if (ticks_until(pacer->next_ms, end) < 0) {
+        const uint32_t missed = (end - pacer->next_ms - 1) / interval + 1;
+        pacer->next_ms += missed * interval;
+        stats->skipped += missed;
+    }
+}
+
+uint32_t CFBD_FramePacerRemaining(CFBD_FramePacer* pacer)
+{
+    if (!pacer->started)
+        return 0;
+    const int32_t left = ticks_until(pacer->next_ms, pacer->tick());
+    return (left > 0) ? (uint32_t) left : 0;
+}
+
+void CFBD_FramePacerWait(CFBD_FramePacer* pacer, CFBD_FrameIdleFunc idle, void* user_data)
+{
+    const uint32_t left = CFBD_FramePacerRemaining(pacer);
+    if (left == 0)
+        return;
+    if (idle != NULL)
+        idle(user_data, left);
+    else
+        system_delay_ms(left);
+}
+
+void CFBD_FramePacerRun(CFBD_FramePacer* pacer,
+                        CFBD_FrameRenderFunc render,
+                        CFBD_FrameIdleFunc idle,
+                        void* user_data)
+{
+    uint32_t now_ms;
+    for (;;) {
+        if (!CFBD_FramePacerBegin(pacer, &now_ms)) {
+            CFBD_FramePacerWait(pacer, idle, user_data);
+            continue;
+        }
+        const CFBD_Bool more = render(user_data, now_ms);
+        CFBD_FramePacerEnd(pacer);
+        if (!more)
+            return;
+    }
+}
@@ -0,0 +1,163 @@
+/**
+ * @file frame_pacer.h
+ * @brief Fixed rate render loop with frame skipping and frame time statistics.
+ * @ingroup Graphics_Animation
+ *
+ * @details
+ * Sleeping a fixed anim_frame_delay_ms after every frame makes an animation
+ * as slow as the bus: the render and flush time comes on top of the delay.
+ * The frame pacer keeps a grid of frame slots, one every interval_ms, and
+ * measures each frame with the application's tick_provider:
+ *
+ * - a frame starts once its slot has come and gets its start tick as
+ *   `now_ms`; the tick based animations (CFBD_AnimationTick(), menu and
+ *   progress bar tick()) draw the frame due at that time, so when frames
+ *   are late the intermediate animation frames are dropped and motion
+ *   keeps its speed
+ * - after the frame only the time left until the next slot is slept (or
+ *   handed to an idle hook), never a full interval
+ * - slots that passed while a frame was still being rendered are skipped
+ *   and counted, the loop does not try to catch up with back to back frames
+ *
+ * On a 100 kHz bus a full frame may take longer than the interval: the
+ * pacer then renders as fast as it can, skips the missed slots and the
+ * animations still finish on time.
+ *
+ * @example
+ * @code
+ * static CFBD_Bool render(void* user_data, uint32_t now_ms)
+ * {
+ *     CFBD_AnimationEngine* engine = user_data;
+ *     return CFBD_AnimationTick(engine, now_ms);   // draw and flush
+ * }
+ *
+ * CFBD_FramePacer pacer;
+ * CFBD_InitFramePacer(&pacer, getApp(CFBD_FALSE)->tick_provider, 20); // 50 fps
+ * CFBD_FramePacerRun(&pacer, render, NULL, &engine);
+ * // pacer.stats.max_ms, CFBD_FramePacerAverageMs(&pacer.stats), pacer.stats.skipped
+ * @endcode
+ */
+
+#pragma once
+#include <stdint.h>
+
+#include "app.h"
+#include "cfbd_define.h"
+
+/**
+ * @addtogroup Graphics_Animation
+ * @{
+ */
+
+/**
+ * @brief Render and flush one frame.
+ * @param user_data Passed through from the loop.
+ * @param now_ms Tick at which the frame started, give it to the animations.
+ * @return CFBD_FALSE to leave CFBD_FramePacerRun() after this frame.
+ */
+typedef CFBD_Bool (*CFBD_FrameRenderFunc)(void* user_data, uint32_t now_ms);
+
+/**
+ * @brief Spend the time left until the next frame, e.g. poll input or sleep.
+ * @param user_data Passed through from the loop.
+ * @param remaining_ms Time until the next frame slot, at least 1.
+ * @note May return early, the loop then asks again.
+ */
+typedef void (*CFBD_FrameIdleFunc)(void* user_data, uint32_t remaining_ms);
+
+/**
+ * @struct CFBD_FrameStats
+ * @brief Frame time statistics, render plus flush time of every frame.
+ */
+typedef struct
+{
+    uint32_t frames;   /**< Frames rendered */
+    uint32_t skipped;  /**< Frame slots dropped because a frame ran late */
+    uint32_t overruns; /**< Frames that took longer than the interval */
+    uint32_t last_ms;  /**< Time of the last frame */
+    uint32_t min_ms;   /**< Shortest frame */
+    uint32_t max_ms;   /**< Longest frame */
+    uint32_t total_ms; /**< Sum of all frame times */
+} CFBD_FrameStats;
+
+/**
+ * @struct CFBD_FramePacer
+ * @brief Frame slot grid of one render loop.
+ */
+typedef struct
+{
+    CFBD_ClockTickProvider tick; /**< Millisecond tick, usually the app's tick_provider */
+    uint32_t interval_ms;        /**< Target frame interval */
+    uint32_t next_ms;            /**< Tick of the next frame slot */
+    uint32_t frame_start;        /**< Tick at which the current frame started */
+    CFBD_Bool started;           /**< CFBD_FALSE until the first frame ended */
+    CFBD_FrameStats stats;       /**< Statistics since init or the last reset */
+} CFBD_FramePacer;
+
+/**
+ * @brief Prepare a pacer, the first frame is due at once.
+ * @param pacer Pacer to initialize.
+ * @param tick Monotonic millisecond tick, wrapping is fine.
+ * @param interval_ms Target frame interval, 0 is treated as 1.
+ */
+void CFBD_InitFramePacer(CFBD_FramePacer* pacer, CFBD_ClockTickProvider tick, uint32_t interval_ms);
+
+/**
+ * @brief Change the target frame interval, takes effect after the next frame.
+ */
+void CFBD_FramePacerSetInterval(CFBD_FramePacer* pacer, uint32_t interval_ms);
+
+/**
+ * @brief Clear the statistics.
+ */
+void CFBD_FramePacerResetStats(CFBD_FramePacer* pacer);
+
+/**
+ * @brief Start a frame if its slot has come, never waits.
+ * @param pacer Pacer of the loop.
+ * @param now_ms Optional, receives the tick of the frame.
+ * @return CFBD_FALSE if the next slot is still ahead, render nothing then.
+ */
+CFBD_Bool CFBD_FramePacerBegin(CFBD_FramePacer* pacer, uint32_t* now_ms);
+
+/**
+ * @brief Finish the frame started by CFBD_FramePacerBegin().
+ * @details Records the frame time and moves to the next slot that is
+ *          still ahead, counting the slots passed on the way as skipped.
+ */
+void CFBD_FramePacerEnd(CFBD_FramePacer* pacer);
+
+/**
+ * @brief Time left until the next frame slot, 0 if a frame is due.
+ */
+uint32_t CFBD_FramePacerRemaining(CFBD_FramePacer* pacer);
+
+/**
+ * @brief Spend the time left until the next frame slot.
+ * @param pacer Pacer of the loop.
+ * @param idle Hook receiving the remaining time, NULL sleeps with system_delay_ms().
+ * @param user_data Passed to @p idle.
+ */
+void CFBD_FramePacerWait(CFBD_FramePacer* pacer, CFBD_FrameIdleFunc idle, void* user_data);
+
+/**
+ * @brief Render paced frames until @p render returns CFBD_FALSE.
+ * @param pacer Pacer of the loop.
+ * @param render Draws and flushes one frame.
+ * @param idle Runs between frames, NULL sleeps.
+ * @param user_data Passed to @p render and @p idle.
+ */
+void CFBD_FramePacerRun(CFBD_FramePacer* pacer,
+                        CFBD_FrameRenderFunc render,
+                        CFBD_FrameIdleFunc idle,
+                        void* user_data);
+
+/**
+ * @brief Average frame time in milliseconds, 0 before the first frame.
+ */
+static inline uint32_t CFBD_FramePacerAverageMs(const CFBD_FrameStats* stats)
+{
+    return stats->frames ? stats->total_ms / stats->frames : 0;
+}
+
+/** @} */
@@ -0,0 +1,182 @@
+#include "sprite_animation.h"
+
+#include <stddef.h>
+
+#include "device/graphic_canvas.h"
+
+typedef struct
+{
+    uint16_t x0, y0, x1, y1;
+    CFBD_Bool any;
+} DirtyBounds;
+
+static void dirty_add(DirtyBounds* dirty, uint16_t x, uint16_t y, uint16_t w, uint16_t h)
+{
+    const uint16_t x1 = x + w - 1;
+    const uint16_t y1 = y + h - 1;
+    if (!dirty->any) {
+        dirty->x0 = x;
+        dirty->y0 = y;
+        dirty->x1 = x1;
+        dirty->y1 = y1;
+        dirty->any = CFBD_TRUE;
+        return;
+    }
+    if (x < dirty->x0)
+        dirty->x0 = x;
+    if (y < dirty->y0)
+        dirty->y0 = y;
+    if (x1 > dirty->x1)
+        dirty->x1 = x1;
+    if (y1 > dirty->y1)
+        dirty->y1 = y1;
+}
+
+/* Copy the runs of delta @p index straight from the sheet, one blit per run */
+static void apply_delta(CFBD_GraphicDevice* device,
+                        const CFBDGraphic_SpritePlayer* player,
+                        uint8_t index,
+                        DirtyBounds* dirty)
+{
+    const CFBDGraphic_SpriteSheet* sheet = player->sheet;
+    const uint8_t* run = sheet->deltas + sheet->frames[index];
+    const uint8_t* end = sheet->deltas + sheet->frames[index + 1];
+    uint32_t offset = 0;
+
+    while (run < end) {
+        offset += run[0];
+        const uint8_t count = run[1];
+        run += 2;
+        if (count == 0)
+            continue;
+
+        // 编码器保证每段不跨页
+        const uint16_t page = (uint16_t) (offset / sheet->width);
+        const uint16_t column = (uint16_t) (offset % sheet->width);
+        const uint16_t rows = (sheet->height - page * 8 < 8) ? (sheet->height - page * 8) : 8;
+        const CFBDGraphic_BlitSource source = {run, count, 0, 0, count, rows};
+        const uint16_t x = player->point.x + column;
+        const uint16_t y = player->point.y + page * 8;
+        CFBDGraphic_DeviceBlit(device, &source, x, y, CFBD_ROP_COPY);
+        dirty_add(dirty, x, y, count, rows);
+
+        run += count;
+        offset += count;
+    }
+}
+
+/* Frame 0 is delta 0 applied to a blank area, the whole area is dirty */
+static void show_first_frame(CFBD_GraphicDevice* device,
+                             CFBDGraphic_SpritePlayer* player,
+                             DirtyBounds* dirty)
+{
+    const CFBDGraphic_SpriteSheet* sheet = player->sheet;
+    device->ops->clear_area(device, player->point.x, player->point.y, sheet->width, sheet->height);
+    apply_delta(device, player, 0, dirty);
+    dirty_add(dirty, player->point.x, player->point.y, sheet->width, sheet->height);
+}
+
+/* Advance @p steps frames, skipped frames included, without flushing */
+static void play_frames(CFBD_GraphicDevice* device,
+                        CFBDGraphic_SpritePlayer* player,
+                        uint32_t steps,
+                        DirtyBounds* dirty)
+{
+    const uint8_t frames = player->timing.anim_frames;
+    for (uint32_t i = 0; i < steps; i++) {
+        if (player->frame + 1 == frames) {
+            apply_delta(device, player, frames, dirty);
+            player->frame = 0;
+        }
+        else {
+            player->frame++;
+            apply_delta(device, player, player->frame, dirty);
+        }
+    }
+}
+
+void CFBDGraphic_InitSpritePlayer(CFBDGraphic_SpritePlayer* player,
+                                  const CFBDGraphic_SpriteSheet* sheet,
+                                  const CFBDGraphic_Point* point,
+                                  uint32_t frame_delay_ms,
+                                  CFBD_Bool loop)
+{
+    player->sheet = sheet;
+    player->point = *point;
+    CFBD_InitBaseAnimation(&player->timing);
+    player->timing.anim_frames = sheet->frame_count;
+    player->timing.anim_frame_delay_ms = frame_delay_ms;
+    player->frame_started = 0;
+    player->frame = 0;
+    player->shown = CFBD_FALSE;
+    player->loop = loop;
+}
+
+CFBD_Bool CFBDGraphic_SpritePlayerTick(CFBD_GraphicDevice* device,
+                                       CFBDGraphic_SpritePlayer* player,
+                                       uint32_t now_ms,
+                                       CFBDGraphicRect* dirty)
+{
+    const uint8_t frames = player->timing.anim_frames;
+    const uint32_t delay = player->timing.anim_frame_delay_ms;
+    DirtyBounds changed = {0};
+
+    if (frames == 0)
+        return CFBD_FALSE;
+
+    uint32_t steps = 0;
+    if (player->shown) {
+        // 无符号减法, tick 回绕后依然正确
+        const uint32_t elapsed = now_ms - player->frame_started;
+        steps = delay ? elapsed / delay : 1;
+        if (steps == 0)
+            return CFBD_FALSE;
+        player->frame_started = delay ? now_ms - elapsed % delay : now_ms;
+
+        if (player->loop)
+            steps %= frames; // whole cycles end on the same frame
+        else if (steps > (uint32_t) (frames - 1 - player->frame))
+            steps = frames - 1 - player->frame;
+    }
+
+    // 整个 tick 内关闭立即刷新, 结束后对变化区域的并集刷新一次
+    const CFBD_Bool immediate = CFBDGraphic_DeviceRequestUpdateAtOnce(device);
+    CFBDGraphic_DeviceSetIfRequestUpdateAtOnce(device, CFBD_FALSE);
+    if (!player->shown) {
+        show_first_frame(device, player, &changed);
+        player->frame = 0;
+        player->frame_started = now_ms;
+        player->shown = CFBD_TRUE;
+    }
+    else {
+        play_frames(device, player, steps, &changed);
+    }
+    CFBDGraphic_DeviceSetIfRequestUpdateAtOnce(device, immediate);
+
+    if (!changed.any)
+        return CFBD_FALSE;
+    if (immediate)
+        device->ops->update_area(device,
+                                 changed.x0,
+                                 changed.y0,
+                                 changed.x1 - changed.x0 + 1,
+                                 changed.y1 - changed.y0 + 1);
+    if (dirty != NULL) {
+        dirty->tl.x = changed.x0;
+        dirty->tl.y = changed.y0;
+        dirty->br.x = changed.x1;
+        dirty->br.y = changed.y1;
+    }
+    return CFBD_TRUE;
+}
+
+void CFBDGraphic_SpritePlayerRestart(CFBDGraphic_SpritePlayer* player)
+{
+    player->frame = 0;
+    player->shown = CFBD_FALSE;
+}
+
+CFBD_Bool CFBDGraphic_SpritePlayerFinished(const CFBDGraphic_SpritePlayer* player)
+{
+    return !player->loop && player->shown && player->frame + 1 >= player->timing.anim_frames;
+}
@@ -0,0 +1,127 @@
+/**
+ * @file sprite_animation.h
+ * @brief Delta encoded sprite sheets and a tick driven player.
+ * @ingroup Graphics_Animation
+ *
+ * @details
+ * Consecutive frames of an animated icon differ in a few bytes only, so a
+ * sprite sheet stores every frame as the byte runs that changed since the
+ * previous one. Runs address the setArea() layout of the frame (byte
+ * `page * width + column`) and never cross a page row:
+ *
+ * | bytes | content                                                |
+ * |-------|--------------------------------------------------------|
+ * | 1     | skip: unchanged bytes since the end of the previous run |
+ * | 1     | count: changed bytes that follow, 0 for a pure skip    |
+ * | count | new values of those bytes                              |
+ *
+ * Delta 0 builds the first frame from a blank area, delta `i` turns frame
+ * `i - 1` into frame `i` and a last delta turns the final frame back into
+ * frame 0 for looping. The player blits each run straight from flash into
+ * the frame buffer and, in immediate mode, flushes the box around the
+ * runs of a tick once: an animated status icon costs a few bytes per frame
+ * on the bus instead of the whole bitmap. Sheets are produced by
+ * `resource/tools/cfbd_rle.py sprite`.
+ *
+ * @example
+ * @code
+ * extern const uint8_t busy_deltas[];
+ * extern const uint16_t busy_frames[];
+ * static const CFBDGraphic_SpriteSheet busy = {16, 16, 8, busy_deltas, busy_frames};
+ *
+ * CFBDGraphic_SpritePlayer spinner;
+ * CFBDGraphic_InitSpritePlayer(&spinner, &busy, &pos, 80, CFBD_TRUE);
+ * // main loop, no delay inside
+ * CFBDGraphic_SpritePlayerTick(device, &spinner, millis(), NULL);
+ * @endcode
+ */
+
+#pragma once
+#include <stdint.h>
+
+#include "base/point.h"
+#include "base/rectangle.h"
+#include "cfbd_define.h"
+#include "device/graphic_device.h"
+#include "widget/animation/animation.h"
+
+/**
+ * @addtogroup Graphics_Animation
+ * @{
+ */
+
+/**
+ * @struct CFBDGraphic_SpriteSheet
+ * @brief Delta encoded frames of one animated bitmap, usually const in flash.
+ */
+typedef struct
+{
+    uint16_t width;         /**< Frame width in pixels */
+    uint16_t height;        /**< Frame height in pixels */
+    uint8_t frame_count;    /**< Number of distinct frames */
+    const uint8_t* deltas;  /**< Run lists of all deltas, back to back */
+    const uint16_t* frames; /**< frame_count + 2 offsets into @ref deltas, the last one ends the data */
+} CFBDGraphic_SpriteSheet;
+
+/**
+ * @struct CFBDGraphic_SpritePlayer
+ * @brief Playback state of a sprite sheet at a screen position.
+ */
+typedef struct
+{
+    const CFBDGraphic_SpriteSheet* sheet; /**< Frames being played */
+    CFBDGraphic_Point point;              /**< Top-left corner on the device */
+    CFBD_BaseAnimation timing;            /**< anim_frames / anim_frame_delay_ms of the sheet */
+    uint32_t frame_started;               /**< Tick (ms) at which @ref frame became due */
+    uint8_t frame;                        /**< Frame currently on screen */
+    CFBD_Bool shown;                      /**< CFBD_FALSE until frame 0 has been drawn */
+    CFBD_Bool loop;                       /**< Restart after the last frame instead of stopping */
+} CFBDGraphic_SpritePlayer;
+
+/**
+ * @brief Prepare a player, nothing is drawn until the first tick.
+ * @param player Player to initialize.
+ * @param sheet Frames to play, must outlive the player.
+ * @param point Top-left corner of the sprite.
+ * @param frame_delay_ms Time each frame stays on screen.
+ * @param loop CFBD_TRUE to play forever, CFBD_FALSE to stop on the last frame.
+ */
+void CFBDGraphic_InitSpritePlayer(CFBDGraphic_SpritePlayer* player,
+                                  const CFBDGraphic_SpriteSheet* sheet,
+                                  const CFBDGraphic_Point* point,
+                                  uint32_t frame_delay_ms,
+                                  CFBD_Bool loop);
+
+/**
+ * @brief Advance the animation to the tick @p now_ms.
+ *
+ * @details
+ * Never waits: returns at once when the current frame is not over yet.
+ * The first call clears the sprite area and draws frame 0. Late ticks
+ * apply every skipped delta so the animation stays in time. The device
+ * raster op is ignored, runs are always copied. In immediate mode the
+ * pixels changed by the whole tick are flushed with one update_area().
+ *
+ * @param device Device the sprite lives on.
+ * @param player Player to advance.
+ * @param now_ms Monotonic millisecond tick, wrapping is fine.
+ * @param dirty Optional, receives the bounding box (inclusive corners) of
+ *        the changed pixels, e.g. for CFBDGraphic_DisplayListReplay().
+ * @return CFBD_TRUE if anything was drawn.
+ */
+CFBD_Bool CFBDGraphic_SpritePlayerTick(CFBD_GraphicDevice* device,
+                                       CFBDGraphic_SpritePlayer* player,
+                                       uint32_t now_ms,
+                                       CFBDGraphicRect* dirty);
+
+/**
+ * @brief Play again from frame 0 on the next tick (the area is redrawn).
+ */
+void CFBDGraphic_SpritePlayerRestart(CFBDGraphic_SpritePlayer* player);
+
+/**
+ * @brief Check whether a non looping player has shown its last frame.
+ */
+CFBD_Bool CFBDGraphic_SpritePlayerFinished(const CFBDGraphic_SpritePlayer* player);
+
+/** @} */
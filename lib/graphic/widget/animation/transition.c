@@ -0,0 +1,197 @@
+#include "transition.h"
+
+#include <stddef.h>
+
+#include "base/rectangle.h"
+#include "base/size.h"
+#include "device/graphic_clip.h"
+#include "device/graphic_scroll.h"
+#include "sys_clock/system_clock.h"
+
+/* Copy columns [strip_x, strip_x + strip_w) of the area from the page placed at @p page_x */
+static void paint_strip(CFBDGraphic_Transition* t, uint16_t strip_x, uint16_t strip_w, int16_t page_x)
+{
+    CFBD_GraphicDevice* dev = t->device;
+    if (strip_w == 0)
+        return;
+    if (t->page == NULL) {
+        dev->ops->clear_area(dev, strip_x, t->y, strip_w, t->height);
+        return;
+    }
+
+    CFBDGraphicRect strip = {{strip_x, t->y}, {strip_x + strip_w - 1, t->y + t->height - 1}};
+    const CFBD_Bool clipped = CFBDGraphic_PushClip(dev, &strip);
+    CFBDGraphic_DrawMemoryCanvas(dev, t->page, page_x, (int16_t) t->y, CFBD_ROP_COPY);
+    if (clipped)
+        CFBDGraphic_PopClip(dev);
+}
+
+/* Show @p columns columns of the new page, drawing only what changed since t->done */
+static void uncover(CFBDGraphic_Transition* t, uint16_t columns)
+{
+    CFBD_GraphicDevice* dev = t->device;
+    const uint16_t step = columns - t->done;
+    const uint16_t left = t->x;
+    const uint16_t right = t->x + t->width; // exclusive
+
+    uint16_t strip_x, strip_w;
+    int16_t page_x;
+    CFBD_Bool whole_area = CFBD_FALSE;
+
+    const CFBD_Bool immediate = CFBDGraphic_DeviceRequestUpdateAtOnce(dev);
+    CFBDGraphic_DeviceSetIfRequestUpdateAtOnce(dev, CFBD_FALSE);
+    switch (t->effect) {
+        case CFBD_TRANSITION_PUSH_LEFT:
+            if (CFBDGraphic_DeviceScrollColumns(dev, t->x, t->y, t->width, t->height, -(int16_t) step)) {
+                strip_x = right - step;
+                strip_w = step;
+                page_x = (int16_t) (right - columns);
+                whole_area = CFBD_TRUE;
+                break;
+            }
+            // 没有帧缓冲时退化为滑入
+            /* fall through */
+        case CFBD_TRANSITION_SLIDE_LEFT:
+            strip_x = right - columns;
+            strip_w = columns;
+            page_x = (int16_t) (right - columns);
+            break;
+        case CFBD_TRANSITION_PUSH_RIGHT:
+            if (CFBDGraphic_DeviceScrollColumns(dev, t->x, t->y, t->width, t->height, (int16_t) step)) {
+                strip_x = left;
+                strip_w = step;
+                page_x = (int16_t) (left + columns - t->width);
+                whole_area = CFBD_TRUE;
+                break;
+            }
+            /* fall through */
+        case CFBD_TRANSITION_SLIDE_RIGHT:
+            strip_x = left;
+            strip_w = columns;
+            page_x = (int16_t) (left + columns - t->width);
+            break;
+        case CFBD_TRANSITION_WIPE_LEFT:
+            strip_x = right - columns;
+            strip_w = step;
+            page_x = (int16_t) left;
+            break;
+        default: // CFBD_TRANSITION_WIPE_RIGHT
+            strip_x = left + t->done;
+            strip_w = step;
+            page_x = (int16_t) left;
+            break;
+    }
+    paint_strip(t, strip_x, strip_w, page_x);
+    CFBDGraphic_DeviceSetIfRequestUpdateAtOnce(dev, immediate);
+
+    if (whole_area)
+        dev->ops->update_area(dev, t->x, t->y, t->width, t->height);
+    else
+        dev->ops->update_area(dev, strip_x, t->y, strip_w, t->height);
+    t->done = columns;
+}
+
+/*
+    Contrast follows |frames - 2 * frame| / frames of the original level:
+    down to 0 at the middle, back up at the end. The new page is written
+    once, at the first frame past the middle.
+*/
+static void fade_to(CFBDGraphic_Transition* t, uint32_t due, uint32_t frames)
+{
+    CFBD_GraphicDevice* dev = t->device;
+    const uint32_t distance = (2 * due > frames) ? 2 * due - frames : frames - 2 * due;
+    uint8_t level = (uint8_t) ((uint32_t) t->contrast * distance / frames);
+    dev->ops->self_sets(dev, "contrast", NULL, &level);
+
+    if (t->done == 0 && 2 * due >= frames) {
+        const CFBD_Bool immediate = CFBDGraphic_DeviceRequestUpdateAtOnce(dev);
+        CFBDGraphic_DeviceSetIfRequestUpdateAtOnce(dev, CFBD_FALSE);
+        paint_strip(t, t->x, t->width, (int16_t) t->x);
+        CFBDGraphic_DeviceSetIfRequestUpdateAtOnce(dev, immediate);
+        dev->ops->update_area(dev, t->x, t->y, t->width, t->height);
+        t->done = t->width;
+    }
+}
+
+void CFBDGraphic_BeginTransition(CFBDGraphic_Transition* t,
+                                 CFBD_GraphicDevice* device,
+                                 CFBDGraphic_TransitionEffect effect,
+                                 const CFBDGraphic_MemoryCanvas* page,
+                                 uint16_t x,
+                                 uint16_t y,
+                                 const CFBD_BaseAnimation* timing,
+                                 uint32_t now_ms)
+{
+    t->device = device;
+    t->page = page;
+    t->effect = effect;
+    t->timing = *timing;
+    t->curve = CFBD_EASE_OUT;
+    t->x = x;
+    t->y = y;
+    if (page != NULL) {
+        t->width = page->width;
+        t->height = page->height;
+    }
+    else {
+        CFBDGraphicSize screen;
+        CFBDGraphic_GetScreenSize(device, &screen);
+        t->width = (screen.width > x) ? screen.width - x : 0;
+        t->height = (screen.height > y) ? screen.height - y : 0;
+    }
+    t->done = 0;
+    t->start_ms = now_ms;
+    t->frame = 0;
+    t->running = (t->width > 0 && t->height > 0);
+
+    // 不支持对比度的设备用擦除代替淡入淡出
+    if (effect == CFBD_TRANSITION_FADE &&
+        !device->ops->self_consult(device, "contrast", NULL, &t->contrast))
+        t->effect = CFBD_TRANSITION_WIPE_RIGHT;
+}
+
+CFBD_Bool CFBDGraphic_TransitionTick(CFBDGraphic_Transition* t, uint32_t now_ms)
+{
+    if (!t->running)
+        return CFBD_FALSE;
+
+    const uint8_t frames = (t->timing.anim_frames > 1) ? t->timing.anim_frames : 1;
+    if (!CFBD_AnimationAdvanceFrame(
+                &t->frame, frames, t->timing.anim_frame_delay_ms, now_ms - t->start_ms))
+        return CFBD_TRUE;
+    const uint8_t due = t->frame;
+
+    if (t->effect == CFBD_TRANSITION_FADE) {
+        fade_to(t, due, frames);
+    }
+    else {
+        const int32_t p = CFBD_EaseQ16(t->curve, CFBD_EaseProgressQ16(due, frames));
+        int32_t columns = CFBD_EaseLerp(0, t->width, p);
+        if (columns > t->width || due == frames)
+            columns = t->width;
+        // 只前进不后退, 回弹曲线在终点处停住
+        if (columns > t->done)
+            uncover(t, (uint16_t) columns);
+    }
+
+    if (due == frames)
+        t->running = CFBD_FALSE;
+    return t->running;
+}
+
+void CFBDGraphic_PlayTransition(CFBD_GraphicDevice* device,
+                                CFBDGraphic_TransitionEffect effect,
+                                const CFBDGraphic_MemoryCanvas* page,
+                                uint16_t x,
+                                uint16_t y,
+                                const CFBD_BaseAnimation* timing)
+{
+    // blocking flavour: the same state machine driven by a virtual clock
+    CFBDGraphic_Transition t;
+    uint32_t now_ms = 0;
+    CFBDGraphic_BeginTransition(&t, device, effect, page, x, y, timing, now_ms);
+    while (CFBDGraphic_TransitionTick(&t, now_ms)) {
+        system_delay_ms(timing->anim_frame_delay_ms);
+        now_ms += timing->anim_frame_delay_ms;
+    }
+}
@@ -0,0 +1,140 @@
+/**
+ * @file transition.h
+ * @brief Page transitions: slide, push, wipe and fade.
+ * @ingroup Graphics_Animation
+ *
+ * @details
+ * Switching pages with clear() + update() + a full redraw shows a black
+ * frame in between. A transition moves from the page on screen to a page
+ * pre-rendered into a memory canvas and only sends what changes:
+ *
+ * | effect | per frame                                                       |
+ * |--------|-----------------------------------------------------------------|
+ * | slide  | the part of the new page already on screen, old page untouched  |
+ * | push   | frame buffer shifted with CFBDGraphic_DeviceScrollColumns(), the |
+ * |        | exposed strip copied from the new page, whole area flushed       |
+ * | wipe   | only the columns uncovered since the last frame                  |
+ * | fade   | two command bytes: the contrast register (0x81) ramps down, the  |
+ * |        | new page is written once while dark, then the contrast ramps up  |
+ *
+ * Pages are copied with CFBDGraphic_DrawMemoryCanvas() under a clip, a
+ * page row at a time in the 1bpp page layout. A NULL page transitions to
+ * a blank screen. Devices without a "contrast" property fade with a wipe,
+ * devices without a frame buffer push with a slide.
+ *
+ * Like the other animations a transition is advanced by ticks; late ticks
+ * skip frames, with a frame delay of 0 every tick draws the next frame.
+ * CFBDGraphic_PlayTransition() is the blocking flavour.
+ *
+ * @example
+ * @code
+ * static uint8_t next_pixels[CFBDGraphic_MEMORY_CANVAS_BYTES(128, 64)];
+ * CFBDGraphic_MemoryCanvas next = {next_pixels, 128, 64};
+ * CFBD_GraphicDevice offscreen;
+ * CFBDGraphic_BindMemoryAsDevice(&offscreen, &next);
+ * draw_settings_page(&offscreen);
+ *
+ * CFBDGraphic_Transition t;
+ * CFBD_BaseAnimation timing = {.anim_frames = 12, .anim_frame_delay_ms = 20};
+ * CFBDGraphic_BeginTransition(&t, panel, CFBD_TRANSITION_PUSH_LEFT, &next, 0, 0, &timing, millis());
+ * // main loop
+ * CFBDGraphic_TransitionTick(&t, millis());
+ * @endcode
+ */
+
+#pragma once
+#include <stdint.h>
+
+#include "animation.h"
+#include "cfbd_define.h"
+#include "device/graphic_device.h"
+#include "device/memory/memory_graphic_device.h"
+#include "easing.h"
+
+/**
+ * @addtogroup Graphics_Animation
+ * @{
+ */
+
+/**
+ * @enum CFBDGraphic_TransitionEffect
+ * @brief How the new page replaces the old one.
+ */
+typedef enum
+{
+    CFBD_TRANSITION_SLIDE_LEFT,  /**< New page slides in from the right over the old one */
+    CFBD_TRANSITION_SLIDE_RIGHT, /**< New page slides in from the left over the old one */
+    CFBD_TRANSITION_PUSH_LEFT,   /**< New page pushes the old one out to the left */
+    CFBD_TRANSITION_PUSH_RIGHT,  /**< New page pushes the old one out to the right */
+    CFBD_TRANSITION_WIPE_LEFT,   /**< New page uncovered from the right edge leftwards */
+    CFBD_TRANSITION_WIPE_RIGHT,  /**< New page uncovered from the left edge rightwards */
+    CFBD_TRANSITION_FADE,        /**< Old page fades out, new page fades in */
+} CFBDGraphic_TransitionEffect;
+
+/**
+ * @struct CFBDGraphic_Transition
+ * @brief State of a running transition.
+ */
+typedef struct
+{
+    CFBD_GraphicDevice* device;             /**< Panel the pages are shown on */
+    const CFBDGraphic_MemoryCanvas* page;   /**< New page, NULL for a blank one */
+    CFBDGraphic_TransitionEffect effect;    /**< Effect actually played */
+    CFBD_BaseAnimation timing;              /**< Frame count and frame delay */
+    CFBD_EasingCurve curve;                 /**< Easing of the moving effects */
+    uint16_t x;                             /**< Left column of the page area */
+    uint16_t y;                             /**< Top row of the page area */
+    uint16_t width;                         /**< Width of the page area */
+    uint16_t height;                        /**< Height of the page area */
+    uint16_t done;                          /**< Columns of the new page already shown */
+    uint8_t contrast;                       /**< Fade: contrast to return to */
+    uint32_t start_ms;                      /**< Tick (ms) of frame 0 */
+    uint8_t frame;                          /**< Frame currently on screen */
+    CFBD_Bool running;                      /**< CFBD_TRUE until the last frame is shown */
+} CFBDGraphic_Transition;
+
+/**
+ * @brief Start a transition, nothing is drawn before the first tick.
+ *
+ * @details
+ * The page area is the size of @p page at (@p x, @p y), or the rest of
+ * the screen for a blank page. Moving effects ease with CFBD_EASE_OUT,
+ * change @ref CFBDGraphic_Transition::curve after this call for another
+ * curve.
+ *
+ * @param t Transition to start.
+ * @param device Panel the old page is on.
+ * @param effect Effect to play.
+ * @param page New page, must outlive the transition; NULL for blank.
+ * @param x Left column of the page area.
+ * @param y Top row of the page area.
+ * @param timing Frame count and frame delay, copied.
+ * @param now_ms Monotonic millisecond tick, wrapping is fine.
+ */
+void CFBDGraphic_BeginTransition(CFBDGraphic_Transition* t,
+                                 CFBD_GraphicDevice* device,
+                                 CFBDGraphic_TransitionEffect effect,
+                                 const CFBDGraphic_MemoryCanvas* page,
+                                 uint16_t x,
+                                 uint16_t y,
+                                 const CFBD_BaseAnimation* timing,
+                                 uint32_t now_ms);
+
+/**
+ * @brief Draw the transition frame due at @p now_ms, never waits.
+ * @return CFBD_TRUE while the transition is still running.
+ */
+CFBD_Bool CFBDGraphic_TransitionTick(CFBDGraphic_Transition* t, uint32_t now_ms);
+
+/**
+ * @brief Play a whole transition, blocking with system_delay_ms() between frames.
+ * @see CFBDGraphic_BeginTransition() for the parameters.
+ */
+void CFBDGraphic_PlayTransition(CFBD_GraphicDevice* device,
+                                CFBDGraphic_TransitionEffect effect,
+                                const CFBDGraphic_MemoryCanvas* page,
+                                uint16_t x,
+                                uint16_t y,
+                                const CFBD_BaseAnimation* timing);
+
+/** @} */
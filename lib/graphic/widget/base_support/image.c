@@ -2,7 +2,15 @@
 
 #include "base/rectangle.h"
 #include "base/size.h"
+#include "device/graphic_canvas.h"
+#include "device/graphic_clip.h"
 #include "device/graphic_device.h"
+#include "device/graphic_scale.h"
+#include "device/graphic_transform.h"
+#include "resource/rle.h"
+
+/* Columns decoded per blit while streaming a compressed image */
+#define CFBD_IMAGE_STREAM_CHUNK (32)
 
 void CFBDGraphic_InitImage(CCGraphic_Image* image,
                            CFBDGraphic_Point* tl_point,
@@ -12,14 +20,77 @@ void CFBDGraphic_InitImage(CCGraphic_Image* image,
     image->image_size = *image_size;
     image->point = *tl_point;
     image->sources_register = sources_register;
+    image->encoding = CFBD_IMAGE_RAW;
+}
+
+void CFBDGraphic_InitCompressedImage(CCGraphic_Image* image,
+                                     CFBDGraphic_Point* tl_point,
+                                     CFBDGraphicSize* image_size,
+                                     const uint8_t* compressed)
+{
+    image->image_size = *image_size;
+    image->point = *tl_point;
+    // 只读: 压缩流仅被解码, 从不写回
+    image->sources_register = (uint8_t*) compressed;
+    image->encoding = CFBD_IMAGE_RLE;
+}
+
+/*
+    Decode one page row at a time, CFBD_IMAGE_STREAM_CHUNK columns per
+    piece, and blit each piece at its final position.
+*/
+static void stream_rle_image(CFBD_GraphicDevice* device, CCGraphic_Image* image)
+{
+    uint8_t chunk[CFBD_IMAGE_STREAM_CHUNK];
+    CFBDGraphic_Canvas canvas;
+    const CFBD_Bool has_canvas = CFBDGraphic_DeviceFetchCanvas(device, &canvas);
+    const uint16_t width = image->image_size.width;
+    const uint16_t height = image->image_size.height;
+
+    CFBDGraphic_RleStream stream;
+    CFBDGraphic_RleOpen(&stream, image->sources_register);
+
+    for (uint16_t top = 0; top < height; top += 8) {
+        const uint16_t rows = (height - top < 8) ? (height - top) : 8;
+        const uint16_t y = image->point.y + top;
+        if (has_canvas && y > canvas.clip.y1)
+            break; // the remaining pages lie below the clip
+
+        for (uint16_t left = 0; left < width; left += CFBD_IMAGE_STREAM_CHUNK) {
+            uint16_t columns = width - left;
+            if (columns > CFBD_IMAGE_STREAM_CHUNK)
+                columns = CFBD_IMAGE_STREAM_CHUNK;
+            CFBDGraphic_RleRead(&stream, chunk, columns);
+            if (has_canvas)
+                CFBDGraphic_CanvasBlit(&canvas, image->point.x + left, y, columns, rows, chunk);
+            else
+                device->ops->setArea(device, image->point.x + left, y, columns, rows, chunk);
+        }
+    }
+}
+
+static void set_whole_image(CFBD_GraphicDevice* device, CCGraphic_Image* image)
+{
+    if (image->encoding == CFBD_IMAGE_RLE) {
+        stream_rle_image(device, image);
+        return;
+    }
+    device->ops->setArea(device,
+                         image->point.x,
+                         image->point.y,
+                         image->image_size.width,
+                         image->image_size.height,
+                         image->sources_register);
 }
 
 /**
- * @brief Draw image with clipping using small fixed buffer (batch processing)
+ * @brief Draw image with clipping through the device clip stack
  * @param device - Graphic device
  * @param image - Image to draw
- * @param clip_rect - Clipping rectangle (viewport bounds)
- * @note Uses 64-byte fixed buffer, processes image in columns batches
+ * @param clip_rect - Clipping rectangle (viewport bounds, br exclusive)
+ * @note Plain images copy only the visible window through the device blit
+ *       op, compressed ones are streamed under a pushed clip rectangle.
+ *       Either way immediate mode flushes the visible part once.
  */
 void CFBDGraphic_DrawImageClipped(CFBD_GraphicDevice* device,
                                   CCGraphic_Image* image,
@@ -30,16 +101,16 @@ void CFBDGraphic_DrawImageClipped(CFBD_GraphicDevice* device,
     }
 
     // 计算图像的边界
-    int16_t img_left = (int16_t) image->point.x;
-    int16_t img_top = (int16_t) image->point.y;
-    int16_t img_right = img_left + (int16_t) image->image_size.width;
-    int16_t img_bottom = img_top + (int16_t) image->image_size.height;
+    int32_t img_left = image->point.x;
+    int32_t img_top = image->point.y;
+    int32_t img_right = img_left + image->image_size.width;
+    int32_t img_bottom = img_top + image->image_size.height;
 
     // 计算裁剪区域的边界
-    int16_t clip_left = clip_rect->tl.x;
-    int16_t clip_top = clip_rect->tl.y;
-    int16_t clip_right = clip_rect->br.x;
-    int16_t clip_bottom = clip_rect->br.y;
+    int32_t clip_left = clip_rect->tl.x;
+    int32_t clip_top = clip_rect->tl.y;
+    int32_t clip_right = clip_rect->br.x;
+    int32_t clip_bottom = clip_rect->br.y;
 
     // 检查是否完全在裁剪区域外
     if (img_right <= clip_left || img_left >= clip_right || img_bottom <= clip_top ||
@@ -47,124 +118,64 @@ void CFBDGraphic_DrawImageClipped(CFBD_GraphicDevice* device,
         return; // 完全不可见
     }
 
-    // 计算可见区域的交集
-    int16_t visible_left = (img_left < clip_left) ? clip_left : img_left;
-    int16_t visible_top = (img_top < clip_top) ? clip_top : img_top;
-    int16_t visible_right = (img_right > clip_right) ? clip_right : img_right;
-    int16_t visible_bottom = (img_bottom > clip_bottom) ? clip_bottom : img_bottom;
-
-    // 计算裁剪后的尺寸
-    uint16_t visible_width = (uint16_t) (visible_right - visible_left);
-    uint16_t visible_height = (uint16_t) (visible_bottom - visible_top);
-
-    if (visible_width == 0 || visible_height == 0) {
-        return;
-    }
-
     // 如果图像完全在裁剪区域内，直接绘制
-    if (visible_left == img_left && visible_top == img_top && visible_right == img_right &&
-        visible_bottom == img_bottom) {
+    if (img_left >= clip_left && img_top >= clip_top && img_right <= clip_right &&
+        img_bottom <= clip_bottom) {
         CFBDGraphic_DrawImage(device, image);
         return;
     }
 
-    // 计算在原图像中的偏移量
-    uint16_t offset_x = (uint16_t) (visible_left - img_left);
-    uint16_t offset_y = (uint16_t) (visible_top - img_top);
-
-// 固定64字节缓冲区
-#define CLIP_BUFFER_SIZE 64
-    uint8_t clipped_buffer[CLIP_BUFFER_SIZE];
-
-    // 计算每列需要的字节数（OLED垂直字节格式）
-    uint16_t bytes_per_column = (visible_height + 7) / 8;
-
-    // 计算每批次能处理多少列
-    uint16_t columns_per_batch = CLIP_BUFFER_SIZE / bytes_per_column;
-    if (columns_per_batch == 0) {
-        columns_per_batch = 1; // 至少处理1列
+    // 计算可见区域的交集
+    int32_t visible_left = (img_left < clip_left) ? clip_left : img_left;
+    int32_t visible_top = (img_top < clip_top) ? clip_top : img_top;
+    int32_t visible_right = (img_right > clip_right) ? clip_right : img_right;
+    int32_t visible_bottom = (img_bottom > clip_bottom) ? clip_bottom : img_bottom;
+
+    // 未压缩图像: 直接拷贝可见窗口, 一次刷新
+    if (image->encoding == CFBD_IMAGE_RAW) {
+        const CFBDGraphic_BlitSource window = {image->sources_register,
+                                               image->image_size.width,
+                                               (uint16_t) (visible_left - img_left),
+                                               (uint16_t) (visible_top - img_top),
+                                               (uint16_t) (visible_right - visible_left),
+                                               (uint16_t) (visible_bottom - visible_top)};
+        CFBDGraphic_DeviceBlit(device,
+                               &window,
+                               (uint16_t) visible_left,
+                               (uint16_t) visible_top,
+                               device->rop);
+        return;
     }
 
-    // 源图像的每列字节数
-    uint16_t src_bytes_per_column = (image->image_size.height + 7) / 8;
-    uint8_t bit_offset = offset_y % 8;
-
-    // 分批次处理
-    for (uint16_t batch_start = 0; batch_start < visible_width; batch_start += columns_per_batch) {
-        // 计算本批次实际处理的列数
-        uint16_t batch_cols = columns_per_batch;
-        if (batch_start + batch_cols > visible_width) {
-            batch_cols = visible_width - batch_start;
-        }
-
-        // 提取本批次的bitmap数据
-        for (uint16_t x = 0; x < batch_cols; x++) {
-            uint16_t src_x = offset_x + batch_start + x;
-
-            for (uint16_t byte_y = 0; byte_y < bytes_per_column; byte_y++) {
-                uint16_t src_byte_y = (offset_y / 8) + byte_y;
-
-                if (src_byte_y < src_bytes_per_column && src_x < image->image_size.width) {
-                    uint8_t src_data =
-                            image->sources_register[src_byte_y * image->image_size.width + src_x];
-
-                    // 处理垂直偏移
-                    if (bit_offset == 0) {
-                        clipped_buffer[byte_y * batch_cols + x] = src_data;
-                    }
-                    else {
-                        // 需要移位拼接
-                        uint8_t current_byte = src_data >> bit_offset;
-
-                        if (src_byte_y + 1 < src_bytes_per_column) {
-                            uint8_t next_byte =
-                                    image->sources_register[(src_byte_y + 1) *
-                                                                    image->image_size.width +
-                                                            src_x];
-                            current_byte |= (next_byte << (8 - bit_offset));
-                        }
-
-                        clipped_buffer[byte_y * batch_cols + x] = current_byte;
-                    }
-                }
-                else {
-                    clipped_buffer[byte_y * batch_cols + x] = 0;
-                }
-            }
-        }
-
-        // 绘制本批次
-        uint16_t batch_x = (uint16_t) (visible_left + batch_start);
-        device->ops->setArea(device,
-                             batch_x,
-                             (uint16_t) visible_top,
-                             batch_cols,
-                             visible_height,
-                             clipped_buffer);
-
-        // 立即更新这一批次
-        if (CFBDGraphic_DeviceRequestUpdateAtOnce(device)) {
-            device->ops->update_area(device,
-                                     batch_x,
-                                     (uint16_t) visible_top,
-                                     batch_cols,
-                                     visible_height);
-        }
+    // 压缩图像按页流式解码: 裁剪栈使用包含式右下角
+    CFBDGraphicRect visible = {{(uint16_t) visible_left, (uint16_t) visible_top},
+                               {(uint16_t) (visible_right - 1), (uint16_t) (visible_bottom - 1)}};
+    if (CFBDGraphic_PushClip(device, &visible)) {
+        set_whole_image(device, image);
+        CFBDGraphic_PopClip(device);
+    }
+    else {
+        // 裁剪栈已满：临时收窄栈顶，绘制后恢复
+        CFBDGraphic_ClipBounds saved = device->clip.bounds[device->clip.depth - 1];
+        CFBDGraphic_IntersectClip(device, &visible);
+        set_whole_image(device, image);
+        device->clip.bounds[device->clip.depth - 1] = saved;
     }
 
-#undef CLIP_BUFFER_SIZE
+    if (CFBDGraphic_DeviceRequestUpdateAtOnce(device)) {
+        device->ops->update_area(device,
+                                 (uint16_t) visible_left,
+                                 (uint16_t) visible_top,
+                                 (uint16_t) (visible_right - visible_left),
+                                 (uint16_t) (visible_bottom - visible_top));
+    }
 }
 
 void CFBDGraphic_DrawImage(CFBD_GraphicDevice* handler, CCGraphic_Image* image)
 {
     if (!image->sources_register)
         return;
-    handler->ops->setArea(handler,
-                          image->point.x,
-                          image->point.y,
-                          image->image_size.width,
-                          image->image_size.height,
-                          image->sources_register);
+    set_whole_image(handler, image);
     if (CFBDGraphic_DeviceRequestUpdateAtOnce(handler)) {
         handler->ops->update_area(handler,
                                   image->point.x,
@@ -173,3 +184,54 @@ void CFBDGraphic_DrawImage(CFBD_GraphicDevice* handler, CCGraphic_Image* image)
                                   image->image_size.height);
     }
 }
+
+CFBD_Bool CFBDGraphic_DrawImageTransformed(CFBD_GraphicDevice* device,
+                                           CCGraphic_Image* image,
+                                           CFBDGraphic_Transform transform)
+{
+    if (!image->sources_register)
+        return CFBD_FALSE;
+    if (transform == CFBD_TRANSFORM_NONE) {
+        CFBDGraphic_DrawImage(device, image);
+        return CFBD_TRUE;
+    }
+    if (image->encoding != CFBD_IMAGE_RAW)
+        return CFBD_FALSE;
+
+    const CFBDGraphic_BlitSource whole = {image->sources_register,
+                                          image->image_size.width,
+                                          0,
+                                          0,
+                                          image->image_size.width,
+                                          image->image_size.height};
+    CFBDGraphic_DeviceBlitTransformed(device,
+                                      &whole,
+                                      image->point.x,
+                                      image->point.y,
+                                      transform,
+                                      device->rop);
+    return CFBD_TRUE;
+}
+
+CFBD_Bool CFBDGraphic_DrawImageScaled(CFBD_GraphicDevice* device,
+                                      CCGraphic_Image* image,
+                                      const CFBDGraphicSize* size)
+{
+    if (!image->sources_register || image->encoding != CFBD_IMAGE_RAW)
+        return CFBD_FALSE;
+
+    const CFBDGraphic_BlitSource whole = {image->sources_register,
+                                          image->image_size.width,
+                                          0,
+                                          0,
+                                          image->image_size.width,
+                                          image->image_size.height};
+    CFBDGraphic_DeviceBlitScaled(device,
+                                 &whole,
+                                 image->point.x,
+                                 image->point.y,
+                                 size->width,
+                                 size->height,
+                                 device->rop);
+    return CFBD_TRUE;
+}
@@ -13,6 +13,19 @@
 #include "base/rectangle.h"
 #include "base/size.h"
 #include "cfbd_graphic_define.h"
+#include "device/graphic_transform.h"
+
+/**
+ * @enum CFBDGraphic_ImageEncoding
+ * @brief How CCGraphic_Image::sources_register is stored
+ */
+typedef enum
+{
+    /** Plain setArea() bitmap */
+    CFBD_IMAGE_RAW = 0,
+    /** RLE stream (resource/rle.h), decoded while drawing */
+    CFBD_IMAGE_RLE
+} CFBDGraphic_ImageEncoding;
 
 /**
  * @typedef CCGraphic_Image
@@ -32,6 +45,9 @@ typedef struct
 
     /** @brief Pointer to bitmap data (owned by caller) */
     uint8_t* sources_register;
+
+    /** @brief Encoding of sources_register, see CFBDGraphic_ImageEncoding */
+    uint8_t encoding;
 } CCGraphic_Image;
 
 /**
@@ -59,6 +75,27 @@ void CFBDGraphic_InitImage(CCGraphic_Image* image,
                            CFBDGraphicSize* image_size,
                            uint8_t* sources_register);
 
+/**
+ * @brief Initialize an image from an RLE compressed bitmap
+ * @details The bitmap is never decompressed as a whole: drawing decodes one
+ *          page row at a time in small chunks and blits each chunk straight
+ *          into the frame buffer (or hands it to setArea() on devices without
+ *          a canvas). Produce the stream with resource/tools/cfbd_rle.py.
+ * @param[out] image - Image structure to initialize
+ * @param[in] tl_point - Top-left position in pixels
+ * @param[in] image_size - Width and height dimensions
+ * @param[in] compressed - RLE stream, usually a const array in flash
+ * @example
+ *     extern const uint8_t logo_rle[];
+ *     CFBDGraphic_InitCompressedImage(&img, &pos, &sz, logo_rle);
+ *     CFBDGraphic_DrawImage(device, &img);
+ * @see CFBDGraphic_InitImage
+ */
+void CFBDGraphic_InitCompressedImage(CCGraphic_Image* image,
+                                     CFBDGraphic_Point* tl_point,
+                                     CFBDGraphicSize* image_size,
+                                     const uint8_t* compressed);
+
 /**
  * @brief Draw image widget on graphics device
  * @details Renders the image bitmap to the graphics device at the specified
@@ -81,14 +118,56 @@ void CFBDGraphic_InitImage(CCGraphic_Image* image,
 void CFBDGraphic_DrawImage(CFBD_GraphicDevice* handler, CCGraphic_Image* image);
 
 /**
- * @brief Draw image with clipping using small fixed buffer (batch processing)
+ * @brief Draw image with clipping through the device clip stack
  * @param device - Graphic device
  * @param image - Image to draw
- * @param clip_rect - Clipping rectangle (viewport bounds)
- * @note Uses 64-byte fixed buffer, processes image in columns batches
+ * @param clip_rect - Clipping rectangle (viewport bounds, br exclusive)
+ * @note Only the visible window of the bitmap is copied, shifted straight
+ *       into the frame buffer pages (see CFBDGraphic_DeviceBlit()); no
+ *       intermediate buffer is used and immediate mode flushes once
+ * @see CFBDGraphic_PushClip
  */
 void CFBDGraphic_DrawImageClipped(CFBD_GraphicDevice* device,
                                   CCGraphic_Image* image,
                                   CFBDGraphicRect* clip_rect);
 
+/**
+ * @brief Draw an image rotated or mirrored at its position
+ * @details The transformed bitmap keeps its top-left corner at
+ *          image->point; the quarter turns swap width and height. Uses the
+ *          8x8 block path of CFBDGraphic_DeviceBlitTransformed() with the
+ *          device raster op and flushes once in immediate mode.
+ * @param[in] device - Graphics device to draw on
+ * @param[in] image - Image widget to render
+ * @param[in] transform - Rotation or mirroring to apply
+ * @return CFBD_FALSE for compressed images with a transform other than
+ *         CFBD_TRANSFORM_NONE (their stream cannot be read out of order)
+ * @example
+ *     // the same arrow asset pointing right and down
+ *     CFBDGraphic_DrawImage(dev, &arrow);
+ *     CFBDGraphic_DrawImageTransformed(dev, &arrow_down, CFBD_TRANSFORM_ROTATE_90);
+ * @see CFBDGraphic_DeviceBlitTransformed
+ */
+CFBD_Bool CFBDGraphic_DrawImageTransformed(CFBD_GraphicDevice* device,
+                                           CCGraphic_Image* image,
+                                           CFBDGraphic_Transform transform);
+
+/**
+ * @brief Draw an image stretched to another size at its position
+ * @details Nearest neighbour scaling through CFBDGraphic_DeviceBlitScaled();
+ *          exact 2x and 4x enlargements use its lookup table path. The
+ *          device raster op applies and immediate mode flushes once.
+ * @param[in] device - Graphics device to draw on
+ * @param[in] image - Image widget to render
+ * @param[in] size - Size of the drawn image
+ * @return CFBD_FALSE for compressed images (their stream cannot be sampled)
+ * @example
+ *     CFBDGraphicSize big = {32, 32};
+ *     CFBDGraphic_DrawImageScaled(dev, &icon16, &big);  // one 16x16 asset, two sizes
+ * @see CFBDGraphic_DeviceBlitScaled
+ */
+CFBD_Bool CFBDGraphic_DrawImageScaled(CFBD_GraphicDevice* device,
+                                      CCGraphic_Image* image,
+                                      const CFBDGraphicSize* size);
+
 /** @} */
@@ -0,0 +1,188 @@
+#include "marquee.h"
+
+#include <stddef.h>
+
+#include "base/rectangle.h"
+#include "device/graphic_clip.h"
+#include "widget/text.h"
+
+void CFBDGraphic_InitMarquee(CFBDGraphic_Marquee* marquee,
+                             CFBD_GraphicDevice* device,
+                             CFBDGraphic_Point tl_point,
+                             CFBDGraphicSize size,
+                             Ascii_Font_Size font_size,
+                             uint8_t* strip_buffer,
+                             uint16_t strip_bytes)
+{
+    marquee->device = device;
+    marquee->tl_point = tl_point;
+    marquee->size = size;
+    marquee->font_size = font_size;
+    marquee->strip.buffer = strip_buffer;
+    marquee->strip.width = 0;
+    marquee->strip.height = 0;
+    marquee->strip.origin_y = 0;
+    marquee->strip.format = CFBD_CANVAS_1BPP_PAGE;
+    marquee->strip.color = 0;
+    marquee->capacity = strip_bytes;
+    marquee->step_ms = CFBDGraphic_MARQUEE_STEP_MS;
+    marquee->gap = CFBDGraphic_MARQUEE_GAP;
+    marquee->pause_ms = CFBDGraphic_MARQUEE_PAUSE_MS;
+    marquee->start_ms = 0;
+    marquee->offset = 0;
+    marquee->drawn = CFBD_FALSE;
+}
+
+void CFBDGraphic_SetMarqueeText(CFBDGraphic_Marquee* marquee, const char* text)
+{
+    const CFBDGraphicSize measured = CFBDGraphic_MeasureText(text, marquee->font_size, 0);
+    const uint16_t pages = (measured.height + 7) / 8;
+    uint16_t width = measured.width;
+    if (pages == 0)
+        width = 0;
+    else if (width > marquee->capacity / pages)
+        width = marquee->capacity / pages; // 缓冲区不够时截断文字
+
+    CFBDGraphic_MemoryCanvas* strip = &marquee->strip;
+    strip->width = width;
+    strip->height = (width > 0) ? measured.height : 0;
+    marquee->offset = 0;
+    marquee->drawn = CFBD_FALSE;
+    if (width == 0)
+        return;
+
+    // 文字只在这里光栅化一次
+    CFBD_GraphicDevice offscreen;
+    CFBDGraphic_BindMemoryAsDevice(&offscreen, strip);
+    offscreen.ops->clear(&offscreen);
+
+    CFBDGraphic_Text label;
+    CFBDGraphic_Point origin = {0, 0};
+    CFBDGraphicSize area = {strip->width, strip->height};
+    CFBDGraphic_InitText(&label, origin, area, marquee->font_size);
+    label.no_wrap = CFBD_TRUE;
+    CFBDGraphic_SetText(&label, (char*) text);
+    CFBDGraphic_DrawText(&offscreen, &label, CCGraphic_AsciiTextItem_AppendContinously);
+}
+
+void CFBDGraphic_SetMarqueeMotion(CFBDGraphic_Marquee* marquee,
+                                  uint16_t step_ms,
+                                  uint16_t gap,
+                                  uint16_t pause_ms)
+{
+    marquee->step_ms = step_ms;
+    marquee->gap = gap;
+    marquee->pause_ms = pause_ms;
+}
+
+/* Strip column at the left edge of the box at @p now_ms */
+static uint16_t offset_at(const CFBDGraphic_Marquee* marquee, uint32_t now_ms)
+{
+    if (!CFBDGraphic_MarqueeScrolls(marquee))
+        return 0;
+
+    const uint32_t period = (uint32_t) marquee->strip.width + marquee->gap;
+    const uint32_t lap_ms = marquee->pause_ms + period * marquee->step_ms;
+    const uint32_t elapsed = (now_ms - marquee->start_ms) % lap_ms;
+    if (elapsed < marquee->pause_ms)
+        return 0;
+    return (uint16_t) ((elapsed - marquee->pause_ms) / marquee->step_ms);
+}
+
+/* Blank the columns [from, to) of the text rows, clamped to the box */
+static void clear_columns(CFBDGraphic_Marquee* marquee, int32_t from, int32_t to, uint16_t rows)
+{
+    const int32_t left = marquee->tl_point.x;
+    const int32_t right = left + marquee->size.width;
+    if (from < left)
+        from = left;
+    if (to > right)
+        to = right;
+    if (from < to)
+        marquee->device->ops->clear_area(
+                marquee->device, (uint16_t) from, marquee->tl_point.y, (uint16_t) (to - from), rows);
+}
+
+/*
+    Copy the visible window of the strip into the text rows of the box:
+    the text from the current offset, the gap, and the start of the next
+    lap once it comes into view.
+*/
+static void paint_window(CFBDGraphic_Marquee* marquee, uint16_t rows)
+{
+    CFBD_GraphicDevice* dev = marquee->device;
+    const CFBDGraphic_MemoryCanvas* strip = &marquee->strip;
+    const int32_t right = marquee->tl_point.x + marquee->size.width;
+    const int32_t text_x = marquee->tl_point.x - marquee->offset;
+    const int32_t gap_x = text_x + strip->width;
+
+    CFBDGraphicRect box = {marquee->tl_point,
+                           {marquee->tl_point.x + marquee->size.width - 1,
+                            marquee->tl_point.y + rows - 1}};
+    const CFBD_Bool clipped = CFBDGraphic_PushClip(dev, &box);
+    CFBDGraphic_DrawMemoryCanvas(dev, strip, (int16_t) text_x, marquee->tl_point.y, CFBD_ROP_COPY);
+    if (CFBDGraphic_MarqueeScrolls(marquee)) {
+        clear_columns(marquee, gap_x, gap_x + marquee->gap, rows);
+        if (gap_x + marquee->gap < right)
+            CFBDGraphic_DrawMemoryCanvas(
+                    dev, strip, (int16_t) (gap_x + marquee->gap), marquee->tl_point.y, CFBD_ROP_COPY);
+    }
+    else {
+        clear_columns(marquee, gap_x, right, rows);
+    }
+    if (clipped)
+        CFBDGraphic_PopClip(dev);
+}
+
+/* Text rows of the box */
+static inline uint16_t text_rows(const CFBDGraphic_Marquee* marquee)
+{
+    return (marquee->strip.height < marquee->size.height) ? marquee->strip.height
+                                                          : marquee->size.height;
+}
+
+void CFBDGraphic_DrawMarquee(CFBDGraphic_Marquee* marquee, uint32_t now_ms)
+{
+    CFBD_GraphicDevice* dev = marquee->device;
+    if (marquee->size.width == 0 || marquee->size.height == 0)
+        return;
+    if (!marquee->drawn)
+        marquee->start_ms = now_ms;
+    marquee->offset = offset_at(marquee, now_ms);
+
+    // 绘制期间不刷新, 结束后刷新整个区域一次
+    const CFBD_Bool immediate = CFBDGraphic_DeviceRequestUpdateAtOnce(dev);
+    CFBDGraphic_DeviceSetIfRequestUpdateAtOnce(dev, CFBD_FALSE);
+    dev->ops->clear_area(
+            dev, marquee->tl_point.x, marquee->tl_point.y, marquee->size.width, marquee->size.height);
+    if (text_rows(marquee) > 0)
+        paint_window(marquee, text_rows(marquee));
+    CFBDGraphic_DeviceSetIfRequestUpdateAtOnce(dev, immediate);
+
+    dev->ops->update_area(
+            dev, marquee->tl_point.x, marquee->tl_point.y, marquee->size.width, marquee->size.height);
+    marquee->drawn = CFBD_TRUE;
+}
+
+CFBD_Bool CFBDGraphic_MarqueeTick(CFBDGraphic_Marquee* marquee, uint32_t now_ms)
+{
+    if (!marquee->drawn) {
+        CFBDGraphic_DrawMarquee(marquee, now_ms);
+        return marquee->drawn;
+    }
+
+    const uint16_t offset = offset_at(marquee, now_ms);
+    const uint16_t rows = text_rows(marquee);
+    if (offset == marquee->offset || rows == 0)
+        return CFBD_FALSE;
+    marquee->offset = offset;
+
+    CFBD_GraphicDevice* dev = marquee->device;
+    const CFBD_Bool immediate = CFBDGraphic_DeviceRequestUpdateAtOnce(dev);
+    CFBDGraphic_DeviceSetIfRequestUpdateAtOnce(dev, CFBD_FALSE);
+    paint_window(marquee, rows);
+    CFBDGraphic_DeviceSetIfRequestUpdateAtOnce(dev, immediate);
+
+    dev->ops->update_area(dev, marquee->tl_point.x, marquee->tl_point.y, marquee->size.width, rows);
+    return CFBD_TRUE;
+}
@@ -0,0 +1,159 @@
+/**
+ * @file marquee.h
+ * @brief Scrolling single line text (ticker) for labels wider than their box.
+ * @ingroup Graphics_Widget Graphics_Text
+ *
+ * @details
+ * CFBDGraphic_Text wraps or clips a label that does not fit. A marquee
+ * renders the string once, with the no-wrap text widget, into a 1bpp memory
+ * canvas one text line high and as wide as the string (the strip). Every
+ * step then copies the window of strip columns currently visible into the
+ * frame buffer with CFBDGraphic_DrawMemoryCanvas() and flushes the marquee
+ * rectangle; glyphs are never rasterized again.
+ *
+ * The text moves one pixel at a time, @ref CFBDGraphic_Marquee::step_ms per
+ * pixel, and wraps around with @ref CFBDGraphic_Marquee::gap blank columns
+ * between the end of the text and its next start. Each lap starts with the
+ * beginning of the text held still for @ref CFBDGraphic_Marquee::pause_ms.
+ * A text that fits is drawn once and never moves.
+ *
+ * The strip buffer belongs to the caller, CFBDGraphic_MARQUEE_STRIP_BYTES()
+ * gives its size. A string wider than the buffer is cut at the last column
+ * that fits.
+ *
+ * @example
+ * @code
+ * static uint8_t strip[CFBDGraphic_MARQUEE_STRIP_BYTES(256, 8)];
+ * CFBDGraphic_Marquee title;
+ * CFBDGraphic_Point at = {0, 0};
+ * CFBDGraphicSize box = {128, 8};
+ * CFBDGraphic_InitMarquee(&title, panel, at, box, ASCII_6x8, strip, sizeof(strip));
+ * CFBDGraphic_SetMarqueeText(&title, "Now playing: a rather long track name");
+ * CFBDGraphic_DrawMarquee(&title, millis());
+ * // main loop
+ * CFBDGraphic_MarqueeTick(&title, millis());
+ * @endcode
+ */
+
+#pragma once
+#include <stdint.h>
+
+#include "base/point.h"
+#include "base/size.h"
+#include "cfbd_define.h"
+#include "device/graphic_device.h"
+#include "device/memory/memory_graphic_device.h"
+#include "widget/text_config.h"
+
+/**
+ * @addtogroup Graphics_Text
+ * @{
+ */
+
+/**
+ * @brief Strip buffer size for a string up to @p width pixels wide in a font @p height pixels high
+ */
+#define CFBDGraphic_MARQUEE_STRIP_BYTES(width, height) CFBDGraphic_MEMORY_CANVAS_BYTES(width, height)
+
+/** @brief Default time per pixel of movement (25 pixels per second) */
+#ifndef CFBDGraphic_MARQUEE_STEP_MS
+#define CFBDGraphic_MARQUEE_STEP_MS (40)
+#endif
+
+/** @brief Default blank columns between the end of the text and its next start */
+#ifndef CFBDGraphic_MARQUEE_GAP
+#define CFBDGraphic_MARQUEE_GAP (16)
+#endif
+
+/** @brief Default hold of the text start at the beginning of every lap */
+#ifndef CFBDGraphic_MARQUEE_PAUSE_MS
+#define CFBDGraphic_MARQUEE_PAUSE_MS (1000)
+#endif
+
+/**
+ * @struct CFBDGraphic_Marquee
+ * @brief A scrolling label and its pre-rendered strip.
+ */
+typedef struct
+{
+    CFBD_GraphicDevice* device;      /**< Panel the marquee is drawn on */
+    CFBDGraphic_Point tl_point;      /**< Top-left corner of the marquee box */
+    CFBDGraphicSize size;            /**< Visible box, the text is clipped to it */
+    Ascii_Font_Size font_size;       /**< Font the strip is rendered with */
+    CFBDGraphic_MemoryCanvas strip;  /**< Rendered text, width is the text width */
+    uint16_t capacity;               /**< Bytes of the strip buffer */
+    uint16_t step_ms;                /**< Time per pixel of movement, 0 stops the text */
+    uint16_t gap;                    /**< Blank columns between laps */
+    uint16_t pause_ms;               /**< Hold at the start of every lap */
+    uint32_t start_ms;               /**< Tick at which the current text started */
+    uint16_t offset;                 /**< Strip column shown at the left edge */
+    CFBD_Bool drawn;                 /**< CFBD_FALSE until the box was drawn once */
+} CFBDGraphic_Marquee;
+
+/**
+ * @brief Set up a marquee with the default speed, gap and pause and an empty text.
+ * @param marquee Marquee to initialize.
+ * @param device Panel to draw on.
+ * @param tl_point Top-left corner of the box.
+ * @param size Box size; the text is drawn on its top rows.
+ * @param font_size Font size or registered font id.
+ * @param strip_buffer Caller owned strip storage, must outlive the marquee.
+ * @param strip_bytes Size of @p strip_buffer.
+ */
+void CFBDGraphic_InitMarquee(CFBDGraphic_Marquee* marquee,
+                             CFBD_GraphicDevice* device,
+                             CFBDGraphic_Point tl_point,
+                             CFBDGraphicSize size,
+                             Ascii_Font_Size font_size,
+                             uint8_t* strip_buffer,
+                             uint16_t strip_bytes);
+
+/**
+ * @brief Render a new text into the strip; the next draw or tick shows it from the start.
+ * @details This is the only place glyphs are rasterized. The string is not
+ *          kept and may be freed or reused afterwards.
+ * @param marquee Marquee to update.
+ * @param text Zero-terminated UTF-8 string.
+ */
+void CFBDGraphic_SetMarqueeText(CFBDGraphic_Marquee* marquee, const char* text);
+
+/**
+ * @brief Change how the text moves, takes effect at the next tick.
+ * @param marquee Marquee to update.
+ * @param step_ms Time per pixel, 0 holds the text at its start.
+ * @param gap Blank columns between the end of the text and its next start.
+ * @param pause_ms Hold at the start of every lap.
+ */
+void CFBDGraphic_SetMarqueeMotion(CFBDGraphic_Marquee* marquee,
+                                  uint16_t step_ms,
+                                  uint16_t gap,
+                                  uint16_t pause_ms);
+
+/**
+ * @brief Whether the text is wider than the box and therefore moves.
+ */
+static inline CFBD_Bool CFBDGraphic_MarqueeScrolls(const CFBDGraphic_Marquee* marquee)
+{
+    return marquee->strip.width > marquee->size.width && marquee->step_ms != 0;
+}
+
+/**
+ * @brief Clear the box and draw the text as due at @p now_ms, then flush the box.
+ * @details Use it for the first draw and after the screen was cleared; the
+ *          lap restarts at @p now_ms if the text was never drawn.
+ * @param marquee Marquee to draw.
+ * @param now_ms Monotonic millisecond tick, wrapping is fine.
+ */
+void CFBDGraphic_DrawMarquee(CFBDGraphic_Marquee* marquee, uint32_t now_ms);
+
+/**
+ * @brief Move the text to its position at @p now_ms, never waits.
+ * @details Copies the visible strip columns and flushes the text rows of the
+ *          box when the position changed, otherwise sends nothing.
+ * @param marquee Marquee to advance.
+ * @param now_ms Monotonic millisecond tick, wrapping is fine.
+ * @return CFBD_TRUE if the box was redrawn.
+ */
+CFBD_Bool CFBDGraphic_MarqueeTick(CFBDGraphic_Marquee* marquee, uint32_t now_ms);
+
+/** @} */
@@ -12,7 +12,9 @@
 
 #include "base/rectangle.h"
 #include "cfbd_define.h"
+#include "device/graphic_clip.h"
 #include "device/graphic_device.h"
+#include "device/graphic_scroll.h"
 #include "sys_clock/system_clock.h"
 #include "widget/base_support/common/helpers.h"
 #include "widget/text_config.h"
@@ -53,42 +55,31 @@ _update_icon_widget(CFBD_IconTextMenu* pMenu, CFBD_IconTextMenuItem* item, int16
     item->icon_widget.point.y = icon_y;
 }
 
-/**
- * @brief Calculate text pixel width (需要根据实际字体系统实现)
- * @param text - Text string
- * @param font_size - Font size
- * @return uint16_t - Text width in pixels
- */
-static uint16_t _calculate_text_width(const char* text, uint8_t font_size)
+static uint16_t _calculate_text_y(CFBD_IconTextMenu* pMenu, CFBD_IconTextMenuItem* item)
 {
-    // 简单估算：每个字符宽度 = font_size * 0.6 (需要根据实际字体调整)
-    // 或者调用实际的字体宽度计算函数
-    if (!text)
-        return 0;
-
-    uint16_t char_count = strlen(text);
-    uint16_t fwidth = __fetch_font_size(font_size).width;
-    return char_count * fwidth;
+    return _calculate_item_y(pMenu) + item->icon_size.height + CFBD_ICONTEXT_MENU_ICON_TEXT_GAP * 2;
 }
 
-static void
-_update_text_widget(CFBD_IconTextMenu* pMenu, CFBD_IconTextMenuItem* item, int16_t item_x)
+/* Left edge of the label of an item at item_x, negative left of the screen */
+static int32_t
+_calculate_text_x(CFBD_IconTextMenu* pMenu, CFBD_IconTextMenuItem* item, int16_t item_x)
 {
-    uint16_t text_y = _calculate_item_y(pMenu) + item->icon_size.height +
-                      CFBD_ICONTEXT_MENU_ICON_TEXT_GAP * 2;
-
-    // 计算文字实际宽度
-    uint16_t text_width = _calculate_text_width(item->label, CFBD_ICONTEXT_MENU_TEXT_SIZE);
+    // 标签宽度在添加时已测量
+    uint16_t text_width = item->label_width;
 
-    uint16_t text_x;
     if (text_width < pMenu->item_width) {
         // 文字宽度小于item宽度：居中对齐
-        text_x = item_x + (pMenu->item_width - text_width) / 2;
-    }
-    else {
-        // 文字宽度大于等于item宽度：左对齐
-        text_x = item_x;
+        return item_x + (pMenu->item_width - text_width) / 2;
     }
+    // 文字宽度大于等于item宽度：左对齐
+    return item_x;
+}
+
+static void
+_update_text_widget(CFBD_IconTextMenu* pMenu, CFBD_IconTextMenuItem* item, int16_t item_x)
+{
+    uint16_t text_y = _calculate_text_y(pMenu, item);
+    uint16_t text_x = (uint16_t) _calculate_text_x(pMenu, item, item_x);
 
     item->text_widget.tl_point.x = text_x;
     item->text_widget.tl_point.y = text_y;
@@ -194,7 +185,6 @@ static void _center_selected_item(CFBD_IconTextMenu* pMenu)
     pMenu->scroll_offset =
             -pMenu->selected_index * (pMenu->item_width + pMenu->item_spacing) + center_offset;
     pMenu->target_scroll_offset = pMenu->scroll_offset;
-    pMenu->prev_scroll_offset = pMenu->scroll_offset;
 }
 
 /* ========== Static Implementation Functions (prefixed with CFBD_) ========== */
@@ -237,8 +227,10 @@ static CFBD_Bool CFBD_IconTextMenuAddItem(CFBD_IconTextMenu* pMenu,
                          CFBD_ICONTEXT_MENU_TEXT_SIZE);
     item->text_widget.no_wrap = CFBD_TRUE;
     CFBDGraphic_SetText(&item->text_widget, (char*) label);
+    item->label_width = CFBDGraphic_MeasureText(label, CFBD_ICONTEXT_MENU_TEXT_SIZE, 0).width;
 
     pMenu->item_count++;
+    pMenu->is_drawn = CFBD_FALSE;
     return CFBD_TRUE;
 }
 
@@ -323,12 +315,11 @@ static void CFBD_IconTextMenuActivateCurrent(CFBD_IconTextMenu* pMenu)
     item->state = CFBD_ICONTEXT_ITEM_FOCUSED;
 }
 
-static void CFBD_IconTextMenuDraw(CFBD_IconTextMenu* pMenu)
+/**
+ * @brief Area cleared and redrawn by a frame: the viewport grown by the selection border
+ */
+static void _fetch_draw_area(CFBD_IconTextMenu* pMenu, CFBDGraphicRect* area)
 {
-    if (!pMenu || !pMenu->device || pMenu->item_count == 0) {
-        return;
-    }
-
     // 【修复1】扩大清除区域，确保边框也被清除
     int16_t clear_x = pMenu->viewport.tl.x;
     int16_t clear_y = pMenu->viewport.tl.y;
@@ -345,7 +336,41 @@ static void CFBD_IconTextMenuDraw(CFBD_IconTextMenu* pMenu)
         clear_h += pMenu->selection_border_width * 2;
     }
 
-    pMenu->device->ops->clear_area(pMenu->device, clear_x, clear_y, clear_w, clear_h);
+    area->tl.x = clear_x;
+    area->tl.y = clear_y;
+    area->br.x = clear_x + clear_w - 1;
+    area->br.y = clear_y + clear_h - 1;
+}
+
+/**
+ * @brief Icon and label of an item at item_x, as a frame shows them
+ * @note Parts starting left of the screen cannot be placed and are skipped
+ */
+static void _draw_item(CFBD_IconTextMenu* pMenu, size_t index, int16_t item_x)
+{
+    CFBD_IconTextMenuItem* item = &pMenu->items[index];
+
+    _update_icon_widget(pMenu, item, item_x);
+    _update_text_widget(pMenu, item, item_x);
+
+    if ((int) index == pMenu->selected_index) {
+        _draw_selection_frame(pMenu, item, item_x);
+    }
+
+    if (item->icon_bitmap) {
+        CFBDGraphic_DrawImageClipped(pMenu->device, &item->icon_widget, &pMenu->viewport);
+    }
+
+    CFBDGraphic_DrawText(pMenu->device, &item->text_widget, CCGraphic_AsciiTextItem_RequestOldPoint);
+}
+
+static void _redraw_all(CFBD_IconTextMenu* pMenu, const CFBDGraphicRect* area)
+{
+    pMenu->device->ops->clear_area(pMenu->device,
+                                   area->tl.x,
+                                   area->tl.y,
+                                   area->br.x - area->tl.x + 1,
+                                   area->br.y - area->tl.y + 1);
 
     for (size_t i = 0; i < pMenu->item_count; i++) {
         CFBD_IconTextMenuItem* item = &pMenu->items[i];
@@ -354,23 +379,152 @@ static void CFBD_IconTextMenuDraw(CFBD_IconTextMenu* pMenu)
         if (!_is_item_visible(pMenu, item, item_x)) {
             continue;
         }
+        _draw_item(pMenu, i, item_x);
+    }
+}
 
-        _update_icon_widget(pMenu, item, item_x);
-        _update_text_widget(pMenu, item, item_x);
+/*
+    Clear [x0, x1) x [y0, y1) and draw every visible item clipped to it, the
+    same pixels a full redraw puts there. Coordinates may be negative.
+*/
+static void _repaint(CFBD_IconTextMenu* pMenu, int32_t x0, int32_t y0, int32_t x1, int32_t y1)
+{
+    x0 = MAX(x0, 0);
+    y0 = MAX(y0, 0);
+    if (x0 >= x1 || y0 >= y1)
+        return;
 
-        if ((int) i == pMenu->selected_index) {
-            _draw_selection_frame(pMenu, item, item_x);
-        }
+    const CFBDGraphicRect rect = {{x0, y0}, {x1 - 1, y1 - 1}};
+    if (!CFBDGraphic_PushClip(pMenu->device, &rect))
+        return;
+    pMenu->device->ops->clear_area(pMenu->device, x0, y0, x1 - x0, y1 - y0);
+    for (size_t i = 0; i < pMenu->item_count; i++) {
+        CFBD_IconTextMenuItem* item = &pMenu->items[i];
+        int16_t item_x = _calculate_item_x(pMenu, i);
+        // 框线在左右各多出 border 列, 过长的标签左对齐伸出 item
+        const int32_t left = item_x - pMenu->selection_border_width;
+        const int32_t right = item_x + MAX(pMenu->item_width, item->label_width) +
+                              pMenu->selection_border_width;
+        if (right > x0 && left < x1 && _is_item_visible(pMenu, item, item_x))
+            _draw_item(pMenu, i, item_x);
+    }
+    CFBDGraphic_PopClip(pMenu->device);
+}
+
+/* The four border strips of the selection frame of item index */
+static void _repaint_frame(CFBD_IconTextMenu* pMenu, int index)
+{
+    if (index < 0 || index >= (int) pMenu->item_count)
+        return;
+
+    CFBD_IconTextMenuItem* item = &pMenu->items[index];
+    const int32_t border = pMenu->selection_border_width;
+    const int32_t x0 = _calculate_item_x(pMenu, index) +
+                       (pMenu->item_width - item->icon_size.width) / 2 - border;
+    const int32_t y0 = _calculate_item_y(pMenu) + CFBD_ICONTEXT_MENU_ICON_TEXT_GAP - border;
+    const int32_t x1 = x0 + item->icon_size.width + 2 * border;
+    const int32_t y1 = y0 + item->icon_size.height + 2 * border;
+
+    _repaint(pMenu, x0, y0, x1, y0 + border);
+    _repaint(pMenu, x0, y1 - border, x1, y1);
+    _repaint(pMenu, x0, y0, x0 + border, y1);
+    _repaint(pMenu, x1 - border, y0, x1, y1);
+}
+
+/* Whether a label at text_x loses the glyph crossing x = 0 */
+static inline CFBD_Bool _label_cut(CFBD_IconTextMenuItem* item, int32_t text_x)
+{
+    return text_x < 0 && text_x + item->label_width > 0;
+}
+
+/*
+    Move the frame on screen by dx columns in the frame buffer, then repaint
+    what did not simply slide along: the exposed strip, labels crossing
+    x = 0 (that glyph is dropped), icons reaching x < 0 (skipped as a whole),
+    labels and the selection frame of items whose icon entered or left the
+    viewport, the columns between area and viewport and a moved selection
+    frame. CFBD_FALSE if the device has no frame buffer access.
+*/
+static CFBD_Bool _scroll_draw(CFBD_IconTextMenu* pMenu, const CFBDGraphicRect* area, int16_t dx)
+{
+    const int32_t ax0 = area->tl.x, ay0 = area->tl.y;
+    const int32_t ax1 = area->br.x + 1, ay1 = area->br.y + 1;
+    if (!CFBDGraphic_DeviceScrollColumns(pMenu->device, ax0, ay0, ax1 - ax0, ay1 - ay0, dx))
+        return CFBD_FALSE;
 
-        if (item->icon_bitmap) {
-            CFBDGraphic_DrawImageClipped(pMenu->device, &item->icon_widget, &pMenu->viewport);
+    // icons are cut at the viewport: columns shifted in from beyond it are exposed too
+    const int32_t vx0 = MAX(ax0, (int32_t) pMenu->viewport.tl.x);
+    const int32_t vx1 = MIN(ax1, (int32_t) pMenu->viewport.br.x);
+    if (dx > 0)
+        _repaint(pMenu, ax0, ay0, vx0 + dx, ay1);
+    else
+        _repaint(pMenu, vx1 + dx, ay0, ax1, ay1);
+    _repaint(pMenu, ax0, ay0, vx0, ay1);
+    _repaint(pMenu, vx1, ay0, ax1, ay1);
+
+    const uint16_t text_h = __fetch_font_size(CFBD_ICONTEXT_MENU_TEXT_SIZE).height;
+    for (size_t i = 0; i < pMenu->item_count; i++) {
+        CFBD_IconTextMenuItem* item = &pMenu->items[i];
+        const int16_t item_x = _calculate_item_x(pMenu, i);
+        const CFBD_Bool shown = _is_item_visible(pMenu, item, item_x);
+        const CFBD_Bool was_shown = _is_item_visible(pMenu, item, item_x - dx);
+
+        const int32_t icon_x = item_x + (pMenu->item_width - item->icon_size.width) / 2;
+        if ((shown && icon_x >= 0) != (was_shown && icon_x - dx >= 0)) {
+            const int32_t icon_y = _calculate_item_y(pMenu) + CFBD_ICONTEXT_MENU_ICON_TEXT_GAP;
+            _repaint(pMenu,
+                     icon_x,
+                     icon_y,
+                     icon_x + item->icon_size.width,
+                     icon_y + item->icon_size.height);
         }
+        // 选中项整体出现或消失, 边框也一样
+        if (shown != was_shown && (int) i == pMenu->selected_index)
+            _repaint_frame(pMenu, (int) i);
+
+        // 其余标签随像素一起平移
+        const int32_t text_x = _calculate_text_x(pMenu, item, item_x);
+        if (shown != was_shown || (shown && _label_cut(item, text_x)) ||
+            (was_shown && _label_cut(item, text_x - dx))) {
+            const int32_t text_y = _calculate_text_y(pMenu, item);
+            _repaint(pMenu, text_x, text_y, text_x + item->label_width, text_y + text_h);
+        }
+    }
+
+    // 选中项变化: 旧边框随像素移动了, 新边框还没画
+    if (pMenu->framed_index != pMenu->selected_index) {
+        _repaint_frame(pMenu, pMenu->framed_index);
+        _repaint_frame(pMenu, pMenu->selected_index);
+    }
+    return CFBD_TRUE;
+}
 
-        CFBDGraphic_DrawText(pMenu->device,
-                             &item->text_widget,
-                             CCGraphic_AsciiTextItem_RequestOldPoint);
+static void CFBD_IconTextMenuDraw(CFBD_IconTextMenu* pMenu)
+{
+    if (!pMenu || !pMenu->device || pMenu->item_count == 0) {
+        return;
     }
 
+    CFBDGraphicRect area;
+    _fetch_draw_area(pMenu, &area);
+    const int32_t width = area.br.x - area.tl.x + 1;
+    const int32_t dx = (int32_t) pMenu->scroll_offset - pMenu->prev_scroll_offset;
+
+    // 整帧只在最后刷新一次; 绘制限制在清除区域内
+    const CFBD_Bool immediate = CFBDGraphic_DeviceRequestUpdateAtOnce(pMenu->device);
+    CFBDGraphic_DeviceSetIfRequestUpdateAtOnce(pMenu->device, CFBD_FALSE);
+    const CFBD_Bool clipped = CFBDGraphic_PushClip(pMenu->device, &area);
+
+    // 滚动帧: 平移已有像素, 只画新露出的列
+    const CFBD_Bool scrolled = pMenu->is_drawn && dx != 0 && dx > -width && dx < width &&
+                               _scroll_draw(pMenu, &area, (int16_t) dx);
+    if (!scrolled)
+        _redraw_all(pMenu, &area);
+
+    if (clipped)
+        CFBDGraphic_PopClip(pMenu->device);
+    CFBDGraphic_DeviceSetIfRequestUpdateAtOnce(pMenu->device, immediate);
+
     pMenu->device->ops->update_area(pMenu->device,
                                     pMenu->viewport.tl.x,
                                     pMenu->viewport.tl.y,
@@ -378,6 +532,8 @@ static void CFBD_IconTextMenuDraw(CFBD_IconTextMenu* pMenu)
                                     rect_height(&pMenu->viewport));
 
     pMenu->prev_scroll_offset = pMenu->scroll_offset;
+    pMenu->framed_index = pMenu->selected_index;
+    pMenu->is_drawn = CFBD_TRUE;
 }
 
 static CFBD_Bool CFBD_IconTextMenuUpdate(CFBD_IconTextMenu* pMenu, uint32_t delta_ms)
@@ -389,13 +545,13 @@ static CFBD_Bool CFBD_IconTextMenuUpdate(CFBD_IconTextMenu* pMenu, uint32_t delt
 
     uint8_t max_frames = pMenu->scroll_animation.anim_frames;
 
-    if (pMenu->anim_current_frame < max_frames)
-        pMenu->anim_current_frame++;
-
-    int32_t start = pMenu->animation_start_offset;
-    int32_t delta = (int32_t) pMenu->target_scroll_offset - start;
+    // 每次调用前进一帧
+    CFBD_AnimationAdvanceFrame(&pMenu->anim_current_frame, max_frames, 0, 0);
 
-    pMenu->scroll_offset = (int16_t) (start + (delta * pMenu->anim_current_frame) / max_frames);
+    const int32_t st = CFBD_EaseQ16(pMenu->scroll_curve,
+                                    CFBD_EaseProgressQ16(pMenu->anim_current_frame, max_frames));
+    pMenu->scroll_offset = (int16_t) CFBD_EaseLerp(
+            pMenu->animation_start_offset, pMenu->target_scroll_offset, st);
 
     if (pMenu->anim_current_frame >= max_frames) {
         pMenu->scroll_offset = pMenu->target_scroll_offset;
@@ -415,6 +571,7 @@ static void CFBD_IconTextMenuSetDimensions(CFBD_IconTextMenu* pMenu,
     pMenu->item_width = width;
     pMenu->item_height = height;
     pMenu->item_spacing = spacing;
+    pMenu->is_drawn = CFBD_FALSE;
 }
 
 static CFBD_IconTextMenuItem* CFBD_IconTextMenuGetSelectedItem(CFBD_IconTextMenu* pMenu)
@@ -447,6 +604,7 @@ static void CFBD_IconTextMenuSetSelectionBorder(CFBD_IconTextMenu* pMenu, uint16
         return;
     }
     pMenu->selection_border_width = border_width;
+    pMenu->is_drawn = CFBD_FALSE;
 }
 
 static void CFBD_IconTextMenuAnimateScroll(CFBD_IconTextMenu* pMenu,
@@ -518,6 +676,8 @@ void CFBD_InitIconTextMenu(CFBD_IconTextMenu* pMenu,
     pMenu->item_spacing = 5;
     pMenu->is_animating = CFBD_FALSE;
     pMenu->is_circular = CFBD_FALSE;
+    pMenu->is_drawn = CFBD_FALSE;
+    pMenu->framed_index = -1;
 
     pMenu->selection_border_width = 1;
 
@@ -528,4 +688,5 @@ void CFBD_InitIconTextMenu(CFBD_IconTextMenu* pMenu,
     CFBD_InitBaseAnimation(&pMenu->scroll_animation);
     pMenu->scroll_animation.anim_frames = 10;
     pMenu->scroll_animation.anim_frame_delay_ms = 30;
+    pMenu->scroll_curve = CFBD_EASE_SMOOTHSTEP;
 }
\ No newline at end of file
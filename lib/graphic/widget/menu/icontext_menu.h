@@ -19,6 +19,7 @@
 #include "cfbd_graphic_define.h"
 #include "menu_item.h"
 #include "widget/animation/animation.h"
+#include "widget/animation/easing.h"
 #include "widget/base_support/image.h"
 #include "widget/text.h"
 
@@ -102,6 +103,9 @@ typedef struct
     /** @brief Text widget for label rendering (internal) */
     CFBDGraphic_Text text_widget;
 
+    /** @brief Label width in pixels, measured once when the item is added (internal) */
+    uint16_t label_width;
+
     /** @brief User-defined data pointer */
     void* user_data;
 } CFBD_IconTextMenuItem;
@@ -138,6 +142,9 @@ typedef struct _CFBD_IconTextMenuOps
 
     /**
      * @brief Draw menu
+     * @note When only the scroll offset changed since the last frame, the
+     *       frame buffer columns are shifted and just the exposed strip is
+     *       drawn; otherwise the viewport is redrawn. One update_area().
      */
     void (*immediate_draw)(CFBD_IconTextMenu* pMenu);
 
@@ -229,6 +236,9 @@ typedef struct _CFBD_IconTextMenu
     /** @brief Animation state for smooth scrolling */
     CFBD_BaseAnimation scroll_animation;
 
+    /** @brief Easing of the scroll animation, CFBD_EASE_SMOOTHSTEP by default */
+    CFBD_EasingCurve scroll_curve;
+
     /** @brief Width of each menu item in pixels */
     SizeBaseType item_width;
 
@@ -250,13 +260,19 @@ typedef struct _CFBD_IconTextMenu
     /** @brief Animation elapsed time in ms */
     uint32_t animation_elapsed_ms;
 
-    /** @brief Previous frame scroll offset (for dirty region detection) */
+    /** @brief Scroll offset of the frame on screen, a new frame only draws the difference */
     int16_t prev_scroll_offset;
 
     /** @brief Current animation frame counter (0 to anim_frames-1) */
     uint8_t anim_current_frame;
 
     uint16_t selection_border_width;
+
+    /** @brief CFBD_FALSE until the next immediate_draw() has to redraw the whole viewport */
+    CFBD_Bool is_drawn;
+
+    /** @brief Item whose selection frame is on screen, -1 for none */
+    int framed_index;
 } CFBD_IconTextMenu;
 
 /**
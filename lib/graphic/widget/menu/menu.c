@@ -6,10 +6,13 @@
 #include "base/size.h"
 #include "cfbd_define.h"
 #include "cfbd_graphic_define.h"
+#include "device/graphic_clip.h"
+#include "device/graphic_scroll.h"
 #include "menu_config.h"
 #include "menu_indicator.h"
 #include "menu_item.h"
 #include "sys_clock/system_clock.h"
+#include "widget/animation/easing.h"
 #include "widget/base_support/common/helpers.h"
 #include "widget/menu/menu.h"
 #include "widget/text.h"
@@ -27,24 +30,47 @@ static const uint16_t get_menu_new_item_height(CFBD_MenuItem* item)
     return (sz.height + 2 * CFBD_MENU_ITEM_Y_GAP);
 }
 
-static const uint16_t get_menu_new_item_y(CFBD_Menu* pMenu)
+/* Sum of the item heights, only recomputed when a whole group is bound */
+static uint32_t sum_item_heights(CFBD_MenuItemGroup* group)
 {
-    uint16_t result = pMenu->tl_point.y;
-    if (!pMenu || !pMenu->menu_items) {
+    uint32_t result = 0;
+    if (!group)
         return result;
-    }
-
-    CFBD_MenuItemGroup* group = pMenu->menu_items;
-    for (uint8_t i = 0; i < group->count; i++) {
+    for (size_t i = 0; i < group->count; i++) {
         result += get_menu_new_item_height(&group->pItems[i]);
     }
-    return result + CFBD_MENU_ITEM_Y_GAP;
+    return result;
+}
+
+static const uint16_t get_menu_new_item_y(CFBD_Menu* pMenu)
+{
+    return pMenu->tl_point.y + pMenu->items_height + CFBD_MENU_ITEM_Y_GAP;
+}
+
+static inline CFBD_Bool has_viewport(CFBD_Menu* m)
+{
+    return m->viewport_height != 0;
+}
+
+static inline uint16_t menu_width(CFBD_Menu* m)
+{
+    return get_menu_new_item_x(m) - m->tl_point.x + m->max_width;
+}
+
+/* Rows the menu occupies on screen: the window, or every item */
+static inline uint16_t menu_height(CFBD_Menu* m)
+{
+    return has_viewport(m) ? m->viewport_height : get_menu_new_item_y(m) - m->tl_point.y;
 }
 
 static void CFBD_BindMenuItems(CFBD_Menu* pMenu, CFBD_MenuItemGroup* assigned_menu_items)
 {
     pMenu->menu_items = assigned_menu_items;
+    pMenu->items_height = sum_item_heights(assigned_menu_items);
     pMenu->selected = 0;
+    pMenu->scroll_y = 0;
+    pMenu->select_anim.running = CFBD_FALSE;
+    pMenu->select_anim.shown = CFBD_FALSE;
 }
 
 static void CFBD_AnimationSet(CFBD_Menu* pMenu, CFBD_BaseAnimation* pBaseAnimation)
@@ -72,294 +98,319 @@ static CFBD_Bool CFBD_MenuAddItems(CFBD_Menu* pMenu,
     CFBDGraphic_InitText(&it->text_obj, it->tl, sz, font_size);
     CFBDGraphic_SetText(&it->text_obj, it->label);
     group->count++;
+    pMenu->items_height += get_menu_new_item_height(it);
 
     return CFBD_TRUE;
 }
 
-static void CFBD_DrawMenu(CFBD_Menu* m)
+/* Highlight of item idx as CFBD_DrawMenu() paints it: bar at y, text reverted */
+static CFBD_MenuHighlight item_highlight(CFBD_Menu* m, int idx)
 {
-    CFBD_GraphicDevice* dev = m->device;
-    CFBD_MenuItemGroup* group = m->menu_items;
-    for (size_t i = 0; i < group->count; ++i) {
-        CFBD_MenuItem* it = &group->pItems[i];
-        CFBDGraphic_DrawText(dev, &it->text_obj, CCGraphic_AsciiTextItem_RequestOldPoint);
-    }
+    CFBD_MenuItem* it = &m->menu_items->pItems[idx];
+    CFBD_MenuHighlight h = {.x = (int16_t) it->text_obj.tl_point.x,
+                            .y = (int16_t) (it->tl.y - m->scroll_y),
+                            .w = (int16_t) rect_width(&it->text_obj.text_bounding_rect),
+                            .h = (int16_t) rect_height(&it->text_obj.text_bounding_rect)};
+    return h;
+}
 
-    /* draw indicator at selected */
-    if (m->selected >= 0 && (size_t) m->selected < group->count) {
-        CFBD_MenuItem* sel = &group->pItems[m->selected];
-        uint16_t ix = m->tl_point.x + m->indicator.x;
-        uint16_t iy = sel->tl.y;
-        uint16_t ih = rect_height(&sel->text_obj.text_bounding_rect);
-        CFBD_DrawMenuIndicator(m, ix, iy, m->indicator.width, ih);
-
-        /* reversed the target */
-        CFBDGraphic_Text* text = &sel->text_obj;
-        m->device->ops->revert_area(m->device,
-                                    text->tl_point.x,
-                                    text->tl_point.y,
-                                    rect_width(&text->text_bounding_rect),
-                                    ih);
-    }
+/*
+    Limit a rectangle that may stick out of the screen (negative while the
+    window scrolls) to the active clip. CFBD_FALSE if nothing is left.
+*/
+static CFBD_Bool visible_part(CFBD_Menu* m,
+                              int32_t x0,
+                              int32_t y0,
+                              int32_t x1,
+                              int32_t y1,
+                              CFBD_MenuHighlight* out)
+{
+    CFBDGraphic_ClipBounds clip;
+    if (!CFBDGraphic_FetchClipBounds(m->device, &clip))
+        return CFBD_FALSE;
+    x0 = MAX(x0, (int32_t) clip.x0);
+    y0 = MAX(y0, (int32_t) clip.y0);
+    x1 = MIN(x1, (int32_t) clip.x1 + 1);
+    y1 = MIN(y1, (int32_t) clip.y1 + 1);
+    if (x0 >= x1 || y0 >= y1)
+        return CFBD_FALSE;
+    out->x = (int16_t) x0;
+    out->y = (int16_t) y0;
+    out->w = (int16_t) (x1 - x0);
+    out->h = (int16_t) (y1 - y0);
+    return CFBD_TRUE;
+}
 
-    if (CFBDGraphic_DeviceRequestUpdateAtOnce(m->device)) {
-        m->device->ops->update(m->device);
+static void toggle_highlight(CFBD_Menu* m, const CFBD_MenuHighlight* h, CFBD_Bool draw)
+{
+    const int32_t colx = m->tl_point.x + m->indicator.x;
+    CFBD_MenuHighlight part;
+    if (visible_part(m, colx, h->y, colx + m->indicator.width, h->y + h->h, &part)) {
+        if (draw)
+            CFBD_DrawMenuIndicator(m, part.x, part.y, part.w, part.h);
+        else
+            m->device->ops->clear_area(m->device, part.x, part.y, part.w, part.h);
     }
+    if (visible_part(m, h->x, h->y, h->x + h->w, h->y + h->h, &part))
+        m->device->ops->revert_area(m->device, part.x, part.y, part.w, part.h);
 }
 
-static void redraw_item(CFBD_Menu* m, int idx)
+/* Clip to the window, CFBD_FALSE when the stack is full (drawing is then unclipped) */
+static CFBD_Bool push_viewport(CFBD_Menu* m, uint16_t y, uint16_t height)
 {
-    if (idx < 0 || (size_t) idx >= m->menu_items->count)
-        return;
-    CFBD_MenuItem* it = &m->menu_items->pItems[idx];
+    const CFBDGraphicRect rect = {{m->tl_point.x, y},
+                                  {m->tl_point.x + menu_width(m) - 1, y + height - 1}};
+    return has_viewport(m) && CFBDGraphic_PushClip(m->device, &rect);
+}
 
-    /* 使用驱动提供的 clear_area（clear_rect_area 已经会代理） */
-    CFBDGraphicSize* size = &it->text_obj.TexthandleSize;
-    m->device->ops->clear_area(m->device, it->tl.x, it->tl.y, size->width, size->height);
-    CFBDGraphic_DrawText(m->device, &it->text_obj, CCGraphic_AsciiTextItem_RequestOldPoint);
+/* First item whose rows reach below content row @p top, items are sorted by y */
+static size_t first_item_below(CFBD_Menu* m, int32_t top)
+{
+    CFBD_MenuItemGroup* group = m->menu_items;
+    size_t lo = 0, hi = group->count;
+    while (lo < hi) {
+        const size_t mid = lo + (hi - lo) / 2;
+        CFBD_MenuItem* it = &group->pItems[mid];
+        if (it->tl.y + get_menu_new_item_height(it) <= top)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
 }
 
-static inline int32_t smoothstep_q8(int32_t f, int32_t frames)
+/*
+    Draw the items overlapping screen rows [top, bottom). Item positions are
+    content rows, the text is moved to its screen row before it is drawn.
+    An item starting above row 0 cannot be placed and stays blank.
+*/
+static void draw_rows(CFBD_Menu* m, int32_t top, int32_t bottom)
 {
-    int32_t t = (f << 8) / frames; // Q8
-    int32_t t2 = (t * t) >> 8;
-    return (t2 * (3 * 256 - 2 * t)) >> 8;
+    CFBD_MenuItemGroup* group = m->menu_items;
+    for (size_t i = first_item_below(m, top + m->scroll_y); i < group->count; ++i) {
+        CFBD_MenuItem* it = &group->pItems[i];
+        if (it->tl.y - m->scroll_y >= bottom)
+            break;
+        if (it->tl.y < m->scroll_y)
+            continue;
+        CFBDGraphic_Point p = {.x = it->tl.x, .y = it->tl.y - m->scroll_y};
+        CFBDGraphic_SetTextTLPointPoint(&it->text_obj, &p);
+        CFBDGraphic_DrawText(m->device, &it->text_obj, CCGraphic_AsciiTextItem_RequestOldPoint);
+    }
 }
 
-void OLED_Menu_Select(CFBD_Menu* m, int new_index)
+/* Smallest scroll change that brings item idx fully into the window */
+static uint16_t scroll_to_show(CFBD_Menu* m, int idx)
 {
-    if (new_index < 0)
-        new_index = 0;
     CFBD_MenuItemGroup* group = m->menu_items;
-    if (new_index >= (int) group->count)
-        new_index = (int) group->count - 1;
-    int old = m->selected;
-    if (old == new_index)
-        return;
+    CFBD_MenuItem* it = &group->pItems[idx];
+    CFBD_MenuItem* last = &group->pItems[group->count - 1];
+    const int32_t top = it->tl.y - m->tl_point.y;
+    const int32_t bottom = top + get_menu_new_item_height(it);
+    const int32_t end = last->tl.y + get_menu_new_item_height(last) - m->tl_point.y;
+    int32_t scroll = m->scroll_y;
+
+    if (top - CFBD_MENU_ITEM_Y_GAP < scroll)
+        scroll = top - CFBD_MENU_ITEM_Y_GAP;
+    else if (bottom > scroll + m->viewport_height)
+        scroll = bottom - m->viewport_height;
+    if (scroll > end - m->viewport_height)
+        scroll = end - m->viewport_height;
+    return (uint16_t) MAX(scroll, 0);
+}
 
-    uint16_t start_y = (old >= 0 && (size_t) old < group->count) ? group->pItems[old].tl.y
-                                                                 : group->pItems[0].tl.y;
+static void CFBD_DrawMenu(CFBD_Menu* m)
+{
+    CFBD_GraphicDevice* dev = m->device;
+    CFBD_MenuItemGroup* group = m->menu_items;
 
-    uint16_t end_y = group->pItems[new_index].tl.y;
-    int frames = (m->animation.anim_frames > 1) ? m->animation.anim_frames : 1;
+    /* a full redraw ends any running selection animation */
+    m->select_anim.running = CFBD_FALSE;
+    m->select_anim.shown = CFBD_FALSE;
+
+    if (!has_viewport(m)) {
+        m->scroll_y = 0;
+        draw_rows(m, 0, INT32_MAX);
+        /* draw indicator at selected, the target reversed */
+        if (m->selected >= 0 && (size_t) m->selected < group->count) {
+            m->select_anim.current = item_highlight(m, m->selected);
+            toggle_highlight(m, &m->select_anim.current, CFBD_TRUE);
+            m->select_anim.shown = CFBD_TRUE;
+        }
 
-#define MAKE_RECT(rx, ry, rw, rh)                                                                  \
-    (CFBDGraphicRect)                                                                              \
-    {                                                                                              \
-        {(uint16_t) (rx), (uint16_t) (ry)},                                                        \
-        {                                                                                          \
-            (uint16_t) ((rx) + (rw)), (uint16_t) ((ry) + (rh))                                     \
-        }                                                                                          \
+        if (CFBDGraphic_DeviceRequestUpdateAtOnce(m->device)) {
+            m->device->ops->update(m->device);
+        }
+        return;
     }
 
-    CFBDGraphicRect global_upd;
-    CFBD_Bool have_global = CFBD_FALSE;
-
-    /* restore old text highlight */
-    uint16_t old_text_x = 0, old_text_w = 0, old_text_h = 0;
-    if (old >= 0 && (size_t) old < group->count) {
-        CFBDGraphic_Text* ot = &group->pItems[old].text_obj;
-        old_text_x = ot->tl_point.x;
-        old_text_w = rect_width(&ot->text_bounding_rect);
-        old_text_h = rect_height(&ot->text_bounding_rect);
-        m->device->ops->revert_area(m->device, old_text_x, ot->tl_point.y, old_text_w, old_text_h);
-        CFBDGraphicRect r = MAKE_RECT(old_text_x, ot->tl_point.y, old_text_w, old_text_h);
-        global_upd = r;
-        have_global = CFBD_TRUE;
+    // 视口模式: 只绘制窗口内的行, 最后统一刷新窗口
+    const CFBD_Bool immediate = CFBDGraphic_DeviceRequestUpdateAtOnce(dev);
+    CFBDGraphic_DeviceSetIfRequestUpdateAtOnce(dev, CFBD_FALSE);
+    const CFBD_Bool clipped = push_viewport(m, m->tl_point.y, m->viewport_height);
+    dev->ops->clear_area(dev, m->tl_point.x, m->tl_point.y, menu_width(m), m->viewport_height);
+    if (m->selected >= 0 && (size_t) m->selected < group->count) {
+        m->scroll_y = scroll_to_show(m, m->selected);
+        draw_rows(m, m->tl_point.y, m->tl_point.y + m->viewport_height);
+        m->select_anim.current = item_highlight(m, m->selected);
+        toggle_highlight(m, &m->select_anim.current, CFBD_TRUE);
+        m->select_anim.shown = CFBD_TRUE;
     }
-
-    /* clear indicator column */
-    uint16_t old_h = (old >= 0 && (size_t) old < group->count)
-                             ? group->pItems[old].text_obj.TexthandleSize.height
-                             : group->pItems[0].text_obj.TexthandleSize.height;
-    uint16_t new_h = group->pItems[new_index].text_obj.TexthandleSize.height;
-    uint16_t miny = MIN(start_y, end_y);
-    uint16_t maxy = MAX(start_y, end_y) + MAX(old_h, new_h);
-    uint16_t colx = m->tl_point.x + m->indicator.x, colw = m->indicator.width;
-    m->device->ops->clear_area(m->device, colx, miny, colw, maxy - miny);
-    {
-        CFBDGraphicRect r = MAKE_RECT(colx, miny, colw, maxy - miny);
-        if (!have_global) {
-            global_upd = r;
-            have_global = CFBD_TRUE;
-        }
-        else {
-            global_upd = rect_union(&global_upd, &r);
-        }
+    else {
+        draw_rows(m, m->tl_point.y, m->tl_point.y + m->viewport_height);
     }
+    if (clipped)
+        CFBDGraphic_PopClip(dev);
+    CFBDGraphic_DeviceSetIfRequestUpdateAtOnce(dev, immediate);
 
-    /* new text parameters */
-    CFBDGraphic_Text* nt = &group->pItems[new_index].text_obj;
-    uint16_t new_text_x = nt->tl_point.x;
-    uint16_t new_text_w = rect_width(&nt->text_bounding_rect);
-    volatile CFBDGraphicRect n = rect_normalize(nt->text_bounding_rect);
-    uint16_t new_text_h = (uint32_t) asInt32_t(n.br.y) - (uint32_t) asInt32_t(n.tl.y);
-
-    /* prepare interpolation bases (if old missing, base on new) */
-    int base_x = (old >= 0 && (size_t) old < group->count) ? (int) old_text_x : (int) new_text_x;
-    int base_w = (old >= 0 && (size_t) old < group->count) ? (int) old_text_w : (int) new_text_w;
-    int base_h = (old >= 0 && (size_t) old < group->count) ? (int) old_text_h : (int) new_text_h;
-
-    int last_rev_x = -1, last_rev_y = -1, last_rev_w = 0, last_rev_h = 0;
-
-    for (int f = 0; f <= frames; ++f) {
-        int32_t st = smoothstep_q8(f, frames);
-#define LERP_Q8(a, b, s) ((a) + (((b) - (a)) * (s) >> 8))
-        int cur_y = LERP_Q8(start_y, end_y, st);
-        int cur_x = LERP_Q8(base_x, new_text_x, st);
-        int cur_w = LERP_Q8(base_w, new_text_w, st);
-        int cur_h = LERP_Q8(base_h, new_text_h, st);
-#undef LERP_Q8
-
-        if (cur_w < 1)
-            cur_w = 1;
-        if (cur_h < 1)
-            cur_h = 1;
-
-        CFBDGraphicRect frame_upd;
-        CFBD_Bool have_frame = CFBD_FALSE;
-
-        /* restore previous frame's revert (before drawing indicator) */
-        if (last_rev_y >= 0) {
-            m->device->ops->revert_area(m->device,
-                                        (uint16_t) last_rev_x,
-                                        (uint16_t) last_rev_y,
-                                        (uint16_t) last_rev_w,
-                                        (uint16_t) last_rev_h);
-            CFBDGraphicRect r = MAKE_RECT(last_rev_x, last_rev_y, last_rev_w, last_rev_h);
-            frame_upd = r;
-            have_frame = CFBD_TRUE;
-        }
-
-        /* draw indicator */
-        uint16_t ih = MAX(old_h, new_h);
-
-        CFBD_DrawMenuIndicator(m, colx, cur_y, colw, ih);
-        {
-            CFBDGraphicRect r = MAKE_RECT(colx, cur_y, colw, ih);
-            if (!have_frame) {
-                frame_upd = r;
-                have_frame = CFBD_TRUE;
-            }
-            else {
-                frame_upd = rect_union(&frame_upd, &r);
-            }
-        }
+    if (CFBDGraphic_DeviceRequestUpdateAtOnce(dev))
+        dev->ops->update_area(dev, m->tl_point.x, m->tl_point.y, menu_width(m), m->viewport_height);
+}
 
-        /* apply current-frame text revert (this produces the highlight) */
-        m->device->ops->revert_area(m->device,
-                                    (uint16_t) cur_x,
-                                    (uint16_t) cur_y,
-                                    (uint16_t) cur_w,
-                                    (uint16_t) cur_h);
-        {
-            CFBDGraphicRect r = MAKE_RECT(cur_x, cur_y, cur_w, cur_h);
-            if (!have_frame) {
-                frame_upd = r;
-                have_frame = CFBD_TRUE;
-            }
-            else {
-                frame_upd = rect_union(&frame_upd, &r);
-            }
-        }
+/*
+    Scroll the window to @p scroll. Rows still visible are moved in the
+    frame buffer and only the exposed strip is drawn; a jump of a whole
+    window (or a device without frame buffer access) redraws the window.
+    The highlight on screen moves along with the rows. One flush.
+*/
+static void scroll_viewport(CFBD_Menu* m, uint16_t scroll)
+{
+    CFBD_GraphicDevice* dev = m->device;
+    CFBD_MenuSelectAnimation* a = &m->select_anim;
+    const int32_t delta = (int32_t) scroll - m->scroll_y;
+    const uint16_t x = m->tl_point.x, y = m->tl_point.y;
+    const uint16_t w = menu_width(m), h = m->viewport_height;
+    if (delta == 0)
+        return;
 
-        last_rev_x = cur_x;
-        last_rev_y = cur_y;
-        last_rev_w = cur_w;
-        last_rev_h = cur_h;
-
-        if (have_frame) {
-            uint16_t ux = frame_upd.tl.x;
-            uint16_t uy = frame_upd.tl.y;
-            uint16_t uw = (uint16_t) (frame_upd.br.x - frame_upd.tl.x);
-            uint16_t uh = (uint16_t) (frame_upd.br.y - frame_upd.tl.y);
-            m->device->ops->update_area(m->device, ux, uy, uw, uh);
-            if (!have_global) {
-                global_upd = frame_upd;
-                have_global = CFBD_TRUE;
-            }
-            else
-                global_upd = rect_union(&global_upd, &frame_upd);
-        }
+    const CFBD_Bool immediate = CFBDGraphic_DeviceRequestUpdateAtOnce(dev);
+    CFBDGraphic_DeviceSetIfRequestUpdateAtOnce(dev, CFBD_FALSE);
+    const CFBD_Bool clipped = push_viewport(m, y, h);
 
-        system_delay_ms(m->animation.anim_frame_delay_ms);
+    m->scroll_y = scroll;
+    a->current.y -= delta;
+    a->from.y -= delta;
 
-        /* clear indicator (non-final frame) */
-        if (f != frames) {
-            m->device->ops->clear_area(m->device, colx, cur_y, colw, ih);
-            CFBDGraphicRect r = MAKE_RECT(colx, cur_y, colw, ih);
-            if (!have_global) {
-                global_upd = r;
-                have_global = CFBD_TRUE;
-            }
-            else {
-                global_upd = rect_union(&global_upd, &r);
-            }
-        }
-    }
-
-    /* redraw old item and include into global update */
-    if (old >= 0 && (size_t) old < group->count) {
-        redraw_item(m, old);
-        CFBDGraphic_Text* ot = &group->pItems[old].text_obj;
-        CFBDGraphicRect r = MAKE_RECT(ot->tl_point.x,
-                                      ot->tl_point.y,
-                                      rect_width(&ot->text_bounding_rect),
-                                      rect_height(&ot->text_bounding_rect));
-        if (!have_global) {
-            global_upd = r;
-            have_global = CFBD_TRUE;
-        }
+    int32_t top = y, bottom = y + h;
+    if ((delta < 0 ? -delta : delta) < h &&
+        CFBDGraphic_DeviceScrollRows(dev, x, y, w, h, (int16_t) -delta)) {
+        if (delta > 0)
+            top = bottom - delta;
         else
-            global_upd = rect_union(&global_upd, &r);
+            bottom = top - delta;
+    }
+    else {
+        dev->ops->clear_area(dev, x, y, w, h);
     }
 
-    /* final correction: if last_rev differs from exact end, restore and set exact final */
-    if (last_rev_y >= 0 && (last_rev_y != (int) end_y || last_rev_w != (int) new_text_w ||
-                            last_rev_x != (int) new_text_x || last_rev_h != (int) new_text_h)) {
-        /* restore last */
-        m->device->ops->revert_area(m->device,
-                                    (uint16_t) last_rev_x,
-                                    (uint16_t) last_rev_y,
-                                    (uint16_t) last_rev_w,
-                                    (uint16_t) last_rev_h);
-        CFBDGraphicRect r1 = MAKE_RECT(last_rev_x, last_rev_y, last_rev_w, last_rev_h);
-        if (!have_global) {
-            global_upd = r1;
-            have_global = CFBD_TRUE;
-        }
-        else {
-            global_upd = rect_union(&global_upd, &r1);
-        }
-
-        /* final exact revert at end_y with new size */
-        m->device->ops->revert_area(m->device, new_text_x, end_y, new_text_w, new_text_h);
-        CFBDGraphicRect r2 = MAKE_RECT(new_text_x, end_y, new_text_w, new_text_h);
-        if (!have_global) {
-            global_upd = r2;
-            have_global = CFBD_TRUE;
-        }
-        else {
-            global_upd = rect_union(&global_upd, &r2);
-        }
+    const CFBD_Bool strip = push_viewport(m, top, bottom - top);
+    draw_rows(m, top, bottom);
+    if (a->shown)
+        toggle_highlight(m, &a->current, CFBD_TRUE);
+    if (strip)
+        CFBDGraphic_PopClip(dev);
+
+    if (clipped)
+        CFBDGraphic_PopClip(dev);
+    CFBDGraphic_DeviceSetIfRequestUpdateAtOnce(dev, immediate);
+    dev->ops->update_area(dev, x, y, w, h);
+}
 
-        /* flush final small region */
-        uint16_t ux = global_upd.tl.x, uy = global_upd.tl.y;
-        uint16_t uw = (uint16_t) (global_upd.br.x - global_upd.tl.x);
-        uint16_t uh = (uint16_t) (global_upd.br.y - global_upd.tl.y);
-        m->device->ops->update_area(m->device, ux, uy, uw, uh);
-    }
-    else {
-        if (have_global) {
-            uint16_t ux = global_upd.tl.x, uy = global_upd.tl.y;
-            uint16_t uw = (uint16_t) (global_upd.br.x - global_upd.tl.x);
-            uint16_t uh = (uint16_t) (global_upd.br.y - global_upd.tl.y);
-            m->device->ops->update_area(m->device, ux, uy, uw, uh);
-        }
+/* Erase the highlight on screen, draw @p next and flush both in one update_area() */
+static void move_highlight(CFBD_Menu* m, const CFBD_MenuHighlight* next)
+{
+    CFBD_MenuSelectAnimation* a = &m->select_anim;
+    const int16_t colx = (int16_t) (m->tl_point.x + m->indicator.x);
+    int16_t x0 = MIN(colx, next->x), y0 = next->y;
+    int16_t x1 = MAX(next->x + next->w, colx + m->indicator.width), y1 = next->y + next->h;
+    const CFBD_Bool clipped = push_viewport(m, m->tl_point.y, m->viewport_height);
+
+    if (a->shown) {
+        toggle_highlight(m, &a->current, CFBD_FALSE);
+        x0 = MIN(x0, a->current.x);
+        y0 = MIN(y0, a->current.y);
+        x1 = MAX(x1, a->current.x + a->current.w);
+        y1 = MAX(y1, a->current.y + a->current.h);
     }
+    toggle_highlight(m, next, CFBD_TRUE);
+    a->current = *next;
+    a->shown = CFBD_TRUE;
+
+    CFBD_MenuHighlight flush;
+    if (visible_part(m, x0, y0, x1, y1, &flush))
+        m->device->ops->update_area(m->device, flush.x, flush.y, flush.w, flush.h);
+    if (clipped)
+        CFBDGraphic_PopClip(m->device);
+}
 
-#undef MAKE_RECT
+static void CFBD_MenuBeginSelect(CFBD_Menu* m, int new_index, uint32_t now_ms)
+{
+    CFBD_MenuItemGroup* group = m->menu_items;
+    if (group->count == 0)
+        return;
+    if (new_index < 0)
+        new_index = 0;
+    if (new_index >= (int) group->count)
+        new_index = (int) group->count - 1;
+
+    CFBD_MenuSelectAnimation* a = &m->select_anim;
+    if (new_index == m->selected)
+        return;
     m->selected = new_index;
+
+    // nothing on screen yet: the next immediate_draw() shows the new selection
+    if (!a->shown)
+        return;
+
+    // the highlight only travels inside the window, scroll the target in first
+    if (has_viewport(m))
+        scroll_viewport(m, scroll_to_show(m, new_index));
+
+    /* 动画中途再次选择: 从当前位置重新出发 */
+    a->from = a->current;
+    a->start_ms = now_ms;
+    a->frame = 0;
+    a->running = CFBD_TRUE;
+}
+
+static CFBD_Bool CFBD_MenuTick(CFBD_Menu* m, uint32_t now_ms)
+{
+    CFBD_MenuSelectAnimation* a = &m->select_anim;
+    if (!a->running)
+        return CFBD_FALSE;
+
+    const uint8_t frames = (m->animation.anim_frames > 1) ? m->animation.anim_frames : 1;
+    if (!CFBD_AnimationAdvanceFrame(
+                &a->frame, frames, m->animation.anim_frame_delay_ms, now_ms - a->start_ms))
+        return CFBD_TRUE;
+    const uint8_t due = a->frame;
+
+    const CFBD_MenuHighlight to = item_highlight(m, m->selected);
+    const int32_t st = CFBD_EaseQ16(CFBD_EASE_SMOOTHSTEP, CFBD_EaseProgressQ16(due, frames));
+    CFBD_MenuHighlight next = {.x = (int16_t) CFBD_EaseLerp(a->from.x, to.x, st),
+                               .y = (int16_t) CFBD_EaseLerp(a->from.y, to.y, st),
+                               .w = (int16_t) CFBD_EaseLerp(a->from.w, to.w, st),
+                               .h = (int16_t) CFBD_EaseLerp(a->from.h, to.h, st)};
+    if (next.w < 1)
+        next.w = 1;
+    if (next.h < 1)
+        next.h = 1;
+    move_highlight(m, &next);
+
+    if (due == frames)
+        a->running = CFBD_FALSE;
+    return a->running;
+}
+
+void OLED_Menu_Select(CFBD_Menu* m, int new_index)
+{
+    // blocking flavour: the same state machine driven by a virtual clock
+    uint32_t now_ms = 0;
+    CFBD_MenuBeginSelect(m, new_index, now_ms);
+    while (CFBD_MenuTick(m, now_ms)) {
+        system_delay_ms(m->animation.anim_frame_delay_ms);
+        now_ms += m->animation.anim_frame_delay_ms;
+    }
 }
 
 static void reset_tl_points(CFBD_Menu* m, CFBDGraphic_Point* p, CFBD_Bool request_updates)
@@ -368,10 +419,13 @@ static void reset_tl_points(CFBD_Menu* m, CFBDGraphic_Point* p, CFBD_Bool reques
                                m->tl_point.x,
                                m->tl_point.y,
                                m->max_width,
-                               get_menu_new_item_y(m) - m->tl_point.y);
+                               menu_height(m));
+    m->select_anim.running = CFBD_FALSE;
+    m->select_anim.shown = CFBD_FALSE;
+    m->scroll_y = 0;
     m->tl_point = *p;
     PointBaseType y_height = CFBD_MENU_ITEM_Y_GAP + m->tl_point.y;
-    for (int i = 0; i < m->menu_items->count; i++) {
+    for (size_t i = 0; i < m->menu_items->count; i++) {
         CFBD_MenuItem* item = &m->menu_items->pItems[i];
         item->tl.x = get_menu_new_item_x(m);
         item->tl.y = y_height;
@@ -383,7 +437,7 @@ static void reset_tl_points(CFBD_Menu* m, CFBDGraphic_Point* p, CFBD_Bool reques
                                     m->tl_point.x,
                                     m->tl_point.y,
                                     m->max_width,
-                                    get_menu_new_item_y(m) - m->tl_point.y);
+                                    menu_height(m));
         CFBD_DrawMenu(m);
     }
 }
@@ -399,13 +453,24 @@ static void OLED_Menu_Activate(CFBD_Menu* m)
     }
 }
 
+static void CFBD_MenuSetViewport(CFBD_Menu* m, SizeBaseType height)
+{
+    m->viewport_height = height;
+    m->scroll_y = 0;
+    m->select_anim.running = CFBD_FALSE;
+    m->select_anim.shown = CFBD_FALSE;
+}
+
 static CFBD_MenuOps _ops = {.bind_item_groups_contains = CFBD_BindMenuItems,
                             .set_animation = CFBD_AnimationSet,
                             .add_item = CFBD_MenuAddItems,
                             .immediate_draw = CFBD_DrawMenu,
                             .activate_current = OLED_Menu_Activate,
                             .select_index = OLED_Menu_Select,
-                            .reset_tl_points = reset_tl_points};
+                            .begin_select = CFBD_MenuBeginSelect,
+                            .tick = CFBD_MenuTick,
+                            .reset_tl_points = reset_tl_points,
+                            .set_viewport = CFBD_MenuSetViewport};
 
 void CFBD_InitMenu(CFBD_Menu* pMenu,
                    CFBD_GraphicDevice* devices,
@@ -420,5 +485,10 @@ void CFBD_InitMenu(CFBD_Menu* pMenu,
     CFBD_InitBaseAnimation(&pMenu->animation);
     CFBD_InitDefaultMenuIndicator(&pMenu->indicator);
     pMenu->menu_items = assigned_menu_items;
+    pMenu->items_height = sum_item_heights(assigned_menu_items);
     pMenu->selected = 0;
+    pMenu->viewport_height = 0;
+    pMenu->scroll_y = 0;
+    pMenu->select_anim.running = CFBD_FALSE;
+    pMenu->select_anim.shown = CFBD_FALSE;
 }
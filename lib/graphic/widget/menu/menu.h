@@ -23,6 +23,39 @@
  */
 typedef struct _CFBD_Menu CFBD_Menu;
 
+/**
+ * @brief Selection highlight geometry: indicator bar at y, text reverted at (x, y, w, h)
+ */
+typedef struct
+{
+    int16_t x;
+    int16_t y;
+    int16_t w;
+    int16_t h;
+} CFBD_MenuHighlight;
+
+/**
+ * @brief State of the selection animation, advanced by CFBD_MenuOps::tick
+ * @details The highlight slides from @ref from to the selected item in
+ *          CFBD_BaseAnimation::anim_frames frames of anim_frame_delay_ms.
+ *          With a delay of 0 each tick draws the next frame.
+ */
+typedef struct
+{
+    /** @brief Highlight currently on screen (valid when @ref shown) */
+    CFBD_MenuHighlight current;
+    /** @brief Highlight at frame 0 of the running animation */
+    CFBD_MenuHighlight from;
+    /** @brief Tick (ms) of frame 0 */
+    uint32_t start_ms;
+    /** @brief Frame currently on screen */
+    uint8_t frame;
+    /** @brief CFBD_TRUE while the highlight moves */
+    CFBD_Bool running;
+    /** @brief CFBD_TRUE once the menu has been drawn */
+    CFBD_Bool shown;
+} CFBD_MenuSelectAnimation;
+
 typedef struct
 {
     /**
@@ -53,9 +86,25 @@ typedef struct
     void (*immediate_draw)(CFBD_Menu* pMenu);
     /**
      * @brief index selectors
-     *
+     * @note blocks until the highlight animation is over, see begin_select.
+     *       With a delay of 0 the frames are drawn back to back.
      */
     void (*select_index)(CFBD_Menu* pMenu, int index);
+    /**
+     * @brief Select an index and start moving the highlight, returns at once
+     * @note Selecting again while the highlight moves retargets it from
+     *       where it currently is. pMenu->selected changes immediately.
+     * @param now_ms monotonic millisecond tick, wrapping is fine
+     */
+    void (*begin_select)(CFBD_Menu* pMenu, int index, uint32_t now_ms);
+    /**
+     * @brief Draw the animation frame due at now_ms, never waits
+     * @note Late ticks skip the frames in between, with a delay of 0 every
+     *       call draws the next frame. Each drawn frame is flushed with one
+     *       update_area() over the old and new highlight.
+     * @return CFBD_TRUE while the animation is still running
+     */
+    CFBD_Bool (*tick)(CFBD_Menu* pMenu, uint32_t now_ms);
     /**
      * @brief User Activate the Selections, so things goes on
      *
@@ -68,6 +117,14 @@ typedef struct
      *
      */
     void (*reset_tl_points)(CFBD_Menu* pMenu, CFBDGraphic_Point* p, CFBD_Bool request_updates);
+    /**
+     * @brief Show the items through a scrolling window of @p height rows
+     * @note 0 (the default) draws every item. With a viewport only the rows
+     *       inside it are drawn; selecting an item outside scrolls the window
+     *       by moving the frame buffer rows and drawing the exposed strip.
+     *       Takes effect on the next immediate_draw().
+     */
+    void (*set_viewport)(CFBD_Menu* pMenu, SizeBaseType height);
 } CFBD_MenuOps;
 
 /**
@@ -103,6 +160,18 @@ typedef struct _CFBD_Menu
 
     /** @brief Animation timing configuration */
     CFBD_BaseAnimation animation;
+
+    /** @brief Non-blocking selection animation state */
+    CFBD_MenuSelectAnimation select_anim;
+
+    /** @brief Sum of all item heights, keeps add_item independent of the item count */
+    uint32_t items_height;
+
+    /** @brief Rows of the scrolling window below tl_point, 0 draws every item */
+    SizeBaseType viewport_height;
+
+    /** @brief Content rows scrolled out above the window (viewport mode only) */
+    uint16_t scroll_y;
 } CFBD_Menu;
 
 /**
@@ -121,6 +190,9 @@ typedef struct _CFBD_Menu
  *     CFBD_InitMenu(&menu, graphics_device, &items, 128);
  *     menu.operations->add_item(&menu, "Item 1", ASCII_8x16, NULL);
  *     menu.operations->immediate_draw(&menu);
+ *
+ *     // long lists: keep 48 rows on screen, only visible rows are drawn
+ *     menu.operations->set_viewport(&menu, 48);
  * @see CFBD_Menu
  * @see CFBD_MenuOps
  */
@@ -165,4 +237,29 @@ static inline void OLED_Menu_SelectPrev(CFBD_Menu* m)
     m->operations->select_index(m, ni);
 }
 
+/**
+ * @brief Non-blocking OLED_Menu_SelectNext(), drive it with tick()
+ * @example
+ *     // UI loop, no delay inside
+ *     if (key_down_pressed())
+ *         OLED_Menu_BeginSelectNext(menu, millis());
+ *     menu->operations->tick(menu, millis());
+ */
+static inline void OLED_Menu_BeginSelectNext(CFBD_Menu* m, uint32_t now_ms)
+{
+    int ni = (m->selected + 1) % (int) m->menu_items->count;
+    m->operations->begin_select(m, ni, now_ms);
+}
+
+/**
+ * @brief Non-blocking OLED_Menu_SelectPrev(), drive it with tick()
+ */
+static inline void OLED_Menu_BeginSelectPrev(CFBD_Menu* m, uint32_t now_ms)
+{
+    int ni = (m->selected - 1);
+    if (ni < 0)
+        ni = (int) m->menu_items->count - 1;
+    m->operations->begin_select(m, ni, now_ms);
+}
+
 /** @} */
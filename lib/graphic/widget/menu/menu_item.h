@@ -8,6 +8,8 @@
  */
 
 #pragma once
+#include <stddef.h>
+
 #include "base/point.h"
 #include "widget/text.h"
 
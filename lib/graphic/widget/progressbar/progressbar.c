@@ -4,46 +4,15 @@
 #include <string.h>
 
 #include "cfbd_define.h"
+#include "base/rectangle.h"
 #include "device/graphic_device.h"
 #include "sys_clock/system_clock.h" /* for system_delay_ms */
 #include "widget/animation/animation.h"
+#include "widget/animation/easing.h"
 #include "widget/base_support/common/helpers.h"
 
-/* Draw rectangle border using setPixel (1px thick) */
-static void
-draw_rect_border(CFBD_GraphicDevice* dev, uint16_t x, uint16_t y, uint16_t w, uint16_t h)
-{
-    CFBD_Bool (*SetPixelAction)(CFBD_GraphicDevice* dev, uint16_t x, uint16_t y) =
-            dev->ops->setPixel;
-    /* top/bottom */
-    for (uint16_t ix = x; ix < x + w; ++ix) {
-        SetPixelAction(dev, ix, y);
-        SetPixelAction(dev, ix, y + h - 1);
-    }
-    /* left/right */
-    for (uint16_t iy = y; iy < y + h; ++iy) {
-        SetPixelAction(dev, x, iy);
-        SetPixelAction(dev, x + w - 1, iy);
-    }
-}
-
-/* Fill rectangular area with pixels (setPixel) */
-static void fill_rect(CFBD_GraphicDevice* dev, uint16_t x, uint16_t y, uint16_t w, uint16_t h)
-{
-    CFBD_Bool (*SetPixelAction)(CFBD_GraphicDevice* dev, uint16_t x, uint16_t y) =
-            dev->ops->setPixel;
-    for (uint16_t iy = y; iy < y + h; ++iy) {
-        for (uint16_t ix = x; ix < x + w; ++ix) {
-            SetPixelAction(dev, ix, iy);
-        }
-    }
-}
-
-/* Clear area using device-provided clear_area (faster than per-pixel clear) */
-static void clear_rect(CFBD_GraphicDevice* dev, uint16_t x, uint16_t y, uint16_t w, uint16_t h)
-{
-    dev->ops->clear_area(dev, x, y, w, h);
-}
+/* Frame length used when the animation asks for no delay */
+#define PROGRESSBAR_DEFAULT_FRAME_MS (16)
 
 /* internal: compute inner box (where fill is drawn) */
 static void compute_inner_box(CFBD_ProgressBar* pb,
@@ -93,12 +62,7 @@ static void compute_inner_box(CFBD_ProgressBar* pb,
     *out_h = h;
 }
 
-static float smoothstep(float t)
-{
-    /* classic smoothstep: 3t^2 - 2t^3 */
-    return t * t * (3.0f - 2.0f * t);
-}
-
+/* Fill width for @p value, rounded to the nearest pixel */
 static uint16_t compute_fill_width(CFBD_ProgressBar* pb, int32_t value)
 {
     uint16_t ix, iy, iw, ih;
@@ -108,101 +72,147 @@ static uint16_t compute_fill_width(CFBD_ProgressBar* pb, int32_t value)
         return 0;
 
     value = clamp_i32(value, pb->min, pb->max);
-    float frac = (float) (value - pb->min) / (float) (pb->max - pb->min);
-
-    if (frac < 0.0f)
-        frac = 0.0f;
-    if (frac > 1.0f)
-        frac = 1.0f;
-
-    return (uint16_t) (frac * (float) iw + 0.5f);
+    // 无符号差值, 覆盖整个 int32 范围
+    const uint32_t range = (uint32_t) pb->max - (uint32_t) pb->min;
+    const uint32_t done = (uint32_t) value - (uint32_t) pb->min;
+    return (uint16_t) (((uint64_t) done * iw + range / 2) / range);
 }
 
-void CFBD_ProgressBar_Draw(CFBD_ProgressBar* pb)
+/* Fill columns [from, to) of the inner box */
+static void fill_columns(CFBD_GraphicDevice* dev,
+                         uint16_t ix,
+                         uint16_t iy,
+                         uint16_t ih,
+                         uint16_t from,
+                         uint16_t to)
 {
-    if (!pb || !pb->device)
+    if (from >= to || ih == 0)
         return;
+    CFBDGraphicRect span = {{ix + from, iy}, {ix + to - 1, iy + ih - 1}};
+    CFBDGraphic_FillRect(dev, &span);
+}
 
+/*
+    Bring the fill on screen to @p fill columns. Once the bar is drawn only
+    the columns between the old and the new fill edge are painted and
+    flushed; the first call draws and flushes the whole bar.
+*/
+static void show_fill(CFBD_ProgressBar* pb, uint16_t fill)
+{
     CFBD_GraphicDevice* dev = pb->device;
+    if (pb->drawn && fill == pb->drawn_fill)
+        return;
 
     uint16_t ix, iy, iw, ih;
     compute_inner_box(pb, &ix, &iy, &iw, &ih);
 
-    /* clear inner area */
-    clear_rect(dev, ix, iy, iw, ih);
+    // 绘制期间不刷新, 结束后只刷新变化的列
+    const CFBD_Bool immediate = CFBDGraphic_DeviceRequestUpdateAtOnce(dev);
+    CFBDGraphic_DeviceSetIfRequestUpdateAtOnce(dev, CFBD_FALSE);
+    if (!pb->drawn) {
+        if (pb->border && pb->size.width > 0 && pb->size.height > 0) {
+            CFBDGraphicRect frame = {pb->tl,
+                                     {pb->tl.x + pb->size.width - 1,
+                                      pb->tl.y + pb->size.height - 1}};
+            CFBDGraphic_DrawRect(dev, &frame);
+        }
+        if (iw > 0 && ih > 0)
+            dev->ops->clear_area(dev, ix, iy, iw, ih);
+        fill_columns(dev, ix, iy, ih, 0, fill);
+    }
+    else if (fill > pb->drawn_fill) {
+        fill_columns(dev, ix, iy, ih, pb->drawn_fill, fill);
+    }
+    else {
+        dev->ops->clear_area(dev, ix + fill, iy, pb->drawn_fill - fill, ih);
+    }
+    CFBDGraphic_DeviceSetIfRequestUpdateAtOnce(dev, immediate);
 
-    /* draw filled area */
-    uint16_t fill_w = compute_fill_width(pb, pb->value);
-    if (fill_w > 0)
-        fill_rect(dev, ix, iy, fill_w, ih);
+    if (!pb->drawn) {
+        dev->ops->update_area(dev, pb->tl.x, pb->tl.y, pb->size.width, pb->size.height);
+    }
+    else if (ih > 0) {
+        const uint16_t lo = (fill < pb->drawn_fill) ? fill : pb->drawn_fill;
+        const uint16_t hi = (fill < pb->drawn_fill) ? pb->drawn_fill : fill;
+        dev->ops->update_area(dev, ix + lo, iy, hi - lo, ih);
+    }
+    pb->drawn = CFBD_TRUE;
+    pb->drawn_fill = fill;
+}
 
-    /* border */
-    if (pb->border)
-        draw_rect_border(dev, pb->tl.x, pb->tl.y, pb->size.width, pb->size.height);
+void CFBD_ProgressBar_Draw(CFBD_ProgressBar* pb)
+{
+    if (!pb || !pb->device)
+        return;
 
-    dev->ops->update_area(dev, pb->tl.x, pb->tl.y, pb->size.width, pb->size.height);
+    // 动画进行中保持当前帧, 否则画目标值
+    const uint16_t fill = (pb->anim.running && pb->drawn) ? pb->drawn_fill
+                                                          : compute_fill_width(pb, pb->value);
+    pb->drawn = CFBD_FALSE;
+    show_fill(pb, fill);
 }
 
-void CFBD_ProgressBar_SetValue(CFBD_ProgressBar* pb, int32_t new_value)
+void CFBD_ProgressBar_BeginValue(CFBD_ProgressBar* pb, int32_t new_value, uint32_t now_ms)
 {
     if (!pb || !pb->device)
         return;
 
     new_value = clamp_i32(new_value, pb->min, pb->max);
 
-    int32_t old_value = pb->value;
+    CFBD_ProgressBarAnimation* a = &pb->anim;
+    const int32_t shown = a->running ? a->current : pb->value;
+    pb->value = new_value;
+
     if (pb->animation.anim_frames <= 1) {
-        pb->value = new_value;
-        CFBD_ProgressBar_Draw(pb);
+        a->running = CFBD_FALSE;
+        show_fill(pb, compute_fill_width(pb, new_value));
         return;
     }
-
-    uint16_t ix, iy, iw, ih;
-    compute_inner_box(pb, &ix, &iy, &iw, &ih);
-    if (iw == 0 || ih == 0) {
-        pb->value = new_value;
+    if (!a->running && shown == new_value)
         return;
-    }
-
-    int frames = pb->animation.anim_frames;
-    int delay = (pb->animation.anim_frame_delay_ms > 0) ? pb->animation.anim_frame_delay_ms : 16;
 
-    uint16_t last_fill = compute_fill_width(pb, old_value);
-
-    for (int f = 1; f <= frames; ++f) {
-        float t = (float) f / (float) frames;
-        float st = smoothstep(t);
-
-        int32_t cur_value = old_value + (int32_t) ((float) (new_value - old_value) * st);
+    /* 动画中途再次设置: 从当前值重新出发 */
+    a->from = shown;
+    a->current = shown;
+    a->start_ms = now_ms;
+    a->frame_ms = (pb->animation.anim_frame_delay_ms > 0) ? pb->animation.anim_frame_delay_ms
+                                                           : PROGRESSBAR_DEFAULT_FRAME_MS;
+    a->frame = 0;
+    a->running = CFBD_TRUE;
+}
 
-        uint16_t cur_fill = compute_fill_width(pb, cur_value);
+CFBD_Bool CFBD_ProgressBar_Tick(CFBD_ProgressBar* pb, uint32_t now_ms)
+{
+    CFBD_ProgressBarAnimation* a = &pb->anim;
+    if (!a->running)
+        return CFBD_FALSE;
 
-        /* incremental update only */
-        if (cur_fill > last_fill) {
-            /* grow */
-            fill_rect(pb->device, ix + last_fill, iy, cur_fill - last_fill, ih);
-        }
-        else if (cur_fill < last_fill) {
-            /* shrink */
-            clear_rect(pb->device, ix + cur_fill, iy, last_fill - cur_fill, ih);
-        }
+    const uint8_t frames = pb->animation.anim_frames ? pb->animation.anim_frames : 1;
+    if (!CFBD_AnimationAdvanceFrame(&a->frame, frames, a->frame_ms, now_ms - a->start_ms))
+        return CFBD_TRUE;
+    const uint8_t due = a->frame;
 
-        if (pb->border)
-            draw_rect_border(pb->device, pb->tl.x, pb->tl.y, pb->size.width, pb->size.height);
+    const int32_t st = CFBD_EaseQ16(CFBD_EASE_SMOOTHSTEP, CFBD_EaseProgressQ16(due, frames));
+    a->current = CFBD_EaseLerp(a->from, pb->value, st);
+    show_fill(pb, compute_fill_width(pb, a->current));
 
-        pb->device->ops->update_area(pb->device,
-                                     pb->tl.x,
-                                     pb->tl.y,
-                                     pb->size.width,
-                                     pb->size.height);
+    if (due == frames)
+        a->running = CFBD_FALSE;
+    return a->running;
+}
 
-        last_fill = cur_fill;
-        pb->value = cur_value;
+void CFBD_ProgressBar_SetValue(CFBD_ProgressBar* pb, int32_t new_value)
+{
+    if (!pb || !pb->device)
+        return;
 
-        system_delay_ms(delay);
+    // blocking flavour: the same state machine driven by a virtual clock
+    uint32_t now_ms = 0;
+    CFBD_ProgressBar_BeginValue(pb, new_value, now_ms);
+    while (CFBD_ProgressBar_Tick(pb, now_ms)) {
+        system_delay_ms(pb->anim.frame_ms);
+        now_ms += pb->anim.frame_ms;
     }
-
-    pb->value = new_value;
 }
 
 /*
@@ -216,11 +226,13 @@ CFBD_ProgressBar_SetProperty(CFBD_ProgressBar* pb, const char* property, const v
     if (strcmp(property, "border") == 0) {
         uint8_t border = *(uint8_t*) (value);
         pb->border = border;
+        pb->drawn = CFBD_FALSE; // geometry changed, next draw is a full one
         return CFBD_TRUE;
     }
     else if (strcmp(property, "padding") == 0) {
         uint8_t padding = *(uint8_t*) (value);
         pb->padding = padding;
+        pb->drawn = CFBD_FALSE;
         return CFBD_TRUE;
     }
     else if (strcmp(property, "animation") == 0) {
@@ -233,7 +245,9 @@ CFBD_ProgressBar_SetProperty(CFBD_ProgressBar* pb, const char* property, const v
 
 CFBD_ProgressBarOps ops = {.immediate_draw = CFBD_ProgressBar_Draw,
                            .set_property = CFBD_ProgressBar_SetProperty,
-                           .set_value = CFBD_ProgressBar_SetValue};
+                           .set_value = CFBD_ProgressBar_SetValue,
+                           .begin_value = CFBD_ProgressBar_BeginValue,
+                           .tick = CFBD_ProgressBar_Tick};
 
 /* simple setters */
 void CFBD_ProgressBar_Init(CFBD_ProgressBar* pb,
@@ -21,6 +21,27 @@
  */
 typedef struct __CFBD_ProgressBar CFBD_ProgressBar;
 
+/**
+ * @brief State of the value animation, advanced by CFBD_ProgressBarOps::tick
+ * @details The value eases from @ref from to CFBD_ProgressBar::value in
+ *          CFBD_BaseAnimation::anim_frames frames of @ref frame_ms.
+ */
+typedef struct
+{
+    /** @brief Value at frame 0 */
+    int32_t from;
+    /** @brief Value of the frame on screen */
+    int32_t current;
+    /** @brief Tick (ms) of frame 0 */
+    uint32_t start_ms;
+    /** @brief Frame length, anim_frame_delay_ms or 16 ms when that is 0 */
+    uint32_t frame_ms;
+    /** @brief Frame currently on screen */
+    uint8_t frame;
+    /** @brief CFBD_TRUE while the value moves */
+    CFBD_Bool running;
+} CFBD_ProgressBarAnimation;
+
 /**
  * @typedef CFBD_ProgressBarOps
  * @brief Progress bar operation callbacks
@@ -32,8 +53,9 @@ typedef struct
 {
     /**
      * @brief Render progress bar immediately
-     * @details Draws current progress bar state with all visual properties.
-     *          Updates display immediately if device in immediate mode.
+     * @details Draws current progress bar state with all visual properties
+     *          and flushes the whole bar. Later value changes only touch
+     *          the columns whose fill changes.
      * @param pb - Progress bar structure
      * @return void
      * @example
@@ -44,7 +66,8 @@ typedef struct
     /**
      * @brief Set progress bar value
      * @details Updates current progress value within [min, max] range.
-     *          Automatically triggers visual update.
+     *          Automatically triggers visual update. Blocks until the
+     *          animation is over, see begin_value for the non-blocking way.
      * @param pb - Progress bar structure
      * @param new_value - New value (clamped to [min, max])
      * @return void
@@ -54,6 +77,32 @@ typedef struct
      */
     void (*set_value)(CFBD_ProgressBar*, int32_t new_value);
 
+    /**
+     * @brief Set the value and start animating towards it, returns at once
+     * @details Without animation (anim_frames <= 1) the new fill is drawn
+     *          right away. Setting again while animating retargets from the
+     *          value currently shown.
+     * @param pb - Progress bar structure
+     * @param new_value - New value (clamped to [min, max])
+     * @param now_ms - Monotonic millisecond tick, wrapping is fine
+     * @return void
+     * @example
+     *     pb->ops->begin_value(pb, reading, millis());
+     *     // main loop, no delay inside
+     *     pb->ops->tick(pb, millis());
+     */
+    void (*begin_value)(CFBD_ProgressBar*, int32_t new_value, uint32_t now_ms);
+
+    /**
+     * @brief Draw the animation frame due at now_ms, never waits
+     * @details Late ticks skip the frames in between. Only the columns
+     *          between the old and the new fill edge are drawn and flushed.
+     * @param pb - Progress bar structure
+     * @param now_ms - Monotonic millisecond tick
+     * @return @c CFBD_TRUE while the animation is still running
+     */
+    CFBD_Bool (*tick)(CFBD_ProgressBar*, uint32_t now_ms);
+
     /**
      * @brief Set progress bar property
      * @details Configures various visual properties of progress bar.
@@ -118,6 +167,15 @@ typedef struct __CFBD_ProgressBar
 
     /** @brief Animation timing configuration for transitions */
     CFBD_BaseAnimation animation;
+
+    /** @brief Running value animation */
+    CFBD_ProgressBarAnimation anim;
+
+    /** @brief Fill width in pixels currently on screen (valid when @ref drawn) */
+    uint16_t drawn_fill;
+
+    /** @brief CFBD_TRUE once the whole bar has been drawn */
+    CFBD_Bool drawn;
 } CFBD_ProgressBar;
 
 /**
@@ -2,6 +2,7 @@
 #include "text.h"
 
 #include <limits.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <string.h>
 
@@ -11,6 +12,9 @@
 #include "base_support/image.h"
 #include "cfbd_define.h"
 #include "cfbd_graphic_define.h"
+#include "device/graphic_canvas.h"
+#include "device/graphic_scale.h"
+#include "text_font.h"
 #include "widget/text.h"
 
 void CFBDGraphic_InitText(CFBDGraphic_Text* item,
@@ -24,30 +28,41 @@ void CFBDGraphic_InitText(CFBDGraphic_Text* item,
     item->indexed_point = tl_point;
     item->TexthandleSize = textHandleSize;
     item->no_wrap = CFBD_FALSE;
+    item->shadow = NULL;
+    item->shadow_size = 0;
+    item->shadow_length = 0;
 }
 
+/*
+    Glyphs are blitted straight into the frame buffer when the device exposes
+    one, else handed to setArea(). Neither flushes: DrawText issues a single
+    update_area() for the whole run.
+*/
 static void __pvt_draw_char_each(CFBD_GraphicDevice* device_handle,
-                                 CCGraphic_Image* borrowing_image,
-                                 const char ch,
-                                 Ascii_Font_Size size)
+                                 CFBDGraphic_Canvas* canvas,
+                                 CFBD_Bool has_canvas,
+                                 CFBDGraphic_Point* tl,
+                                 const CFBDGraphicSize* glyph_size,
+                                 const uint8_t* glyph)
 {
-    borrowing_image->image_size = __fetch_font_size(size);
-    uint8_t* ascii = __select_from_ascii_font_size(size, ch);
-    borrowing_image->sources_register = ascii;
-    CFBDGraphic_DrawImage(device_handle, borrowing_image);
-}
+    if (glyph == NULL)
+        return;
 
-static uint8_t inline __pvt_should_be_next_line(CFBD_GraphicDevice* device_handle,
-                                                CFBDGraphic_Point* brpoint,
-                                                CFBDGraphic_Point* cur_draw_p,
-                                                Ascii_Font_Size s)
-{
-    return cur_draw_p->x + (int16_t) (1.5 * __fetch_font_size(s).width) >= brpoint->x;
+    if (has_canvas) {
+        CFBDGraphic_CanvasBlit(canvas, tl->x, tl->y, glyph_size->width, glyph_size->height, glyph);
+        return;
+    }
+    device_handle->ops->setArea(device_handle,
+                                tl->x,
+                                tl->y,
+                                glyph_size->width,
+                                glyph_size->height,
+                                (uint8_t*) glyph);
 }
 
 static CFBDGraphic_Point inline __pvt_fetch_valid_final_point(CFBD_GraphicDevice* device_handle,
-                                                              CFBDGraphicSize* size,
-                                                              CFBDGraphic_Point* tl)
+                                                              const CFBDGraphicSize* size,
+                                                              const CFBDGraphic_Point* tl)
 {
     CFBDGraphic_Point br;
     CFBDGraphicSize device_size;
@@ -64,91 +79,275 @@ static CFBDGraphic_Point inline __pvt_fetch_valid_final_point(CFBD_GraphicDevice
     return br;
 }
 
-CFBDGraphic_Point
-CFBDGraphic_DrawText(CFBD_GraphicDevice* device_handle, CFBDGraphic_Text* item, AppendMethod method)
+/*
+    A line wraps after the cell that leaves less than one and a half cells
+    before the right edge, so a line starting at x holds a fixed count.
+*/
+static uint16_t __pvt_cells_per_line(int32_t x, int32_t right, SizeBaseType cell_width)
 {
-    if (!device_handle || !item || !device_handle->ops)
+    const int32_t room = right - (3 * (int32_t) cell_width) / 2 - x;
+    if (room <= 0)
+        return 1;
+    const int32_t cells = (room + cell_width - 1) / cell_width + 1;
+    return (cells < UINT16_MAX) ? (uint16_t) cells : UINT16_MAX;
+}
+
+static void __pvt_layout(const char* text,
+                         Ascii_Font_Size font_size,
+                         CFBDGraphic_Point origin,
+                         PointBaseType line_x,
+                         int32_t right,
+                         CFBD_Bool wrap,
+                         CFBDGraphic_TextLayout* layout)
+{
+    const CFBDGraphicSize cell = __fetch_font_size(font_size);
+    layout->origin = origin;
+    layout->line_x = line_x;
+    layout->cell = cell;
+
+    uint16_t cells = 0;
+    for (const char* cursor = text; CFBDGraphic_DecodeUTF8(&cursor) != 0;)
+        cells++;
+    layout->cells = cells;
+
+    if (wrap && cell.width != 0) {
+        layout->first_line_cells = __pvt_cells_per_line(origin.x, right, cell.width);
+        layout->line_cells = __pvt_cells_per_line(line_x, right, cell.width);
+    }
+    else {
+        layout->first_line_cells = UINT16_MAX;
+        layout->line_cells = UINT16_MAX;
+    }
+
+    if (cells == 0) {
+        layout->lines = 0;
+        layout->bounds.tl = origin;
+        layout->bounds.br = origin;
+        return;
+    }
+
+    // 第一行之后每行字符数相同, 包围盒可直接算出
+    const uint16_t first = (cells < layout->first_line_cells) ? cells : layout->first_line_cells;
+    int32_t lx = origin.x;
+    int32_t rx = origin.x + (int32_t) first * cell.width;
+    layout->lines = 1;
+    if (cells > layout->first_line_cells) {
+        const uint16_t rest = cells - layout->first_line_cells;
+        const uint16_t widest = (rest < layout->line_cells) ? rest : layout->line_cells;
+        layout->lines += (rest + layout->line_cells - 1) / layout->line_cells;
+        if (line_x < lx)
+            lx = line_x;
+        if (line_x + (int32_t) widest * cell.width > rx)
+            rx = line_x + (int32_t) widest * cell.width;
+    }
+
+    layout->bounds.tl.x = clamp_u16_from_i32(lx);
+    layout->bounds.tl.y = origin.y;
+    layout->bounds.br.x = clamp_u16_from_i32(rx);
+    layout->bounds.br.y = clamp_u16_from_i32(origin.y + (int32_t) layout->lines * cell.height);
+}
+
+CFBDGraphicSize
+CFBDGraphic_MeasureText(const char* text, Ascii_Font_Size font_size, SizeBaseType max_width)
+{
+    CFBDGraphicSize size = {0, 0};
+    if (text == NULL)
+        return size;
+
+    CFBDGraphic_TextLayout layout;
+    CFBDGraphic_Point origin = {0, 0};
+    __pvt_layout(text, font_size, origin, 0, max_width, max_width != 0, &layout);
+    size.width = layout.bounds.br.x - layout.bounds.tl.x;
+    size.height = layout.bounds.br.y - layout.bounds.tl.y;
+    return size;
+}
+
+void CFBDGraphic_LayoutText(CFBD_GraphicDevice* device_handle,
+                            const CFBDGraphic_Text* item,
+                            CFBDGraphic_TextLayout* layout)
+{
+    const CFBDGraphic_Point br =
+            __pvt_fetch_valid_final_point(device_handle, &item->TexthandleSize, &item->tl_point);
+    __pvt_layout(item->sources_borrowed,
+                 item->font_size,
+                 item->indexed_point,
+                 item->tl_point.x,
+                 br.x,
+                 !item->no_wrap,
+                 layout);
+}
+
+void CFBDGraphic_TextLayoutCell(const CFBDGraphic_TextLayout* layout,
+                                uint16_t cell,
+                                CFBDGraphic_Point* tl)
+{
+    if (cell < layout->first_line_cells) {
+        tl->x = layout->origin.x + cell * layout->cell.width;
+        tl->y = layout->origin.y;
+        return;
+    }
+
+    const uint16_t rest = cell - layout->first_line_cells;
+    tl->x = layout->line_x + (rest % layout->line_cells) * layout->cell.width;
+    tl->y = layout->origin.y + (1 + rest / layout->line_cells) * layout->cell.height;
+}
+
+/* Step to the next cell, line_left counts the cells left on the current line */
+static inline void __pvt_next_cell(const CFBDGraphic_TextLayout* layout,
+                                   CFBDGraphic_Point* tl,
+                                   uint16_t* line_left)
+{
+    if (--(*line_left) == 0) {
+        tl->x = layout->line_x;
+        tl->y += layout->cell.height;
+        *line_left = layout->line_cells;
+    }
+    else {
+        tl->x += layout->cell.width;
+    }
+}
+
+static inline void __pvt_grow_bounds(int32_t* lx,
+                                     int32_t* ty,
+                                     int32_t* rx,
+                                     int32_t* by,
+                                     const CFBDGraphic_Point* cell,
+                                     const CFBDGraphicSize* size)
+{
+    const int32_t cx1 = asInt32_t(cell->x);
+    const int32_t cy1 = asInt32_t(cell->y);
+    const int32_t cx2 = cx1 + size->width;
+    const int32_t cy2 = cy1 + size->height;
+
+    if (cx1 < *lx)
+        *lx = cx1;
+    if (cy1 < *ty)
+        *ty = cy1;
+    if (cx2 > *rx)
+        *rx = cx2;
+    if (cy2 > *by)
+        *by = cy2;
+}
+
+/* The shadow describes what is on screen only if it was rendered from the same spot */
+static inline CFBD_Bool __pvt_can_diff(const CFBDGraphic_Text* item)
+{
+    return item->shadow != NULL && item->shadow_length != 0 &&
+           item->shadow_origin.x == item->indexed_point.x &&
+           item->shadow_origin.y == item->indexed_point.y;
+}
+
+/* Keep as many whole UTF-8 characters as fit, the shadow stays terminated */
+static void __pvt_save_shadow(CFBDGraphic_Text* item, CFBDGraphic_Point origin, uint16_t cells)
+{
+    const char* source = item->sources_borrowed;
+    const char* kept_end = source;
+    const char* cursor = source;
+    while (CFBDGraphic_DecodeUTF8(&cursor) != 0 &&
+           cursor - source <= item->shadow_size - 1) {
+        kept_end = cursor;
+    }
+
+    memcpy(item->shadow, source, (size_t) (kept_end - source));
+    item->shadow[kept_end - source] = '\0';
+    item->shadow_length = cells;
+    item->shadow_origin = origin;
+}
+
+CFBDGraphic_Point CFBDGraphic_DrawTextLayout(CFBD_GraphicDevice* device_handle,
+                                             CFBDGraphic_Text* item,
+                                             const CFBDGraphic_TextLayout* layout,
+                                             AppendMethod method)
+{
+    if (!device_handle || !item || !device_handle->ops || !layout)
         return item->tl_point;
 
-    if (strcmp(item->sources_borrowed, "") == 0)
+    // 增量模式下空字符串仍需擦除上次留下的字符
+    const CFBD_Bool diffing = __pvt_can_diff(item);
+    if (strcmp(item->sources_borrowed, "") == 0 && !diffing)
         return item->tl_point;
     CFBDGraphic_Point old = item->tl_point;
-    CCGraphic_Image handle_draw_image;
-    CFBDGraphic_Point draw_tl_point = item->indexed_point;
+    const CFBDGraphic_Point origin = item->indexed_point;
+    CFBDGraphic_Canvas canvas;
+    const CFBD_Bool has_canvas = CFBDGraphic_DeviceFetchCanvas(device_handle, &canvas);
 
-    const Ascii_Font_Size font_size = item->font_size;
-    const CFBDGraphicSize size = __fetch_font_size(font_size);
+    const CFBDGraphic_Font* font = CFBDGraphic_FetchFont(item->font_size);
+    const CFBDGraphicSize size = layout->cell;
     const SizeBaseType font_width = size.width;
     const SizeBaseType font_height = size.height;
 
-    CFBDGraphic_Point br = __pvt_fetch_valid_final_point(device_handle,
-                                                         &(item->TexthandleSize),
-                                                         &(item->tl_point));
-
-    uint8_t offseterx = 0;
-    uint8_t offsetery = 0;
-
-    int32_t lx = INT32_MAX;
-    int32_t ty = INT32_MAX;
-    int32_t rx = INT32_MIN;
-    int32_t by = INT32_MIN;
-
-    for (uint8_t i = 0; item->sources_borrowed[i] != '\0'; i++) {
-        draw_tl_point.x = item->indexed_point.x + offseterx * font_width;
-        draw_tl_point.y = item->indexed_point.y + offsetery * font_height;
-
-        handle_draw_image.point = draw_tl_point;
-
-        __pvt_draw_char_each(device_handle,
-                             &handle_draw_image,
-                             item->sources_borrowed[i],
-                             item->font_size);
-
-        int32_t cx1 = asInt32_t(draw_tl_point.x);
-        int32_t cy1 = asInt32_t(draw_tl_point.y);
-        int32_t cx2 = cx1 + font_width;
-        int32_t cy2 = cy1 + font_height;
-
-        if (cx1 < lx)
-            lx = cx1;
-        if (cy1 < ty)
-            ty = cy1;
-        if (cx2 > rx)
-            rx = cx2;
-        if (cy2 > by)
-            by = cy2;
-
-        if (!item->no_wrap &&
-            __pvt_should_be_next_line(device_handle, &br, &draw_tl_point, font_size)) {
-            offseterx = 0;
-            offsetery++;
-            item->indexed_point.x = item->tl_point.x;
+    /* cells actually written, what immediate mode has to flush */
+    int32_t dirty_lx = INT32_MAX;
+    int32_t dirty_ty = INT32_MAX;
+    int32_t dirty_rx = INT32_MIN;
+    int32_t dirty_by = INT32_MIN;
+
+    /* 每个字符格对应一个 UTF-8 码点；增量模式同步解码上次的字符串 */
+    CFBDGraphic_Point draw_tl_point = layout->origin;
+    uint16_t line_left = layout->first_line_cells;
+    uint16_t i = 0;
+    const char* cursor = item->sources_borrowed;
+    const char* shadow_cursor = item->shadow;
+    uint32_t code;
+    while ((code = CFBDGraphic_DecodeUTF8(&cursor)) != 0) {
+        const uint32_t old_code = diffing ? CFBDGraphic_DecodeUTF8(&shadow_cursor) : 0;
+        if (old_code != code) {
+            __pvt_draw_char_each(device_handle,
+                                 &canvas,
+                                 has_canvas,
+                                 &draw_tl_point,
+                                 &size,
+                                 font ? CFBDGraphic_FontGlyph(font, code) : NULL);
+            __pvt_grow_bounds(&dirty_lx, &dirty_ty, &dirty_rx, &dirty_by, &draw_tl_point, &size);
         }
-        else {
-            offseterx++;
+        __pvt_next_cell(layout, &draw_tl_point, &line_left);
+        i++;
+    }
+
+    /* 字符串变短：按同一排版擦除多出来的字符格 */
+    if (diffing) {
+        for (uint16_t j = i; j < item->shadow_length; j++) {
+            device_handle->ops->clear_area(device_handle,
+                                           draw_tl_point.x,
+                                           draw_tl_point.y,
+                                           font_width,
+                                           font_height);
+            __pvt_grow_bounds(&dirty_lx, &dirty_ty, &dirty_rx, &dirty_by, &draw_tl_point, &size);
+            __pvt_next_cell(layout, &draw_tl_point, &line_left);
         }
     }
+    if (item->shadow != NULL)
+        __pvt_save_shadow(item, origin, i);
 
     /* 缓存 TextBoundingRect */
-    if (lx <= rx && ty <= by) {
-        item->text_bounding_rect.tl.x = clamp_u16_from_i32(lx - CFBDGraphic_TEXT_PADDING_WIDTH);
-        item->text_bounding_rect.tl.y = clamp_u16_from_i32(ty - CFBDGraphic_TEXT_PADDING_HEIGHT);
-        item->text_bounding_rect.br.x = clamp_u16_from_i32(rx + CFBDGraphic_TEXT_PADDING_WIDTH);
-        item->text_bounding_rect.br.y = clamp_u16_from_i32(by + CFBDGraphic_TEXT_PADDING_HEIGHT);
+    if (layout->cells != 0) {
+        item->text_bounding_rect.tl.x =
+                clamp_u16_from_i32(layout->bounds.tl.x - CFBDGraphic_TEXT_PADDING_WIDTH);
+        item->text_bounding_rect.tl.y =
+                clamp_u16_from_i32(layout->bounds.tl.y - CFBDGraphic_TEXT_PADDING_HEIGHT);
+        item->text_bounding_rect.br.x =
+                clamp_u16_from_i32(layout->bounds.br.x + CFBDGraphic_TEXT_PADDING_WIDTH);
+        item->text_bounding_rect.br.y =
+                clamp_u16_from_i32(layout->bounds.br.y + CFBDGraphic_TEXT_PADDING_HEIGHT);
     }
     else {
         item->text_bounding_rect.tl = item->indexed_point;
         item->text_bounding_rect.br = item->indexed_point;
     }
 
-    if (CFBDGraphic_DeviceRequestUpdateAtOnce(device_handle)) {
+    // 包围盒的右下边界不含在内
+    if (CFBDGraphic_DeviceRequestUpdateAtOnce(device_handle) && dirty_lx < dirty_rx) {
         device_handle->ops->update_area(device_handle,
-                                        clamp_u16_from_i32(lx),
-                                        clamp_u16_from_i32(ty),
-                                        clamp_u16_from_i32(rx - lx + 1),
-                                        clamp_u16_from_i32(by - ty + 1));
+                                        clamp_u16_from_i32(dirty_lx),
+                                        clamp_u16_from_i32(dirty_ty),
+                                        clamp_u16_from_i32(dirty_rx - dirty_lx),
+                                        clamp_u16_from_i32(dirty_by - dirty_ty));
     }
 
+    // 发生过换行时, 后续追加从左边界开始
+    if (layout->cells >= layout->first_line_cells)
+        item->indexed_point.x = item->tl_point.x;
+
     switch (method) {
         case CCGraphic_AsciiTextItem_AppendNextLine:
             item->indexed_point.x = item->tl_point.x;
@@ -166,3 +365,66 @@ CFBDGraphic_DrawText(CFBD_GraphicDevice* device_handle, CFBDGraphic_Text* item,
 
     return item->indexed_point;
 }
+
+CFBDGraphic_Point
+CFBDGraphic_DrawText(CFBD_GraphicDevice* device_handle, CFBDGraphic_Text* item, AppendMethod method)
+{
+    if (!device_handle || !item || !device_handle->ops)
+        return item->tl_point;
+
+    CFBDGraphic_TextLayout layout;
+    CFBDGraphic_LayoutText(device_handle, item, &layout);
+    return CFBDGraphic_DrawTextLayout(device_handle, item, &layout, method);
+}
+
+CFBDGraphic_Point CFBDGraphic_DrawTextScaled(CFBD_GraphicDevice* device_handle,
+                                             const CFBDGraphic_Point* point,
+                                             const char* text,
+                                             Ascii_Font_Size font_size,
+                                             uint8_t scale)
+{
+    CFBDGraphic_Point cursor = *point;
+    const CFBDGraphic_Font* font = CFBDGraphic_FetchFont(font_size);
+    if (!device_handle || !text || !font || scale == 0)
+        return cursor;
+
+    const uint16_t cell_width = font->width * scale;
+    const uint16_t cell_height = font->height * scale;
+
+    // 逐字形缩放绘制, 结束后统一刷新一次
+    const CFBD_Bool immediate = CFBDGraphic_DeviceRequestUpdateAtOnce(device_handle);
+    CFBDGraphic_DeviceSetIfRequestUpdateAtOnce(device_handle, CFBD_FALSE);
+
+    uint32_t code;
+    while ((code = CFBDGraphic_DecodeUTF8(&text)) != 0) {
+        if ((uint32_t) cursor.x + cell_width > UINT16_MAX)
+            break;
+        const uint8_t* glyph = CFBDGraphic_FontGlyph(font, code);
+        if (glyph != NULL) {
+            const CFBDGraphic_BlitSource source = {glyph,
+                                                   font->width,
+                                                   0,
+                                                   0,
+                                                   font->width,
+                                                   font->height};
+            CFBDGraphic_DeviceBlitScaled(device_handle,
+                                         &source,
+                                         cursor.x,
+                                         cursor.y,
+                                         cell_width,
+                                         cell_height,
+                                         device_handle->rop);
+        }
+        cursor.x += cell_width;
+    }
+
+    CFBDGraphic_DeviceSetIfRequestUpdateAtOnce(device_handle, immediate);
+    if (CFBDGraphic_DeviceRequestUpdateAtOnce(device_handle) && cursor.x > point->x) {
+        device_handle->ops->update_area(device_handle,
+                                        point->x,
+                                        point->y,
+                                        cursor.x - point->x,
+                                        cell_height);
+    }
+    return cursor;
+}
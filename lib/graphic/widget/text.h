@@ -9,6 +9,7 @@
  */
 
 #pragma once
+#include <stddef.h>
 #include <stdint.h>
 
 #include "base/point.h"
@@ -53,7 +54,8 @@
 typedef struct
 {
     /** @brief Text string pointer (borrowed - caller owns memory)
-     *  @details Zero-terminated C string, must remain valid during rendering */
+     *  @details Zero-terminated UTF-8 string (plain ASCII included), must remain
+     *           valid during rendering; each code point takes one cell */
     char* sources_borrowed;
 
     /** @brief Top-left corner position of text area in pixels */
@@ -75,8 +77,62 @@ typedef struct
     CFBDGraphicRect text_bounding_rect;
 
     CFBD_Bool no_wrap;
+
+    /** @brief Copy of the last rendered string, possibly truncated, NULL when
+     *         every draw repaints all cells
+     *  @details Caller-provided, see CFBDGraphic_SetTextIncremental() */
+    char* shadow;
+
+    /** @brief Bytes of @ref shadow, terminator included */
+    uint16_t shadow_size;
+
+    /** @brief Character cells of the last rendered string, 0 when nothing is remembered
+     *  @details Internal state of incremental mode */
+    uint16_t shadow_length;
+
+    /** @brief indexed_point the last string was rendered from (internal state) */
+    CFBDGraphic_Point shadow_origin;
 } CFBDGraphic_Text;
 
+/**
+ * @typedef CFBDGraphic_TextLayout
+ * @brief Line breaks and cell positions of a text, computed once
+ * @details Every code point takes one cell of the font. The first line
+ *          starts at @ref origin and holds @ref first_line_cells cells, every
+ *          wrapped line starts at @ref line_x and holds @ref line_cells
+ *          cells, so the position of any cell is known without walking the
+ *          string. A layout stays valid while the string, the font, the
+ *          text area and the position of the text are unchanged.
+ * @see CFBDGraphic_LayoutText()
+ * @see CFBDGraphic_DrawTextLayout()
+ */
+typedef struct
+{
+    /** @brief Top-left corner of the first cell */
+    CFBDGraphic_Point origin;
+
+    /** @brief Left edge of wrapped lines */
+    PointBaseType line_x;
+
+    /** @brief Glyph cell size of the font */
+    CFBDGraphicSize cell;
+
+    /** @brief Cells in the string (code points) */
+    uint16_t cells;
+
+    /** @brief Cells on the first line, UINT16_MAX when the text does not wrap */
+    uint16_t first_line_cells;
+
+    /** @brief Cells on every wrapped line */
+    uint16_t line_cells;
+
+    /** @brief Lines holding at least one cell, 0 for an empty string */
+    uint16_t lines;
+
+    /** @brief Union of all cells, br one past the last pixel; tl == br when empty */
+    CFBDGraphicRect bounds;
+} CFBDGraphic_TextLayout;
+
 /**
  * @typedef AppendMethod
  * @brief Text append/layout method enumeration
@@ -108,7 +164,8 @@ typedef enum
  * @param[out] item - Text structure to initialize
  * @param[in] tl_point - Top-left corner position in pixels
  * @param[in] textHandleSize - Width and height of text rendering area
- * @param[in] text_size - Font size enumeration (ASCII_6x8, ASCII_8x16, etc.)
+ * @param[in] text_size - Font size enumeration (ASCII_6x8, ASCII_8x16, etc.) or
+ *                        an id returned by CFBDGraphic_RegisterFont()
  * @return void
  * @note Position and size pointers must remain valid for rendering lifetime
  * @warning Text content is not set by this function; call CFBDGraphic_SetText() before drawing
@@ -147,6 +204,56 @@ static inline void CFBDGraphic_SetText(CFBDGraphic_Text* item, char* text)
     item->sources_borrowed = text;
 }
 
+/**
+ * @brief Enable or disable incremental redraws
+ * @details In incremental mode the text remembers the last rendered string.
+ *          When the next draw starts from the same indexed_point, only the
+ *          cells whose character changed are redrawn and flushed, and the
+ *          cells left over by a longer previous string are cleared. A numeric
+ *          readout that changes one digit then costs one glyph on the bus.
+ *
+ *          The string is remembered in @p shadow, cut at a whole UTF-8
+ *          character to size - 1 bytes. Longer strings still render
+ *          correctly; characters past the kept part are simply redrawn every
+ *          time. Texts that never use the mode only pay for the pointer.
+ * @param[in,out] item - Text widget to update
+ * @param[in] shadow - Buffer owned by the caller, must outlive the text;
+ *                     NULL turns incremental redraws off
+ * @param[in] size - Bytes of @p shadow, terminator included
+ * @return void
+ * @note The text assumes the screen still shows what it drew last; call
+ *       CFBDGraphic_InvalidateText() after clearing the screen, drawing over
+ *       the text or changing its font or area
+ * @example
+ *     static char fps_shadow[16];
+ *     CFBDGraphic_SetTextIncremental(&fps_text, fps_shadow, sizeof(fps_shadow));
+ *     while (running) {
+ *         snprintf(buffer, sizeof(buffer), "FPS: %lu", fps);
+ *         CFBDGraphic_SetText(&fps_text, buffer);
+ *         CFBDGraphic_DrawText(device, &fps_text, CCGraphic_AsciiTextItem_RequestOldPoint);
+ *     }
+ * @see CFBDGraphic_InvalidateText()
+ */
+static inline void CFBDGraphic_SetTextIncremental(CFBDGraphic_Text* item,
+                                                  char* shadow,
+                                                  uint16_t size)
+{
+    item->shadow = (size != 0) ? shadow : NULL;
+    item->shadow_size = size;
+    item->shadow_length = 0;
+}
+
+/**
+ * @brief Forget the last rendered string, the next draw repaints every cell
+ * @param[in,out] item - Text widget to update
+ * @return void
+ * @see CFBDGraphic_SetTextIncremental()
+ */
+static inline void CFBDGraphic_InvalidateText(CFBDGraphic_Text* item)
+{
+    item->shadow_length = 0;
+}
+
 /**
  * @brief Set text widget top-left position
  * @details Updates rendering position and resets insertion point to top-left.
@@ -221,7 +328,11 @@ static inline void CCGraphicWidget_AsciiTextItem_relocate(CFBDGraphic_Text* item
  * @retval x - Next X position for continued text
  * @retval y - Next Y position (may be on new line)
  * @note
- *     - Respects device drawing mode (immediate/deferred)
+ *     - Respects device drawing mode (immediate/deferred); immediate mode
+ *       flushes the union of all glyph cells once, not once per character
+ *     - In incremental mode only changed cells are drawn and flushed
+ *     - Glyphs go straight into the device frame buffer ("canvas") with a
+ *       page aligned blit that honors the clip stack and the raster op
  *     - Automatically wraps text when reaching width limit
  *     - Updates text_bounding_rect with rendered area
  *     - Character spacing: CFBDGraphic_TEXT_PADDING_WIDTH pixels
@@ -256,6 +367,94 @@ CFBDGraphic_Point CFBDGraphic_DrawText(CFBD_GraphicDevice* device_handle,
                                        CFBDGraphic_Text* item,
                                        AppendMethod method);
 
+/**
+ * @brief Size a string without drawing it
+ * @details Lays the string out from (0, 0) in an area @p max_width pixels
+ *          wide, using the same wrapping rule as CFBDGraphic_DrawText().
+ * @param[in] text - Zero-terminated UTF-8 string
+ * @param[in] font_size - Font size or registered font id
+ * @param[in] max_width - Wrapping width in pixels, 0 for a single line
+ * @return Width and height of the laid out cells
+ * @example
+ *     CFBDGraphicSize label = CFBDGraphic_MeasureText("Settings", ASCII_6x8, 0);
+ *     uint16_t x = item_x + (item_width - label.width) / 2;  // centered
+ * @see CFBDGraphic_LayoutText()
+ */
+CFBDGraphicSize
+CFBDGraphic_MeasureText(const char* text, Ascii_Font_Size font_size, SizeBaseType max_width);
+
+/**
+ * @brief Compute line breaks, bounds and cell positions of a text widget
+ * @details Uses the current string, font, area, wrapping flag and
+ *          indexed_point of @p item. The area is limited to the screen of
+ *          @p device_handle, which is queried here once instead of on every
+ *          draw. Nothing is drawn.
+ * @param[in] device_handle - Device the text will be drawn on
+ * @param[in] item - Text widget
+ * @param[out] layout - Layout to fill, reusable across frames
+ * @see CFBDGraphic_DrawTextLayout()
+ * @see CFBDGraphic_TextLayoutCell()
+ */
+void CFBDGraphic_LayoutText(CFBD_GraphicDevice* device_handle,
+                            const CFBDGraphic_Text* item,
+                            CFBDGraphic_TextLayout* layout);
+
+/**
+ * @brief Top-left corner of a cell of a layout
+ * @param[in] layout - Computed layout
+ * @param[in] cell - Cell index, may lie past the end of the string
+ * @param[out] tl - Cell position
+ */
+void CFBDGraphic_TextLayoutCell(const CFBDGraphic_TextLayout* layout,
+                                uint16_t cell,
+                                CFBDGraphic_Point* tl);
+
+/**
+ * @brief Draw a text widget from a precomputed layout
+ * @details Same result as CFBDGraphic_DrawText() (incremental mode, the
+ *          single flush and the returned point included) without laying the
+ *          text out again. CFBDGraphic_DrawText() is LayoutText() followed
+ *          by this call.
+ * @param[in] device_handle - Graphics device to render on
+ * @param[in,out] item - Text widget the layout was computed for
+ * @param[in] layout - Layout of @p item
+ * @param[in] method - Text layout method (continuous, newline, query)
+ * @return CFBDGraphic_Point - Position after last rendered character
+ * @example
+ *     CFBDGraphic_TextLayout title_layout;
+ *     CFBDGraphic_LayoutText(device, &title, &title_layout);  // once
+ *     while (running) {
+ *         CFBDGraphic_DrawTextLayout(device, &title, &title_layout,
+ *                                    CCGraphic_AsciiTextItem_RequestOldPoint);
+ *     }
+ */
+CFBDGraphic_Point CFBDGraphic_DrawTextLayout(CFBD_GraphicDevice* device_handle,
+                                             CFBDGraphic_Text* item,
+                                             const CFBDGraphic_TextLayout* layout,
+                                             AppendMethod method);
+
+/**
+ * @brief Draw one line of text enlarged by an integer factor
+ * @details Every glyph is scaled with CFBDGraphic_DeviceBlitScaled(), so
+ *          factors 2 and 4 use the lookup table path. Big numerals for a
+ *          clock or a gauge come from the small font this way. No wrapping,
+ *          the device raster op applies and immediate mode flushes once.
+ * @param[in] device_handle - Graphics device to render on
+ * @param[in] point - Top-left corner of the first glyph
+ * @param[in] text - Zero-terminated UTF-8 string
+ * @param[in] font_size - Font size or registered font id
+ * @param[in] scale - Enlargement factor, 1 draws the font as is
+ * @return Top-left corner of the cell after the last glyph
+ * @example
+ *     CFBDGraphic_Point at = {16, 16};
+ *     CFBDGraphic_DrawTextScaled(device, &at, "12:45", ASCII_8x16, 2);  // 16x32 digits
+ */
+CFBDGraphic_Point CFBDGraphic_DrawTextScaled(CFBD_GraphicDevice* device_handle,
+                                             const CFBDGraphic_Point* point,
+                                             const char* text,
+                                             Ascii_Font_Size font_size,
+                                             uint8_t scale);
+
 /** @} */
 
 /** @} */
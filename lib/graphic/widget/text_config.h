@@ -32,10 +32,9 @@
  *     Current implementation supports:
  *     - 6x8: 6 pixels wide x 8 pixels tall per character
  *     - 8x16: 8 pixels wide x 16 pixels tall per character
- *     To add more fonts:
- *     1. Provide font bitmap data source
- *     2. Implement __select_from_ascii_font_size() for new size
- *     3. Add enable macro in resource/config.h
+ *     To add more fonts, describe the bitmaps with a CFBDGraphic_Font and
+ *     register it with CFBDGraphic_RegisterFont() (text_font.h); the returned
+ *     id is used like the values below. No library code has to change.
  * @see __select_from_ascii_font_size()
  * @see __fetch_font_size()
  * @example
@@ -105,15 +104,15 @@ typedef enum
  * @param[in] ch - ASCII character to render (0-127 for standard ASCII)
  * @return Pointer to font bitmap data for character, or UNSUPPORTIVE_FONT_SOURCE
  *         if font size not enabled at compile time
- * @retval UNSUPPORTIVE_FONT_SOURCE - Font disabled or character out of range
+ * @retval UNSUPPORTIVE_FONT_SOURCE - Font not registered, or neither the
+ *         character nor the font fallback has a glyph
  * @note
  *     - Font data ownership: system (embedded in binary)
  *     - Data lifetime: entire program execution
  *     - Each character bitmap is contiguous in memory
  *     - Bitmap format matches font dimensions (6x8 or 8x16 pixels)
- * @warning
- *     - Behavior undefined if s is not a valid Ascii_Font_Size
- *     - Character code outside ASCII range may return invalid data
+ * @note Characters outside the font resolve to the font fallback ('?' for
+ *       the built-in fonts)
  * @example
  *     // Render 'A' in 8x16 font
  *     uint8_t* font_data = __select_from_ascii_font_size(ASCII_8x16, 'A');
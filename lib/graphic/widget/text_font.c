@@ -0,0 +1,242 @@
+#include "text_font.h"
+
+#include <stddef.h>
+
+#include "resource/rle.h"
+
+extern const uint8_t ascii8x16_sources[][16];
+extern const uint8_t ascii6x8_sources[][6];
+extern const uint8_t ascii8x16_rle[];
+extern const uint16_t ascii8x16_rle_blocks[];
+
+#if ENABLE_ASCII_6x8_SOURCES
+static const CFBDGraphic_Font ascii6x8_font = {.width = 6,
+                                               .height = 8,
+                                               .glyph_bytes = 6,
+                                               .first = ' ',
+                                               .last = '~',
+                                               .glyphs = ascii6x8_sources[0],
+                                               .fallback = '?'};
+#endif
+
+#if ENABLE_ASCII_8x16_SOURCES && ENABLE_ASCII_8x16_COMPRESSED
+#if CFBD_GLYPH_CACHE_SLOTS == 0
+#error "the compressed 8x16 font needs CFBD_GLYPH_CACHE_SLOTS"
+#endif
+static const CFBDGraphic_Font ascii8x16_font = {.width = 8,
+                                                .height = 16,
+                                                .glyph_bytes = 16,
+                                                .first = ' ',
+                                                .last = '~',
+                                                .glyphs = ascii8x16_rle,
+                                                .fallback = '?',
+                                                .blocks = ascii8x16_rle_blocks,
+                                                .block_glyphs = 8};
+#elif ENABLE_ASCII_8x16_SOURCES
+static const CFBDGraphic_Font ascii8x16_font = {.width = 8,
+                                                .height = 16,
+                                                .glyph_bytes = 16,
+                                                .first = ' ',
+                                                .last = '~',
+                                                .glyphs = ascii8x16_sources[0],
+                                                .fallback = '?'};
+#endif
+
+/*
+    Slot n holds font id n. Built-in fonts sit at their enum values, the slot
+    of NO_ASCII_SIZE stays empty so the sentinel never names a font.
+*/
+static const CFBDGraphic_Font* font_registry[CFBD_FONT_REGISTRY_CAPACITY] = {
+#if ENABLE_ASCII_6x8_SOURCES
+        [ASCII_6x8] = &ascii6x8_font,
+#endif
+#if ENABLE_ASCII_8x16_SOURCES
+        [ASCII_8x16] = &ascii8x16_font,
+#endif
+};
+
+Ascii_Font_Size CFBDGraphic_RegisterFont(const CFBDGraphic_Font* font)
+{
+    if (font == NULL || font->glyphs == NULL || font->width == 0 || font->height == 0 ||
+        font->glyph_bytes == 0)
+        return NO_ASCII_SIZE;
+    if (font->blocks != NULL && (CFBD_GLYPH_CACHE_SLOTS == 0 || font->block_glyphs == 0 ||
+                                 font->glyph_bytes > CFBD_GLYPH_CACHE_GLYPH_BYTES))
+        return NO_ASCII_SIZE;
+
+    for (uint8_t id = 0; id < CFBD_FONT_REGISTRY_CAPACITY; id++) {
+        if (font_registry[id] == font)
+            return (Ascii_Font_Size) id;
+    }
+    for (uint8_t id = NO_ASCII_SIZE + 1; id < CFBD_FONT_REGISTRY_CAPACITY; id++) {
+        if (font_registry[id] == NULL) {
+            font_registry[id] = font;
+            return (Ascii_Font_Size) id;
+        }
+    }
+    return NO_ASCII_SIZE;
+}
+
+const CFBDGraphic_Font* CFBDGraphic_FetchFont(Ascii_Font_Size id)
+{
+    if ((unsigned) id >= CFBD_FONT_REGISTRY_CAPACITY)
+        return NULL;
+    return font_registry[id];
+}
+
+/* Lower bound over the sorted index */
+static const CFBDGraphic_FontIndexEntry* find_sparse(const CFBDGraphic_Font* font, uint32_t code)
+{
+    uint16_t lo = 0;
+    uint16_t hi = font->index_count;
+    while (lo < hi) {
+        const uint16_t mid = lo + (hi - lo) / 2;
+        if (font->index[mid].code < code)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    if (lo < font->index_count && font->index[lo].code == code)
+        return &font->index[lo];
+    return NULL;
+}
+
+static CFBD_Bool glyph_number(const CFBDGraphic_Font* font, uint32_t code, uint16_t* glyph)
+{
+    if (font->index == NULL) {
+        if (code < font->first || code > font->last)
+            return CFBD_FALSE;
+        *glyph = (uint16_t) (code - font->first);
+        return CFBD_TRUE;
+    }
+
+    const CFBDGraphic_FontIndexEntry* entry = find_sparse(font, code);
+    if (entry == NULL)
+        return CFBD_FALSE;
+    *glyph = entry->glyph;
+    return CFBD_TRUE;
+}
+
+/* ---------- glyph cache ---------- */
+
+#if CFBD_GLYPH_CACHE_SLOTS > 0
+typedef struct
+{
+    const CFBDGraphic_Font* font;
+    uint16_t glyph;
+    uint32_t last_use;
+    uint8_t bitmap[CFBD_GLYPH_CACHE_GLYPH_BYTES];
+} GlyphCacheSlot;
+
+static GlyphCacheSlot glyph_cache[CFBD_GLYPH_CACHE_SLOTS];
+static uint32_t glyph_cache_clock;
+static CFBDGraphic_GlyphCacheStats glyph_cache_stats;
+
+/* Least recently used slot wins, empty slots (last_use 0) go first */
+static const uint8_t* cached_glyph(const CFBDGraphic_Font* font, uint16_t glyph)
+{
+    GlyphCacheSlot* victim = &glyph_cache[0];
+    if (++glyph_cache_clock == 0) {
+        // 时钟回绕: 所有槽位重新同龄
+        for (uint8_t i = 0; i < CFBD_GLYPH_CACHE_SLOTS; i++)
+            glyph_cache[i].last_use = 0;
+        glyph_cache_clock = 1;
+    }
+    for (uint8_t i = 0; i < CFBD_GLYPH_CACHE_SLOTS; i++) {
+        GlyphCacheSlot* slot = &glyph_cache[i];
+        if (slot->font == font && slot->glyph == glyph) {
+            slot->last_use = glyph_cache_clock;
+            glyph_cache_stats.hits++;
+            return slot->bitmap;
+        }
+        if (slot->last_use < victim->last_use)
+            victim = slot;
+    }
+
+    // 解码所在块, 跳过块内前面的字形
+    CFBDGraphic_RleStream stream;
+    CFBDGraphic_RleOpen(&stream, font->glyphs + font->blocks[glyph / font->block_glyphs]);
+    CFBDGraphic_RleRead(&stream, NULL, (uint16_t) (glyph % font->block_glyphs) * font->glyph_bytes);
+    CFBDGraphic_RleRead(&stream, victim->bitmap, font->glyph_bytes);
+
+    victim->font = font;
+    victim->glyph = glyph;
+    victim->last_use = glyph_cache_clock;
+    glyph_cache_stats.misses++;
+    return victim->bitmap;
+}
+#endif
+
+static const uint8_t* lookup_glyph(const CFBDGraphic_Font* font, uint32_t code)
+{
+    uint16_t glyph;
+    if (!glyph_number(font, code, &glyph))
+        return NULL;
+#if CFBD_GLYPH_CACHE_SLOTS > 0
+    if (font->blocks != NULL)
+        return cached_glyph(font, glyph);
+#endif
+    return font->glyphs + (uint32_t) glyph * font->glyph_bytes;
+}
+
+const uint8_t* CFBDGraphic_FontGlyph(const CFBDGraphic_Font* font, uint32_t code)
+{
+    const uint8_t* glyph = lookup_glyph(font, code);
+    return glyph ? glyph : lookup_glyph(font, font->fallback);
+}
+
+void CFBDGraphic_FetchGlyphCacheStats(CFBDGraphic_GlyphCacheStats* stats, CFBD_Bool reset)
+{
+#if CFBD_GLYPH_CACHE_SLOTS > 0
+    *stats = glyph_cache_stats;
+    if (reset) {
+        glyph_cache_stats.hits = 0;
+        glyph_cache_stats.misses = 0;
+    }
+#else
+    (void) reset;
+    stats->hits = 0;
+    stats->misses = 0;
+#endif
+}
+
+uint32_t CFBDGraphic_DecodeUTF8(const char** cursor)
+{
+    const uint8_t* s = (const uint8_t*) *cursor;
+    const uint8_t lead = s[0];
+    if (lead < 0x80) {
+        if (lead != 0)
+            (*cursor)++;
+        return lead;
+    }
+
+    uint8_t extra;
+    uint32_t code;
+    if ((lead & 0xE0) == 0xC0) {
+        extra = 1;
+        code = lead & 0x1F;
+    }
+    else if ((lead & 0xF0) == 0xE0) {
+        extra = 2;
+        code = lead & 0x0F;
+    }
+    else if ((lead & 0xF8) == 0xF0) {
+        extra = 3;
+        code = lead & 0x07;
+    }
+    else {
+        (*cursor)++;
+        return 0xFFFD;
+    }
+
+    // a terminator fails the continuation test, nothing is read past it
+    for (uint8_t i = 1; i <= extra; i++) {
+        if ((s[i] & 0xC0) != 0x80) {
+            (*cursor)++;
+            return 0xFFFD;
+        }
+        code = (code << 6) | (s[i] & 0x3F);
+    }
+    *cursor += extra + 1;
+    return code;
+}
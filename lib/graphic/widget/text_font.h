@@ -0,0 +1,173 @@
+/**
+ * @file text_font.h
+ * @brief Font descriptors and the font registry used by the text widget
+ * @details A font is a plain descriptor (cell metrics, glyph table and code
+ *          point coverage) that lives in flash. Fonts are registered at
+ *          runtime and addressed by the id returned on registration, which
+ *          is accepted everywhere an Ascii_Font_Size is expected. The
+ *          built-in ASCII fonts occupy the ids of their enum values.
+ *
+ *          Glyph lookup is an array index for dense code point ranges and a
+ *          binary search over a sorted index for sparse sets (for instance
+ *          the few hundred CJK characters a product actually uses).
+ *
+ *          Glyph tables may be RLE compressed (see resource/rle.h). Such
+ *          glyphs are decoded on first use into a small glyph cache, so hot
+ *          characters cost a cache lookup instead of a decode.
+ * @ingroup Graphics_Widget Graphics_Text Graphics_TextConfig
+ * @{
+ */
+
+#pragma once
+#include <stdint.h>
+
+#include "cfbd_define.h"
+#include "text_config.h"
+
+/**
+ * @defgroup Graphics_Font Font Registry
+ * @ingroup Graphics_Text
+ * @brief Pluggable fonts with O(1) / O(log n) glyph lookup
+ * @{
+ */
+
+/**
+ * @brief Number of fonts the registry can hold, built-in fonts included
+ */
+#ifndef CFBD_FONT_REGISTRY_CAPACITY
+#define CFBD_FONT_REGISTRY_CAPACITY (8)
+#endif
+
+/**
+ * @brief Decoded glyphs kept for compressed fonts
+ * @note 0 leaves the cache out, and with it support for compressed fonts.
+ *       The default keeps it only when the built-in 8x16 font is compressed;
+ *       ports registering compressed fonts of their own set it explicitly.
+ */
+#ifndef CFBD_GLYPH_CACHE_SLOTS
+#if ENABLE_ASCII_8x16_SOURCES && ENABLE_ASCII_8x16_COMPRESSED
+#define CFBD_GLYPH_CACHE_SLOTS (8)
+#else
+#define CFBD_GLYPH_CACHE_SLOTS (0)
+#endif
+#endif
+
+/**
+ * @brief Largest glyph (glyph_bytes) a compressed font may use
+ * @note The cache takes CFBD_GLYPH_CACHE_SLOTS * CFBD_GLYPH_CACHE_GLYPH_BYTES
+ *       bytes of RAM; the default fits 16x16 CJK glyphs.
+ */
+#ifndef CFBD_GLYPH_CACHE_GLYPH_BYTES
+#define CFBD_GLYPH_CACHE_GLYPH_BYTES (32)
+#endif
+
+/**
+ * @typedef CFBDGraphic_FontIndexEntry
+ * @brief One entry of a sparse font index
+ */
+typedef struct
+{
+    uint32_t code;  /**< Unicode code point */
+    uint16_t glyph; /**< Glyph number in CFBDGraphic_Font::glyphs */
+} CFBDGraphic_FontIndexEntry;
+
+/**
+ * @typedef CFBDGraphic_Font
+ * @brief Font descriptor
+ * @details Glyphs use the setArea() layout (1bpp pages, one byte per column
+ *          per page) and are stored back to back, glyph_bytes each.
+ *
+ *          Without @ref index the font covers the dense range
+ *          [@ref first, @ref last] and glyph n is code point first + n.
+ *          With @ref index the font covers exactly the listed code points;
+ *          the entries must be sorted by code.
+ *
+ *          With @ref blocks the glyph table is RLE compressed in blocks of
+ *          @ref block_glyphs glyphs, block b starting at glyphs + blocks[b].
+ *          resource/tools/cfbd_rle.py emits both arrays.
+ * @example
+ *     static const CFBDGraphic_FontIndexEntry cjk_index[] = {
+ *         {0x4E2D, 0}, {0x6587, 1},  // 中 文, sorted by code point
+ *     };
+ *     static const CFBDGraphic_Font cjk16 = {
+ *         .width = 16, .height = 16, .glyph_bytes = 32,
+ *         .glyphs = cjk16_bitmaps, .index = cjk_index, .index_count = 2,
+ *         .fallback = 0x4E2D,
+ *     };
+ *
+ *     Ascii_Font_Size cjk = CFBDGraphic_RegisterFont(&cjk16);
+ *     CFBDGraphic_InitText(&title, p, area, cjk);
+ *     CFBDGraphic_SetText(&title, "\xE4\xB8\xAD\xE6\x96\x87");  // UTF-8
+ */
+typedef struct
+{
+    uint8_t width;                           /**< Cell width in pixels */
+    uint8_t height;                          /**< Cell height in pixels */
+    uint16_t glyph_bytes;                    /**< width * ((height + 7) / 8) */
+    uint32_t first;                          /**< First code point of a dense font */
+    uint32_t last;                           /**< Last code point of a dense font */
+    const uint8_t* glyphs;                   /**< Glyph bitmaps */
+    const CFBDGraphic_FontIndexEntry* index; /**< Sorted sparse index, or NULL (dense) */
+    uint16_t index_count;                    /**< Entries in @ref index */
+    uint32_t fallback;                       /**< Code point drawn for missing glyphs */
+    const uint16_t* blocks;                  /**< RLE block offsets, or NULL (plain glyphs) */
+    uint8_t block_glyphs;                    /**< Glyphs per compressed block */
+} CFBDGraphic_Font;
+
+/**
+ * @typedef CFBDGraphic_GlyphCacheStats
+ * @brief Glyph cache counters, for benchmarks
+ */
+typedef struct
+{
+    uint32_t hits;   /**< Compressed glyphs served from the cache */
+    uint32_t misses; /**< Compressed glyphs decoded */
+} CFBDGraphic_GlyphCacheStats;
+
+/**
+ * @brief Register a font
+ * @param[in] font - Descriptor, must outlive every text using it
+ * @return Id to pass as font size, or NO_ASCII_SIZE if the registry is full
+ *         or the font is invalid (compressed glyphs larger than
+ *         CFBD_GLYPH_CACHE_GLYPH_BYTES, or any compressed font when
+ *         CFBD_GLYPH_CACHE_SLOTS is 0, count as invalid)
+ * @note Registering the same descriptor twice returns the same id
+ */
+Ascii_Font_Size CFBDGraphic_RegisterFont(const CFBDGraphic_Font* font);
+
+/**
+ * @brief Fetch the descriptor of a font id
+ * @return Descriptor, or NULL for unknown ids
+ */
+const CFBDGraphic_Font* CFBDGraphic_FetchFont(Ascii_Font_Size id);
+
+/**
+ * @brief Find the glyph bitmap of a code point
+ * @details Missing code points resolve to the font fallback; NULL is only
+ *          returned when the fallback is missing as well. Glyphs of
+ *          compressed fonts point into the glyph cache and stay valid until
+ *          the next call.
+ * @param[in] font - Font descriptor
+ * @param[in] code - Unicode code point
+ * @return Glyph bitmap (glyph_bytes bytes) or NULL
+ */
+const uint8_t* CFBDGraphic_FontGlyph(const CFBDGraphic_Font* font, uint32_t code);
+
+/**
+ * @brief Read the glyph cache counters
+ * @param[out] stats - Counters since boot or the last reset
+ * @param[in] reset - Clear the counters after reading
+ */
+void CFBDGraphic_FetchGlyphCacheStats(CFBDGraphic_GlyphCacheStats* stats, CFBD_Bool reset);
+
+/**
+ * @brief Decode the next UTF-8 code point and advance the cursor
+ * @details Malformed sequences decode to U+FFFD and consume one byte, so
+ *          a string always advances. Plain ASCII costs one comparison.
+ * @param[in,out] cursor - Read position inside a zero terminated string
+ * @return Code point, 0 at the end of the string
+ */
+uint32_t CFBDGraphic_DecodeUTF8(const char** cursor);
+
+/** @} */
+/** @} */
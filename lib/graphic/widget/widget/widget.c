@@ -3,6 +3,7 @@
 #include <stddef.h>
 
 #include "cfbd_define.h"
+#include "device/graphic_clip.h"
 
 
 /*
@@ -93,8 +94,36 @@ static void CFBD_WidgetSetParent_Default(CFBD_Widget* self, CFBD_Widget* new_par
     }
 }
 
+/* Inclusive device rectangle covered by the widget, CFBD_FALSE if it has no area */
+static CFBD_Bool widget_bounds(const CFBD_Widget* self, CFBDGraphicRect* bounds)
+{
+    if (self->size.width == 0 || self->size.height == 0)
+        return CFBD_FALSE;
+    bounds->tl = self->tl_point;
+    bounds->br.x = self->tl_point.x + self->size.width - 1;
+    bounds->br.y = self->tl_point.y + self->size.height - 1;
+    return CFBD_TRUE;
+}
+
+static void CFBD_WidgetInvalidate_Default(CFBD_Widget* self, const CFBDGraphicRect* rect)
+{
+    CFBDGraphicRect area;
+    if (rect != NULL)
+        area = *rect;
+    else if (!widget_bounds(self, &area))
+        return;
+
+    /* 冒泡到根节点 */
+    CFBD_Widget* root = self;
+    while (root->parent)
+        root = root->parent;
+    if (root->damage)
+        CFBD_WidgetDamageAdd(root->damage, &area);
+}
+
 static CFBD_WidgetOperations g_cfbd_widget_default_ops = {
         .set_parent = CFBD_WidgetSetParent_Default,
+        .invalidate = CFBD_WidgetInvalidate_Default,
 };
 
 void CFBD_WidgetCreateBase(CFBD_Widget* self, CFBD_WidgetCreationPack* pack)
@@ -112,6 +141,7 @@ void CFBD_WidgetCreateBase(CFBD_Widget* self, CFBD_WidgetCreationPack* pack)
 
     self->tl_point = pack->tl_point;
     self->size = pack->size;
+    self->damage = NULL;
 
     /* 统计已有 children */
     if (self->children) {
@@ -170,3 +200,155 @@ void CFBD_WidgetAssignedChildPlace(CFBD_Widget* self,
         self->children_cnt = cnt;
     }
 }
+
+/*
+ Damage tracking and repaint
+*/
+
+static uint32_t box_area(const CFBDGraphicRect* r)
+{
+    return (uint32_t) (r->br.x - r->tl.x + 1) * (uint32_t) (r->br.y - r->tl.y + 1);
+}
+
+/* Overlapping or sharing an edge: the union wastes no pixel row or column */
+static CFBD_Bool box_touches(const CFBDGraphicRect* a, const CFBDGraphicRect* b)
+{
+    return a->tl.x <= b->br.x + 1 && b->tl.x <= a->br.x + 1 && a->tl.y <= b->br.y + 1 &&
+           b->tl.y <= a->br.y + 1;
+}
+
+static CFBDGraphicRect box_union(const CFBDGraphicRect* a, const CFBDGraphicRect* b)
+{
+    CFBDGraphicRect u = *a;
+    if (b->tl.x < u.tl.x)
+        u.tl.x = b->tl.x;
+    if (b->tl.y < u.tl.y)
+        u.tl.y = b->tl.y;
+    if (b->br.x > u.br.x)
+        u.br.x = b->br.x;
+    if (b->br.y > u.br.y)
+        u.br.y = b->br.y;
+    return u;
+}
+
+static void damage_remove(CFBD_WidgetDamage* damage, uint8_t index)
+{
+    damage->rects[index] = damage->rects[--damage->count];
+}
+
+void CFBD_WidgetDamageReset(CFBD_WidgetDamage* damage)
+{
+    damage->count = 0;
+}
+
+void CFBD_WidgetDamageAdd(CFBD_WidgetDamage* damage, const CFBDGraphicRect* rect)
+{
+    CFBDGraphicRect box = rect_normalize(*rect);
+
+    /* 合并后的矩形可能又碰到别的矩形, 从头再查 */
+    for (uint8_t i = 0; i < damage->count;) {
+        if (box_touches(&box, &damage->rects[i])) {
+            box = box_union(&box, &damage->rects[i]);
+            damage_remove(damage, i);
+            i = 0;
+        }
+        else {
+            ++i;
+        }
+    }
+
+    if (damage->count < CFBD_WIDGET_DAMAGE_RECTS) {
+        damage->rects[damage->count++] = box;
+        return;
+    }
+
+    // no slot left: merge into the region that grows least
+    uint8_t best = 0;
+    uint32_t best_growth = UINT32_MAX;
+    for (uint8_t i = 0; i < damage->count; ++i) {
+        const CFBDGraphicRect u = box_union(&box, &damage->rects[i]);
+        const uint32_t growth = box_area(&u) - box_area(&damage->rects[i]);
+        if (growth < best_growth) {
+            best_growth = growth;
+            best = i;
+        }
+    }
+    box = box_union(&box, &damage->rects[best]);
+    damage_remove(damage, best);
+    CFBD_WidgetDamageAdd(damage, &box);
+}
+
+void CFBD_WidgetAttachDamage(CFBD_Widget* root, CFBD_WidgetDamage* damage)
+{
+    if (!root)
+        return;
+    root->damage = damage;
+    if (damage)
+        CFBD_WidgetDamageReset(damage);
+}
+
+/* Parents before children, so children paint over their container */
+static void paint_tree(CFBD_Widget* self, CFBD_GraphicDevice* device, const CFBDGraphicRect* region)
+{
+    CFBDGraphicRect bounds;
+    if (self->override_ops && self->override_ops->paint && widget_bounds(self, &bounds) &&
+        rect_intersects(&bounds, region)) {
+        self->override_ops->paint(self, device);
+    }
+
+    if (!self->children)
+        return;
+    for (size_t i = 0; i < self->children_container_sz; ++i) {
+        if (self->children[i])
+            paint_tree(self->children[i], device, region);
+    }
+}
+
+CFBD_Bool CFBD_WidgetRender(CFBD_Widget* root, CFBD_GraphicDevice* device)
+{
+    if (!root || !root->damage || root->damage->count == 0)
+        return CFBD_FALSE;
+
+    CFBD_WidgetDamage* damage = root->damage;
+    CFBDGraphic_ClipBounds flushes[CFBD_WIDGET_DAMAGE_RECTS];
+    uint8_t flush_cnt = 0;
+
+    const CFBD_Bool immediate = CFBDGraphic_DeviceRequestUpdateAtOnce(device);
+    CFBDGraphic_DeviceSetIfRequestUpdateAtOnce(device, CFBD_FALSE);
+
+    for (uint8_t i = 0; i < damage->count; ++i) {
+        const CFBD_Bool pushed = CFBDGraphic_PushClip(device, &damage->rects[i]);
+        CFBDGraphic_ClipBounds visible;
+        if (CFBDGraphic_FetchClipBounds(device, &visible)) {
+            // 裁剪栈已满时按整个可见区域重绘
+            CFBDGraphicRect region = damage->rects[i];
+            if (!pushed) {
+                region.tl.x = visible.x0;
+                region.tl.y = visible.y0;
+                region.br.x = visible.x1;
+                region.br.y = visible.y1;
+            }
+            device->ops->clear_area(device,
+                                    visible.x0,
+                                    visible.y0,
+                                    visible.x1 - visible.x0 + 1,
+                                    visible.y1 - visible.y0 + 1);
+            paint_tree(root, device, &region);
+            flushes[flush_cnt++] = visible;
+        }
+        if (pushed)
+            CFBDGraphic_PopClip(device);
+    }
+
+    CFBDGraphic_DeviceSetIfRequestUpdateAtOnce(device, immediate);
+    for (uint8_t i = 0; i < flush_cnt; ++i) {
+        device->ops->update_area(device,
+                                 flushes[i].x0,
+                                 flushes[i].y0,
+                                 flushes[i].x1 - flushes[i].x0 + 1,
+                                 flushes[i].y1 - flushes[i].y0 + 1);
+    }
+
+    CFBD_WidgetDamageReset(damage);
+    return flush_cnt != 0;
+}
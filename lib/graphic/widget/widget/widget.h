@@ -2,11 +2,34 @@
 #include <stddef.h>
 
 #include "base/point.h"
+#include "base/rectangle.h"
 #include "base/size.h"
 #include "cfbd_graphic_define.h"
+#include "device/graphic_device.h"
+
+/**
+ * @def CFBD_WIDGET_DAMAGE_RECTS
+ * @brief Separate regions a damage accumulator keeps before merging the closest ones.
+ */
+#ifndef CFBD_WIDGET_DAMAGE_RECTS
+#define CFBD_WIDGET_DAMAGE_RECTS (4)
+#endif
 
 typedef struct __CFBD_Widget CFBD_Widget;
 
+/**
+ * @brief Screen regions that need a repaint, owned by a root widget.
+ *
+ * Rectangles use inclusive corners like the clip stack. Overlapping or
+ * touching rectangles are merged on insertion; once all slots are taken a
+ * new rectangle is merged with the one whose bounding box grows least.
+ */
+typedef struct
+{
+    CFBDGraphicRect rects[CFBD_WIDGET_DAMAGE_RECTS];
+    uint8_t count;
+} CFBD_WidgetDamage;
+
 typedef struct
 {
     void (*paint)(CFBD_Widget* w, CFBD_GraphicDevice* graphic_device);
@@ -16,6 +39,9 @@ typedef struct
 {
     // When NULL parent, parent of old will auto clear arrays
     void (*set_parent)(CFBD_Widget* self, CFBD_Widget* parent);
+
+    // Report rect (inclusive, NULL for the whole widget) as changed, bubbles up to the root
+    void (*invalidate)(CFBD_Widget* self, const CFBDGraphicRect* rect);
 } CFBD_WidgetOperations;
 
 /**
@@ -37,6 +63,9 @@ typedef struct __CFBD_Widget
     CFBDGraphic_Point tl_point;
     CFBDGraphicSize size;
 
+    // Only roots own one, see CFBD_WidgetAttachDamage()
+    CFBD_WidgetDamage* damage;
+
     void* external_data; // ah, yeah!
 } CFBD_Widget;
 
@@ -53,3 +82,51 @@ void CFBD_WidgetCreateBase(CFBD_Widget* self, CFBD_WidgetCreationPack* pack);
 void CFBD_WidgetAssignedChildPlace(CFBD_Widget* self,
                                    CFBD_Widget** children_array,
                                    size_t children_container_sz);
+
+/**
+ * @brief Forget every damaged region.
+ */
+void CFBD_WidgetDamageReset(CFBD_WidgetDamage* damage);
+
+/**
+ * @brief Add a changed region (inclusive corners, any order), merging as needed.
+ */
+void CFBD_WidgetDamageAdd(CFBD_WidgetDamage* damage, const CFBDGraphicRect* rect);
+
+/**
+ * @brief Let @p root collect the invalidations of its whole tree.
+ *
+ * @param root Top of the widget tree.
+ * @param damage Accumulator, reset here; NULL detaches it.
+ */
+void CFBD_WidgetAttachDamage(CFBD_Widget* root, CFBD_WidgetDamage* damage);
+
+/**
+ * @brief Mark a region of @p self as changed, nothing is drawn yet.
+ *
+ * The rectangle travels up the parent chain to the root and lands in its
+ * accumulator; without one it is dropped.
+ *
+ * @param self Widget whose content changed.
+ * @param rect Changed region in device coordinates, NULL for the whole widget.
+ */
+static inline void CFBD_WidgetInvalidate(CFBD_Widget* self, const CFBDGraphicRect* rect)
+{
+    self->ops->invalidate(self, rect);
+}
+
+/**
+ * @brief Repaint the damaged regions of a widget tree and flush each one.
+ *
+ * @details
+ * Every merged region is cleared and repainted with the region pushed as
+ * clip rectangle: the tree is walked parents first, and only widgets whose
+ * bounds intersect the region have their `paint` called. Drawing is
+ * deferred while painting, afterwards each visible region is flushed with
+ * one update_area(), whatever the immediate mode. The damage is reset.
+ *
+ * @param root Root widget with an attached accumulator.
+ * @param device Device the tree is shown on.
+ * @return CFBD_FALSE if there was nothing to repaint.
+ */
+CFBD_Bool CFBD_WidgetRender(CFBD_Widget* root, CFBD_GraphicDevice* device);
@@ -137,4 +137,16 @@
  */
 #define CACHED_WIDTH (144)
 
+/**
+ * @def CFBD_OLED_LOCAL_GRAM
+ * @brief Keep the CACHED_HEIGHT x CACHED_WIDTH frame buffer in RAM.
+ * @details
+ * Define as 0 on parts that cannot spare the RAM and only render through
+ * the band renderer (`stream_area`). Every frame buffer operation of the
+ * backend then returns CFBD_FALSE and "framebuffer" is not answered.
+ */
+#ifndef CFBD_OLED_LOCAL_GRAM
+#define CFBD_OLED_LOCAL_GRAM (1)
+#endif
+
 /** @} */
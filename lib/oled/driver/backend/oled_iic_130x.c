@@ -5,10 +5,13 @@
 
 #include "cfbd_define.h"
 #include "configs/cache_config-ssd130x.h"
+#include "driver/device/oled_ssd130x_privates.h"
 #include "iic.h"
 #include "oled.h"
 
+#if CFBD_OLED_LOCAL_GRAM
 static uint8_t OLED_GRAM[CACHED_HEIGHT][CACHED_WIDTH];
+#endif
 
 static inline CFBD_OLED_IICInitsParams* asIICInitsParams(void* internal)
 {
@@ -64,6 +67,126 @@ __pvt_oled_set_cursor(CFBD_OLED_IICInitsParams* handle, const uint8_t y, const u
     send_cmd(handle, 0x00 | (x & 0x0F));
 }
 
+/* Contrast (0x81) on the panel, the SSD1306 reset value until init() */
+static uint8_t contrast_level = 0x7F;
+
+/* Pages of the running hardware scroll, the GRAM keeps the unscrolled picture */
+static struct
+{
+    CFBD_Bool running;
+    uint8_t first_page;
+    uint8_t last_page;
+} scroll_state;
+
+static inline uint16_t frames_distance(uint16_t a, uint16_t b)
+{
+    return (a > b) ? a - b : b - a;
+}
+
+/* 3 bit step interval code closest to @p frames */
+static uint8_t scroll_interval(uint16_t frames)
+{
+    static const uint16_t code_frames[8] = {5, 64, 128, 256, 3, 4, 25, 2};
+    uint8_t best = 0;
+    for (uint8_t code = 1; code < 8; code++) {
+        if (frames_distance(code_frames[code], frames) < frames_distance(code_frames[best], frames))
+            best = code;
+    }
+    return best;
+}
+
+static CFBD_Bool has_scroll_column_window(CFBD_OLED_IICInitsParams* internal)
+{
+    const SSD130XPrivateDatas* privates = internal->device_specifics->private_data;
+    return privates != NULL && privates->scroll_column_window;
+}
+
+/* Stop the controller, the caller rewrites the panel RAM */
+static CFBD_Bool halt_scroll(CFBD_OLED_IICInitsParams* internal)
+{
+    if (!scroll_state.running)
+        return CFBD_FALSE;
+    scroll_state.running = CFBD_FALSE;
+    send_cmd(internal, 0x2E);
+    send_cmd(internal, 0x40); // 垂直滚动会移动起始行, 恢复为 0
+    return CFBD_TRUE;
+}
+
+/* Stop the controller and put the unscrolled picture back from the GRAM */
+static void end_scroll(CFBD_OLED_IICInitsParams* internal)
+{
+    if (!halt_scroll(internal))
+        return;
+#if CFBD_OLED_LOCAL_GRAM
+    // 停止滚动后面板 RAM 停留在滚动后的状态, 需要重写
+    for (uint8_t page = scroll_state.first_page; page <= scroll_state.last_page; page++) {
+        __pvt_oled_set_cursor(internal, page, 0);
+        send_data(internal, OLED_GRAM[page], internal->device_specifics->logic_width);
+    }
+#endif
+}
+
+static CFBD_Bool start_scroll(CFBD_OLED* oled, const CFBD_OLEDScroll* scroll)
+{
+    CFBD_OLED_IICInitsParams* internal = asIICInitsParams(oled->oled_internal_handle);
+    const uint16_t POINT_X_MAX = internal->device_specifics->logic_width;
+    const uint16_t POINT_Y_MAX = internal->device_specifics->logic_height;
+
+    end_scroll(internal);
+    if (scroll->direction == CFBD_OLED_SCROLL_STOP)
+        return CFBD_TRUE;
+    if (scroll->x >= POINT_X_MAX || scroll->y >= POINT_Y_MAX || scroll->width == 0 ||
+        scroll->height == 0)
+        return CFBD_FALSE;
+
+    const uint16_t right =
+            (scroll->x + scroll->width > POINT_X_MAX) ? POINT_X_MAX - 1 : scroll->x + scroll->width - 1;
+    const uint16_t bottom = (scroll->y + scroll->height > POINT_Y_MAX)
+                                    ? POINT_Y_MAX - 1
+                                    : scroll->y + scroll->height - 1;
+    const uint8_t first_page = scroll->y / 8;
+    const uint8_t last_page = bottom / 8;
+    const uint8_t interval = scroll_interval(scroll->frames);
+    const CFBD_Bool right_way = scroll->direction == CFBD_OLED_SCROLL_RIGHT;
+
+    if (scroll->rows == 0) {
+        send_cmd(internal, right_way ? 0x26 : 0x27);
+        send_cmd(internal, 0x00);
+        send_cmd(internal, first_page);
+        send_cmd(internal, interval);
+        send_cmd(internal, last_page);
+        send_cmd(internal, 0x00);
+        if (has_scroll_column_window(internal)) {
+            send_cmd(internal, scroll->x);
+            send_cmd(internal, right);
+        }
+        else {
+            send_cmd(internal, 0xFF);
+        }
+    }
+    else {
+        // 垂直滚动区域: 顶部固定 y 行, 其后的行参与滚动
+        send_cmd(internal, 0xA3);
+        send_cmd(internal, scroll->y);
+        send_cmd(internal, bottom - scroll->y + 1);
+
+        send_cmd(internal, right_way ? 0x29 : 0x2A);
+        // SSD1309 的首参数为水平偏移 (0/1 列), SSD1306 为空字节
+        send_cmd(internal, has_scroll_column_window(internal) ? 0x01 : 0x00);
+        send_cmd(internal, first_page);
+        send_cmd(internal, interval);
+        send_cmd(internal, last_page);
+        send_cmd(internal, (scroll->rows > 63) ? 63 : scroll->rows);
+    }
+    send_cmd(internal, 0x2F);
+
+    scroll_state.running = CFBD_TRUE;
+    // 垂直滚动移动整块显示区, 停止时整帧重写
+    scroll_state.first_page = (scroll->rows == 0) ? first_page : 0;
+    scroll_state.last_page = (scroll->rows == 0) ? last_page : (POINT_Y_MAX - 1) / 8;
+    return CFBD_TRUE;
+}
+
 // Impls
 static int init(CFBD_OLED* oled, void* init_args)
 {
@@ -74,9 +197,14 @@ static int init(CFBD_OLED* oled, void* init_args)
         send_cmd(internal, init_cmds[i]);
     }
 
+    const SSD130XPrivateDatas* privates = internal->device_specifics->private_data;
+    if (privates != NULL)
+        contrast_level = privates->contrast;
+
     return CFBD_TRUE;
 }
 
+#if CFBD_OLED_LOCAL_GRAM
 static CFBD_Bool setPixel(CFBD_OLED* handle, uint16_t x, uint16_t y)
 {
     CFBD_OLED_IICInitsParams* internal = asIICInitsParams(handle->oled_internal_handle);
@@ -97,6 +225,7 @@ static CFBD_Bool clear(CFBD_OLED* handle)
 static CFBD_Bool update(CFBD_OLED* handle)
 {
     CFBD_OLED_IICInitsParams* internal = asIICInitsParams(handle->oled_internal_handle);
+    halt_scroll(internal); // 整帧都会重写
     for (uint8_t j = 0; j < CACHED_HEIGHT; j++) {
         __pvt_oled_set_cursor(handle->oled_internal_handle, j, 0);
         send_data(handle->oled_internal_handle,
@@ -187,6 +316,7 @@ oled_helper_update_area(CFBD_OLED* handle, uint16_t x, uint16_t y, uint16_t widt
     if (y + height > POINT_Y_MAX)
         height = POINT_Y_MAX - y;
 
+    end_scroll(internal);
     for (uint8_t i = y / 8; i < (y + height - 1) / 8 + 1; i++) {
         /*设置光标位置为相关页的指定列*/
         __pvt_oled_set_cursor(internal, i, x);
@@ -233,6 +363,75 @@ oled_helper_reversearea(CFBD_OLED* handle, uint16_t x, uint16_t y, uint16_t widt
     return CFBD_TRUE;
 }
 
+#else
+/* 无本地显存：只能通过 stream_area 直接写屏 */
+static CFBD_Bool setPixel(CFBD_OLED* handle, uint16_t x, uint16_t y)
+{
+    return CFBD_FALSE;
+}
+
+static CFBD_Bool clear(CFBD_OLED* handle)
+{
+    return CFBD_FALSE;
+}
+
+static CFBD_Bool update(CFBD_OLED* handle)
+{
+    return CFBD_FALSE;
+}
+
+static CFBD_Bool oled_helper_reverse(CFBD_OLED* handle)
+{
+    return CFBD_FALSE;
+}
+
+static CFBD_Bool oled_helper_draw_area(CFBD_OLED* handle,
+                                       uint16_t x,
+                                       uint16_t y,
+                                       uint16_t width,
+                                       uint16_t height,
+                                       uint8_t* sources)
+{
+    return CFBD_FALSE;
+}
+
+static CFBD_Bool
+oled_helper_no_gram_area(CFBD_OLED* handle, uint16_t x, uint16_t y, uint16_t width, uint16_t height)
+{
+    return CFBD_FALSE;
+}
+
+#define oled_helper_clear_area oled_helper_no_gram_area
+#define oled_helper_update_area oled_helper_no_gram_area
+#define oled_helper_reversearea oled_helper_no_gram_area
+#endif
+
+static CFBD_Bool oled_helper_stream_area(CFBD_OLED* handle,
+                                         uint16_t x,
+                                         uint16_t y,
+                                         uint16_t width,
+                                         uint16_t height,
+                                         const uint8_t* sources)
+{
+    CFBD_OLED_IICInitsParams* internal = asIICInitsParams(handle->oled_internal_handle);
+    const uint16_t POINT_X_MAX = internal->device_specifics->logic_width;
+    const uint16_t POINT_Y_MAX = internal->device_specifics->logic_height;
+    if (x >= POINT_X_MAX || y >= POINT_Y_MAX)
+        return CFBD_FALSE;
+    if (y % 8 != 0 || height % 8 != 0)
+        return CFBD_FALSE;
+
+    end_scroll(internal);
+    // 源数据按页存放，每页 width 字节，超出屏幕的列不发送
+    const uint16_t send_width = (x + width > POINT_X_MAX) ? (POINT_X_MAX - x) : width;
+    for (uint16_t page = 0; page < height / 8 && y + page * 8 < POINT_Y_MAX; page++) {
+        __pvt_oled_set_cursor(internal, y / 8 + page, x);
+        send_data(internal, (uint8_t*) &sources[page * width], send_width);
+    }
+
+    return CFBD_TRUE;
+}
+
 static CFBD_Bool open_oled(CFBD_OLED* handle)
 {
     CFBD_OLED_IICInitsParams* internal = asIICInitsParams(handle->oled_internal_handle);
@@ -277,12 +476,60 @@ static CFBD_Bool iic_query(CFBD_OLED* oled,
         return CFBD_TRUE;
     }
 
+    if (strcmp("contrast", property) == 0) {
+        uint8_t* contrast = (uint8_t*) request_data;
+        *contrast = contrast_level;
+        return CFBD_TRUE;
+    }
+
+    if (strcmp("scroll", property) == 0) {
+        CFBD_Bool* running = (CFBD_Bool*) request_data;
+        *running = scroll_state.running;
+        return CFBD_TRUE;
+    }
+
+#if CFBD_OLED_LOCAL_GRAM
+    if (strcmp("framebuffer", property) == 0) {
+        CFBD_OLEDFrameBuffer* fb = (CFBD_OLEDFrameBuffer*) request_data;
+        fb->gram = &OLED_GRAM[0][0];
+        fb->stride = CACHED_WIDTH;
+        fb->width = internal->device_specifics->logic_width;
+        fb->height = internal->device_specifics->logic_height;
+        fb->bits_per_pixel = 1;
+        fb->color = 1;
+        return CFBD_TRUE;
+    }
+#endif
+
     return CFBD_FALSE;
 }
 
 static CFBD_Bool iic_sets(CFBD_OLED* oled, const char* property, void* args, void* request_data)
 {
-    // Oh no
+    CFBD_OLED_IICInitsParams* internal = asIICInitsParams(oled->oled_internal_handle);
+    if (strcmp("remap", property) == 0) {
+        const uint8_t remap = *(uint8_t*) request_data;
+        halt_scroll(internal);
+        // 初始化表中 0xA1 / 0xC8 为正常方向
+        send_cmd(internal, (remap & CFBD_OLED_REMAP_SEGMENT) ? 0xA0 : 0xA1);
+        send_cmd(internal, (remap & CFBD_OLED_REMAP_COM) ? 0xC0 : 0xC8);
+#if CFBD_OLED_LOCAL_GRAM
+        // 段重映射只作用于之后写入的数据, 重新发送整帧
+        update(oled);
+#endif
+        return CFBD_TRUE;
+    }
+
+    if (strcmp("contrast", property) == 0) {
+        contrast_level = *(uint8_t*) request_data;
+        send_cmd(internal, 0x81);
+        send_cmd(internal, contrast_level);
+        return CFBD_TRUE;
+    }
+
+    if (strcmp("scroll", property) == 0)
+        return start_scroll(oled, (const CFBD_OLEDScroll*) request_data);
+
     return CFBD_FALSE;
 }
 
@@ -297,6 +544,7 @@ static const CFBD_OLEDOperations iic_ops = {.init = init,
                                             .clear_area = oled_helper_clear_area,
                                             .update_area = oled_helper_update_area,
                                             .revert_area = oled_helper_reversearea,
+                                            .stream_area = oled_helper_stream_area,
 
                                             .close = close_oled,
                                             .open = open_oled,
@@ -7,7 +7,9 @@
 #include "driver/device/oled_ssd132x_privates.h"
 #include "oled.h"
 
+#if CFBD_OLED_LOCAL_GRAM
 static uint8_t OLED_GRAM[CACHED_HEIGHT][CACHED_WIDTH];
+#endif
 
 extern I2C_HandleTypeDef hi2c1;
 
@@ -71,6 +73,96 @@ static void set_window(CFBD_OLED_IICInitsParams* internal,
     send_cmd(internal, row_end);
 }
 
+/* Rows of the running hardware scroll, the GRAM keeps the unscrolled picture */
+static struct
+{
+    CFBD_Bool running;
+    uint8_t first_row;
+    uint8_t last_row;
+} scroll_state;
+
+static inline uint16_t frames_distance(uint16_t a, uint16_t b)
+{
+    return (a > b) ? a - b : b - a;
+}
+
+/* 3 bit step interval code closest to @p frames */
+static uint8_t scroll_interval(uint16_t frames)
+{
+    static const uint16_t code_frames[8] = {6, 10, 100, 200, 2, 3, 4, 5};
+    uint8_t best = 0;
+    for (uint8_t code = 1; code < 8; code++) {
+        if (frames_distance(code_frames[code], frames) < frames_distance(code_frames[best], frames))
+            best = code;
+    }
+    return best;
+}
+
+/**
+ * @brief 停止硬件滚动, 面板 RAM 由调用者重写
+ */
+static CFBD_Bool halt_scroll(CFBD_OLED_IICInitsParams* internal)
+{
+    if (!scroll_state.running)
+        return CFBD_FALSE;
+    scroll_state.running = CFBD_FALSE;
+    send_cmd(internal, 0x2E);
+    return CFBD_TRUE;
+}
+
+/**
+ * @brief 停止硬件滚动, 并用本地显存重写被滚动的行
+ */
+static void end_scroll(CFBD_OLED_IICInitsParams* internal)
+{
+    if (!halt_scroll(internal))
+        return;
+#if CFBD_OLED_LOCAL_GRAM
+    set_window(internal, 0, CACHED_WIDTH - 1, scroll_state.first_row, scroll_state.last_row);
+    for (uint16_t row = scroll_state.first_row; row <= scroll_state.last_row; row++) {
+        send_data(internal, OLED_GRAM[row], CACHED_WIDTH);
+    }
+#endif
+}
+
+/**
+ * @brief 启动水平硬件滚动, 列按 2 像素对齐
+ */
+static CFBD_Bool start_scroll(CFBD_OLED* oled, const CFBD_OLEDScroll* scroll)
+{
+    CFBD_OLED_IICInitsParams* internal = asIICInitsParams(oled->oled_internal_handle);
+    const uint16_t width = internal->device_specifics->logic_width;
+    const uint16_t height = internal->device_specifics->logic_height;
+
+    end_scroll(internal);
+    if (scroll->direction == CFBD_OLED_SCROLL_STOP)
+        return CFBD_TRUE;
+    // 控制器没有垂直滚动
+    if (scroll->rows != 0 || scroll->x >= width || scroll->y >= height || scroll->width == 0 ||
+        scroll->height == 0)
+        return CFBD_FALSE;
+
+    const uint16_t right =
+            (scroll->x + scroll->width > width) ? width - 1 : scroll->x + scroll->width - 1;
+    const uint16_t bottom =
+            (scroll->y + scroll->height > height) ? height - 1 : scroll->y + scroll->height - 1;
+
+    send_cmd(internal, (scroll->direction == CFBD_OLED_SCROLL_RIGHT) ? 0x26 : 0x27);
+    send_cmd(internal, 0x00);
+    send_cmd(internal, scroll->y);
+    send_cmd(internal, scroll_interval(scroll->frames));
+    send_cmd(internal, bottom);
+    send_cmd(internal, scroll->x / 2);
+    send_cmd(internal, right / 2);
+    send_cmd(internal, 0x00);
+    send_cmd(internal, 0x2F);
+
+    scroll_state.running = CFBD_TRUE;
+    scroll_state.first_row = scroll->y;
+    scroll_state.last_row = bottom;
+    return CFBD_TRUE;
+}
+
 static uint8_t get_grey_scale(CFBD_OLED* oled)
 {
     CFBD_OLED_IICInitsParams* internal = asIICInitsParams(oled->oled_internal_handle);
@@ -92,6 +184,7 @@ static int init(CFBD_OLED* oled, void* args)
     return CFBD_TRUE;
 }
 
+#if CFBD_OLED_LOCAL_GRAM
 /**
  * @brief 设置单个像素
  * @param handle OLED句柄
@@ -140,6 +233,7 @@ static CFBD_Bool clear(CFBD_OLED* handle)
 static CFBD_Bool update(CFBD_OLED* handle)
 {
     CFBD_OLED_IICInitsParams* internal = asIICInitsParams(handle->oled_internal_handle);
+    halt_scroll(internal); // 整帧都会重写
 
     // 设置全屏窗口
     set_window(internal, 0, CACHED_WIDTH - 1, 0, CACHED_HEIGHT - 1);
@@ -257,6 +351,8 @@ oled_helper_update_area(CFBD_OLED* handle, uint16_t x, uint16_t y, uint16_t widt
     if (y + height > internal->device_specifics->logic_height)
         height = internal->device_specifics->logic_height - y;
 
+    end_scroll(internal);
+
     // 计算列范围
     uint8_t col_start = x / 2;
     uint8_t col_end = (x + width - 1) / 2;
@@ -322,6 +418,94 @@ oled_helper_reversearea(CFBD_OLED* handle, uint16_t x, uint16_t y, uint16_t widt
     return CFBD_TRUE;
 }
 
+#else
+/* 无本地显存：只能通过 stream_area 直接写屏 */
+static CFBD_Bool setPixel(CFBD_OLED* handle, uint16_t x, uint16_t y)
+{
+    return CFBD_FALSE;
+}
+
+static CFBD_Bool clear(CFBD_OLED* handle)
+{
+    return CFBD_FALSE;
+}
+
+static CFBD_Bool update(CFBD_OLED* handle)
+{
+    return CFBD_FALSE;
+}
+
+static CFBD_Bool oled_helper_reverse(CFBD_OLED* handle)
+{
+    return CFBD_FALSE;
+}
+
+static CFBD_Bool oled_helper_draw_area(CFBD_OLED* handle,
+                                       uint16_t x,
+                                       uint16_t y,
+                                       uint16_t width,
+                                       uint16_t height,
+                                       uint8_t* sources)
+{
+    return CFBD_FALSE;
+}
+
+static CFBD_Bool
+oled_helper_no_gram_area(CFBD_OLED* handle, uint16_t x, uint16_t y, uint16_t width, uint16_t height)
+{
+    return CFBD_FALSE;
+}
+
+#define oled_helper_clear_area oled_helper_no_gram_area
+#define oled_helper_update_area oled_helper_no_gram_area
+#define oled_helper_reversearea oled_helper_no_gram_area
+#endif
+
+/**
+ * @brief 直接写屏（不经过本地显存），1bpp 页格式源数据展开为当前灰度
+ */
+static CFBD_Bool oled_helper_stream_area(CFBD_OLED* handle,
+                                         uint16_t x,
+                                         uint16_t y,
+                                         uint16_t width,
+                                         uint16_t height,
+                                         const uint8_t* sources)
+{
+    CFBD_OLED_IICInitsParams* internal = asIICInitsParams(handle->oled_internal_handle);
+
+    if (x >= internal->device_specifics->logic_width ||
+        y >= internal->device_specifics->logic_height)
+        return CFBD_FALSE;
+
+    uint16_t draw_w = (x + width > internal->device_specifics->logic_width)
+                              ? (internal->device_specifics->logic_width - x)
+                              : width;
+    uint16_t draw_h = (y + height > internal->device_specifics->logic_height)
+                              ? (internal->device_specifics->logic_height - y)
+                              : height;
+
+    const uint8_t grey = get_grey_scale(handle);
+    const uint8_t col_start = x / 2;
+    const uint8_t col_end = (x + draw_w - 1) / 2;
+    uint8_t row[CACHED_WIDTH];
+
+    end_scroll(internal);
+    set_window(internal, col_start, col_end, y, y + draw_h - 1);
+
+    for (uint16_t j = 0; j < draw_h; j++) {
+        memset(row, 0, sizeof(row));
+        for (uint16_t i = 0; i < draw_w; i++) {
+            if (!((sources[(j / 8) * width + i] >> (j % 8)) & 0x01))
+                continue;
+            const uint16_t curr_x = x + i;
+            row[curr_x / 2 - col_start] |= (curr_x % 2 == 0) ? (grey << 4) : grey;
+        }
+        send_data(internal, row, col_end - col_start + 1);
+    }
+
+    return CFBD_TRUE;
+}
+
 /**
  * @brief 打开显示
  */
@@ -372,6 +556,33 @@ static CFBD_Bool iic_query(CFBD_OLED* oled, const char* property, void* args, vo
         return CFBD_TRUE;
     }
 
+    if (strcmp("contrast", property) == 0) {
+        uint8_t* contrast = (uint8_t*) request_data;
+        SSD132XPrivateDatas* privates =
+                (SSD132XPrivateDatas*) internal->device_specifics->private_data;
+        *contrast = privates->contrast;
+        return CFBD_TRUE;
+    }
+
+    if (strcmp("scroll", property) == 0) {
+        CFBD_Bool* running = (CFBD_Bool*) request_data;
+        *running = scroll_state.running;
+        return CFBD_TRUE;
+    }
+
+#if CFBD_OLED_LOCAL_GRAM
+    if (strcmp("framebuffer", property) == 0) {
+        CFBD_OLEDFrameBuffer* fb = (CFBD_OLEDFrameBuffer*) request_data;
+        fb->gram = &OLED_GRAM[0][0];
+        fb->stride = CACHED_WIDTH;
+        fb->width = internal->device_specifics->logic_width;
+        fb->height = internal->device_specifics->logic_height;
+        fb->bits_per_pixel = 4;
+        fb->color = get_grey_scale(oled);
+        return CFBD_TRUE;
+    }
+#endif
+
     return CFBD_FALSE;
 }
 
@@ -387,6 +598,18 @@ static CFBD_Bool iic_sets(CFBD_OLED* oled, const char* property, void* args, voi
         return CFBD_TRUE;
     }
 
+    if (strcmp("contrast", property) == 0) {
+        SSD132XPrivateDatas* privates =
+                (SSD132XPrivateDatas*) internal->device_specifics->private_data;
+        privates->contrast = *(uint8_t*) request_data;
+        send_cmd(internal, 0x81);
+        send_cmd(internal, privates->contrast);
+        return CFBD_TRUE;
+    }
+
+    if (strcmp("scroll", property) == 0)
+        return start_scroll(oled, (const CFBD_OLEDScroll*) request_data);
+
     return CFBD_FALSE;
 }
 
@@ -401,6 +624,7 @@ static const CFBD_OLEDOperations iic_ops = {.init = init,
                                             .clear_area = oled_helper_clear_area,
                                             .update_area = oled_helper_update_area,
                                             .revert_area = oled_helper_reversearea,
+                                            .stream_area = oled_helper_stream_area,
 
                                             .close = close_oled,
                                             .open = open_oled,
@@ -0,0 +1,11 @@
+#pragma once
+#include <stdint.h>
+
+#include "cfbd_define.h"
+
+typedef struct __SSD130XPrivateDatas
+{
+    // 0x26/0x27 后跟起止列 (SSD1309), 否则固定 0x00 0xFF 滚动整行 (SSD1306)
+    CFBD_Bool scroll_column_window;
+    uint8_t contrast; // 初始化表中 0x81 的参数
+} SSD130XPrivateDatas;
\ No newline at end of file
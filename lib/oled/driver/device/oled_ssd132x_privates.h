@@ -4,4 +4,5 @@
 typedef struct __SSD132XPrivateDatas
 {
     uint8_t grey_scale;
+    uint8_t contrast; // 初始化表中 0x81 的参数
 } SSD132XPrivateDatas;
\ No newline at end of file
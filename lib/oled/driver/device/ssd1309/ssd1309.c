@@ -3,6 +3,8 @@
 #include <stdint.h>
 #include <string.h>
 
+#include "../oled_ssd130x_privates.h"
+
 static uint8_t ssd1309_inits_commands[] = {
         0xAE,       // Turn off OLED panel
         0xFD, 0x12, // Set display clock divide ratio/oscillator frequency
@@ -35,6 +37,9 @@ static uint8_t* ssd1309_init_sessions(void)
     return ssd1309_inits_commands;
 }
 
+static SSD130XPrivateDatas ssd1309_private_data = {.scroll_column_window = CFBD_TRUE,
+                                                   .contrast = 0xBF};
+
 static CFBD_OLED_DeviceSpecific ssd1309_specific;
 
 CFBD_OLED_DeviceSpecific* getSSD1309Specific()
@@ -46,6 +51,6 @@ CFBD_OLED_DeviceSpecific* getSSD1309Specific()
     ssd1309_specific.logic_height = 64;
     ssd1309_specific.logic_width = 128;
     ssd1309_specific.iic_pack_type = SSD1309_IIC_PACK;
-    ssd1309_specific.private_data = NULL; // no, nothing here
+    ssd1309_specific.private_data = &ssd1309_private_data;
     return &ssd1309_specific;
 }
\ No newline at end of file
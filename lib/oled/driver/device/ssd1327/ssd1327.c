@@ -28,7 +28,7 @@ static uint8_t* ssd1327_init_sessions(void)
 }
 
 static CFBD_OLED_DeviceSpecific ssd1327_specific;
-static SSD132XPrivateDatas ssd1327_private_data = {.grey_scale = 0x05};
+static SSD132XPrivateDatas ssd1327_private_data = {.grey_scale = 0x05, .contrast = 0x77};
 
 CFBD_OLED_DeviceSpecific* getSSD1327Specific()
 {
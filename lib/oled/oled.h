@@ -180,6 +180,83 @@ typedef CFBD_Bool (*OLED_SetPropertyOperation)(CFBD_OLED* oled,
                                                void* args,
                                                void* request_data); // What to write?
 
+/**
+ * @struct CFBD_OLEDFrameBuffer
+ * @brief Description of the backend's local frame buffer (GRAM cache).
+ *
+ * @details
+ * Returned by the "framebuffer" query of backends that keep a local GRAM
+ * cache. Upper layers may write pixels straight into @ref gram instead of
+ * calling setPixel() for every pixel, as long as they respect the layout:
+ * - bits_per_pixel == 1: SSD130x page layout, byte `gram[(y / 8) * stride + x]`,
+ *   bit `y % 8` (LSB on top)
+ * - bits_per_pixel == 4: SSD132x packed layout, byte `gram[y * stride + x / 2]`,
+ *   even x in the high nibble
+ *
+ * @note The cache is only pushed to the panel by update()/update_area().
+ */
+typedef struct
+{
+    uint8_t* gram;          /**< First byte of the frame buffer */
+    uint16_t stride;        /**< Bytes between two pages (1bpp) or two rows (4bpp) */
+    uint16_t width;         /**< Logic width in pixels */
+    uint16_t height;        /**< Logic height in pixels */
+    uint8_t bits_per_pixel; /**< 1 (page layout) or 4 (packed grey scale) */
+    uint8_t color;          /**< Active drawing grey level for 4bpp panels */
+} CFBD_OLEDFrameBuffer;
+
+/**
+ * @def CFBD_OLED_REMAP_SEGMENT
+ * @brief "remap" flag: scan the columns right to left (mirror left/right).
+ */
+#define CFBD_OLED_REMAP_SEGMENT (0x01)
+
+/**
+ * @def CFBD_OLED_REMAP_COM
+ * @brief "remap" flag: scan the COM lines bottom to top (mirror top/bottom).
+ */
+#define CFBD_OLED_REMAP_COM (0x02)
+
+/**
+ * @enum CFBD_OLEDScrollDirection
+ * @brief Direction of a continuous hardware scroll ("scroll" property).
+ */
+typedef enum
+{
+    CFBD_OLED_SCROLL_STOP,  /**< Stop scrolling, the panel shows the GRAM again */
+    CFBD_OLED_SCROLL_LEFT,  /**< Content moves left, wrapping around */
+    CFBD_OLED_SCROLL_RIGHT, /**< Content moves right, wrapping around */
+} CFBD_OLEDScrollDirection;
+
+/**
+ * @struct CFBD_OLEDScroll
+ * @brief Argument of the "scroll" property.
+ *
+ * @details
+ * The controller moves the area one column every @ref frames panel frames
+ * on its own, no byte crosses the bus while it runs. The frame count is
+ * rounded to the nearest step interval the controller knows. SSD130x
+ * parts scroll whole pages, @ref y and @ref height are widened to page
+ * boundaries; the SSD1306 always scrolls the full width. A non zero
+ * @ref rows adds vertical motion (SSD130x only): the rows y .. y + height - 1
+ * move up by @ref rows every step as well.
+ *
+ * The local GRAM keeps the unscrolled picture. Stopping, and any
+ * update(), update_area(), stream_area() or "remap" while a scroll runs,
+ * stops the controller first and rewrites the scrolled pages from the
+ * GRAM, so the panel shows the GRAM again whenever the driver writes to it.
+ */
+typedef struct
+{
+    CFBD_OLEDScrollDirection direction; /**< CFBD_OLED_SCROLL_STOP ends a running scroll */
+    uint16_t x;                         /**< First column of the area */
+    uint16_t y;                         /**< First row of the area */
+    uint16_t width;                     /**< Width of the area in pixels */
+    uint16_t height;                    /**< Height of the area in pixels */
+    uint16_t frames;                    /**< Panel frames between two steps */
+    uint8_t rows;                       /**< Vertical rows per step, 0 for horizontal only */
+} CFBD_OLEDScroll;
+
 /**
  * @struct CFBD_OLEDOperations
  * @brief Virtual operation table implementing OLED driver functionality.
@@ -307,6 +384,23 @@ typedef struct _CFBD_OLED_OPS
      */
     AreaOperations revert_area;
 
+    /**
+     * @brief Send 1bpp page-layout pixels directly to the panel RAM.
+     *
+     * @details
+     * The local frame buffer (if any) is neither read nor modified, which
+     * lets band renderers drive the panel without a full frame in RAM.
+     * @p source uses the setArea() layout; @p y and @p height must be
+     * multiples of 8. Grey scale panels expand set bits to the active
+     * grey level. Optional, may be NULL.
+     */
+    CFBD_Bool (*stream_area)(CFBD_OLED* oled,
+                             uint16_t x,
+                             uint16_t y,
+                             uint16_t width,
+                             uint16_t height,
+                             const uint8_t* source);
+
     /**
      * @brief Open/enable the display device.
      *
@@ -334,6 +428,10 @@ typedef struct _CFBD_OLED_OPS
      * - "width" (uint16_t): Display width in pixels
      * - "height" (uint16_t): Display height in pixels
      * - "color" (uint8_t): Some Chips supports grey scale, try query these :)
+     * - "framebuffer" (CFBD_OLEDFrameBuffer): Local GRAM cache description,
+     *   only available on backends that keep one
+     * - "scroll" (CFBD_Bool): CFBD_TRUE while a hardware scroll runs
+     * - "contrast" (uint8_t): Contrast register (0x81) currently set
      *
      * Additional device-specific properties may be queried as needed.
      */
@@ -346,6 +444,12 @@ typedef struct _CFBD_OLED_OPS
      * Retrieves device-specific information such as resolution, color depth,
      * and supported features. Implementations must support at least:
      * - "color" (uint8_t): Some Chips supports grey scale, you can set this
+     * - "remap" (uint8_t): CFBD_OLED_REMAP_* flags, mirrors the panel through
+     *   the controller's segment remap / COM scan direction
+     * - "scroll" (CFBD_OLEDScroll): starts or stops a continuous hardware
+     *   scroll, optional
+     * - "contrast" (uint8_t): panel brightness through the contrast
+     *   register (0x81), optional
      *
      * Additional device-specific properties may be queried as needed.
      */
@@ -117,6 +117,9 @@ void do1309Demo()
     // system_delay_ms(1000);
     CFBDGraphic_DeviceClearImmediate(&graphic_device);
     test_fps(&graphic_device);
+
+    system_delay_ms(2000);
+    test_band_render(&graphic_device);
     // test_widget(&graphic_device);
     while (1)
         ;
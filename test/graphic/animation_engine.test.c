@@ -0,0 +1,332 @@
+/*
+    Animation engine: a late tick applies only the frame that is due, a
+    retargeted tween eases from where it stands, finished and cancelled
+    tweens free their slot, and every tick flushes the bounding box of the
+    regions its tweens changed with a single update_area(). A random run
+    of starts, retargets, cancels and ticks across the 32 bit tick wrap is
+    compared against a model of each tween.
+*/
+#include <string.h>
+
+#include "host_test.h"
+#include "widget/animation/animation_engine.h"
+
+#define BARS (CFBD_ANIMATION_MAX_TWEENS + 2)
+
+/* A bar of 4x6 pixels on a row of its own, moved by its tween */
+typedef struct
+{
+    int row;
+    CFBD_Bool hidden; /* applies draw nothing */
+    int32_t x;        /* value last applied */
+    unsigned applies; /* applies during the current tick */
+    CFBDGraphicRect dirty;
+} Bar;
+
+static Bar bars[BARS];
+static CFBD_Bool deferred;
+
+static CFBD_Bool apply_bar(CFBD_GraphicDevice* device,
+                           int32_t value,
+                           void* user_data,
+                           CFBDGraphicRect* dirty)
+{
+    Bar* bar = user_data;
+    if (CFBDGraphic_DeviceRequestUpdateAtOnce(device))
+        deferred = CFBD_FALSE;
+    bar->applies++;
+    // the previous and the new position, corners in any order
+    CFBDGraphicRect r = {{value + 3, bar->row * 6 + 5}, {bar->x, bar->row * 6}};
+    bar->x = value;
+    bar->dirty = r;
+    *dirty = r;
+    return !bar->hidden;
+}
+
+static void reset_bars(void)
+{
+    memset(bars, 0, sizeof(bars));
+    for (int i = 0; i < BARS; i++)
+        bars[i].row = i;
+}
+
+static CFBD_Bool tick(CFBD_AnimationEngine* engine, uint32_t now_ms)
+{
+    for (int i = 0; i < BARS; i++)
+        bars[i].applies = 0;
+    host_flushes = 0;
+    deferred = CFBD_TRUE;
+    return CFBD_AnimationTick(engine, now_ms);
+}
+
+/* Linear 0 -> 80 in 8 frames of 10 ms: one frame per 10 units */
+static void check_late_ticks(CFBD_GraphicDevice* device, uint32_t base)
+{
+    static const struct
+    {
+        uint32_t at;      /* tick, relative to the start */
+        int32_t x;        /* expected bar position afterwards */
+        unsigned applies; /* expected applies */
+        CFBD_Bool running;
+    } script[] = {
+            {0, 0, 0, CFBD_TRUE},     // frame 0 is on screen already
+            {9, 0, 0, CFBD_TRUE},     // not due yet
+            {10, 10, 1, CFBD_TRUE},   // frame 1
+            {35, 30, 1, CFBD_TRUE},   // late: frame 2 is skipped
+            {39, 30, 0, CFBD_TRUE},   // frame 3 again, nothing to do
+            {79, 70, 1, CFBD_TRUE},   // frames 4 - 6 skipped
+            {500, 80, 1, CFBD_FALSE}, // far too late: the last frame, slot freed
+            {600, 80, 0, CFBD_FALSE},
+    };
+    const CFBD_BaseAnimation timing = {.anim_frames = 8, .anim_frame_delay_ms = 10};
+    CFBD_AnimationEngine engine;
+    CFBD_InitAnimationEngine(&engine, device);
+    reset_bars();
+    CFBD_Tween* t = CFBD_AnimationStart(
+            &engine, &timing, 0, 80, CFBD_EASE_LINEAR, apply_bar, &bars[0], base);
+
+    for (size_t i = 0; i < sizeof(script) / sizeof(script[0]); i++) {
+        const CFBD_Bool running = tick(&engine, base + script[i].at);
+        HOST_CHECK(running == script[i].running && bars[0].x == script[i].x &&
+                           bars[0].applies == script[i].applies &&
+                           host_flushes == script[i].applies && deferred,
+                   "base %u tick %u: x %d after %u applies and %u flushes, running %d",
+                   base,
+                   script[i].at,
+                   bars[0].x,
+                   bars[0].applies,
+                   host_flushes,
+                   running);
+    }
+    HOST_CHECK(!CFBD_TweenRunning(t), "base %u: finished tween keeps its slot", base);
+}
+
+/* A retarget eases from the current value, the frames count from the retarget */
+static void check_retarget(CFBD_GraphicDevice* device)
+{
+    const CFBD_BaseAnimation timing = {.anim_frames = 4, .anim_frame_delay_ms = 10};
+    CFBD_AnimationEngine engine;
+    CFBD_InitAnimationEngine(&engine, device);
+    reset_bars();
+    CFBD_Tween* t =
+            CFBD_AnimationStart(&engine, &timing, 0, 40, CFBD_EASE_LINEAR, apply_bar, &bars[0], 0);
+
+    tick(&engine, 25); // frame 2: x 20
+    CFBD_TweenRetarget(t, 100, 27);
+    tick(&engine, 36); // not a frame of the new run yet
+    HOST_CHECK(bars[0].x == 20 && bars[0].applies == 0, "retarget: x %d too early", bars[0].x);
+    tick(&engine, 37);
+    HOST_CHECK(bars[0].x == 40 && bars[0].applies == 1, "retarget frame 1: x %d", bars[0].x);
+    tick(&engine, 57);
+    HOST_CHECK(bars[0].x == 80 && CFBD_TweenRunning(t), "retarget frame 3: x %d", bars[0].x);
+
+    // back to where it stands: no frame changes the value, no apply, no flush
+    CFBD_TweenRetarget(t, 80, 60);
+    const CFBD_Bool running = tick(&engine, 100);
+    HOST_CHECK(!running && bars[0].applies == 0 && host_flushes == 0 && !CFBD_TweenRunning(t),
+               "retarget in place: %u applies, %u flushes, running %d",
+               bars[0].applies,
+               host_flushes,
+               running);
+}
+
+/* Every slot taken, then freed by finishing, cancelling and a zero delay */
+static void check_slots(CFBD_GraphicDevice* device)
+{
+    const CFBD_BaseAnimation slow = {.anim_frames = 4, .anim_frame_delay_ms = 100};
+    const CFBD_BaseAnimation fast = {.anim_frames = 2, .anim_frame_delay_ms = 5};
+    const CFBD_BaseAnimation at_once = {.anim_frames = 6, .anim_frame_delay_ms = 0};
+    CFBD_AnimationEngine engine;
+    CFBD_Tween* tweens[CFBD_ANIMATION_MAX_TWEENS];
+    CFBD_InitAnimationEngine(&engine, device);
+    reset_bars();
+
+    for (int i = 0; i < CFBD_ANIMATION_MAX_TWEENS; i++) {
+        tweens[i] = CFBD_AnimationStart(&engine,
+                                        (i == 1) ? &fast : &slow,
+                                        0,
+                                        40,
+                                        CFBD_EASE_OUT,
+                                        apply_bar,
+                                        &bars[i],
+                                        0);
+        HOST_CHECK(tweens[i] != NULL, "slot %d refused", i);
+    }
+    HOST_CHECK(!CFBD_AnimationStart(&engine, &slow, 0, 1, CFBD_EASE_OUT, apply_bar, &bars[8], 0),
+               "a tween beyond the last slot was started");
+
+    // the fast tween ends, a cancelled one is never applied again
+    CFBD_TweenCancel(tweens[3]);
+    tick(&engine, 10);
+    HOST_CHECK(!CFBD_TweenRunning(tweens[1]) && bars[1].x == 40 && bars[3].applies == 0,
+               "fast tween at %d, cancelled one applied %u times",
+               bars[1].x,
+               bars[3].applies);
+
+    // both freed slots are reused; a zero delay draws a frame per tick
+    CFBD_Tween* a = CFBD_AnimationStart(
+            &engine, &at_once, 5, 60, CFBD_EASE_SPRING, apply_bar, &bars[8], 10);
+    CFBD_Tween* b = CFBD_AnimationStart(
+            &engine, &at_once, 0, 0, CFBD_EASE_LINEAR, apply_bar, &bars[9], 10);
+    HOST_CHECK(a != NULL && b != NULL && (a == tweens[1] || a == tweens[3]) &&
+                       (b == tweens[1] || b == tweens[3]),
+               "freed slots not reused");
+    for (int frame = 1; frame < at_once.anim_frames; frame++)
+        tick(&engine, 10);
+    HOST_CHECK(a != NULL && CFBD_TweenRunning(a), "zero delay: done before the last frame");
+    tick(&engine, 10);
+    HOST_CHECK(a != NULL && b != NULL && !CFBD_TweenRunning(a) && !CFBD_TweenRunning(b) &&
+                       bars[8].x == 60 && bars[8].applies == 1 && bars[9].applies == 0,
+               "zero delay: x %d after %u applies",
+               bars[8].x,
+               bars[8].applies);
+}
+
+/* Model of one tween, kept beside the engine */
+typedef struct
+{
+    CFBD_Tween* tween;
+    CFBD_BaseAnimation timing;
+    CFBD_EasingCurve curve;
+    int32_t from, to, value;
+    uint32_t start_ms;
+    uint32_t frame;
+} Model;
+
+static Model models[BARS];
+
+/* Advance the model to now_ms, tick the engine and compare */
+static void check_tick(CFBD_AnimationEngine* engine, int round, uint32_t now_ms)
+{
+    Model expected[BARS];
+    CFBD_Bool expect_running = CFBD_FALSE;
+    memcpy(expected, models, sizeof(models));
+    for (int i = 0; i < BARS; i++) {
+        Model* e = &expected[i];
+        if (e->tween == NULL)
+            continue;
+        const uint32_t frames = e->timing.anim_frames ? e->timing.anim_frames : 1;
+        const uint32_t delay = e->timing.anim_frame_delay_ms;
+        uint32_t due = delay ? (now_ms - e->start_ms) / delay : e->frame + 1;
+        due = (due > frames) ? frames : due;
+        if (due != e->frame) {
+            const int32_t eased = CFBD_EaseQ16(e->curve, CFBD_EaseProgressQ16(due, frames));
+            e->frame = due;
+            e->value = (due == frames) ? e->to : CFBD_EaseLerp(e->from, e->to, eased);
+        }
+        if (due == frames)
+            e->tween = NULL;
+        else
+            expect_running = CFBD_TRUE;
+    }
+
+    const CFBD_Bool running = tick(engine, now_ms);
+    CFBD_Bool any = CFBD_FALSE;
+    CFBDGraphicRect bounds;
+    for (int i = 0; i < BARS; i++) {
+        const CFBD_Bool moved = expected[i].value != models[i].value;
+        HOST_CHECK(bars[i].applies == (unsigned) moved && bars[i].x == expected[i].value,
+                   "round %d bar %d: x %d after %u applies, expected %d",
+                   round,
+                   i,
+                   bars[i].x,
+                   bars[i].applies,
+                   expected[i].value);
+        if (moved && !bars[i].hidden) {
+            const CFBDGraphicRect d = rect_normalize(bars[i].dirty);
+            bounds = any ? rect_union(&bounds, &d) : d;
+            any = CFBD_TRUE;
+        }
+    }
+    memcpy(models, expected, sizeof(models));
+
+    HOST_CHECK(running == expect_running && deferred &&
+                       CFBDGraphic_DeviceRequestUpdateAtOnce(engine->device),
+               "round %d: running %d, expected %d",
+               round,
+               running,
+               expect_running);
+    const CFBDGraphic_ClipBounds* f = &host_last_flush;
+    HOST_CHECK(host_flushes == (unsigned) any &&
+                       (!any || (f->x0 == bounds.tl.x && f->y0 == bounds.tl.y &&
+                                 f->x1 == bounds.br.x && f->y1 == bounds.br.y)),
+               "round %d: %u flushes of (%d,%d)-(%d,%d)",
+               round,
+               host_flushes,
+               f->x0,
+               f->y0,
+               f->x1,
+               f->y1);
+}
+
+static void check_random(CFBD_GraphicDevice* device, uint32_t base)
+{
+    CFBD_AnimationEngine engine;
+    CFBD_InitAnimationEngine(&engine, device);
+    reset_bars();
+    memset(models, 0, sizeof(models));
+    uint32_t now_ms = base;
+
+    for (int round = 0; round < 20000; round++) {
+        Model* m = &models[host_random(BARS)];
+        Bar* bar = &bars[m - models];
+        switch (host_random(6)) {
+            case 0: // start
+                if (m->tween != NULL)
+                    break;
+                m->timing.anim_frames = (uint8_t) host_random(12);
+                m->timing.anim_frame_delay_ms = host_random(4) ? host_random(20) : 0;
+                m->curve = (CFBD_EasingCurve) host_random(4);
+                m->from = m->value = bar->x;
+                m->to = 20 + (int32_t) host_random(80); // a spring stays on screen
+                m->start_ms = now_ms;
+                m->frame = 0;
+                bar->hidden = host_random(5) == 0;
+                m->tween = CFBD_AnimationStart(
+                        &engine, &m->timing, m->from, m->to, m->curve, apply_bar, bar, now_ms);
+                if (m->tween == NULL) {
+                    unsigned busy = 0;
+                    for (int i = 0; i < BARS; i++)
+                        busy += models[i].tween != NULL;
+                    HOST_CHECK(busy == CFBD_ANIMATION_MAX_TWEENS,
+                               "round %d: refused with %u slots busy",
+                               round,
+                               busy);
+                }
+                break;
+            case 1: // retarget
+                if (m->tween == NULL)
+                    break;
+                m->from = m->value;
+                m->to = 20 + (int32_t) host_random(80);
+                m->start_ms = now_ms;
+                m->frame = 0;
+                CFBD_TweenRetarget(m->tween, m->to, now_ms);
+                break;
+            case 2: // cancel
+                if (m->tween == NULL || host_random(3) != 0)
+                    break;
+                CFBD_TweenCancel(m->tween);
+                m->tween = NULL;
+                break;
+            default: // tick, sometimes late
+                now_ms += host_random(8) ? host_random(15) : host_random(200);
+                check_tick(&engine, round, now_ms);
+                break;
+        }
+    }
+}
+
+int main(void)
+{
+    static HostPanel panel;
+    host_bind(&panel, CFBD_CANVAS_1BPP_PAGE, CFBD_TRUE);
+    host_count_flushes(&panel);
+    check_late_ticks(&panel.device, 0);
+    check_late_ticks(&panel.device, UINT32_MAX - 20);
+    check_retarget(&panel.device);
+    check_slots(&panel.device);
+    check_random(&panel.device, 0);
+    check_random(&panel.device, UINT32_MAX - 5000);
+    return host_report("animation_engine");
+}
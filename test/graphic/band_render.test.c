@@ -0,0 +1,113 @@
+/*
+    Band rendering: a frame streamed band by band must show the same pixels
+    as the display list replayed directly onto a cleared panel, for every
+    band height and with the panel's raster op and clear-before-draw
+    setting. The panel's own frame buffer is left alone.
+*/
+#include <string.h>
+
+#include "base/circle.h"
+#include "base/line.h"
+#include "base/rectangle.h"
+#include "display_list/band_renderer.h"
+#include "display_list/display_list.h"
+#include "host_test.h"
+
+static HostPanel streamed;
+static CFBD_GraphicDeviceOperation streaming_ops;
+
+/* The controller side: 1bpp pages written straight into "streamed" */
+static CFBD_Bool stream_to_panel(CFBD_GraphicDevice* device,
+                                 uint16_t x,
+                                 uint16_t y,
+                                 uint16_t width,
+                                 uint16_t height,
+                                 const uint8_t* source)
+{
+    (void) device;
+    if (y % 8 != 0 || height % 8 != 0)
+        return CFBD_FALSE;
+    for (uint16_t page = 0; page < height / 8; page++)
+        memcpy(&streamed.pixels[(y / 8 + page) * HOST_WIDTH + x], &source[page * width], width);
+    return CFBD_TRUE;
+}
+
+static void record_frame(CFBDGraphic_DisplayList* list)
+{
+    static char caption[] = "Band 42";
+    for (int i = 0; i < 10; i++) {
+        const CFBDGraphic_Point a = {host_random(HOST_WIDTH), host_random(HOST_HEIGHT)};
+        const CFBDGraphic_Point b = {host_random(HOST_WIDTH), host_random(HOST_HEIGHT)};
+        CFBDGraphic_Line line = {a, b};
+        CFBDGraphicRect rect = rect_normalize((CFBDGraphicRect) {a, b});
+        CFBDGraphicCircle circle = {.radius = host_random(24), .center = a};
+        switch (host_random(6)) {
+            case 0:
+                CFBDGraphic_DisplayListLine(list, &line);
+                break;
+            case 1:
+                CFBDGraphic_DisplayListRect(list, &rect);
+                break;
+            case 2:
+                CFBDGraphic_DisplayListFillRect(list, &rect);
+                break;
+            case 3:
+                CFBDGraphic_DisplayListCircle(list, &circle);
+                break;
+            case 4:
+                CFBDGraphic_DisplayListFilledCircle(list, &circle);
+                break;
+            default:
+                CFBDGraphic_DisplayListText(list, &a, caption, ASCII_6x8);
+                break;
+        }
+    }
+}
+
+int main(void)
+{
+    static const uint16_t band_rows[] = {8, 16, 24, 32, 64};
+    static uint8_t storage[512];
+    static uint8_t band[CFBDGraphic_BAND_BYTES(HOST_WIDTH, 64)];
+    static HostPanel panel, direct, blank;
+    CFBDGraphic_DisplayList list;
+
+    host_bind(&streamed, CFBD_CANVAS_1BPP_PAGE, CFBD_TRUE);
+    host_bind(&direct, CFBD_CANVAS_1BPP_PAGE, CFBD_TRUE);
+    host_bind(&blank, CFBD_CANVAS_1BPP_PAGE, CFBD_TRUE);
+    host_bind(&panel, CFBD_CANVAS_1BPP_PAGE, CFBD_TRUE);
+    streaming_ops = *panel.device.ops;
+    streaming_ops.stream_area = stream_to_panel;
+    panel.device.ops = &streaming_ops;
+
+    for (int round = 0; round < 1500; round++) {
+        CFBDGraphic_DisplayListInit(&list, storage, sizeof(storage));
+        record_frame(&list);
+        const CFBDGraphic_RasterOp rop = (CFBDGraphic_RasterOp) host_random(4);
+        const CFBD_Bool clear = host_random(2);
+        const uint16_t rows = band_rows[round % 5];
+
+        CFBDGraphic_DeviceSetRasterOp(&panel.device, rop);
+        CFBDGraphic_DeviceSetClearBeforeDraw(&panel.device, clear);
+        CFBDGraphic_DeviceSetRasterOp(&direct.device, rop);
+        CFBDGraphic_DeviceSetClearBeforeDraw(&direct.device, clear);
+
+        host_clear(&direct);
+        CFBDGraphic_DisplayListReplay(&direct.device, &list, NULL);
+        memset(streamed.pixels, 0xA5, sizeof(streamed.pixels));
+        HOST_CHECK(CFBDGraphic_BandRender(&panel.device, &list, band, rows),
+                   "round %d: band render failed",
+                   round);
+
+        HOST_CHECK(host_same_pixels(&direct, &streamed),
+                   "round %d: %d row bands, rop %d, clear %d differ from the direct replay",
+                   round,
+                   rows,
+                   rop,
+                   clear);
+        HOST_CHECK(host_same_pixels(&panel, &blank), "round %d: the panel buffer was written", round);
+    }
+
+    HOST_CHECK(!CFBDGraphic_BandRender(&panel.device, &list, band, 12), "12 row bands accepted");
+    return host_report("band_render");
+}
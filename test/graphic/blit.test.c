@@ -0,0 +1,165 @@
+/*
+    Device blit: a window of a page bitmap lands on the panel following a
+    per-pixel reference of the four raster ops, inside the active clip only,
+    with and without the backend blit op. An immediate device is flushed
+    once with the visible rectangle, and clipped images show the bitmap
+    inside the clip and leave the rest of the panel alone.
+*/
+#include <string.h>
+
+#include "device/graphic_canvas.h"
+#include "device/graphic_clip.h"
+#include "host_test.h"
+#include "widget/base_support/image.h"
+
+#define BITMAP_WIDTH (40)
+#define BITMAP_HEIGHT (24)
+
+static uint8_t bitmap[CFBDGraphic_MEMORY_CANVAS_BYTES(BITMAP_WIDTH, BITMAP_HEIGHT)];
+
+static CFBD_Bool bitmap_ink(uint16_t x, uint16_t y)
+{
+    return (bitmap[(y / 8) * BITMAP_WIDTH + x] >> (y & 7)) & 0x01;
+}
+
+static void randomize(HostPanel* panel, HostPanel* before)
+{
+    for (size_t i = 0; i < sizeof(bitmap); i++)
+        bitmap[i] = (uint8_t) host_random(256);
+    for (size_t i = 0; i < sizeof(panel->pixels); i++)
+        panel->pixels[i] = (uint8_t) host_random(256);
+    memcpy(before->pixels, panel->pixels, sizeof(panel->pixels));
+}
+
+static void check_blit_ops(CFBD_Bool fast_path)
+{
+    static HostPanel panel, before;
+    host_bind(&panel, CFBD_CANVAS_1BPP_PAGE, fast_path);
+    host_bind(&before, CFBD_CANVAS_1BPP_PAGE, CFBD_TRUE);
+    host_count_flushes(&panel);
+
+    for (int round = 0; round < 2000; round++) {
+        randomize(&panel, &before);
+        CFBDGraphic_BlitSource source = {
+                bitmap, BITMAP_WIDTH, host_random(BITMAP_WIDTH), host_random(BITMAP_HEIGHT), 0, 0};
+        source.width = 1 + host_random(BITMAP_WIDTH - source.x);
+        source.height = 1 + host_random(BITMAP_HEIGHT - source.y);
+        const uint16_t x = host_random(HOST_WIDTH + 8), y = host_random(HOST_HEIGHT + 8);
+        const CFBDGraphic_RasterOp rop = (CFBDGraphic_RasterOp) host_random(4);
+
+        // 可选裁剪矩形, 角点包含在内
+        CFBDGraphicRect clip = {{0, 0}, {HOST_WIDTH - 1, HOST_HEIGHT - 1}};
+        const CFBD_Bool clipped = host_random(2);
+        if (clipped) {
+            clip.tl = (CFBDGraphic_Point) {host_random(HOST_WIDTH), host_random(HOST_HEIGHT)};
+            clip.br.x = clip.tl.x + host_random(HOST_WIDTH - clip.tl.x);
+            clip.br.y = clip.tl.y + host_random(HOST_HEIGHT - clip.tl.y);
+            CFBDGraphic_PushClip(&panel.device, &clip);
+        }
+        CFBDGraphic_DeviceSetIfRequestUpdateAtOnce(&panel.device, CFBD_TRUE);
+        host_flushes = 0;
+        const CFBD_Bool drawn = CFBDGraphic_DeviceBlit(&panel.device, &source, x, y, rop);
+        CFBDGraphic_DeviceSetIfRequestUpdateAtOnce(&panel.device, CFBD_FALSE);
+        if (clipped)
+            CFBDGraphic_PopClip(&panel.device);
+
+        CFBD_Bool same = CFBD_TRUE;
+        int32_t lx = INT32_MAX, ty = INT32_MAX, rx = INT32_MIN, by = INT32_MIN;
+        for (int32_t py = 0; py < HOST_HEIGHT; py++) {
+            for (int32_t px = 0; px < HOST_WIDTH; px++) {
+                const CFBD_Bool under = host_pixel(&before, px, py);
+                CFBD_Bool expected = under;
+                if (px >= x && px < x + source.width && py >= y && py < y + source.height &&
+                    px >= clip.tl.x && px <= clip.br.x && py >= clip.tl.y && py <= clip.br.y) {
+                    const CFBD_Bool ink = bitmap_ink(source.x + (px - x), source.y + (py - y));
+                    expected = host_raster_op(rop, under, ink);
+                    lx = (px < lx) ? px : lx;
+                    ty = (py < ty) ? py : ty;
+                    rx = (px > rx) ? px : rx;
+                    by = (py > by) ? py : by;
+                }
+                if (host_pixel(&panel, px, py) != expected)
+                    same = CFBD_FALSE;
+            }
+        }
+        HOST_CHECK(same,
+                   "round %d: blit rop %d (fast path %d, clip %d) differs from the reference",
+                   round,
+                   rop,
+                   fast_path,
+                   clipped);
+
+        const CFBDGraphic_ClipBounds* f = &host_last_flush;
+        if (lx > rx) {
+            HOST_CHECK(!drawn && host_flushes == 0, "round %d: invisible blit flushed", round);
+        }
+        else {
+            HOST_CHECK(drawn && host_flushes == 1 && f->x0 == lx && f->y0 == ty && f->x1 == rx &&
+                               f->y1 == by,
+                       "round %d: %u flushes, last (%d,%d)-(%d,%d), visible (%d,%d)-(%d,%d)",
+                       round,
+                       host_flushes,
+                       f->x0,
+                       f->y0,
+                       f->x1,
+                       f->y1,
+                       (int) lx,
+                       (int) ty,
+                       (int) rx,
+                       (int) by);
+        }
+    }
+}
+
+static void check_clipped_image(CFBD_Bool fast_path)
+{
+    static HostPanel panel, before;
+    host_bind(&panel, CFBD_CANVAS_1BPP_PAGE, fast_path);
+    host_bind(&before, CFBD_CANVAS_1BPP_PAGE, CFBD_TRUE);
+
+    for (int round = 0; round < 1000; round++) {
+        randomize(&panel, &before);
+        CFBDGraphic_Point at = {host_random(HOST_WIDTH), host_random(HOST_HEIGHT)};
+        CFBDGraphicSize size = {BITMAP_WIDTH, BITMAP_HEIGHT};
+        // 视口右下角不含在内
+        CFBDGraphicRect viewport = {{host_random(HOST_WIDTH), host_random(HOST_HEIGHT)}, {0, 0}};
+        viewport.br.x = viewport.tl.x + host_random(HOST_WIDTH + 1 - viewport.tl.x);
+        viewport.br.y = viewport.tl.y + host_random(HOST_HEIGHT + 1 - viewport.tl.y);
+
+        CCGraphic_Image image;
+        CFBDGraphic_InitImage(&image, &at, &size, bitmap);
+        CFBDGraphic_DrawImageClipped(&panel.device, &image, &viewport);
+
+        CFBD_Bool same = CFBD_TRUE;
+        for (int32_t py = 0; py < HOST_HEIGHT; py++) {
+            for (int32_t px = 0; px < HOST_WIDTH; px++) {
+                CFBD_Bool expected = host_pixel(&before, px, py);
+                if (px >= at.x && px < at.x + BITMAP_WIDTH && py >= at.y &&
+                    py < at.y + BITMAP_HEIGHT && px >= viewport.tl.x && px < viewport.br.x &&
+                    py >= viewport.tl.y && py < viewport.br.y)
+                    expected = bitmap_ink(px - at.x, py - at.y);
+                if (host_pixel(&panel, px, py) != expected)
+                    same = CFBD_FALSE;
+            }
+        }
+        HOST_CHECK(same,
+                   "round %d: image at (%d,%d) in (%d,%d)-(%d,%d) (fast path %d) differs",
+                   round,
+                   at.x,
+                   at.y,
+                   viewport.tl.x,
+                   viewport.tl.y,
+                   viewport.br.x,
+                   viewport.br.y,
+                   fast_path);
+    }
+}
+
+int main(void)
+{
+    for (int fast_path = 0; fast_path < 2; fast_path++) {
+        check_blit_ops(fast_path);
+        check_clipped_image(fast_path);
+    }
+    return host_report("blit");
+}
@@ -0,0 +1,235 @@
+/*
+    Offscreen canvases: shapes drawn into a memory canvas and composed onto
+    the panel at an offset light the same pixels as the shifted shapes drawn
+    on the panel inside the canvas window. Random 1bpp and 4bpp canvases
+    composed at random, possibly negative, offsets follow a per-pixel
+    reference of the raster ops, and an immediate device is flushed once
+    with the visible rectangle.
+*/
+#include <string.h>
+
+#include "base/circle.h"
+#include "base/line.h"
+#include "base/rectangle.h"
+#include "device/graphic_clip.h"
+#include "host_test.h"
+
+#define CANVAS_MAX_WIDTH (72)
+#define CANVAS_MAX_HEIGHT (48)
+#define PANEL_STRIDE_4BPP ((HOST_WIDTH + 1) / 2)
+
+static uint8_t canvas_pixels[CFBDGraphic_MEMORY_CANVAS_4BPP_BYTES(CANVAS_MAX_WIDTH,
+                                                                  CANVAS_MAX_HEIGHT)];
+
+static uint8_t nibble(const uint8_t* buffer, uint16_t stride, int32_t x, int32_t y)
+{
+    const uint8_t byte = buffer[y * stride + x / 2];
+    return (x & 1) ? (byte & 0x0F) : (byte >> 4);
+}
+
+static CFBD_Bool canvas_bit(const CFBDGraphic_MemoryCanvas* canvas, int32_t x, int32_t y)
+{
+    return (canvas->buffer[(y / 8) * canvas->width + x] >> (y & 7)) & 0x01;
+}
+
+/* 4bpp sources: SET writes non-zero pixels, CLEAR blanks under them, XOR toggles levels */
+static uint8_t reference_4bpp(CFBDGraphic_RasterOp rop, uint8_t under, uint8_t ink)
+{
+    switch (rop) {
+        case CFBD_ROP_COPY:
+            return ink;
+        case CFBD_ROP_SET:
+            return ink ? ink : under;
+        case CFBD_ROP_CLEAR:
+            return ink ? 0 : under;
+        default:
+            return under ^ ink;
+    }
+}
+
+static void
+draw_shape(CFBD_GraphicDevice* device, int shape, CFBDGraphic_Point a, CFBDGraphic_Point b)
+{
+    CFBDGraphic_Line line = {a, b};
+    CFBDGraphicRect rect = rect_normalize((CFBDGraphicRect) {a, b});
+    // 半径取两点之差, 平移后不变
+    const PointBaseType radius = (b.x > a.x ? b.x - a.x : a.x - b.x) % 16;
+    CFBDGraphicCircle circle = {.radius = radius, .center = a};
+    switch (shape) {
+        case 0:
+            CFBDGraphic_DrawLine(device, &line);
+            break;
+        case 1:
+            CFBDGraphic_DrawRect(device, &rect);
+            break;
+        case 2:
+            CFBDGraphic_FillRect(device, &rect);
+            break;
+        default:
+            CFBDGraphic_DrawCircle(device, &circle);
+            break;
+    }
+}
+
+static void check_offscreen_drawing(CFBDGraphic_CanvasFormat format)
+{
+    static HostPanel panel, direct;
+    host_bind(&panel, format, CFBD_TRUE);
+    host_bind(&direct, format, CFBD_TRUE);
+
+    for (int round = 0; round < 1000; round++) {
+        CFBDGraphic_MemoryCanvas canvas = {.buffer = canvas_pixels,
+                                           .width = 8 + host_random(CANVAS_MAX_WIDTH - 8),
+                                           .height = 8 + host_random(CANVAS_MAX_HEIGHT - 8),
+                                           .origin_y = 0,
+                                           .format = format};
+        CFBD_GraphicDevice offscreen;
+        CFBDGraphic_BindMemoryAsDevice(&offscreen, &canvas);
+        offscreen.ops->clear(&offscreen);
+        // 两边使用同样的绘制状态
+        CFBDGraphic_DeviceSetClearBeforeDraw(&direct.device,
+                                             CFBDGraphic_DeviceGetClearBeforeDraw(&offscreen));
+        host_clear(&panel);
+        host_clear(&direct);
+
+        // 面板上的平移图形限制在画布窗口内
+        const uint16_t dx = host_random(HOST_WIDTH), dy = host_random(HOST_HEIGHT);
+        const CFBDGraphicRect window = {{dx, dy}, {dx + canvas.width - 1, dy + canvas.height - 1}};
+        CFBDGraphic_PushClip(&direct.device, &window);
+        for (int i = 0; i < 6; i++) {
+            const int shape = host_random(4);
+            const CFBDGraphic_Point a = {host_random(canvas.width), host_random(canvas.height)};
+            const CFBDGraphic_Point b = {host_random(canvas.width), host_random(canvas.height)};
+            draw_shape(&offscreen, shape, a, b);
+            draw_shape(&direct.device,
+                       shape,
+                       (CFBDGraphic_Point) {a.x + dx, a.y + dy},
+                       (CFBDGraphic_Point) {b.x + dx, b.y + dy});
+        }
+        CFBDGraphic_PopClip(&direct.device);
+
+        CFBDGraphic_DrawMemoryCanvas(&panel.device, &canvas, dx, dy, CFBD_ROP_COPY);
+        HOST_CHECK(host_same_pixels(&panel, &direct),
+                   "round %d: %dx%d canvas at (%d,%d) format %d differs from the direct draw",
+                   round,
+                   canvas.width,
+                   canvas.height,
+                   dx,
+                   dy,
+                   format);
+    }
+}
+
+static void check_compose(CFBDGraphic_CanvasFormat format)
+{
+    static HostPanel panel, before;
+    host_bind(&panel, format, CFBD_TRUE);
+    host_bind(&before, format, CFBD_TRUE);
+    host_count_flushes(&panel);
+
+    for (int round = 0; round < 3000; round++) {
+        CFBDGraphic_MemoryCanvas canvas = {.buffer = canvas_pixels,
+                                           .width = 1 + host_random(CANVAS_MAX_WIDTH),
+                                           .height = 1 + host_random(CANVAS_MAX_HEIGHT),
+                                           .origin_y = 0,
+                                           .format = format};
+        for (size_t i = 0; i < sizeof(canvas_pixels); i++)
+            canvas_pixels[i] = (uint8_t) host_random(256);
+        for (size_t i = 0; i < sizeof(panel.pixels); i++)
+            panel.pixels[i] = (uint8_t) host_random(256);
+        memcpy(before.pixels, panel.pixels, sizeof(panel.pixels));
+
+        // 偏移可为负, 也可超出屏幕
+        const int16_t x = (int16_t) host_random(HOST_WIDTH + CANVAS_MAX_WIDTH) - CANVAS_MAX_WIDTH;
+        const int16_t y =
+                (int16_t) host_random(HOST_HEIGHT + CANVAS_MAX_HEIGHT) - CANVAS_MAX_HEIGHT;
+        const CFBDGraphic_RasterOp rop = (CFBDGraphic_RasterOp) host_random(4);
+        host_flushes = 0;
+        const CFBD_Bool drawn = CFBDGraphic_DrawMemoryCanvas(&panel.device, &canvas, x, y, rop);
+
+        CFBD_Bool same = CFBD_TRUE;
+        int32_t lx = INT32_MAX, ty = INT32_MAX, rx = INT32_MIN, by = INT32_MIN;
+        for (int32_t py = 0; py < HOST_HEIGHT; py++) {
+            for (int32_t px = 0; px < HOST_WIDTH; px++) {
+                const int32_t cx = px - x, cy = py - y;
+                const CFBD_Bool covered =
+                        cx >= 0 && cy >= 0 && cx < canvas.width && cy < canvas.height;
+                if (covered) {
+                    lx = (px < lx) ? px : lx;
+                    ty = (py < ty) ? py : ty;
+                    rx = (px > rx) ? px : rx;
+                    by = (py > by) ? py : by;
+                }
+                if (format == CFBD_CANVAS_4BPP_PACKED) {
+                    const uint8_t under = nibble(before.pixels, PANEL_STRIDE_4BPP, px, py);
+                    const uint8_t expected =
+                            covered ? reference_4bpp(rop,
+                                                     under,
+                                                     nibble(canvas_pixels,
+                                                            (canvas.width + 1) / 2,
+                                                            cx,
+                                                            cy))
+                                    : under;
+                    if (nibble(panel.pixels, PANEL_STRIDE_4BPP, px, py) != expected)
+                        same = CFBD_FALSE;
+                }
+                else {
+                    const CFBD_Bool under = host_pixel(&before, px, py);
+                    const CFBD_Bool expected =
+                            covered ? host_raster_op(rop, under, canvas_bit(&canvas, cx, cy))
+                                    : under;
+                    if (host_pixel(&panel, px, py) != expected)
+                        same = CFBD_FALSE;
+                }
+            }
+        }
+        HOST_CHECK(same,
+                   "round %d: %dx%d canvas at (%d,%d) rop %d format %d composed wrong",
+                   round,
+                   canvas.width,
+                   canvas.height,
+                   x,
+                   y,
+                   rop,
+                   format);
+
+        const CFBDGraphic_ClipBounds* f = &host_last_flush;
+        if (lx > rx) {
+            HOST_CHECK(!drawn && host_flushes == 0, "round %d: invisible canvas flushed", round);
+        }
+        else {
+            HOST_CHECK(drawn && host_flushes == 1 && f->x0 == lx && f->y0 == ty && f->x1 == rx &&
+                               f->y1 == by,
+                       "round %d: %u flushes, last (%d,%d)-(%d,%d)",
+                       round,
+                       host_flushes,
+                       f->x0,
+                       f->y0,
+                       f->x1,
+                       f->y1);
+        }
+    }
+}
+
+static void check_format_mismatch(void)
+{
+    static HostPanel panel;
+    host_bind(&panel, CFBD_CANVAS_1BPP_PAGE, CFBD_TRUE);
+    CFBDGraphic_MemoryCanvas grey = {.buffer = canvas_pixels,
+                                     .width = 16,
+                                     .height = 16,
+                                     .origin_y = 0,
+                                     .format = CFBD_CANVAS_4BPP_PACKED};
+    HOST_CHECK(!CFBDGraphic_DrawMemoryCanvas(&panel.device, &grey, 0, 0, CFBD_ROP_COPY),
+               "4bpp canvas composed onto a 1bpp panel");
+}
+
+int main(void)
+{
+    check_offscreen_drawing(CFBD_CANVAS_1BPP_PAGE);
+    check_offscreen_drawing(CFBD_CANVAS_4BPP_PACKED);
+    check_compose(CFBD_CANVAS_1BPP_PAGE);
+    check_compose(CFBD_CANVAS_4BPP_PACKED);
+    check_format_mismatch();
+    return host_report("canvas_compose");
+}
@@ -0,0 +1,172 @@
+/*
+    Clipped lines and circles. A clipped line must light exactly the pixels
+    of the unclipped Bresenham walk that fall inside the clip, whatever part
+    of the walk is hidden; circles and arcs drawn under a clip must match
+    the unclipped shape cut to the clip.
+*/
+#include "base/arc.h"
+#include "base/circle.h"
+#include "base/line.h"
+#include "device/graphic_canvas.h"
+#include "device/graphic_clip.h"
+#include "host_test.h"
+
+typedef struct
+{
+    int32_t x0, y0, x1, y1; // inclusive
+} Window;
+
+static CFBD_Bool in_window(const Window* w, int32_t x, int32_t y)
+{
+    return x >= w->x0 && x <= w->x1 && y >= w->y0 && y <= w->y1 && x < HOST_WIDTH &&
+           y < HOST_HEIGHT;
+}
+
+/* Reference: the whole walk, one bounds test per pixel */
+static void reference_line(HostPanel* panel, const CFBDGraphic_Line* line, const Window* clip)
+{
+    int32_t x = line->p_left.x, y = line->p_left.y;
+    const int32_t x1 = line->p_right.x, y1 = line->p_right.y;
+    const int32_t dx = x1 > x ? x1 - x : x - x1;
+    const int32_t dy = -(y1 > y ? y1 - y : y - y1);
+    const int32_t sx = x < x1 ? 1 : -1, sy = y < y1 ? 1 : -1;
+    int32_t err = dx + dy;
+    for (;;) {
+        if (in_window(clip, x, y))
+            panel->device.ops->setPixel(&panel->device, (uint16_t) x, (uint16_t) y);
+        if (x == x1 && y == y1)
+            break;
+        const int32_t e2 = 2 * err;
+        if (e2 >= dy) {
+            err += dy;
+            x += sx;
+        }
+        if (e2 <= dx) {
+            err += dx;
+            y += sy;
+        }
+    }
+}
+
+static Window random_clip(CFBDGraphicRect* rect)
+{
+    Window w;
+    w.x0 = host_random(HOST_WIDTH);
+    w.y0 = host_random(HOST_HEIGHT);
+    w.x1 = w.x0 + host_random(HOST_WIDTH - w.x0);
+    w.y1 = w.y0 + host_random(HOST_HEIGHT - w.y0);
+    if (host_random(8) == 0)
+        w.x1 = w.x0; // one column
+    *rect = (CFBDGraphicRect) {{w.x0, w.y0}, {w.x1, w.y1}};
+    return w;
+}
+
+static void check_lines(CFBDGraphic_CanvasFormat format, CFBD_Bool fast_path)
+{
+    static HostPanel drawn, expected;
+    host_bind(&drawn, format, fast_path);
+    host_bind(&expected, CFBD_CANVAS_1BPP_PAGE, CFBD_TRUE);
+
+    for (int round = 0; round < 20000; round++) {
+        // end points well outside the panel on every side
+        CFBDGraphic_Line line = {{host_random(3 * HOST_WIDTH), host_random(3 * HOST_HEIGHT)},
+                                 {host_random(3 * HOST_WIDTH), host_random(3 * HOST_HEIGHT)}};
+        if (host_random(4) == 0) {
+            line.p_left.x %= HOST_WIDTH;
+            line.p_left.y %= HOST_HEIGHT;
+        }
+        CFBDGraphicRect rect;
+        const Window clip = random_clip(&rect);
+
+        host_clear(&drawn);
+        host_clear(&expected);
+        CFBDGraphic_PushClip(&drawn.device, &rect);
+        CFBDGraphic_DrawLine(&drawn.device, &line);
+        CFBDGraphic_PopClip(&drawn.device);
+        reference_line(&expected, &line, &clip);
+
+        HOST_CHECK(host_same_pixels(&drawn, &expected),
+                   "line (%d,%d)-(%d,%d) clip (%d,%d)-(%d,%d) format %d fast path %d",
+                   line.p_left.x,
+                   line.p_left.y,
+                   line.p_right.x,
+                   line.p_right.y,
+                   (int) clip.x0,
+                   (int) clip.y0,
+                   (int) clip.x1,
+                   (int) clip.y1,
+                   format,
+                   fast_path);
+    }
+}
+
+/* Shapes drawn under the clip against the unclipped shape cut to the clip */
+static void check_round_shapes(CFBDGraphic_CanvasFormat format, CFBD_Bool fast_path)
+{
+    static HostPanel clipped, whole;
+    host_bind(&clipped, format, fast_path);
+    host_bind(&whole, format, fast_path);
+
+    for (int round = 0; round < 4000; round++) {
+        const CFBDGraphic_Point center = {host_random(HOST_WIDTH + 32),
+                                          host_random(HOST_HEIGHT + 32)};
+        CFBDGraphicCircle circle = {.radius = host_random(48), .center = center};
+        CFBD_GraphicArc arc = {center, host_random(48), host_random(360), host_random(360)};
+        const int shape = round % 4;
+        CFBDGraphicRect rect;
+        const Window clip = random_clip(&rect);
+
+        host_clear(&clipped);
+        host_clear(&whole);
+        CFBDGraphic_PushClip(&clipped.device, &rect);
+        for (int pass = 0; pass < 2; pass++) {
+            CFBD_GraphicDevice* device = pass ? &whole.device : &clipped.device;
+            switch (shape) {
+                case 0:
+                    CFBDGraphic_DrawCircle(device, &circle);
+                    break;
+                case 1:
+                    CFBDGraphic_DrawFilledCircle(device, &circle);
+                    break;
+                case 2:
+                    CFBDGraphic_DrawArc(device, &arc);
+                    break;
+                default:
+                    CFBDGraphic_DrawFilledArc(device, &arc);
+                    break;
+            }
+        }
+        CFBDGraphic_PopClip(&clipped.device);
+
+        CFBD_Bool same = CFBD_TRUE;
+        for (int32_t y = 0; y < HOST_HEIGHT; y++) {
+            for (int32_t x = 0; x < HOST_WIDTH; x++) {
+                const CFBD_Bool visible = in_window(&clip, x, y) && host_pixel(&whole, x, y);
+                if (host_pixel(&clipped, x, y) != visible)
+                    same = CFBD_FALSE;
+            }
+        }
+        HOST_CHECK(same,
+                   "shape %d at (%d,%d) clip (%d,%d)-(%d,%d) format %d fast path %d",
+                   shape,
+                   center.x,
+                   center.y,
+                   (int) clip.x0,
+                   (int) clip.y0,
+                   (int) clip.x1,
+                   (int) clip.y1,
+                   format,
+                   fast_path);
+    }
+}
+
+int main(void)
+{
+    for (int fast_path = 0; fast_path < 2; fast_path++) {
+        check_lines(CFBD_CANVAS_1BPP_PAGE, fast_path);
+        check_round_shapes(CFBD_CANVAS_1BPP_PAGE, fast_path);
+    }
+    check_lines(CFBD_CANVAS_4BPP_PACKED, CFBD_TRUE);
+    check_round_shapes(CFBD_CANVAS_4BPP_PACKED, CFBD_TRUE);
+    return host_report("clip_line");
+}
@@ -0,0 +1,160 @@
+/*
+    Display lists: replaying a recorded list must light the same pixels as
+    the direct draw calls, a replay limited to a region the same pixels as
+    the direct calls inside it and none outside, a region missing every command draws
+    nothing, and an immediate device is flushed once per replay. A baked
+    list drawn as one image matches the direct calls as well.
+*/
+#include <string.h>
+
+#include "base/circle.h"
+#include "base/line.h"
+#include "base/rectangle.h"
+#include "display_list/display_list.h"
+#include "host_test.h"
+#include "widget/text.h"
+
+#define COMMANDS (12)
+
+static uint8_t storage[1024];
+static CFBDGraphic_DisplayList list;
+
+/* Record one random command and draw it directly, left of x = 64 */
+static void record_and_draw(CFBD_GraphicDevice* direct)
+{
+    const CFBDGraphic_Point a = {host_random(56), host_random(HOST_HEIGHT)};
+    const CFBDGraphic_Point b = {host_random(56), host_random(HOST_HEIGHT)};
+    CFBDGraphic_Line line = {a, b};
+    CFBDGraphicRect rect = rect_normalize((CFBDGraphicRect) {a, b});
+    CFBDGraphicCircle circle = {.radius = host_random(8), .center = {8 + a.x / 2, 8 + a.y / 2}};
+
+    switch (host_random(6)) {
+        case 0:
+            CFBDGraphic_DisplayListLine(&list, &line);
+            CFBDGraphic_DrawLine(direct, &line);
+            break;
+        case 1:
+            CFBDGraphic_DisplayListRect(&list, &rect);
+            CFBDGraphic_DrawRect(direct, &rect);
+            break;
+        case 2:
+            CFBDGraphic_DisplayListFillRect(&list, &rect);
+            CFBDGraphic_FillRect(direct, &rect);
+            break;
+        case 3:
+            CFBDGraphic_DisplayListCircle(&list, &circle);
+            CFBDGraphic_DrawCircle(direct, &circle);
+            break;
+        case 4:
+            CFBDGraphic_DisplayListFilledCircle(&list, &circle);
+            CFBDGraphic_DrawFilledCircle(direct, &circle);
+            break;
+        default: {
+            static char label[] = "Menu 7";
+            CFBDGraphic_Text text;
+            CFBDGraphicSize area = {6 * 6, 8};
+            CFBDGraphic_DisplayListText(&list, &a, label, ASCII_6x8);
+            CFBDGraphic_InitText(&text, a, area, ASCII_6x8);
+            text.no_wrap = CFBD_TRUE;
+            CFBDGraphic_SetText(&text, label);
+            CFBDGraphic_DrawText(direct, &text, CCGraphic_AsciiTextItem_AppendContinously);
+        } break;
+    }
+}
+
+static void check_replay(void)
+{
+    static HostPanel direct, replayed;
+    host_bind(&direct, CFBD_CANVAS_1BPP_PAGE, CFBD_TRUE);
+    host_bind(&replayed, CFBD_CANVAS_1BPP_PAGE, CFBD_TRUE);
+    CFBDGraphic_DeviceSetClearBeforeDraw(&direct.device, CFBD_TRUE);
+    CFBDGraphic_DeviceSetClearBeforeDraw(&replayed.device, CFBD_TRUE);
+
+    host_count_flushes(&replayed);
+
+    for (int round = 0; round < 600; round++) {
+        CFBDGraphic_DisplayListInit(&list, storage, sizeof(storage));
+        host_clear(&direct);
+        for (int i = 0; i < COMMANDS; i++)
+            record_and_draw(&direct.device);
+        HOST_CHECK(!list.overflow && list.count == COMMANDS, "round %d: list overflowed", round);
+
+        host_clear(&replayed);
+        CFBDGraphic_DeviceSetIfRequestUpdateAtOnce(&replayed.device, CFBD_TRUE);
+        host_flushes = 0;
+        const uint16_t drawn = CFBDGraphic_DisplayListReplay(&replayed.device, &list, NULL);
+        HOST_CHECK(drawn == COMMANDS, "round %d: %d of %d commands drawn", round, drawn, COMMANDS);
+        HOST_CHECK(host_flushes == 1,
+                   "round %d: whole replay flushed %u times",
+                   round,
+                   host_flushes);
+        HOST_CHECK(host_same_pixels(&direct, &replayed), "round %d: replay differs", round);
+
+        // 区域内与直接绘制一致, 区域外不绘制
+        CFBDGraphicRect region = {{host_random(64), host_random(HOST_HEIGHT)}, {0, 0}};
+        region.br.x = region.tl.x + host_random(64);
+        region.br.y = region.tl.y + host_random(HOST_HEIGHT - region.tl.y);
+        host_clear(&replayed);
+        CFBDGraphic_DeviceSetIfRequestUpdateAtOnce(&replayed.device, CFBD_FALSE);
+        CFBDGraphic_DisplayListReplay(&replayed.device, &list, &region);
+
+        CFBD_Bool same = CFBD_TRUE;
+        for (int32_t y = 0; y < HOST_HEIGHT; y++) {
+            for (int32_t x = 0; x < HOST_WIDTH; x++) {
+                const CFBD_Bool inside = x >= region.tl.x && x <= region.br.x &&
+                                         y >= region.tl.y && y <= region.br.y;
+                if (host_pixel(&replayed, x, y) != (inside && host_pixel(&direct, x, y)))
+                    same = CFBD_FALSE;
+            }
+        }
+        HOST_CHECK(same,
+                   "round %d: region (%d,%d)-(%d,%d) differs from the direct draw",
+                   round,
+                   region.tl.x,
+                   region.tl.y,
+                   region.br.x,
+                   region.br.y);
+
+        // 完全在内容右侧的区域: 不绘制任何命令
+        CFBDGraphicRect empty = {{100, 0}, {HOST_WIDTH - 1, HOST_HEIGHT - 1}};
+        host_clear(&replayed);
+        HOST_CHECK(CFBDGraphic_DisplayListReplay(&replayed.device, &list, &empty) == 0,
+                   "round %d: commands left of the region were not culled",
+                   round);
+    }
+}
+
+static void check_bake(void)
+{
+    static HostPanel direct, panel;
+    static uint8_t baked_pixels[CFBDGraphic_MEMORY_CANVAS_BYTES(HOST_WIDTH, HOST_HEIGHT)];
+    host_bind(&direct, CFBD_CANVAS_1BPP_PAGE, CFBD_TRUE);
+    host_bind(&panel, CFBD_CANVAS_1BPP_PAGE, CFBD_TRUE);
+    CFBDGraphic_DeviceSetClearBeforeDraw(&direct.device, CFBD_TRUE);
+
+    for (int round = 0; round < 300; round++) {
+        CFBDGraphic_DisplayListInit(&list, storage, sizeof(storage));
+        host_clear(&direct);
+        for (int i = 0; i < COMMANDS; i++)
+            record_and_draw(&direct.device);
+
+        CFBDGraphic_MemoryCanvas canvas = {.buffer = baked_pixels,
+                                           .width = HOST_WIDTH,
+                                           .height = HOST_HEIGHT,
+                                           .origin_y = 0,
+                                           .format = CFBD_CANVAS_1BPP_PAGE};
+        CCGraphic_Image image;
+        HOST_CHECK(CFBDGraphic_DisplayListBake(&list, &canvas, &image), "round %d: bake", round);
+
+        host_clear(&panel);
+        CFBDGraphic_DrawImage(&panel.device, &image);
+        HOST_CHECK(host_same_pixels(&direct, &panel), "round %d: baked image differs", round);
+    }
+}
+
+int main(void)
+{
+    check_replay();
+    check_bake();
+    return host_report("display_list");
+}
@@ -0,0 +1,69 @@
+/*
+    Canvas fast path: lines and circles written straight into the frame
+    buffer must light the same pixels as the setPixel() fallback, for the
+    1bpp page and 4bpp packed layouts, with end points and centers well
+    outside the panel.
+*/
+#include "base/circle.h"
+#include "base/line.h"
+#include "host_test.h"
+
+static void draw_shape(CFBD_GraphicDevice* device,
+                       int shape,
+                       CFBDGraphic_Point a,
+                       CFBDGraphic_Point b,
+                       PointBaseType radius)
+{
+    CFBDGraphic_Line line = {a, b};
+    CFBDGraphicCircle circle = {.radius = radius, .center = a};
+    switch (shape) {
+        case 0:
+            CFBDGraphic_DrawLine(device, &line);
+            break;
+        case 1:
+            CFBDGraphic_DrawCircle(device, &circle);
+            break;
+        default:
+            CFBDGraphic_DrawFilledCircle(device, &circle);
+            break;
+    }
+}
+
+static void check_format(CFBDGraphic_CanvasFormat format)
+{
+    static HostPanel fast, slow;
+    host_bind(&fast, format, CFBD_TRUE);
+    host_bind(&slow, format, CFBD_FALSE);
+
+    for (int round = 0; round < 6000; round++) {
+        const int shape = round % 3;
+        CFBDGraphic_Point a = {host_random(2 * HOST_WIDTH), host_random(2 * HOST_HEIGHT)};
+        CFBDGraphic_Point b = {host_random(2 * HOST_WIDTH), host_random(2 * HOST_HEIGHT)};
+        if (round % 5 == 0)
+            b.y = a.y; // horizontal spans
+        else if (round % 5 == 1)
+            b.x = a.x; // vertical spans
+        const PointBaseType radius = host_random(64);
+
+        host_clear(&fast);
+        host_clear(&slow);
+        draw_shape(&fast.device, shape, a, b, radius);
+        draw_shape(&slow.device, shape, a, b, radius);
+        HOST_CHECK(host_same_pixels(&fast, &slow),
+                   "shape %d (%d,%d)-(%d,%d) r %d format %d: fast path differs",
+                   shape,
+                   a.x,
+                   a.y,
+                   b.x,
+                   b.y,
+                   radius,
+                   format);
+    }
+}
+
+int main(void)
+{
+    check_format(CFBD_CANVAS_1BPP_PAGE);
+    check_format(CFBD_CANVAS_4BPP_PACKED);
+    return host_report("fast_path");
+}
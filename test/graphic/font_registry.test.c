@@ -0,0 +1,246 @@
+/*
+    Font registry: dense fonts index glyph code - first, sparse fonts find
+    every listed code point by binary search, anything else resolves to the
+    fallback glyph. UTF-8 strings decode to the code points they encode and
+    a registered font draws through DrawText like a built-in one.
+*/
+#include <string.h>
+
+#include "host_test.h"
+#include "widget/text.h"
+#include "widget/text_font.h"
+
+#define DENSE_FIRST (0x100)
+#define DENSE_GLYPHS (96)
+#define SPARSE_GLYPHS (300)
+
+static uint8_t dense_glyphs[DENSE_GLYPHS][8];
+static uint8_t sparse_glyphs[SPARSE_GLYPHS][32];
+static CFBDGraphic_FontIndexEntry sparse_index[SPARSE_GLYPHS];
+
+static CFBD_Bool indexed(uint32_t code)
+{
+    for (int i = 0; i < SPARSE_GLYPHS; i++) {
+        if (sparse_index[i].code == code)
+            return CFBD_TRUE;
+    }
+    return CFBD_FALSE;
+}
+
+/* Sorted random CJK code points, glyph numbers shuffled */
+static void build_sparse_index(void)
+{
+    uint32_t code = 0x4E00;
+    for (int i = 0; i < SPARSE_GLYPHS; i++) {
+        code += 1 + host_random(60);
+        sparse_index[i].code = code;
+        sparse_index[i].glyph = (uint16_t) ((i * 7) % SPARSE_GLYPHS);
+    }
+    for (int g = 0; g < SPARSE_GLYPHS; g++) {
+        for (int b = 0; b < 32; b++)
+            sparse_glyphs[g][b] = (uint8_t) host_random(256);
+    }
+}
+
+static void check_dense(void)
+{
+    for (int g = 0; g < DENSE_GLYPHS; g++)
+        memset(dense_glyphs[g], g + 1, sizeof(dense_glyphs[g]));
+    static const CFBDGraphic_Font dense = {.width = 8,
+                                           .height = 8,
+                                           .glyph_bytes = 8,
+                                           .first = DENSE_FIRST,
+                                           .last = DENSE_FIRST + DENSE_GLYPHS - 1,
+                                           .glyphs = dense_glyphs[0],
+                                           .fallback = DENSE_FIRST + 5};
+
+    const Ascii_Font_Size id = CFBDGraphic_RegisterFont(&dense);
+    HOST_CHECK(id != NO_ASCII_SIZE, "dense font rejected");
+    HOST_CHECK(CFBDGraphic_RegisterFont(&dense) == id, "same font registered twice");
+    HOST_CHECK(CFBDGraphic_FetchFont(id) == &dense, "id %d does not name the dense font", id);
+
+    for (uint32_t code = 0; code < 0x400; code++) {
+        const CFBD_Bool covered = code >= DENSE_FIRST && code < DENSE_FIRST + DENSE_GLYPHS;
+        const uint8_t* expected = dense_glyphs[covered ? code - DENSE_FIRST : 5];
+        HOST_CHECK(CFBDGraphic_FontGlyph(&dense, code) == expected,
+                   "dense U+%04X: wrong glyph",
+                   (unsigned) code);
+    }
+}
+
+static void check_sparse(void)
+{
+    build_sparse_index();
+    static CFBDGraphic_Font sparse = {.width = 16,
+                                      .height = 16,
+                                      .glyph_bytes = 32,
+                                      .glyphs = sparse_glyphs[0],
+                                      .index = sparse_index,
+                                      .index_count = SPARSE_GLYPHS};
+    sparse.fallback = sparse_index[0].code;
+
+    HOST_CHECK(CFBDGraphic_RegisterFont(&sparse) != NO_ASCII_SIZE, "sparse font rejected");
+    for (int i = 0; i < SPARSE_GLYPHS; i++) {
+        HOST_CHECK(CFBDGraphic_FontGlyph(&sparse, sparse_index[i].code) ==
+                           sparse_glyphs[sparse_index[i].glyph],
+                   "sparse U+%04X: wrong glyph",
+                   (unsigned) sparse_index[i].code);
+    }
+
+    const uint8_t* fallback = sparse_glyphs[sparse_index[0].glyph];
+    for (uint32_t code = 0; code < 0xA000; code += 1 + host_random(8)) {
+        if (!indexed(code))
+            HOST_CHECK(CFBDGraphic_FontGlyph(&sparse, code) == fallback,
+                       "sparse U+%04X: missing code point not on the fallback",
+                       (unsigned) code);
+    }
+
+    // 回退字形也不存在时返回 NULL
+    sparse.fallback = 0x20;
+    HOST_CHECK(CFBDGraphic_FontGlyph(&sparse, 0x41) == NULL, "missing fallback returned a glyph");
+    sparse.fallback = sparse_index[0].code;
+}
+
+static void check_registry_limits(void)
+{
+    static const uint8_t glyph[6];
+    static CFBDGraphic_Font fonts[CFBD_FONT_REGISTRY_CAPACITY];
+    const CFBDGraphic_Font empty = {.width = 6, .height = 8, .glyph_bytes = 6};
+    const CFBDGraphic_Font too_big = {.width = 32,
+                                      .height = 16,
+                                      .glyph_bytes = 64,
+                                      .glyphs = glyph,
+                                      .blocks = (const uint16_t*) glyph,
+                                      .block_glyphs = 1};
+    HOST_CHECK(CFBDGraphic_RegisterFont(NULL) == NO_ASCII_SIZE, "NULL font accepted");
+    HOST_CHECK(CFBDGraphic_RegisterFont(&empty) == NO_ASCII_SIZE, "font without glyphs accepted");
+    HOST_CHECK(CFBDGraphic_RegisterFont(&too_big) == NO_ASCII_SIZE,
+               "compressed glyphs larger than a cache slot accepted");
+
+    int registered = 0;
+    for (int i = 0; i < CFBD_FONT_REGISTRY_CAPACITY; i++) {
+        fonts[i] = (CFBDGraphic_Font) {.width = 6, .height = 8, .glyph_bytes = 6, .glyphs = glyph};
+        if (CFBDGraphic_RegisterFont(&fonts[i]) != NO_ASCII_SIZE)
+            registered++;
+    }
+    HOST_CHECK(registered < CFBD_FONT_REGISTRY_CAPACITY, "registry never fills up");
+    HOST_CHECK(CFBDGraphic_FetchFont(NO_ASCII_SIZE) == NULL, "the sentinel names a font");
+    HOST_CHECK(CFBDGraphic_FetchFont((Ascii_Font_Size) CFBD_FONT_REGISTRY_CAPACITY) == NULL,
+               "id past the registry names a font");
+}
+
+static int encode_utf8(uint32_t code, char* out)
+{
+    if (code < 0x80) {
+        out[0] = (char) code;
+        return 1;
+    }
+    if (code < 0x800) {
+        out[0] = (char) (0xC0 | (code >> 6));
+        out[1] = (char) (0x80 | (code & 0x3F));
+        return 2;
+    }
+    if (code < 0x10000) {
+        out[0] = (char) (0xE0 | (code >> 12));
+        out[1] = (char) (0x80 | ((code >> 6) & 0x3F));
+        out[2] = (char) (0x80 | (code & 0x3F));
+        return 3;
+    }
+    out[0] = (char) (0xF0 | (code >> 18));
+    out[1] = (char) (0x80 | ((code >> 12) & 0x3F));
+    out[2] = (char) (0x80 | ((code >> 6) & 0x3F));
+    out[3] = (char) (0x80 | (code & 0x3F));
+    return 4;
+}
+
+static void check_utf8(void)
+{
+    for (int round = 0; round < 2000; round++) {
+        uint32_t codes[16];
+        char text[16 * 4 + 1];
+        int length = 0;
+        for (int i = 0; i < 16; i++) {
+            static const uint32_t limits[] = {0x80, 0x800, 0x10000, 0x110000};
+            codes[i] = 1 + host_random(limits[host_random(4)] - 1);
+            length += encode_utf8(codes[i], &text[length]);
+        }
+        text[length] = '\0';
+
+        const char* cursor = text;
+        for (int i = 0; i < 16; i++) {
+            const uint32_t code = CFBDGraphic_DecodeUTF8(&cursor);
+            HOST_CHECK(code == codes[i], "decoded U+%X, encoded U+%X", code, codes[i]);
+        }
+        HOST_CHECK(CFBDGraphic_DecodeUTF8(&cursor) == 0 && cursor == text + length,
+                   "round %d: decoder did not stop at the terminator",
+                   round);
+    }
+
+    // 非法序列: 解码为 U+FFFD, 只前进一个字节
+    static const char* malformed[] = {"\x80", "\xC3", "\xE4\xB8", "\xFF", "\xF0\x9F\x98"};
+    for (int i = 0; i < 5; i++) {
+        const char* cursor = malformed[i];
+        HOST_CHECK(CFBDGraphic_DecodeUTF8(&cursor) == 0xFFFD && cursor == malformed[i] + 1,
+                   "malformed sequence %d",
+                   i);
+    }
+}
+
+/* A sparse font string drawn through DrawText shows the indexed glyphs */
+static void check_draw(void)
+{
+    static HostPanel panel;
+    host_bind(&panel, CFBD_CANVAS_1BPP_PAGE, CFBD_TRUE);
+    static CFBDGraphic_Font sparse = {.width = 16,
+                                      .height = 16,
+                                      .glyph_bytes = 32,
+                                      .glyphs = sparse_glyphs[0],
+                                      .index = sparse_index,
+                                      .index_count = SPARSE_GLYPHS};
+    const Ascii_Font_Size id = CFBDGraphic_RegisterFont(&sparse);
+    if (id == NO_ASCII_SIZE)
+        return; // registry already full, reported above
+
+    for (int round = 0; round < 200; round++) {
+        uint16_t entries[4];
+        char text[4 * 3 + 1];
+        int length = 0;
+        for (int i = 0; i < 4; i++) {
+            entries[i] = (uint16_t) host_random(SPARSE_GLYPHS);
+            length += encode_utf8(sparse_index[entries[i]].code, &text[length]);
+        }
+        text[length] = '\0';
+
+        CFBDGraphic_Text item;
+        const CFBDGraphic_Point at = {host_random(HOST_WIDTH - 64), host_random(HOST_HEIGHT - 16)};
+        const CFBDGraphicSize area = {HOST_WIDTH, HOST_HEIGHT};
+        CFBDGraphic_InitText(&item, at, area, id);
+        item.no_wrap = CFBD_TRUE;
+        CFBDGraphic_SetText(&item, text);
+        host_clear(&panel);
+        CFBDGraphic_DrawText(&panel.device, &item, CCGraphic_AsciiTextItem_RequestOldPoint);
+
+        CFBD_Bool same = CFBD_TRUE;
+        for (int i = 0; i < 4; i++) {
+            const uint8_t* glyph = sparse_glyphs[sparse_index[entries[i]].glyph];
+            for (int x = 0; x < 16; x++) {
+                for (int y = 0; y < 16; y++) {
+                    const CFBD_Bool ink = (glyph[(y / 8) * 16 + x] >> (y % 8)) & 1;
+                    if (host_pixel(&panel, at.x + 16 * i + x, at.y + y) != ink)
+                        same = CFBD_FALSE;
+                }
+            }
+        }
+        HOST_CHECK(same, "round %d: drawn cells differ from the indexed glyphs", round);
+    }
+}
+
+int main(void)
+{
+    check_dense();
+    check_sparse();
+    check_draw();
+    check_utf8();
+    check_registry_limits();
+    return host_report("font_registry");
+}
@@ -0,0 +1,156 @@
+/*
+    Frame pacer against a fake millisecond tick: frames that start on time,
+    late, end exactly on the next slot or overrun several slots must keep
+    the slot grid of the first frame, count the slots passed over as
+    skipped and the long frames as overruns. The same script runs once
+    from tick 0 and once across the 32 bit tick wrap.
+*/
+#include "host_test.h"
+#include "widget/animation/frame_pacer.h"
+
+#define INTERVAL_MS (10)
+
+static uint32_t fake_now;
+
+static uint32_t fake_tick(void)
+{
+    return fake_now;
+}
+
+/* One frame of the script, times relative to the first frame */
+typedef struct
+{
+    uint32_t begin;    /* tick at which the loop asks for the frame */
+    uint32_t end;      /* tick at which the frame ends */
+    uint32_t next;     /* expected slot of the next frame */
+    uint32_t skipped;  /* expected skipped slots so far */
+    uint32_t overruns; /* expected overruns so far */
+} ScriptFrame;
+
+static const ScriptFrame script[] = {
+        {0, 4, 10, 0, 0},      // first frame fixes the grid
+        {10, 20, 20, 0, 0},    // a whole interval, ends exactly on the next slot
+        {20, 21, 30, 0, 0},    // on time
+        {33, 35, 40, 0, 0},    // starts late, the grid keeps its phase
+        {40, 65, 70, 2, 1},    // overrun, slots 50 and 60 are dropped
+        {70, 90, 90, 3, 2},    // overrun ending exactly on slot 90: only 80 is dropped
+        {90, 91, 100, 3, 2},   // back on time
+        {100, 111, 120, 4, 3}, // one millisecond over, slot 110 is dropped
+};
+
+static void check_script(uint32_t base)
+{
+    CFBD_FramePacer pacer;
+    fake_now = base;
+    CFBD_InitFramePacer(&pacer, fake_tick, INTERVAL_MS);
+    HOST_CHECK(CFBD_FramePacerRemaining(&pacer) == 0, "base %u: first frame not due", base);
+
+    uint32_t previous_next = 0;
+    for (size_t i = 0; i < sizeof(script) / sizeof(script[0]); i++) {
+        const ScriptFrame* f = &script[i];
+        uint32_t now_ms = 0;
+
+        // one tick before its slot the frame must wait
+        if (i > 0 && f->begin == previous_next) {
+            fake_now = base + f->begin - 1;
+            HOST_CHECK(!CFBD_FramePacerBegin(&pacer, NULL) &&
+                               CFBD_FramePacerRemaining(&pacer) == 1,
+                       "base %u frame %u: started a tick early",
+                       base,
+                       (unsigned) i);
+        }
+
+        fake_now = base + f->begin;
+        HOST_CHECK(CFBD_FramePacerBegin(&pacer, &now_ms) && now_ms == base + f->begin,
+                   "base %u frame %u: not started at %u",
+                   base,
+                   (unsigned) i,
+                   f->begin);
+        fake_now = base + f->end;
+        CFBD_FramePacerEnd(&pacer);
+
+        HOST_CHECK(pacer.next_ms - base == f->next && pacer.stats.skipped == f->skipped &&
+                           pacer.stats.overruns == f->overruns &&
+                           pacer.stats.frames == i + 1 &&
+                           pacer.stats.last_ms == f->end - f->begin,
+                   "base %u frame %u: next %u skipped %u overruns %u, expected %u %u %u",
+                   base,
+                   (unsigned) i,
+                   pacer.next_ms - base,
+                   pacer.stats.skipped,
+                   pacer.stats.overruns,
+                   f->next,
+                   f->skipped,
+                   f->overruns);
+        HOST_CHECK(CFBD_FramePacerRemaining(&pacer) == f->next - f->end,
+                   "base %u frame %u: %u ms left",
+                   base,
+                   (unsigned) i,
+                   CFBD_FramePacerRemaining(&pacer));
+        previous_next = f->next;
+    }
+
+    HOST_CHECK(pacer.stats.min_ms == 1 && pacer.stats.max_ms == 25 &&
+                       pacer.stats.total_ms == 4 + 10 + 1 + 2 + 25 + 20 + 1 + 11,
+               "base %u: min %u max %u total %u",
+               base,
+               pacer.stats.min_ms,
+               pacer.stats.max_ms,
+               pacer.stats.total_ms);
+}
+
+/* CFBD_FramePacerRun(): render takes the time of the script, idle sleeps */
+static uint32_t run_base;
+static unsigned run_frames;
+static uint32_t run_starts[16];
+
+static CFBD_Bool run_render(void* user_data, uint32_t now_ms)
+{
+    (void) user_data;
+    static const uint32_t durations[] = {4, 3, 27, 1, 10, 2};
+    run_starts[run_frames] = now_ms - run_base;
+    fake_now += durations[run_frames % 6];
+    return ++run_frames < 6;
+}
+
+static void run_idle(void* user_data, uint32_t remaining_ms)
+{
+    (void) user_data;
+    HOST_CHECK(remaining_ms >= 1 && remaining_ms <= INTERVAL_MS, "idle for %u ms", remaining_ms);
+    fake_now += remaining_ms;
+}
+
+static void check_run(uint32_t base)
+{
+    // 4, 3 on time; 27 drops slots 30 and 40; 1 and 10 on time; 2 on time
+    static const uint32_t starts[] = {0, 10, 20, 50, 60, 70};
+    CFBD_FramePacer pacer;
+    fake_now = run_base = base;
+    run_frames = 0;
+    CFBD_InitFramePacer(&pacer, fake_tick, INTERVAL_MS);
+    CFBD_FramePacerRun(&pacer, run_render, run_idle, NULL);
+
+    HOST_CHECK(run_frames == 6 && pacer.stats.skipped == 2 && pacer.stats.overruns == 1,
+               "base %u: %u frames, %u skipped, %u overruns",
+               base,
+               run_frames,
+               pacer.stats.skipped,
+               pacer.stats.overruns);
+    for (unsigned i = 0; i < run_frames && i < 6; i++) {
+        HOST_CHECK(run_starts[i] == starts[i],
+                   "base %u: frame %u started at %u, expected %u",
+                   base,
+                   i,
+                   run_starts[i],
+                   starts[i]);
+    }
+}
+
+int main(void)
+{
+    check_script(0);
+    check_script(UINT32_MAX - 30); // the tick wraps during the overruns
+    check_run(0);
+    check_run(UINT32_MAX - 15);
+    return host_report("frame_pacer");
+}
@@ -0,0 +1,96 @@
+/*
+    Glyph runs: text blitted straight into the frame buffer must match the
+    setArea() path glyph for glyph, wrapped or not, and an immediate device
+    is flushed once with exactly the cells that were written.
+*/
+#include "host_test.h"
+#include "widget/text.h"
+
+static void random_text(char* text, int length)
+{
+    for (int i = 0; i < length; i++)
+        text[i] = (char) (' ' + host_random(95));
+    text[length] = '\0';
+}
+
+static void draw(HostPanel* panel,
+                 CFBDGraphic_Point at,
+                 CFBDGraphicSize area,
+                 Ascii_Font_Size font,
+                 CFBD_Bool wrap,
+                 char* text)
+{
+    CFBDGraphic_Text item;
+    CFBDGraphic_InitText(&item, at, area, font);
+    item.no_wrap = !wrap;
+    CFBDGraphic_SetText(&item, text);
+    CFBDGraphic_DrawText(&panel->device, &item, CCGraphic_AsciiTextItem_RequestOldPoint);
+}
+
+static void check_paths(CFBDGraphic_CanvasFormat format)
+{
+    static HostPanel fast, slow;
+    host_bind(&fast, format, CFBD_TRUE);
+    host_bind(&slow, format, CFBD_FALSE);
+
+    for (int round = 0; round < 3000; round++) {
+        char text[48];
+        random_text(text, 1 + host_random(40));
+        const Ascii_Font_Size font = (round % 2) ? ASCII_6x8 : ASCII_8x16;
+        const CFBDGraphic_Point at = {host_random(HOST_WIDTH), host_random(HOST_HEIGHT)};
+        const CFBDGraphicSize area = {HOST_WIDTH, HOST_HEIGHT};
+        const CFBD_Bool wrap = host_random(2);
+
+        host_clear(&fast);
+        host_clear(&slow);
+        draw(&fast, at, area, font, wrap, text);
+        draw(&slow, at, area, font, wrap, text);
+        HOST_CHECK(host_same_pixels(&fast, &slow),
+                   "\"%s\" at (%d,%d) font %d wrap %d format %d: blit differs from setArea()",
+                   text,
+                   at.x,
+                   at.y,
+                   font,
+                   wrap,
+                   format);
+    }
+}
+
+static void check_flush(void)
+{
+    static HostPanel panel;
+    host_bind(&panel, CFBD_CANVAS_1BPP_PAGE, CFBD_TRUE);
+    host_count_flushes(&panel);
+
+    for (int round = 0; round < 500; round++) {
+        char text[24];
+        const int length = 1 + host_random(16);
+        random_text(text, length);
+        const CFBDGraphic_Point at = {host_random(24), host_random(48)};
+        const CFBDGraphicSize area = {HOST_WIDTH, HOST_HEIGHT};
+
+        host_flushes = 0;
+        draw(&panel, at, area, ASCII_6x8, CFBD_FALSE, text);
+        const CFBDGraphic_ClipBounds* f = &host_last_flush;
+        HOST_CHECK(host_flushes == 1, "\"%s\": %u flushes", text, host_flushes);
+        HOST_CHECK(f->x0 == at.x && f->y0 == at.y && f->x1 == at.x + 6 * length - 1 &&
+                           f->y1 == at.y + 7,
+                   "\"%s\" at (%d,%d): flushed (%d,%d)-(%d,%d), wrote %dx8",
+                   text,
+                   at.x,
+                   at.y,
+                   f->x0,
+                   f->y0,
+                   f->x1,
+                   f->y1,
+                   6 * length);
+    }
+}
+
+int main(void)
+{
+    check_paths(CFBD_CANVAS_1BPP_PAGE);
+    check_paths(CFBD_CANVAS_4BPP_PACKED);
+    check_flush();
+    return host_report("glyph_run");
+}
@@ -0,0 +1,154 @@
+#include "host_test.h"
+
+#include <string.h>
+
+#include "device/graphic_canvas.h"
+#include "device/graphic_clip.h"
+
+unsigned host_failures = 0;
+unsigned host_flushes = 0;
+CFBDGraphic_ClipBounds host_last_flush;
+CFBDGraphic_ClipBounds host_flush_log[HOST_FLUSH_LOG];
+
+/* the library waits through these on the target, nothing to wait for here */
+void system_delay_ms(uint32_t ms)
+{
+    (void) ms;
+}
+
+void system_delay_us(uint32_t us)
+{
+    (void) us;
+}
+
+static CFBD_GraphicDeviceOperation pixel_only_ops;
+static CFBD_GraphicDeviceOperation* memory_ops;
+
+/* The memory device without its "canvas" property */
+static CFBD_Bool pixel_only_consult(CFBD_GraphicDevice* device,
+                                    const char* property,
+                                    void* args,
+                                    void* request_data)
+{
+    if (strcmp(property, "canvas") == 0)
+        return CFBD_FALSE;
+    return memory_ops->self_consult(device, property, args, request_data);
+}
+
+/* setArea() without a canvas: the library's per-pixel blit fallback */
+static CFBD_Bool pixel_only_set_area(CFBD_GraphicDevice* device,
+                                     uint16_t x,
+                                     uint16_t y,
+                                     uint16_t width,
+                                     uint16_t height,
+                                     uint8_t* source)
+{
+    const CFBDGraphic_BlitSource window = {source, width, 0, 0, width, height};
+    CFBDGraphic_DeviceBlit(device, &window, x, y, device->rop);
+    return CFBD_TRUE;
+}
+
+void host_bind(HostPanel* panel, CFBDGraphic_CanvasFormat format, CFBD_Bool fast_path)
+{
+    memset(panel->pixels, 0, sizeof(panel->pixels));
+    panel->canvas = (CFBDGraphic_MemoryCanvas) {.buffer = panel->pixels,
+                                                .width = HOST_WIDTH,
+                                                .height = HOST_HEIGHT,
+                                                .origin_y = 0,
+                                                .format = format};
+    CFBDGraphic_BindMemoryAsDevice(&panel->device, &panel->canvas);
+    CFBDGraphic_DeviceSetClearBeforeDraw(&panel->device, CFBD_FALSE);
+    if (!fast_path) {
+        memory_ops = panel->device.ops;
+        pixel_only_ops = *memory_ops;
+        pixel_only_ops.self_consult = pixel_only_consult;
+        pixel_only_ops.setArea = pixel_only_set_area;
+        pixel_only_ops.blit = NULL;
+        panel->device.ops = &pixel_only_ops;
+    }
+}
+
+static CFBD_GraphicDeviceOperation counting_ops;
+static CFBD_GraphicDeviceOperation* counted_ops;
+
+/* Record the area, then flush as the panel would */
+static CFBD_Bool counting_update_area(
+        CFBD_GraphicDevice* device, uint16_t x, uint16_t y, uint16_t width, uint16_t height)
+{
+    const CFBDGraphic_ClipBounds area = {x, y, x + width - 1, y + height - 1};
+    if (host_flushes < HOST_FLUSH_LOG)
+        host_flush_log[host_flushes] = area;
+    host_last_flush = area;
+    host_flushes++;
+    return counted_ops->update_area(device, x, y, width, height);
+}
+
+CFBD_GraphicDeviceOperation* host_count_flushes(HostPanel* panel)
+{
+    counted_ops = panel->device.ops;
+    counting_ops = *counted_ops;
+    counting_ops.update_area = counting_update_area;
+    panel->device.ops = &counting_ops;
+    CFBDGraphic_DeviceSetIfRequestUpdateAtOnce(&panel->device, CFBD_TRUE);
+    host_flushes = 0;
+    return &counting_ops;
+}
+
+void host_clear(HostPanel* panel)
+{
+    memset(panel->pixels, 0, sizeof(panel->pixels));
+}
+
+CFBD_Bool host_pixel(const HostPanel* panel, int32_t x, int32_t y)
+{
+    if (x < 0 || y < 0 || x >= HOST_WIDTH || y >= HOST_HEIGHT)
+        return CFBD_FALSE;
+    if (panel->canvas.format == CFBD_CANVAS_4BPP_PACKED) {
+        const uint8_t byte = panel->pixels[y * ((HOST_WIDTH + 1) / 2) + x / 2];
+        return ((x & 1) ? (byte & 0x0F) : (byte >> 4)) != 0;
+    }
+    return (panel->pixels[(y / 8) * HOST_WIDTH + x] >> (y & 7)) & 0x01;
+}
+
+CFBD_Bool host_same_pixels(const HostPanel* a, const HostPanel* b)
+{
+    for (int32_t y = 0; y < HOST_HEIGHT; y++)
+        for (int32_t x = 0; x < HOST_WIDTH; x++)
+            if (host_pixel(a, x, y) != host_pixel(b, x, y))
+                return CFBD_FALSE;
+    return CFBD_TRUE;
+}
+
+CFBD_Bool host_raster_op(CFBDGraphic_RasterOp rop, CFBD_Bool under, CFBD_Bool ink)
+{
+    switch (rop) {
+        case CFBD_ROP_COPY:
+            return ink;
+        case CFBD_ROP_SET:
+            return under || ink;
+        case CFBD_ROP_CLEAR:
+            return under && !ink;
+        default:
+            return under != ink;
+    }
+}
+
+uint32_t host_random(uint32_t range)
+{
+    static uint32_t state = 2463534242u;
+    // xorshift32
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return range ? state % range : 0;
+}
+
+int host_report(const char* name)
+{
+    if (host_failures == 0) {
+        printf("%s: passed\n", name);
+        return 0;
+    }
+    printf("%s: %u checks failed\n", name, host_failures);
+    return 1;
+}
@@ -0,0 +1,113 @@
+/**
+ * @file host_test.h
+ * @brief Shared helpers of the host-side graphic regression checks.
+ *
+ * @details
+ * The checks in this directory run on the development machine, without a
+ * panel: every drawing goes into a memory device (memory_graphic_device.h)
+ * and the result is compared pixel by pixel against a naive reference
+ * written in the test itself. Each *.test.c file is a program of its own,
+ * build and run one from the repository root with
+ *
+ * @code
+ * gcc -std=gnu11 -Ilib/graphic -Ilib/config -Ilib/application -Ilib \
+ *     test/graphic/host_test.c test/graphic/fast_path.test.c \
+ *     $(find lib/graphic -name '*.c' ! -path '*oled*' ! -path '*benchmark*' \
+ *       ! -path '*fast_test*' ! -name grapgic_device.c) -lm -o fast_path && ./fast_path
+ * @endcode
+ *
+ * A program exits with 0 when every check passed and prints the first
+ * failures otherwise.
+ */
+
+#pragma once
+#include <stdint.h>
+#include <stdio.h>
+
+#include "cfbd_define.h"
+#include "device/graphic_device.h"
+#include "device/memory/memory_graphic_device.h"
+
+/** @brief Size of the test panel */
+#define HOST_WIDTH (128)
+#define HOST_HEIGHT (64)
+
+/** @brief Failed checks so far */
+extern unsigned host_failures;
+
+/**
+ * @brief Count a failed check when @p cond is false, print the first few.
+ */
+#define HOST_CHECK(cond, ...)                                                                      \
+    do {                                                                                           \
+        if (!(cond)) {                                                                             \
+            if (host_failures++ < 10) {                                                            \
+                printf("%s:%d: ", __FILE__, __LINE__);                                             \
+                printf(__VA_ARGS__);                                                               \
+                printf("\n");                                                                      \
+            }                                                                                      \
+        }                                                                                          \
+    } while (0)
+
+/**
+ * @struct HostPanel
+ * @brief A memory device standing in for the panel.
+ */
+typedef struct
+{
+    CFBD_GraphicDevice device;
+    CFBDGraphic_MemoryCanvas canvas;
+    uint8_t pixels[CFBDGraphic_MEMORY_CANVAS_4BPP_BYTES(HOST_WIDTH, HOST_HEIGHT)];
+} HostPanel;
+
+/**
+ * @brief Bind a blank panel.
+ * @param panel Panel to set up.
+ * @param format 1bpp pages or 4bpp packed.
+ * @param fast_path CFBD_FALSE hides the canvas, so the primitives fall back
+ *        to setPixel() like on a device without frame buffer access.
+ */
+void host_bind(HostPanel* panel, CFBDGraphic_CanvasFormat format, CFBD_Bool fast_path);
+
+/** @brief update_area() calls logged in order by host_count_flushes() */
+#define HOST_FLUSH_LOG (8)
+
+/** @brief update_area() calls of the counted panel, reset by the caller */
+extern unsigned host_flushes;
+
+/** @brief Area of the last update_area() call */
+extern CFBDGraphic_ClipBounds host_last_flush;
+
+/** @brief Areas of the first HOST_FLUSH_LOG calls since host_flushes was 0 */
+extern CFBDGraphic_ClipBounds host_flush_log[HOST_FLUSH_LOG];
+
+/**
+ * @brief Count the flushes of a panel and turn on immediate drawing.
+ * @details Every update_area() of @p panel is recorded in host_flushes,
+ *          host_last_flush and host_flush_log, then forwarded. One panel is
+ *          counted at a time; call after host_bind().
+ * @return The ops table now bound to @p panel, its other entries forward to
+ *         the previous table. Tests may override them further.
+ */
+CFBD_GraphicDeviceOperation* host_count_flushes(HostPanel* panel);
+
+/** @brief Blank every pixel, the drawing state is kept. */
+void host_clear(HostPanel* panel);
+
+/** @brief Whether the pixel at (@p x, @p y) is lit (any grey level for 4bpp). */
+CFBD_Bool host_pixel(const HostPanel* panel, int32_t x, int32_t y);
+
+/** @brief Whether both panels show the same pixels. */
+CFBD_Bool host_same_pixels(const HostPanel* a, const HostPanel* b);
+
+/**
+ * @brief Reference result of blitting an @p ink pixel over an @p under pixel.
+ * @details Blits carry paper pixels as well, only COPY writes them.
+ */
+CFBD_Bool host_raster_op(CFBDGraphic_RasterOp rop, CFBD_Bool under, CFBD_Bool ink);
+
+/** @brief Deterministic pseudo random number in [0, range). */
+uint32_t host_random(uint32_t range);
+
+/** @brief Print the summary line, return the process exit code. */
+int host_report(const char* name);
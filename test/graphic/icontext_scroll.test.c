@@ -0,0 +1,114 @@
+/*
+    Icon-text menu scrolling: a frame drawn by shifting the columns already
+    on screen must show the same pixels as the frame redrawn from scratch.
+    Random scroll deltas move long and short labels across x = 0 and the
+    viewport edges, icons in and out of the viewport, and the selection
+    frame between items; every frame is flushed once.
+*/
+#include <string.h>
+
+#include "host_test.h"
+#include "widget/menu/icontext_menu.h"
+
+#define ITEMS (7)
+#define ITEM_WIDTH (30)
+#define ITEM_HEIGHT (40)
+#define ITEM_SPACING (4)
+
+static const char* const labels[ITEMS] =
+        {"Home", "Display brightness", "A", "Wi", "Network status", "Clock", "About"};
+static const CFBDGraphicSize icon_sizes[ITEMS] =
+        {{16, 16}, {20, 12}, {8, 8}, {24, 16}, {16, 16}, {12, 20}, {16, 10}};
+static uint8_t icons[ITEMS][24 * 3];
+
+static void init_menu(CFBD_IconTextMenu* menu,
+                      CFBD_IconTextMenuItem* items,
+                      HostPanel* panel,
+                      CFBDGraphicRect* viewport)
+{
+    CFBD_InitIconTextMenu(menu, &panel->device, viewport, items, ITEMS);
+    menu->operations->set_dimensions(menu, ITEM_WIDTH, ITEM_HEIGHT, ITEM_SPACING);
+    for (int i = 0; i < ITEMS; i++) {
+        CFBDGraphicSize size = icon_sizes[i];
+        menu->operations->add_item(menu, labels[i], icons[i], &size, NULL);
+    }
+}
+
+/* Mostly steps a scroll animation makes, sometimes a jump */
+static int16_t next_offset(int16_t offset)
+{
+    const int32_t lowest = -ITEMS * (ITEM_WIDTH + ITEM_SPACING) - 40;
+    int32_t next = (host_random(8) == 0) ? lowest + (int32_t) host_random(-lowest + 80)
+                                         : offset + (int32_t) host_random(41) - 20;
+    if (next < lowest)
+        next = lowest;
+    if (next > 40)
+        next = 40;
+    return (int16_t) next;
+}
+
+static void check_scroll(CFBDGraphic_CanvasFormat format,
+                         CFBD_Bool fast_path,
+                         CFBDGraphicRect viewport,
+                         uint16_t border)
+{
+    static HostPanel panel, reference;
+    static CFBD_IconTextMenuItem scrolled_items[ITEMS], full_items[ITEMS];
+    CFBD_IconTextMenu scrolled, full;
+
+    host_bind(&panel, format, fast_path);
+    host_bind(&reference, format, fast_path);
+    host_count_flushes(&panel);
+
+    init_menu(&scrolled, scrolled_items, &panel, &viewport);
+    init_menu(&full, full_items, &reference, &viewport);
+    scrolled.operations->set_selection_border(&scrolled, border);
+    full.operations->set_selection_border(&full, border);
+
+    int16_t offset = 0;
+    for (int round = 0; round < 2000; round++) {
+        const int16_t previous = offset;
+        offset = next_offset(offset);
+        const int selected = (host_random(5) == 0) ? (int) host_random(ITEMS)
+                                                   : scrolled.selected_index;
+        scrolled.scroll_offset = full.scroll_offset = offset;
+        scrolled.selected_index = full.selected_index = selected;
+
+        host_flushes = 0;
+        scrolled.operations->immediate_draw(&scrolled);
+        full.is_drawn = CFBD_FALSE;
+        full.operations->immediate_draw(&full);
+
+        HOST_CHECK(host_same_pixels(&panel, &reference),
+                   "round %d: scroll %d -> %d (item %d) differs from a redraw, viewport "
+                   "(%d,%d)-(%d,%d) border %d format %d fast path %d",
+                   round,
+                   previous,
+                   offset,
+                   selected,
+                   viewport.tl.x,
+                   viewport.tl.y,
+                   viewport.br.x,
+                   viewport.br.y,
+                   border,
+                   format,
+                   fast_path);
+        HOST_CHECK(host_flushes == 1, "round %d: %u flushes", round, host_flushes);
+    }
+}
+
+int main(void)
+{
+    for (size_t i = 0; i < sizeof(icons); i++)
+        ((uint8_t*) icons)[i] = (uint8_t) host_random(256);
+
+    const CFBDGraphicRect whole = {{0, 0}, {HOST_WIDTH - 1, HOST_HEIGHT - 1}};
+    const CFBDGraphicRect inset = {{10, 4}, {100, 60}};
+    check_scroll(CFBD_CANVAS_1BPP_PAGE, CFBD_TRUE, whole, 1);
+    check_scroll(CFBD_CANVAS_1BPP_PAGE, CFBD_TRUE, inset, 1);
+    check_scroll(CFBD_CANVAS_1BPP_PAGE, CFBD_TRUE, inset, 3);
+    check_scroll(CFBD_CANVAS_4BPP_PACKED, CFBD_TRUE, whole, 1);
+    check_scroll(CFBD_CANVAS_4BPP_PACKED, CFBD_TRUE, inset, 2);
+    check_scroll(CFBD_CANVAS_1BPP_PAGE, CFBD_FALSE, inset, 1);
+    return host_report("icontext_scroll");
+}
@@ -0,0 +1,117 @@
+/*
+    Incremental text: a readout redrawn string after string in incremental
+    mode must show the same pixels as the string drawn on a blank panel, and
+    an immediate device is flushed with exactly the cells that changed,
+    trailing cells of a longer previous string included. A shadow shorter
+    than the string only costs the redraw of the cells it does not hold.
+*/
+#include <string.h>
+
+#include "host_test.h"
+#include "widget/text.h"
+
+#define ORIGIN_X (10)
+#define ORIGIN_Y (20)
+
+/* Change a digit or two, sometimes the length, like a sensor readout */
+static void next_readout(char* text)
+{
+    int length = (int) strlen(text);
+    switch (host_random(4)) {
+        case 0:
+            length = 1 + host_random(12);
+            for (int i = 0; i < length; i++)
+                text[i] = (char) ('0' + host_random(10));
+            text[length] = '\0';
+            break;
+        case 1:
+            break; // unchanged
+        default:
+            for (int n = host_random(3); n >= 0; n--)
+                text[host_random(length)] = (char) ('0' + host_random(10));
+            break;
+    }
+}
+
+static void draw(HostPanel* panel, CFBDGraphic_Text* item, char* text)
+{
+    CFBDGraphic_Point origin = {ORIGIN_X, ORIGIN_Y};
+    CFBDGraphic_SetTextIndexedPoint(item, &origin);
+    CFBDGraphic_SetText(item, text);
+    CFBDGraphic_DrawText(&panel->device, item, CCGraphic_AsciiTextItem_RequestOldPoint);
+}
+
+static void check_format(CFBDGraphic_CanvasFormat format, CFBD_Bool fast_path, uint16_t kept)
+{
+    static HostPanel panel, reference;
+    const CFBDGraphic_Point origin = {ORIGIN_X, ORIGIN_Y};
+    const CFBDGraphicSize area = {HOST_WIDTH - ORIGIN_X, 8};
+    CFBDGraphic_Text readout, full;
+    char text[16] = "0", shown[16] = "";
+    char shadow[16];
+
+    host_bind(&panel, format, fast_path);
+    host_bind(&reference, format, fast_path);
+    host_count_flushes(&panel);
+
+    CFBDGraphic_InitText(&readout, origin, area, ASCII_6x8);
+    CFBDGraphic_InitText(&full, origin, area, ASCII_6x8);
+    readout.no_wrap = full.no_wrap = CFBD_TRUE;
+    CFBDGraphic_SetTextIncremental(&readout, shadow, kept + 1);
+
+    for (int round = 0; round < 3000; round++) {
+        next_readout(text);
+
+        /* 期望刷新的字符格: 内容变化的格子, 以及上次更长时多出的格子 */
+        const int length = (int) strlen(text);
+        const int shown_length = (int) strlen(shown);
+        int first = -1, last = -1;
+        for (int i = 0; i < (length > shown_length ? length : shown_length); i++) {
+            if (i >= length || i >= shown_length || i >= kept || text[i] != shown[i]) {
+                if (first < 0)
+                    first = i;
+                last = i;
+            }
+        }
+
+        host_flushes = 0;
+        draw(&panel, &readout, text);
+        host_clear(&reference);
+        draw(&reference, &full, text);
+        HOST_CHECK(host_same_pixels(&panel, &reference),
+                   "round %d: \"%s\" after \"%s\" differs from a full draw (format %d)",
+                   round,
+                   text,
+                   shown,
+                   format);
+
+        /* setArea() of the pixel-only panel flushes each glyph by itself */
+        const CFBDGraphic_ClipBounds* f = &host_last_flush;
+        if (fast_path && first < 0) {
+            HOST_CHECK(host_flushes == 0, "round %d: unchanged \"%s\" flushed", round, text);
+        }
+        else if (fast_path) {
+            HOST_CHECK(host_flushes == 1 && f->x0 == ORIGIN_X + 6 * first && f->y0 == ORIGIN_Y &&
+                               f->x1 == ORIGIN_X + 6 * last + 5 && f->y1 == ORIGIN_Y + 7,
+                       "round %d: \"%s\" after \"%s\": %u flushes, last (%d,%d)-(%d,%d)",
+                       round,
+                       text,
+                       shown,
+                       host_flushes,
+                       f->x0,
+                       f->y0,
+                       f->x1,
+                       f->y1);
+        }
+        strcpy(shown, text);
+    }
+}
+
+int main(void)
+{
+    check_format(CFBD_CANVAS_1BPP_PAGE, CFBD_TRUE, 15);
+    check_format(CFBD_CANVAS_1BPP_PAGE, CFBD_TRUE, 5);
+    check_format(CFBD_CANVAS_1BPP_PAGE, CFBD_FALSE, 15);
+    check_format(CFBD_CANVAS_4BPP_PACKED, CFBD_TRUE, 15);
+    return host_report("incremental_text");
+}
@@ -0,0 +1,193 @@
+/*
+    Marquee against a per-pixel reference of the strip window: box column
+    c shows strip column (offset + c) modulo the text width plus the gap,
+    blank inside the gap, so the end of the text, the gap and the start of
+    the next lap are all covered. Every lap holds the text start for the
+    pause, then moves one column per step. A tick redraws and flushes the
+    text rows only when the offset changed; pixels outside the box, and
+    below the text rows once drawn, never change.
+*/
+#include <string.h>
+
+#include "host_test.h"
+#include "widget/marquee/marquee.h"
+
+#define STRIP_WIDTH (400)
+
+static const char* const texts[] = {
+        "Now playing: a rather long track name",
+        "Wi-Fi",
+        "0123456789 abcdefghijklmnopqrstuvwxyz",
+        "Battery low - connect the charger",
+};
+
+static uint8_t strip_buffer[CFBDGraphic_MARQUEE_STRIP_BYTES(STRIP_WIDTH, 16)];
+
+static CFBD_Bool strip_pixel(const CFBDGraphic_MemoryCanvas* strip, int32_t x, int32_t y)
+{
+    return (strip->buffer[(y / 8) * strip->width + x] >> (y & 7)) & 0x01;
+}
+
+/* Offset due at now_ms: a pause at the start of every lap, then a column per step */
+static uint16_t expected_offset(const CFBDGraphic_Marquee* m, uint32_t now_ms)
+{
+    if (!CFBDGraphic_MarqueeScrolls(m))
+        return 0;
+    const uint32_t period = m->strip.width + m->gap;
+    const uint32_t elapsed = (now_ms - m->start_ms) % (m->pause_ms + period * m->step_ms);
+    return (elapsed < m->pause_ms) ? 0 : (uint16_t) ((elapsed - m->pause_ms) / m->step_ms);
+}
+
+/* Box pixels against the strip window, everything else against @p before */
+static CFBD_Bool same_window(const CFBDGraphic_Marquee* m,
+                             uint16_t offset,
+                             const HostPanel* panel,
+                             const HostPanel* before)
+{
+    // a text that does not move is shown once, without a next lap
+    const uint32_t period = CFBDGraphic_MarqueeScrolls(m) ? m->strip.width + m->gap : UINT32_MAX;
+    const uint16_t rows = (m->strip.height < m->size.height) ? m->strip.height : m->size.height;
+    for (int32_t y = 0; y < HOST_HEIGHT; y++) {
+        for (int32_t x = 0; x < HOST_WIDTH; x++) {
+            const int32_t c = x - m->tl_point.x, r = y - m->tl_point.y;
+            CFBD_Bool expected = host_pixel(before, x, y);
+            if (c >= 0 && r >= 0 && c < m->size.width && r < m->size.height) {
+                const uint32_t s = (offset + (uint32_t) c) % period;
+                expected = r < rows && s < m->strip.width && strip_pixel(&m->strip, s, r);
+            }
+            if (host_pixel(panel, x, y) != expected)
+                return CFBD_FALSE;
+        }
+    }
+    return CFBD_TRUE;
+}
+
+static void check_marquee(CFBDGraphic_CanvasFormat format, CFBD_Bool fast_path)
+{
+    static HostPanel panel, before;
+    host_bind(&panel, format, fast_path);
+    host_bind(&before, format, CFBD_TRUE);
+    host_count_flushes(&panel);
+    const CFBDGraphic_ClipBounds* f = &host_last_flush;
+
+    for (int round = 0; round < 60; round++) {
+        for (size_t i = 0; i < sizeof(panel.pixels); i++)
+            panel.pixels[i] = (uint8_t) host_random(256);
+        memcpy(before.pixels, panel.pixels, sizeof(panel.pixels));
+
+        CFBDGraphic_Marquee m;
+        const CFBDGraphic_Point at = {host_random(100), host_random(HOST_HEIGHT - 4)};
+        const CFBDGraphicSize box = {8 + host_random(80), 4 + host_random(20)};
+        const Ascii_Font_Size font = host_random(2) ? ASCII_6x8 : ASCII_8x16;
+        // sometimes a buffer too small for the whole text
+        const uint16_t bytes = host_random(4) ? sizeof(strip_buffer) : 64 + host_random(200);
+        CFBDGraphic_InitMarquee(&m, &panel.device, at, box, font, strip_buffer, bytes);
+        CFBDGraphic_SetMarqueeText(&m, texts[host_random(4)]);
+        const uint16_t step_ms = host_random(8) ? 1 + host_random(30) : 0;
+        CFBDGraphic_SetMarqueeMotion(&m, step_ms, host_random(40), host_random(300));
+
+        uint32_t now_ms = host_random(3) ? host_random(1000) : UINT32_MAX - 2000;
+        host_flushes = 0;
+        CFBDGraphic_DrawMarquee(&m, now_ms);
+        HOST_CHECK(host_flushes == 1 && f->x0 == at.x && f->y0 == at.y &&
+                           f->x1 == at.x + box.width - 1 && f->y1 == at.y + box.height - 1,
+                   "round %d: first draw flushed %u times",
+                   round,
+                   host_flushes);
+        HOST_CHECK(same_window(&m, 0, &panel, &before), "round %d: first draw differs", round);
+
+        // ticks shorter than a step over one and a half laps, then random and late ones
+        const uint32_t period = m.strip.width + m.gap;
+        const uint32_t lap_ms = m.pause_ms + period * m.step_ms;
+        const uint32_t sweep_end = now_ms + lap_ms + lap_ms / 2;
+        uint16_t shown = 0;
+        for (uint32_t i = 0, late = 0; late < 200; i++) {
+            if ((int32_t) (sweep_end - now_ms) > 0) {
+                now_ms += 1 + host_random(m.step_ms);
+            }
+            else {
+                now_ms += host_random(4) ? host_random(3 * m.step_ms + 2)
+                                         : host_random(lap_ms + 1);
+                late++;
+            }
+            const uint16_t due = expected_offset(&m, now_ms);
+            host_flushes = 0;
+            const CFBD_Bool redrawn = CFBDGraphic_MarqueeTick(&m, now_ms);
+            const uint16_t rows = (m.strip.height < box.height) ? m.strip.height : box.height;
+            HOST_CHECK(m.offset == due && redrawn == (due != shown) &&
+                               host_flushes == (unsigned) redrawn,
+                       "round %d tick %u: offset %u, expected %u, redrawn %d, %u flushes",
+                       round,
+                       i,
+                       m.offset,
+                       due,
+                       redrawn,
+                       host_flushes);
+            if (redrawn) {
+                HOST_CHECK(f->x0 == at.x && f->y0 == at.y && f->x1 == at.x + box.width - 1 &&
+                                   f->y1 == at.y + rows - 1,
+                           "round %d tick %u: flushed (%d,%d)-(%d,%d)",
+                           round,
+                           i,
+                           f->x0,
+                           f->y0,
+                           f->x1,
+                           f->y1);
+                HOST_CHECK(same_window(&m, due, &panel, &before),
+                           "round %d tick %u: offset %u of %u + %u gap differs, box %dx%d at "
+                           "(%d,%d), format %d fast path %d",
+                           round,
+                           i,
+                           due,
+                           m.strip.width,
+                           m.gap,
+                           box.width,
+                           box.height,
+                           at.x,
+                           at.y,
+                           format,
+                           fast_path);
+            }
+            shown = due;
+        }
+    }
+}
+
+/* One lap of a known motion: pause, a column per step, the wrap back to 0 */
+static void check_lap(void)
+{
+    static HostPanel panel;
+    host_bind(&panel, CFBD_CANVAS_1BPP_PAGE, CFBD_TRUE);
+    CFBDGraphic_Marquee m;
+    const CFBDGraphic_Point at = {0, 0};
+    const CFBDGraphicSize box = {40, 8};
+    CFBDGraphic_InitMarquee(
+            &m, &panel.device, at, box, ASCII_6x8, strip_buffer, sizeof(strip_buffer));
+    CFBDGraphic_SetMarqueeText(&m, "Wi-Fi settings"); // 14 glyphs, 84 columns
+    CFBDGraphic_SetMarqueeMotion(&m, 10, 6, 100);
+    CFBDGraphic_DrawMarquee(&m, 5000);
+
+    HOST_CHECK(m.strip.width == 84, "strip is %u columns wide", m.strip.width);
+    HOST_CHECK(!CFBDGraphic_MarqueeTick(&m, 5099) && m.offset == 0, "moved during the pause");
+    HOST_CHECK(!CFBDGraphic_MarqueeTick(&m, 5109) && CFBDGraphic_MarqueeTick(&m, 5110) &&
+                       m.offset == 1,
+               "first step at offset %u",
+               m.offset);
+    HOST_CHECK(CFBDGraphic_MarqueeTick(&m, 5100 + 89 * 10) && m.offset == 89,
+               "last column of the lap at offset %u",
+               m.offset);
+    HOST_CHECK(CFBDGraphic_MarqueeTick(&m, 5100 + 90 * 10) && m.offset == 0,
+               "next lap starts at offset %u",
+               m.offset);
+    HOST_CHECK(!CFBDGraphic_MarqueeTick(&m, 5100 + 90 * 10 + 99) && m.offset == 0,
+               "next lap skipped its pause");
+}
+
+int main(void)
+{
+    check_marquee(CFBD_CANVAS_1BPP_PAGE, CFBD_TRUE);
+    check_marquee(CFBD_CANVAS_1BPP_PAGE, CFBD_FALSE);
+    check_marquee(CFBD_CANVAS_4BPP_PACKED, CFBD_TRUE);
+    check_lap();
+    return host_report("marquee");
+}
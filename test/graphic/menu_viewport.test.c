@@ -0,0 +1,87 @@
+/*
+    Viewport menu: selecting an item outside the window scrolls the rows
+    already on screen and draws only the exposed strip. After every
+    selection, blocking or ticked, the window must show the same pixels as
+    a full immediate_draw() of the same selection and scroll position on a
+    blank panel. Every label fits on one line: an item is one line tall,
+    a wrapped label would spill over the items below it.
+*/
+#include <string.h>
+
+#include "host_test.h"
+#include "widget/menu/menu.h"
+
+#define ITEMS (24)
+#define MENU_Y (8)
+#define VIEWPORT_HEIGHT (44)
+
+static const char* const labels[] = {"Home", "Display", "Wi", "Network", "A", "Clock"};
+
+static void init_menu(CFBD_Menu* menu, CFBD_MenuItemGroup* group, HostPanel* panel)
+{
+    static CFBD_MenuItemCallbackPack no_callback;
+    CFBD_InitMenu(menu, &panel->device, group, 100);
+    for (int i = 0; i < ITEMS; i++) {
+        const Ascii_Font_Size size = (i % 5 == 3) ? ASCII_8x16 : ASCII_6x8;
+        menu->operations->add_item(menu, labels[i % 6], size, &no_callback);
+    }
+    CFBDGraphic_Point tl = {0, MENU_Y};
+    menu->operations->reset_tl_points(menu, &tl, CFBD_FALSE);
+    menu->operations->set_viewport(menu, VIEWPORT_HEIGHT);
+}
+
+static void check_viewport(CFBDGraphic_CanvasFormat format, CFBD_Bool fast_path)
+{
+    static HostPanel panel, reference;
+    static CFBD_MenuItem scrolled_items[ITEMS], full_items[ITEMS];
+    CFBD_MenuItemGroup scrolled_group = {scrolled_items, ITEMS, 0};
+    CFBD_MenuItemGroup full_group = {full_items, ITEMS, 0};
+    CFBD_Menu scrolled, full;
+
+    host_bind(&panel, format, fast_path);
+    host_bind(&reference, format, fast_path);
+    init_menu(&scrolled, &scrolled_group, &panel);
+    init_menu(&full, &full_group, &reference);
+    scrolled.operations->immediate_draw(&scrolled);
+
+    uint32_t now_ms = 0;
+    for (int round = 0; round < 400; round++) {
+        // mostly the neighbours, sometimes a jump across the list
+        int index = scrolled.selected + (int) host_random(5) - 2;
+        if (host_random(6) == 0)
+            index = (int) host_random(ITEMS);
+
+        if (host_random(2) == 0) {
+            scrolled.operations->select_index(&scrolled, index);
+        }
+        else {
+            CFBD_BaseAnimation timing = {.anim_frames = 6, .anim_frame_delay_ms = 10};
+            scrolled.operations->set_animation(&scrolled, &timing);
+            scrolled.operations->begin_select(&scrolled, index, now_ms);
+            while (scrolled.operations->tick(&scrolled, now_ms))
+                now_ms += host_random(25);
+            CFBD_InitBaseAnimation(&scrolled.animation);
+        }
+
+        host_clear(&reference);
+        full.selected = scrolled.selected;
+        full.scroll_y = scrolled.scroll_y;
+        full.operations->immediate_draw(&full);
+        HOST_CHECK(full.scroll_y == scrolled.scroll_y && host_same_pixels(&panel, &reference),
+                   "round %d: item %d at scroll %d differs from a full draw (format %d, fast "
+                   "path %d)",
+                   round,
+                   scrolled.selected,
+                   scrolled.scroll_y,
+                   format,
+                   fast_path);
+    }
+}
+
+int main(void)
+{
+    check_viewport(CFBD_CANVAS_1BPP_PAGE, CFBD_TRUE);
+    check_viewport(CFBD_CANVAS_1BPP_PAGE, CFBD_FALSE);
+    check_viewport(CFBD_CANVAS_4BPP_PACKED, CFBD_TRUE);
+    return host_report("menu_viewport");
+}
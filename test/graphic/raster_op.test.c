@@ -0,0 +1,214 @@
+/*
+    Raster ops: every primitive writes each pixel it covers once, so under
+    CFBD_ROP_XOR a shape drawn on a blank panel looks the same as with
+    CFBD_ROP_SET and a second draw restores the panel. The triangle
+    outline still lights exactly the pixels of its three edges.
+*/
+#include "base/arc.h"
+#include "base/circle.h"
+#include "base/ellipse.h"
+#include "base/line.h"
+#include "base/rectangle.h"
+#include "base/triangle.h"
+#include "device/graphic_canvas.h"
+#include "device/graphic_clip.h"
+#include "host_test.h"
+
+#define SHAPE_COUNT (11)
+
+static const char* const shape_names[SHAPE_COUNT] = {"line",
+                                                     "rect",
+                                                     "filled rect",
+                                                     "circle",
+                                                     "filled circle",
+                                                     "arc",
+                                                     "filled arc",
+                                                     "triangle",
+                                                     "filled triangle",
+                                                     "ellipse",
+                                                     "filled ellipse"};
+
+typedef struct
+{
+    CFBDGraphic_Point a, b, c;
+    PointBaseType radius, radius_y;
+    int16_t start_degree, end_degree;
+} ShapeParams;
+
+static void random_shape(ShapeParams* p)
+{
+    p->a = (CFBDGraphic_Point) {host_random(HOST_WIDTH + 16), host_random(HOST_HEIGHT + 16)};
+    p->b = (CFBDGraphic_Point) {host_random(HOST_WIDTH + 16), host_random(HOST_HEIGHT + 16)};
+    p->c = (CFBDGraphic_Point) {host_random(HOST_WIDTH + 16), host_random(HOST_HEIGHT + 16)};
+    if (host_random(4) == 0)
+        p->b = p->a; // degenerate shapes share their pixels the most
+    p->radius = host_random(4) == 0 ? host_random(3) : host_random(40);
+    p->radius_y = host_random(30);
+    p->start_degree = host_random(360);
+    p->end_degree = host_random(360);
+}
+
+static void draw_shape(CFBD_GraphicDevice* device, int shape, const ShapeParams* p)
+{
+    CFBDGraphic_Line line = {p->a, p->b};
+    CFBDGraphicRect rect = rect_normalize((CFBDGraphicRect) {p->a, p->b});
+    CFBDGraphicCircle circle = {.radius = p->radius, .center = p->a};
+    CFBD_GraphicArc arc = {p->a, p->radius, p->start_degree, p->end_degree};
+    CFBDGraphic_Triangle triangle = {p->a, p->b, p->c};
+    CFBD_GraphicEllipse ellipse = {p->a, p->radius, p->radius_y};
+
+    switch (shape) {
+        case 0:
+            CFBDGraphic_DrawLine(device, &line);
+            break;
+        case 1:
+            CFBDGraphic_DrawRect(device, &rect);
+            break;
+        case 2:
+            CFBDGraphic_FillRect(device, &rect);
+            break;
+        case 3:
+            CFBDGraphic_DrawCircle(device, &circle);
+            break;
+        case 4:
+            CFBDGraphic_DrawFilledCircle(device, &circle);
+            break;
+        case 5:
+            CFBDGraphic_DrawArc(device, &arc);
+            break;
+        case 6:
+            CFBDGraphic_DrawFilledArc(device, &arc);
+            break;
+        case 7:
+            CCGraphic_DrawTriangle(device, &triangle);
+            break;
+        case 8:
+            CCGraphic_DrawFilledTriangle(device, &triangle);
+            break;
+        case 9:
+            CFBDGraphic_DrawEllipse(device, &ellipse);
+            break;
+        default:
+            CFBDGraphic_DrawFilledEllipse(device, &ellipse);
+            break;
+    }
+}
+
+static CFBD_Bool is_blank(const HostPanel* panel)
+{
+    for (int32_t y = 0; y < HOST_HEIGHT; y++)
+        for (int32_t x = 0; x < HOST_WIDTH; x++)
+            if (host_pixel(panel, x, y))
+                return CFBD_FALSE;
+    return CFBD_TRUE;
+}
+
+static void check_shapes(CFBDGraphic_CanvasFormat format, CFBD_Bool fast_path)
+{
+    static HostPanel set, xor;
+    host_bind(&set, format, fast_path);
+    host_bind(&xor, format, fast_path);
+    CFBDGraphic_DeviceSetRasterOp(&set.device, CFBD_ROP_SET);
+    CFBDGraphic_DeviceSetRasterOp(&xor.device, CFBD_ROP_XOR);
+
+    for (int round = 0; round < 400; round++) {
+        for (int shape = 0; shape < SHAPE_COUNT; shape++) {
+            ShapeParams p;
+            random_shape(&p);
+            CFBDGraphicRect clip = {{host_random(64), host_random(32)},
+                                    {64 + host_random(64), 32 + host_random(32)}};
+            const CFBD_Bool clipped = host_random(3) == 0;
+
+            host_clear(&set);
+            host_clear(&xor);
+            if (clipped) {
+                CFBDGraphic_PushClip(&set.device, &clip);
+                CFBDGraphic_PushClip(&xor.device, &clip);
+            }
+            draw_shape(&set.device, shape, &p);
+            draw_shape(&xor.device, shape, &p);
+            HOST_CHECK(host_same_pixels(&set, &xor),
+                       "%s (format %d, fast path %d): XOR on blank differs from SET",
+                       shape_names[shape],
+                       format,
+                       fast_path);
+            draw_shape(&xor.device, shape, &p);
+            HOST_CHECK(is_blank(&xor),
+                       "%s (format %d, fast path %d): second XOR did not restore the panel",
+                       shape_names[shape],
+                       format,
+                       fast_path);
+            if (clipped) {
+                CFBDGraphic_PopClip(&set.device);
+                CFBDGraphic_PopClip(&xor.device);
+            }
+        }
+    }
+}
+
+static void check_pixel_ops(CFBDGraphic_CanvasFormat format, CFBD_Bool fast_path)
+{
+    static HostPanel panel;
+    host_bind(&panel, format, fast_path);
+    CFBD_GraphicDevice* device = &panel.device;
+
+    device->ops->setPixel(device, 3, 4);
+    HOST_CHECK(host_pixel(&panel, 3, 4), "COPY did not light the pixel");
+    CFBDGraphic_DeviceSetRasterOp(device, CFBD_ROP_SET);
+    device->ops->setPixel(device, 3, 4);
+    HOST_CHECK(host_pixel(&panel, 3, 4), "SET cleared a lit pixel");
+    CFBDGraphic_DeviceSetRasterOp(device, CFBD_ROP_XOR);
+    device->ops->setPixel(device, 3, 4);
+    HOST_CHECK(!host_pixel(&panel, 3, 4), "XOR did not toggle a lit pixel off");
+    device->ops->setPixel(device, 3, 4);
+    HOST_CHECK(host_pixel(&panel, 3, 4), "XOR did not toggle a blank pixel on");
+    CFBDGraphic_DeviceSetRasterOp(device, CFBD_ROP_CLEAR);
+    device->ops->setPixel(device, 3, 4);
+    HOST_CHECK(!host_pixel(&panel, 3, 4), "CLEAR left the pixel lit");
+    device->ops->setPixel(device, 5, 4);
+    HOST_CHECK(!host_pixel(&panel, 5, 4), "CLEAR lit a blank pixel");
+}
+
+/* The outline lights exactly the pixels of its three edges drawn one by one */
+static void check_triangle_outline(CFBDGraphic_CanvasFormat format, CFBD_Bool fast_path)
+{
+    static HostPanel outline, edges;
+    host_bind(&outline, format, fast_path);
+    host_bind(&edges, format, fast_path);
+
+    for (int round = 0; round < 4000; round++) {
+        ShapeParams p;
+        random_shape(&p);
+        CFBDGraphic_Triangle triangle = {p.a, p.b, p.c};
+        CFBDGraphic_Line lines[3] = {{p.a, p.b}, {p.b, p.c}, {p.a, p.c}};
+
+        host_clear(&outline);
+        host_clear(&edges);
+        CCGraphic_DrawTriangle(&outline.device, &triangle);
+        for (int i = 0; i < 3; i++)
+            CFBDGraphic_DrawLine(&edges.device, &lines[i]);
+        HOST_CHECK(host_same_pixels(&outline, &edges),
+                   "triangle (%d,%d) (%d,%d) (%d,%d) format %d fast path %d: not its edges",
+                   p.a.x,
+                   p.a.y,
+                   p.b.x,
+                   p.b.y,
+                   p.c.x,
+                   p.c.y,
+                   format,
+                   fast_path);
+    }
+}
+
+int main(void)
+{
+    for (int fast_path = 0; fast_path < 2; fast_path++) {
+        check_pixel_ops(CFBD_CANVAS_1BPP_PAGE, fast_path);
+        check_pixel_ops(CFBD_CANVAS_4BPP_PACKED, fast_path);
+        check_shapes(CFBD_CANVAS_1BPP_PAGE, fast_path);
+        check_triangle_outline(CFBD_CANVAS_1BPP_PAGE, fast_path);
+    }
+    check_shapes(CFBD_CANVAS_4BPP_PACKED, CFBD_TRUE);
+    check_triangle_outline(CFBD_CANVAS_4BPP_PACKED, CFBD_TRUE);
+    return host_report("raster_op");
+}
@@ -0,0 +1,207 @@
+/*
+    RLE resources: random token streams decode to the bytes they describe
+    whatever the read and skip sizes, the generated 8x16 table decodes to
+    the plain one, compressed images draw like plain ones, and the glyph
+    cache of a compressed font evicts the least recently used glyph. The
+    cache is only built with the compressed 8x16 font, so add
+    -DCFBD_GLYPH_CACHE_SLOTS=8 to the build command to cover it; without it
+    compressed fonts must be refused.
+*/
+#include <string.h>
+
+// 与普通字库一同编入生成的压缩字库, 用于往返比对
+#define ENABLE_ASCII_8x16_COMPRESSED 1
+#include "resource/default/ascii8x16.rle.c"
+// 以下按库的实际配置编译
+#undef ENABLE_ASCII_8x16_COMPRESSED
+
+#include "host_test.h"
+#include "resource/rle.h"
+#include "widget/base_support/image.h"
+#include "widget/text_font.h"
+
+extern const uint8_t ascii8x16_sources[][16];
+
+#define STREAM_BYTES (4096)
+
+static uint8_t encoded[2 * STREAM_BYTES];
+static uint8_t expected[STREAM_BYTES + 128];
+
+/* Random tokens of every kind, @p expected receives what they decode to */
+static void make_stream(uint16_t bytes)
+{
+    uint8_t* in = encoded;
+    uint16_t out = 0;
+    while (out < bytes) {
+        const uint8_t n = (uint8_t) host_random(64);
+        switch (host_random(4)) {
+            case 0:
+                *in++ = n;
+                for (int i = 0; i <= n; i++)
+                    expected[out++] = *in++ = (uint8_t) host_random(256);
+                break;
+            case 1:
+                *in++ = 0x40 | n;
+                memset(&expected[out], 0, n + 1);
+                out += n + 1;
+                break;
+            case 2: {
+                const uint8_t value = (uint8_t) host_random(256);
+                *in++ = 0x80 | n;
+                *in++ = value;
+                memset(&expected[out], value, n + 2);
+                out += n + 2;
+            } break;
+            default: {
+                const uint8_t zeros = n >> 3, literals = (n & 0x07) + 1;
+                *in++ = 0xC0 | n;
+                memset(&expected[out], 0, zeros);
+                out += zeros;
+                for (int i = 0; i < literals; i++)
+                    expected[out++] = *in++ = (uint8_t) host_random(256);
+            } break;
+        }
+    }
+}
+
+static void check_stream(void)
+{
+    static uint8_t decoded[STREAM_BYTES];
+    for (int round = 0; round < 500; round++) {
+        const uint16_t bytes = 1 + host_random(STREAM_BYTES);
+        make_stream(bytes);
+        memset(decoded, 0xA5, sizeof(decoded));
+
+        CFBDGraphic_RleStream stream;
+        CFBDGraphic_RleOpen(&stream, encoded);
+        uint16_t at = 0;
+        CFBD_Bool same = CFBD_TRUE;
+        while (at < bytes) {
+            uint16_t count = 1 + host_random(200);
+            if (count > bytes - at)
+                count = bytes - at;
+            if (host_random(3) == 0) {
+                CFBDGraphic_RleRead(&stream, NULL, count); // skipped
+            }
+            else {
+                CFBDGraphic_RleRead(&stream, &decoded[at], count);
+                if (memcmp(&decoded[at], &expected[at], count) != 0)
+                    same = CFBD_FALSE;
+            }
+            at += count;
+        }
+        HOST_CHECK(same, "round %d: %d byte stream decoded wrong", round, bytes);
+    }
+}
+
+static void check_font_table(void)
+{
+    CFBD_Bool same = CFBD_TRUE;
+    for (int glyph = 0; glyph < 95; glyph++) {
+        uint8_t decoded[16];
+        CFBDGraphic_RleStream stream;
+        CFBDGraphic_RleOpen(&stream, ascii8x16_rle + ascii8x16_rle_blocks[glyph / 8]);
+        CFBDGraphic_RleRead(&stream, NULL, (glyph % 8) * 16);
+        CFBDGraphic_RleRead(&stream, decoded, 16);
+        if (memcmp(decoded, ascii8x16_sources[glyph], 16) != 0)
+            same = CFBD_FALSE;
+    }
+    HOST_CHECK(same, "generated 8x16 RLE table differs from the plain table");
+}
+
+static void check_image(CFBD_Bool fast_path)
+{
+    static HostPanel plain, compressed;
+    host_bind(&plain, CFBD_CANVAS_1BPP_PAGE, fast_path);
+    host_bind(&compressed, CFBD_CANVAS_1BPP_PAGE, fast_path);
+
+    for (int round = 0; round < 300; round++) {
+        CFBDGraphicSize size = {1 + host_random(HOST_WIDTH), 1 + host_random(HOST_HEIGHT)};
+        CFBDGraphic_Point at = {host_random(HOST_WIDTH), host_random(HOST_HEIGHT)};
+        make_stream(size.width * ((size.height + 7) / 8));
+
+        CCGraphic_Image image;
+        host_clear(&plain);
+        CFBDGraphic_InitImage(&image, &at, &size, expected);
+        CFBDGraphic_DrawImage(&plain.device, &image);
+        host_clear(&compressed);
+        CFBDGraphic_InitCompressedImage(&image, &at, &size, encoded);
+        CFBDGraphic_DrawImage(&compressed.device, &image);
+        HOST_CHECK(host_same_pixels(&plain, &compressed),
+                   "round %d: %dx%d image at (%d,%d) differs from the plain one",
+                   round,
+                   size.width,
+                   size.height,
+                   at.x,
+                   at.y);
+    }
+}
+
+/* A reference LRU next to the cache: slot order is recency, front is newest */
+static void check_glyph_cache(void)
+{
+    static const CFBDGraphic_Font font = {.width = 8,
+                                          .height = 16,
+                                          .glyph_bytes = 16,
+                                          .first = ' ',
+                                          .last = '~',
+                                          .glyphs = ascii8x16_rle,
+                                          .fallback = '?',
+                                          .blocks = ascii8x16_rle_blocks,
+                                          .block_glyphs = 8};
+#if CFBD_GLYPH_CACHE_SLOTS == 0
+    HOST_CHECK(CFBDGraphic_RegisterFont(&font) == NO_ASCII_SIZE,
+               "compressed font accepted without a glyph cache");
+#else
+    HOST_CHECK(CFBDGraphic_RegisterFont(&font) != NO_ASCII_SIZE, "compressed font rejected");
+
+    uint32_t recent[CFBD_GLYPH_CACHE_SLOTS];
+    int cached = 0;
+    uint32_t hits = 0, misses = 0;
+    CFBDGraphic_GlyphCacheStats stats;
+    CFBDGraphic_FetchGlyphCacheStats(&stats, CFBD_TRUE);
+
+    for (int round = 0; round < 20000; round++) {
+        // 少量热字符 + 随机冷字符
+        const uint32_t code = host_random(4) ? ' ' + host_random(10) : ' ' + host_random(95);
+        const uint8_t* glyph = CFBDGraphic_FontGlyph(&font, code);
+        HOST_CHECK(glyph && memcmp(glyph, ascii8x16_sources[code - ' '], 16) == 0,
+                   "round %d: cached glyph of '%c' differs",
+                   round,
+                   (char) code);
+
+        int found = 0;
+        while (found < cached && recent[found] != code)
+            found++;
+        if (found < cached) {
+            hits++;
+        }
+        else {
+            misses++;
+            if (cached < CFBD_GLYPH_CACHE_SLOTS)
+                cached++;
+            found = cached - 1;
+        }
+        memmove(&recent[1], &recent[0], found * sizeof(recent[0]));
+        recent[0] = code;
+    }
+
+    CFBDGraphic_FetchGlyphCacheStats(&stats, CFBD_FALSE);
+    HOST_CHECK(stats.hits == hits && stats.misses == misses,
+               "cache %lu hits %lu misses, LRU expects %lu and %lu",
+               (unsigned long) stats.hits,
+               (unsigned long) stats.misses,
+               (unsigned long) hits,
+               (unsigned long) misses);
+#endif
+}
+
+int main(void)
+{
+    check_stream();
+    check_font_table();
+    check_image(CFBD_TRUE);
+    check_image(CFBD_FALSE);
+    check_glyph_cache();
+    return host_report("rle");
+}
@@ -0,0 +1,166 @@
+/*
+    Scaled blits against a per-pixel nearest neighbour reference, with the
+    2x and 4x lookup table paths forced every third round and the raster op
+    applied to the random content already on the panel. An immediate device
+    is flushed once per blit. Scaled text shows every glyph pixel as a
+    scale x scale block.
+*/
+#include <string.h>
+
+#include "device/graphic_canvas.h"
+#include "device/graphic_scale.h"
+#include "host_test.h"
+#include "widget/text.h"
+#include "widget/text_font.h"
+
+#define BITMAP_WIDTH (48)
+#define BITMAP_HEIGHT (40)
+
+static uint8_t bitmap[CFBDGraphic_MEMORY_CANVAS_BYTES(BITMAP_WIDTH, BITMAP_HEIGHT)];
+
+static CFBD_Bool bitmap_pixel(uint16_t x, uint16_t y)
+{
+    return (bitmap[(y / 8) * BITMAP_WIDTH + x] >> (y & 7)) & 0x01;
+}
+
+/* Nearest source pixel at the center of scaled pixel @p u, in 16.16 like the library */
+static int32_t scaled_source(uint16_t size, uint16_t scaled, int32_t u)
+{
+    const uint32_t step = ((uint32_t) size << 16) / scaled;
+    return (int32_t) ((u * step + step / 2) >> 16);
+}
+
+static void random_content(HostPanel* panel, HostPanel* before, CFBDGraphic_BlitSource* source)
+{
+    for (size_t i = 0; i < sizeof(bitmap); i++)
+        bitmap[i] = (uint8_t) host_random(256);
+    // 4bpp 像素只取全暗或全亮, XOR 的结果才与亮灭参考一致
+    for (size_t i = 0; i < sizeof(panel->pixels); i++) {
+        const uint8_t random = (uint8_t) host_random(256);
+        if (panel->canvas.format == CFBD_CANVAS_4BPP_PACKED)
+            panel->pixels[i] = ((random & 0x10) ? 0xF0 : 0) | ((random & 0x01) ? 0x0F : 0);
+        else
+            panel->pixels[i] = random;
+    }
+    memcpy(before->pixels, panel->pixels, sizeof(panel->pixels));
+
+    source->bitmap = bitmap;
+    source->stride = BITMAP_WIDTH;
+    source->x = host_random(BITMAP_WIDTH);
+    source->y = host_random(BITMAP_HEIGHT);
+    source->width = 1 + host_random(BITMAP_WIDTH - source->x);
+    source->height = 1 + host_random(BITMAP_HEIGHT - source->y);
+}
+
+static void check_scaling(CFBDGraphic_CanvasFormat format, CFBD_Bool fast_path)
+{
+    static HostPanel panel, before;
+    host_bind(&panel, format, fast_path);
+    host_bind(&before, format, CFBD_TRUE);
+    host_count_flushes(&panel);
+
+    for (int round = 0; round < 6000; round++) {
+        CFBDGraphic_BlitSource source;
+        random_content(&panel, &before, &source);
+        uint16_t width = 1 + host_random(96), height = 1 + host_random(64);
+        if (round % 3 == 0) {
+            // the lookup table paths
+            const uint16_t factor = (round % 2) ? 2 : 4;
+            source.width = 1 + host_random(source.width < 24 ? source.width : 24);
+            source.height = 1 + host_random(source.height < 16 ? source.height : 16);
+            width = factor * source.width;
+            height = factor * source.height;
+        }
+        const CFBDGraphic_RasterOp rop = (CFBDGraphic_RasterOp) host_random(4);
+        const uint16_t x = host_random(HOST_WIDTH), y = host_random(HOST_HEIGHT);
+
+        host_flushes = 0;
+        CFBDGraphic_DeviceBlitScaled(&panel.device, &source, x, y, width, height, rop);
+
+        CFBD_Bool same = CFBD_TRUE;
+        for (int32_t py = 0; py < HOST_HEIGHT; py++) {
+            for (int32_t px = 0; px < HOST_WIDTH; px++) {
+                const CFBD_Bool under = host_pixel(&before, px, py);
+                CFBD_Bool expected = under;
+                if (px >= x && px < x + width && py >= y && py < y + height) {
+                    const int32_t sx = scaled_source(source.width, width, px - x);
+                    const int32_t sy = scaled_source(source.height, height, py - y);
+                    expected = host_raster_op(
+                            rop, under, bitmap_pixel(source.x + sx, source.y + sy));
+                }
+                if (host_pixel(&panel, px, py) != expected)
+                    same = CFBD_FALSE;
+            }
+        }
+        HOST_CHECK(same,
+                   "scale %dx%d to %dx%d rop %d at (%d,%d) format %d fast path %d",
+                   source.width,
+                   source.height,
+                   width,
+                   height,
+                   rop,
+                   x,
+                   y,
+                   format,
+                   fast_path);
+        /* the pixel-only setArea() path flushes on its own */
+        HOST_CHECK(!fast_path || host_flushes == 1,
+                   "scale to %dx%d: %u flushes",
+                   width,
+                   height,
+                   host_flushes);
+    }
+}
+
+static void check_text(void)
+{
+    static HostPanel panel;
+    host_bind(&panel, CFBD_CANVAS_1BPP_PAGE, CFBD_TRUE);
+    const CFBDGraphic_Font* font = CFBDGraphic_FetchFont(ASCII_6x8);
+
+    for (int round = 0; round < 300; round++) {
+        char text[6];
+        for (int i = 0; i < 5; i++)
+            text[i] = (char) ('!' + host_random(94));
+        text[5] = '\0';
+        const uint8_t scale = (uint8_t) (1 + host_random(4));
+        const CFBDGraphic_Point at = {host_random(HOST_WIDTH), host_random(HOST_HEIGHT)};
+
+        host_clear(&panel);
+        const CFBDGraphic_Point end =
+                CFBDGraphic_DrawTextScaled(&panel.device, &at, text, ASCII_6x8, scale);
+        HOST_CHECK(end.x == at.x + 5 * 6 * scale && end.y == at.y,
+                   "round %d: ended at (%d,%d)",
+                   round,
+                   end.x,
+                   end.y);
+
+        CFBD_Bool same = CFBD_TRUE;
+        for (int i = 0; i < 5; i++) {
+            const uint8_t* glyph = CFBDGraphic_FontGlyph(font, (uint8_t) text[i]);
+            for (int y = 0; y < 8 * scale; y++) {
+                for (int x = 0; x < 6 * scale; x++) {
+                    const int32_t px = at.x + i * 6 * scale + x, py = at.y + y;
+                    const CFBD_Bool ink = (glyph[x / scale] >> (y / scale)) & 1;
+                    if (px < HOST_WIDTH && py < HOST_HEIGHT && host_pixel(&panel, px, py) != ink)
+                        same = CFBD_FALSE;
+                }
+            }
+        }
+        HOST_CHECK(same,
+                   "round %d: \"%s\" at %dx differs from the enlarged glyphs",
+                   round,
+                   text,
+                   scale);
+    }
+}
+
+int main(void)
+{
+    for (int fast_path = 0; fast_path < 2; fast_path++) {
+        check_scaling(CFBD_CANVAS_1BPP_PAGE, fast_path);
+        check_scaling(CFBD_CANVAS_4BPP_PACKED, fast_path);
+    }
+    check_text();
+    return host_report("scale");
+}
@@ -0,0 +1,169 @@
+/*
+    Frame buffer scrolling against a per-pixel reference: random areas,
+    partly off screen and cut by a clip rectangle, move their random
+    content by random rows or columns either way, further than the area
+    included. Inside the visible part of the area every pixel comes from
+    the pixel dy rows (dx columns) away or is cleared; every other pixel,
+    and every grey level of a 4bpp panel, must stay as it was. A hardware
+    scroll reaches only a device with a "scroll" property.
+*/
+#include <string.h>
+
+#include "device/graphic_clip.h"
+#include "device/graphic_scroll.h"
+#include "host_test.h"
+
+/* Raw pixel value: the bit of a 1bpp panel, the grey level of a 4bpp one */
+static uint8_t raw_pixel(const HostPanel* panel, int32_t x, int32_t y)
+{
+    if (panel->canvas.format == CFBD_CANVAS_4BPP_PACKED) {
+        const uint8_t byte = panel->pixels[y * ((HOST_WIDTH + 1) / 2) + x / 2];
+        return (x & 1) ? (byte & 0x0F) : (byte >> 4);
+    }
+    return (panel->pixels[(y / 8) * HOST_WIDTH + x] >> (y & 7)) & 0x01;
+}
+
+static void check_scroll(CFBDGraphic_CanvasFormat format, CFBD_Bool rows)
+{
+    static HostPanel panel, before;
+    host_bind(&panel, format, CFBD_TRUE);
+    host_bind(&before, format, CFBD_TRUE);
+
+    for (int round = 0; round < 6000; round++) {
+        for (size_t i = 0; i < sizeof(panel.pixels); i++)
+            panel.pixels[i] = (uint8_t) host_random(256);
+        memcpy(before.pixels, panel.pixels, sizeof(panel.pixels));
+
+        const uint16_t x = host_random(HOST_WIDTH + 8), y = host_random(HOST_HEIGHT + 8);
+        const uint16_t width = 1 + host_random(HOST_WIDTH), height = 1 + host_random(HOST_HEIGHT);
+        const int32_t span = rows ? height : width;
+        const int16_t delta = (int16_t) ((int32_t) host_random(2 * span + 9) - span - 4);
+        CFBDGraphicRect clip = {{host_random(HOST_WIDTH), host_random(HOST_HEIGHT)},
+                                {HOST_WIDTH - 1, HOST_HEIGHT - 1}};
+        clip.br.x = clip.tl.x + host_random(HOST_WIDTH - clip.tl.x);
+        clip.br.y = clip.tl.y + host_random(HOST_HEIGHT - clip.tl.y);
+        const CFBD_Bool clipped = host_random(3) == 0;
+
+        if (clipped)
+            CFBDGraphic_PushClip(&panel.device, &clip);
+        const CFBD_Bool done =
+                rows ? CFBDGraphic_DeviceScrollRows(&panel.device, x, y, width, height, delta)
+                     : CFBDGraphic_DeviceScrollColumns(&panel.device, x, y, width, height, delta);
+        if (clipped)
+            CFBDGraphic_PopClip(&panel.device);
+
+        // the visible part of the area, inclusive
+        int32_t x0 = x, y0 = y, x1 = x + width - 1, y1 = y + height - 1;
+        if (x1 > HOST_WIDTH - 1)
+            x1 = HOST_WIDTH - 1;
+        if (y1 > HOST_HEIGHT - 1)
+            y1 = HOST_HEIGHT - 1;
+        if (clipped) {
+            x0 = (x0 > clip.tl.x) ? x0 : clip.tl.x;
+            y0 = (y0 > clip.tl.y) ? y0 : clip.tl.y;
+            x1 = (x1 < clip.br.x) ? x1 : clip.br.x;
+            y1 = (y1 < clip.br.y) ? y1 : clip.br.y;
+        }
+
+        CFBD_Bool same = CFBD_TRUE;
+        for (int32_t py = 0; py < HOST_HEIGHT; py++) {
+            for (int32_t px = 0; px < HOST_WIDTH; px++) {
+                uint8_t expected = raw_pixel(&before, px, py);
+                if (px >= x0 && px <= x1 && py >= y0 && py <= y1) {
+                    const int32_t sx = rows ? px : px - delta;
+                    const int32_t sy = rows ? py - delta : py;
+                    const CFBD_Bool inside = sx >= x0 && sx <= x1 && sy >= y0 && sy <= y1;
+                    expected = inside ? raw_pixel(&before, sx, sy) : 0;
+                }
+                if (raw_pixel(&panel, px, py) != expected)
+                    same = CFBD_FALSE;
+            }
+        }
+        HOST_CHECK(done && same,
+                   "%s by %d of %dx%d at (%d,%d)%s format %d",
+                   rows ? "rows" : "columns",
+                   delta,
+                   width,
+                   height,
+                   x,
+                   y,
+                   clipped ? " clipped" : "",
+                   format);
+    }
+}
+
+/* Without frame buffer access the caller is told to redraw */
+static void check_no_canvas(void)
+{
+    static HostPanel panel;
+    host_bind(&panel, CFBD_CANVAS_1BPP_PAGE, CFBD_FALSE);
+    HOST_CHECK(!CFBDGraphic_DeviceScrollRows(&panel.device, 0, 0, HOST_WIDTH, HOST_HEIGHT, 3),
+               "rows scrolled without a canvas");
+    HOST_CHECK(!CFBDGraphic_DeviceScrollColumns(&panel.device, 0, 0, HOST_WIDTH, HOST_HEIGHT, 3),
+               "columns scrolled without a canvas");
+}
+
+/* Hardware scroll goes through the "scroll" property, a device without one says so */
+static CFBD_GraphicDeviceOperation scrolling_ops;
+static CFBD_GraphicDeviceOperation* memory_ops;
+static CFBDGraphic_HardwareScroll requested;
+static unsigned scroll_requests;
+
+static CFBD_Bool scrolling_sets(CFBD_GraphicDevice* device,
+                                const char* property,
+                                void* args,
+                                void* request_data)
+{
+    if (strcmp(property, "scroll") == 0) {
+        requested = *(const CFBDGraphic_HardwareScroll*) request_data;
+        scroll_requests++;
+        return CFBD_TRUE;
+    }
+    return memory_ops->self_sets(device, property, args, request_data);
+}
+
+static void check_hardware_scroll(void)
+{
+    static HostPanel panel, before;
+    host_bind(&panel, CFBD_CANVAS_1BPP_PAGE, CFBD_TRUE);
+    host_bind(&before, CFBD_CANVAS_1BPP_PAGE, CFBD_TRUE);
+    for (size_t i = 0; i < sizeof(panel.pixels); i++)
+        panel.pixels[i] = (uint8_t) host_random(256);
+    memcpy(before.pixels, panel.pixels, sizeof(panel.pixels));
+
+    const CFBDGraphic_HardwareScroll ticker = {CFBD_HW_SCROLL_LEFT, 0, 8, HOST_WIDTH, 16, 5, 0};
+    HOST_CHECK(!CFBDGraphic_DeviceStartHardwareScroll(&panel.device, &ticker),
+               "memory device started a hardware scroll");
+    HOST_CHECK(!CFBDGraphic_DeviceStopHardwareScroll(&panel.device),
+               "memory device stopped a hardware scroll");
+    HOST_CHECK(!memcmp(panel.pixels, before.pixels, sizeof(panel.pixels)),
+               "a rejected hardware scroll touched the frame buffer");
+
+    memory_ops = panel.device.ops;
+    scrolling_ops = *memory_ops;
+    scrolling_ops.self_sets = scrolling_sets;
+    panel.device.ops = &scrolling_ops;
+    scroll_requests = 0;
+    HOST_CHECK(CFBDGraphic_DeviceStartHardwareScroll(&panel.device, &ticker) &&
+                       scroll_requests == 1 && requested.direction == ticker.direction &&
+                       requested.y == ticker.y && requested.width == ticker.width &&
+                       requested.height == ticker.height && requested.frames == ticker.frames,
+               "hardware scroll not passed on unchanged");
+    HOST_CHECK(CFBDGraphic_DeviceStopHardwareScroll(&panel.device) && scroll_requests == 2 &&
+                       requested.direction == CFBD_HW_SCROLL_STOP,
+               "stop sent direction %d",
+               requested.direction);
+    HOST_CHECK(!memcmp(panel.pixels, before.pixels, sizeof(panel.pixels)),
+               "a hardware scroll touched the frame buffer");
+}
+
+int main(void)
+{
+    check_scroll(CFBD_CANVAS_1BPP_PAGE, CFBD_TRUE);
+    check_scroll(CFBD_CANVAS_1BPP_PAGE, CFBD_FALSE);
+    check_scroll(CFBD_CANVAS_4BPP_PACKED, CFBD_TRUE);
+    check_scroll(CFBD_CANVAS_4BPP_PACKED, CFBD_FALSE);
+    check_no_canvas();
+    check_hardware_scroll();
+    return host_report("scroll");
+}
@@ -0,0 +1,161 @@
+/*
+    Sprite player: random frames delta encoded like cfbd_rle.py does are
+    played with random tick gaps, late ticks included. After every tick the
+    sprite area shows the frame that is due, and an immediate device got
+    one flush covering the reported dirty box, or none when nothing changed.
+*/
+#include <string.h>
+
+#include "host_test.h"
+#include "widget/animation/sprite_animation.h"
+
+#define SPRITE_WIDTH (24)
+#define SPRITE_HEIGHT (20)
+#define SPRITE_PAGES ((SPRITE_HEIGHT + 7) / 8)
+#define SPRITE_BYTES (SPRITE_WIDTH * SPRITE_PAGES)
+#define FRAMES (6)
+#define DELAY_MS (40)
+
+static uint8_t frames[FRAMES][SPRITE_BYTES];
+static uint8_t deltas[(FRAMES + 1) * 3 * SPRITE_BYTES];
+static uint16_t offsets[FRAMES + 2];
+
+/* Runs of changed bytes per page row, same layout as the converter emits */
+static uint16_t encode_delta(const uint8_t* prev, const uint8_t* cur, uint16_t at)
+{
+    uint16_t skip = 0;
+    for (uint16_t page = 0; page < SPRITE_PAGES; page++) {
+        uint16_t column = 0;
+        while (column < SPRITE_WIDTH) {
+            const uint16_t i = page * SPRITE_WIDTH + column;
+            if (prev[i] == cur[i]) {
+                skip++;
+                column++;
+                continue;
+            }
+            while (skip > 255) {
+                deltas[at++] = 255;
+                deltas[at++] = 0;
+                skip -= 255;
+            }
+            uint16_t count = 0;
+            while (column + count < SPRITE_WIDTH && prev[i + count] != cur[i + count])
+                count++;
+            deltas[at++] = (uint8_t) skip;
+            deltas[at++] = (uint8_t) count;
+            memcpy(&deltas[at], &cur[i], count);
+            at += count;
+            skip = 0;
+            column += count;
+        }
+    }
+    return at;
+}
+
+static void build_sheet(CFBDGraphic_SpriteSheet* sheet)
+{
+    static const uint8_t blank[SPRITE_BYTES];
+    // 每帧只改动少量字节, 与真实动画相近
+    for (int i = 0; i < SPRITE_BYTES; i++)
+        frames[0][i] = (uint8_t) host_random(256);
+    for (int k = 1; k < FRAMES; k++) {
+        memcpy(frames[k], frames[k - 1], SPRITE_BYTES);
+        for (int n = host_random(12); n >= 0; n--)
+            frames[k][host_random(SPRITE_BYTES)] = (uint8_t) host_random(256);
+    }
+
+    uint16_t at = 0;
+    offsets[0] = 0;
+    at = encode_delta(blank, frames[0], at);
+    for (int k = 1; k < FRAMES; k++) {
+        offsets[k] = at;
+        at = encode_delta(frames[k - 1], frames[k], at);
+    }
+    offsets[FRAMES] = at;
+    at = encode_delta(frames[FRAMES - 1], frames[0], at);
+    offsets[FRAMES + 1] = at;
+
+    *sheet = (CFBDGraphic_SpriteSheet) {SPRITE_WIDTH, SPRITE_HEIGHT, FRAMES, deltas, offsets};
+}
+
+static CFBD_Bool shows_frame(const HostPanel* panel, CFBDGraphic_Point at, int frame)
+{
+    for (int y = 0; y < SPRITE_HEIGHT; y++) {
+        for (int x = 0; x < SPRITE_WIDTH; x++) {
+            const CFBD_Bool ink = (frames[frame][(y / 8) * SPRITE_WIDTH + x] >> (y % 8)) & 1;
+            if (host_pixel(panel, at.x + x, at.y + y) != ink)
+                return CFBD_FALSE;
+        }
+    }
+    return CFBD_TRUE;
+}
+
+static void check_playback(CFBD_Bool loop)
+{
+    static HostPanel panel;
+    host_bind(&panel, CFBD_CANVAS_1BPP_PAGE, CFBD_TRUE);
+    host_count_flushes(&panel);
+
+    for (int round = 0; round < 200; round++) {
+        CFBDGraphic_SpriteSheet sheet;
+        build_sheet(&sheet);
+        CFBDGraphic_Point at = {host_random(HOST_WIDTH - SPRITE_WIDTH),
+                                host_random(HOST_HEIGHT - SPRITE_HEIGHT)};
+        CFBDGraphic_SpritePlayer player;
+        CFBDGraphic_InitSpritePlayer(&player, &sheet, &at, DELAY_MS, loop);
+
+        // 起点靠近 uint32 回绕
+        const uint32_t start = UINT32_MAX - host_random(4 * DELAY_MS);
+        uint32_t now = start;
+        host_clear(&panel);
+        for (int tick = 0; tick < 60; tick++) {
+            host_flushes = 0;
+            CFBDGraphicRect dirty;
+            const CFBD_Bool changed =
+                    CFBDGraphic_SpritePlayerTick(&panel.device, &player, now, &dirty);
+
+            const uint32_t due = (now - start) / DELAY_MS;
+            const int frame = loop ? (int) (due % FRAMES) : (due < FRAMES ? (int) due : FRAMES - 1);
+            HOST_CHECK(player.frame == frame && shows_frame(&panel, at, frame),
+                       "round %d tick %d: %lu ms in, frame %d shown, %d due",
+                       round,
+                       tick,
+                       (unsigned long) (now - start),
+                       player.frame,
+                       frame);
+            const CFBDGraphic_ClipBounds* f = &host_last_flush;
+            if (changed) {
+                HOST_CHECK(host_flushes == 1 && f->x0 == dirty.tl.x && f->y0 == dirty.tl.y &&
+                                   f->x1 == dirty.br.x && f->y1 == dirty.br.y,
+                           "round %d tick %d: %u flushes, last (%d,%d)-(%d,%d)",
+                           round,
+                           tick,
+                           host_flushes,
+                           f->x0,
+                           f->y0,
+                           f->x1,
+                           f->y1);
+            }
+            else {
+                HOST_CHECK(host_flushes == 0,
+                           "round %d tick %d: flushed without change",
+                           round,
+                           tick);
+            }
+            HOST_CHECK(CFBDGraphic_SpritePlayerFinished(&player) == (!loop && frame == FRAMES - 1),
+                       "round %d tick %d: finished flag wrong",
+                       round,
+                       tick);
+
+            // 多数 tick 不足一帧, 偶尔迟到好几帧
+            now += host_random(8) ? host_random(DELAY_MS) : host_random(6 * DELAY_MS);
+        }
+    }
+}
+
+int main(void)
+{
+    check_playback(CFBD_TRUE);
+    check_playback(CFBD_FALSE);
+    return host_report("sprite");
+}
@@ -0,0 +1,179 @@
+/*
+    Text layout: cell positions, line count and bounds of a layout match a
+    walk of the string with the wrapping rule of DrawText, MeasureText
+    gives the size of that walk, and a layout computed once draws the same
+    pixels and returns the same point as DrawText, every cell inside the
+    bounds.
+*/
+#include "host_test.h"
+#include "widget/text.h"
+#include "widget/text_font.h"
+
+#define MAX_CELLS (48)
+
+typedef struct
+{
+    CFBDGraphic_Point cells[MAX_CELLS];
+    int count;
+    int lines;
+    int32_t lx, ty, rx, by;
+} Walk;
+
+/* Reference: a cell wraps the line when less than 1.5 cells are left after it */
+static void walk(const char* text,
+                 CFBDGraphicSize cell,
+                 CFBDGraphic_Point origin,
+                 int32_t line_x,
+                 int32_t right,
+                 CFBD_Bool wrap,
+                 Walk* out)
+{
+    int32_t x = origin.x, y = origin.y;
+    out->count = 0;
+    out->lines = 0;
+    out->lx = out->ty = INT32_MAX;
+    out->rx = out->by = INT32_MIN;
+    for (const char* cursor = text; CFBDGraphic_DecodeUTF8(&cursor) != 0;) {
+        out->cells[out->count++] = (CFBDGraphic_Point) {x, y};
+        out->lx = (x < out->lx) ? x : out->lx;
+        out->ty = (y < out->ty) ? y : out->ty;
+        out->rx = (x + cell.width > out->rx) ? x + cell.width : out->rx;
+        out->by = (y + cell.height > out->by) ? y + cell.height : out->by;
+        if (wrap && x + (3 * cell.width) / 2 >= right) {
+            x = line_x;
+            y += cell.height;
+        }
+        else {
+            x += cell.width;
+        }
+    }
+    if (out->count != 0)
+        out->lines = (out->by - out->ty) / cell.height;
+}
+
+static void random_text(char* text, int length)
+{
+    for (int i = 0; i < length; i++)
+        text[i] = (char) ('!' + host_random(94));
+    text[length] = '\0';
+}
+
+static void check_layout(void)
+{
+    static HostPanel panel, direct;
+    host_bind(&panel, CFBD_CANVAS_1BPP_PAGE, CFBD_TRUE);
+    host_bind(&direct, CFBD_CANVAS_1BPP_PAGE, CFBD_TRUE);
+
+    for (int round = 0; round < 4000; round++) {
+        char text[MAX_CELLS + 1];
+        random_text(text, host_random(MAX_CELLS));
+        const Ascii_Font_Size font = (round % 2) ? ASCII_6x8 : ASCII_8x16;
+        const CFBDGraphicSize cell = (font == ASCII_6x8) ? (CFBDGraphicSize) {6, 8}
+                                                         : (CFBDGraphicSize) {8, 16};
+        const CFBDGraphic_Point tl = {host_random(HOST_WIDTH), host_random(HOST_HEIGHT)};
+        const CFBDGraphicSize area = {host_random(2 * HOST_WIDTH), HOST_HEIGHT};
+        const CFBD_Bool wrap = host_random(2);
+
+        CFBDGraphic_Text item;
+        CFBDGraphic_InitText(&item, tl, area, font);
+        item.no_wrap = !wrap;
+        CFBDGraphic_SetText(&item, text);
+        if (host_random(3) == 0) {
+            CFBDGraphic_Point resume = {tl.x + host_random(40), tl.y};
+            CFBDGraphic_SetTextIndexedPoint(&item, &resume);
+        }
+
+        CFBDGraphic_TextLayout layout;
+        CFBDGraphic_LayoutText(&panel.device, &item, &layout);
+        Walk expected;
+        const int32_t right = (tl.x + area.width < HOST_WIDTH) ? tl.x + area.width : HOST_WIDTH;
+        walk(text, cell, item.indexed_point, tl.x, right, wrap, &expected);
+
+        HOST_CHECK(layout.cells == expected.count && layout.lines == expected.lines,
+                   "round %d: %d cells %d lines, expected %d and %d",
+                   round,
+                   layout.cells,
+                   layout.lines,
+                   expected.count,
+                   expected.lines);
+        CFBD_Bool same = CFBD_TRUE;
+        for (int i = 0; i < expected.count; i++) {
+            CFBDGraphic_Point at;
+            CFBDGraphic_TextLayoutCell(&layout, i, &at);
+            if (at.x != expected.cells[i].x || at.y != expected.cells[i].y)
+                same = CFBD_FALSE;
+        }
+        HOST_CHECK(same, "round %d: \"%s\" cell positions differ from the walk", round, text);
+        if (expected.count != 0) {
+            HOST_CHECK(layout.bounds.tl.x == expected.lx && layout.bounds.tl.y == expected.ty &&
+                               layout.bounds.br.x == expected.rx &&
+                               layout.bounds.br.y == expected.by,
+                       "round %d: bounds (%d,%d)-(%d,%d), walk (%d,%d)-(%d,%d)",
+                       round,
+                       layout.bounds.tl.x,
+                       layout.bounds.tl.y,
+                       layout.bounds.br.x,
+                       layout.bounds.br.y,
+                       expected.lx,
+                       expected.ty,
+                       expected.rx,
+                       expected.by);
+        }
+
+        // 与 DrawText 的像素与返回点一致, 且不超出包围盒
+        CFBDGraphic_Text twin = item;
+        host_clear(&panel);
+        host_clear(&direct);
+        const AppendMethod method = (AppendMethod) host_random(3);
+        const CFBDGraphic_Point a = CFBDGraphic_DrawTextLayout(&panel.device, &item, &layout, method);
+        const CFBDGraphic_Point b = CFBDGraphic_DrawText(&direct.device, &twin, method);
+        HOST_CHECK(host_same_pixels(&panel, &direct) && a.x == b.x && a.y == b.y,
+                   "round %d: layout draw differs from DrawText",
+                   round);
+
+        CFBD_Bool inside = CFBD_TRUE;
+        for (int32_t y = 0; y < HOST_HEIGHT; y++) {
+            for (int32_t x = 0; x < HOST_WIDTH; x++) {
+                if (host_pixel(&panel, x, y) &&
+                    (x < layout.bounds.tl.x || x >= layout.bounds.br.x ||
+                     y < layout.bounds.tl.y || y >= layout.bounds.br.y))
+                    inside = CFBD_FALSE;
+            }
+        }
+        HOST_CHECK(inside, "round %d: \"%s\" drawn outside its bounds", round, text);
+    }
+}
+
+static void check_measure(void)
+{
+    for (int round = 0; round < 4000; round++) {
+        char text[MAX_CELLS + 1];
+        random_text(text, host_random(MAX_CELLS));
+        const Ascii_Font_Size font = (round % 2) ? ASCII_6x8 : ASCII_8x16;
+        const CFBDGraphicSize cell = (font == ASCII_6x8) ? (CFBDGraphicSize) {6, 8}
+                                                         : (CFBDGraphicSize) {8, 16};
+        const SizeBaseType max_width = (round % 3) ? host_random(200) : 0;
+
+        Walk expected;
+        walk(text, cell, (CFBDGraphic_Point) {0, 0}, 0, max_width, max_width != 0, &expected);
+        const CFBDGraphicSize size = CFBDGraphic_MeasureText(text, font, max_width);
+        const int32_t width = expected.count ? expected.rx - expected.lx : 0;
+        const int32_t height = expected.count ? expected.by - expected.ty : 0;
+        HOST_CHECK(size.width == width && size.height == height,
+                   "round %d: \"%s\" in %d px measured %dx%d, walk %dx%d",
+                   round,
+                   text,
+                   max_width,
+                   size.width,
+                   size.height,
+                   width,
+                   height);
+    }
+}
+
+int main(void)
+{
+    check_layout();
+    check_measure();
+    return host_report("text_layout");
+}
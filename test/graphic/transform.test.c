@@ -0,0 +1,174 @@
+/*
+    Rotated and mirrored blits against a per-pixel reference: every
+    destination pixel is looked up in the source window on its own, with
+    the raster op applied to the random content already on the panel. An
+    immediate device is flushed once per visible blit, and the 8x8 block
+    transpose matches a bit by bit one.
+*/
+#include <string.h>
+
+#include "device/graphic_canvas.h"
+#include "device/graphic_clip.h"
+#include "device/graphic_transform.h"
+#include "host_test.h"
+
+#define BITMAP_WIDTH (48)
+#define BITMAP_HEIGHT (40)
+
+static uint8_t bitmap[CFBDGraphic_MEMORY_CANVAS_BYTES(BITMAP_WIDTH, BITMAP_HEIGHT)];
+
+static CFBD_Bool bitmap_pixel(uint16_t x, uint16_t y)
+{
+    return (bitmap[(y / 8) * BITMAP_WIDTH + x] >> (y & 7)) & 0x01;
+}
+
+/* Window pixel shown at (u, v) of the transformed window */
+static void transformed_source(const CFBDGraphic_BlitSource* source,
+                               CFBDGraphic_Transform transform,
+                               int32_t u,
+                               int32_t v,
+                               int32_t* sx,
+                               int32_t* sy)
+{
+    const int32_t w = source->width, h = source->height;
+    switch (transform) {
+        case CFBD_TRANSFORM_ROTATE_90: // clockwise
+            *sx = v;
+            *sy = h - 1 - u;
+            break;
+        case CFBD_TRANSFORM_ROTATE_180:
+            *sx = w - 1 - u;
+            *sy = h - 1 - v;
+            break;
+        case CFBD_TRANSFORM_ROTATE_270:
+            *sx = w - 1 - v;
+            *sy = u;
+            break;
+        case CFBD_TRANSFORM_MIRROR_X:
+            *sx = w - 1 - u;
+            *sy = v;
+            break;
+        case CFBD_TRANSFORM_MIRROR_Y:
+            *sx = u;
+            *sy = h - 1 - v;
+            break;
+        default:
+            *sx = u;
+            *sy = v;
+            break;
+    }
+}
+
+static void random_content(HostPanel* panel, HostPanel* before, CFBDGraphic_BlitSource* source)
+{
+    for (size_t i = 0; i < sizeof(bitmap); i++)
+        bitmap[i] = (uint8_t) host_random(256);
+    // 4bpp 像素只取全暗或全亮, XOR 的结果才与亮灭参考一致
+    for (size_t i = 0; i < sizeof(panel->pixels); i++) {
+        const uint8_t random = (uint8_t) host_random(256);
+        if (panel->canvas.format == CFBD_CANVAS_4BPP_PACKED)
+            panel->pixels[i] = ((random & 0x10) ? 0xF0 : 0) | ((random & 0x01) ? 0x0F : 0);
+        else
+            panel->pixels[i] = random;
+    }
+    memcpy(before->pixels, panel->pixels, sizeof(panel->pixels));
+
+    source->bitmap = bitmap;
+    source->stride = BITMAP_WIDTH;
+    source->x = host_random(BITMAP_WIDTH);
+    source->y = host_random(BITMAP_HEIGHT);
+    source->width = 1 + host_random(BITMAP_WIDTH - source->x);
+    source->height = 1 + host_random(BITMAP_HEIGHT - source->y);
+}
+
+static void check_transforms(CFBDGraphic_CanvasFormat format, CFBD_Bool fast_path)
+{
+    static HostPanel panel, before;
+    host_bind(&panel, format, fast_path);
+    host_bind(&before, format, CFBD_TRUE);
+    host_count_flushes(&panel);
+
+    for (int round = 0; round < 6000; round++) {
+        CFBDGraphic_BlitSource source;
+        random_content(&panel, &before, &source);
+        const CFBDGraphic_Transform transform = (CFBDGraphic_Transform) (round % 6);
+        const CFBDGraphic_RasterOp rop = (CFBDGraphic_RasterOp) host_random(4);
+        const uint16_t x = host_random(HOST_WIDTH + 8), y = host_random(HOST_HEIGHT + 8);
+        const CFBD_Bool swaps = CFBDGraphic_TransformSwapsAxes(transform);
+        const int32_t width = swaps ? source.height : source.width;
+        const int32_t height = swaps ? source.width : source.height;
+        CFBDGraphicRect clip = {{host_random(HOST_WIDTH), host_random(HOST_HEIGHT)},
+                                {HOST_WIDTH - 1, HOST_HEIGHT - 1}};
+        const CFBD_Bool clipped = host_random(3) == 0;
+
+        if (clipped)
+            CFBDGraphic_PushClip(&panel.device, &clip);
+        host_flushes = 0;
+        const CFBD_Bool drawn =
+                CFBDGraphic_DeviceBlitTransformed(&panel.device, &source, x, y, transform, rop);
+        if (clipped)
+            CFBDGraphic_PopClip(&panel.device);
+
+        CFBD_Bool same = CFBD_TRUE;
+        for (int32_t py = 0; py < HOST_HEIGHT; py++) {
+            for (int32_t px = 0; px < HOST_WIDTH; px++) {
+                const CFBD_Bool under = host_pixel(&before, px, py);
+                CFBD_Bool expected = under;
+                const CFBD_Bool visible = !clipped || (px >= clip.tl.x && py >= clip.tl.y);
+                if (visible && px >= x && px < x + width && py >= y && py < y + height) {
+                    int32_t sx, sy;
+                    transformed_source(&source, transform, px - x, py - y, &sx, &sy);
+                    expected = host_raster_op(
+                            rop, under, bitmap_pixel(source.x + sx, source.y + sy));
+                }
+                if (host_pixel(&panel, px, py) != expected)
+                    same = CFBD_FALSE;
+            }
+        }
+        HOST_CHECK(same,
+                   "transform %d rop %d window %dx%d at (%d,%d) format %d fast path %d",
+                   transform,
+                   rop,
+                   source.width,
+                   source.height,
+                   x,
+                   y,
+                   format,
+                   fast_path);
+        /* the pixel-only setArea() path flushes on its own */
+        HOST_CHECK(!fast_path || host_flushes == (drawn ? 1u : 0u),
+                   "transform %d: %u flushes, visible %d",
+                   transform,
+                   host_flushes,
+                   drawn);
+    }
+}
+
+static void check_transpose(void)
+{
+    for (int round = 0; round < 10000; round++) {
+        uint8_t block[8], original[8];
+        for (int i = 0; i < 8; i++)
+            block[i] = original[i] = (uint8_t) host_random(256);
+        CFBDGraphic_TransposeBlock8x8(block);
+
+        CFBD_Bool same = CFBD_TRUE;
+        for (int column = 0; column < 8; column++) {
+            for (int row = 0; row < 8; row++) {
+                if (((block[row] >> column) & 1) != ((original[column] >> row) & 1))
+                    same = CFBD_FALSE;
+            }
+        }
+        HOST_CHECK(same, "round %d: 8x8 transpose differs", round);
+    }
+}
+
+int main(void)
+{
+    check_transpose();
+    for (int fast_path = 0; fast_path < 2; fast_path++) {
+        check_transforms(CFBD_CANVAS_1BPP_PAGE, fast_path);
+        check_transforms(CFBD_CANVAS_4BPP_PACKED, fast_path);
+    }
+    return host_report("transform");
+}
@@ -0,0 +1,352 @@
+/*
+    Page transitions against a per-pixel reference: after every tick the
+    page area shows, column by column, the part of the new page uncovered
+    so far and the old page (shifted for a push) elsewhere; pixels outside
+    the area never change. Each frame flushes only the strip it uncovered
+    (the whole area for a push or a fade), and nothing outside the flushed
+    strip changes. The fade ramps a fake "contrast" property down and back
+    to its starting level, writing the page once on the first frame past
+    the middle, at level 0 when no frame is skipped; without the property
+    it wipes instead. The last frame shows the page, or a blank
+    area for a NULL page.
+*/
+#include <string.h>
+
+#include "host_test.h"
+#include "widget/animation/transition.h"
+
+static uint8_t page_pixels[CFBDGraphic_MEMORY_CANVAS_BYTES(HOST_WIDTH, HOST_HEIGHT)];
+
+static CFBD_Bool has_contrast;
+static uint8_t contrast;
+static unsigned contrast_sets;
+static uint8_t levels[32]; /* first contrast values set */
+static CFBD_GraphicDeviceOperation* panel_ops;
+
+/* A panel with a contrast register, when has_contrast is set */
+static CFBD_Bool contrast_consult(CFBD_GraphicDevice* device,
+                                  const char* property,
+                                  void* args,
+                                  void* request_data)
+{
+    if (has_contrast && strcmp(property, "contrast") == 0) {
+        *(uint8_t*) request_data = contrast;
+        return CFBD_TRUE;
+    }
+    return panel_ops->self_consult(device, property, args, request_data);
+}
+
+static CFBD_Bool contrast_sets_op(CFBD_GraphicDevice* device,
+                                  const char* property,
+                                  void* args,
+                                  void* request_data)
+{
+    if (strcmp(property, "contrast") == 0) {
+        if (!has_contrast)
+            return CFBD_FALSE;
+        contrast = *(uint8_t*) request_data;
+        if (contrast_sets < sizeof(levels))
+            levels[contrast_sets] = contrast;
+        contrast_sets++;
+        return CFBD_TRUE;
+    }
+    return panel_ops->self_sets(device, property, args, request_data);
+}
+
+static void bind_counting(HostPanel* panel, CFBD_Bool fast_path)
+{
+    host_bind(panel, CFBD_CANVAS_1BPP_PAGE, fast_path);
+    panel_ops = panel->device.ops;
+    CFBD_GraphicDeviceOperation* ops = host_count_flushes(panel);
+    ops->self_consult = contrast_consult;
+    ops->self_sets = contrast_sets_op;
+}
+
+static CFBD_Bool page_pixel(const CFBDGraphic_MemoryCanvas* page, int32_t c, int32_t r)
+{
+    if (page == NULL)
+        return CFBD_FALSE;
+    return (page->buffer[(r / 8) * page->width + c] >> (r & 7)) & 0x01;
+}
+
+/* Pixel expected at (px, py) once @p done columns of the new page are shown */
+static CFBD_Bool expected_pixel(const CFBDGraphic_Transition* t,
+                                CFBD_Bool pushed,
+                                const HostPanel* old,
+                                int32_t px,
+                                int32_t py)
+{
+    const int32_t c = px - t->x, r = py - t->y, w = t->width, done = t->done;
+    if (c < 0 || r < 0 || c >= w || r >= t->height)
+        return host_pixel(old, px, py);
+
+    switch (t->effect) {
+        case CFBD_TRANSITION_WIPE_RIGHT:
+            return (c < done) ? page_pixel(t->page, c, r) : host_pixel(old, px, py);
+        case CFBD_TRANSITION_WIPE_LEFT:
+            return (c >= w - done) ? page_pixel(t->page, c, r) : host_pixel(old, px, py);
+        case CFBD_TRANSITION_SLIDE_LEFT:
+        case CFBD_TRANSITION_PUSH_LEFT:
+            if (c >= w - done)
+                return page_pixel(t->page, c - (w - done), r);
+            return host_pixel(old, pushed ? px + done : px, py);
+        case CFBD_TRANSITION_SLIDE_RIGHT:
+        case CFBD_TRANSITION_PUSH_RIGHT:
+            if (c < done)
+                return page_pixel(t->page, c + w - done, r);
+            return host_pixel(old, pushed ? px - done : px, py);
+        default: // CFBD_TRANSITION_FADE
+            return (done == w) ? page_pixel(t->page, c, r) : host_pixel(old, px, py);
+    }
+}
+
+/* Columns a frame has to flush when it moves from @p before to t->done */
+static void expected_strip(const CFBDGraphic_Transition* t,
+                           CFBD_Bool pushed,
+                           uint16_t before,
+                           uint16_t* x0,
+                           uint16_t* x1)
+{
+    const uint16_t left = t->x, right = t->x + t->width - 1;
+    *x0 = left;
+    *x1 = right;
+    switch (t->effect) {
+        case CFBD_TRANSITION_WIPE_RIGHT:
+            *x0 = left + before;
+            *x1 = left + t->done - 1;
+            break;
+        case CFBD_TRANSITION_WIPE_LEFT:
+            *x0 = right + 1 - t->done;
+            *x1 = right - before;
+            break;
+        case CFBD_TRANSITION_SLIDE_LEFT:
+        case CFBD_TRANSITION_PUSH_LEFT:
+            if (!pushed)
+                *x0 = right + 1 - t->done;
+            break;
+        case CFBD_TRANSITION_SLIDE_RIGHT:
+        case CFBD_TRANSITION_PUSH_RIGHT:
+            if (!pushed)
+                *x1 = left + t->done - 1;
+            break;
+        default:
+            break;
+    }
+}
+
+static void check_effect(CFBDGraphic_TransitionEffect effect,
+                         CFBD_Bool fast_path,
+                         CFBD_Bool contrast_register,
+                         CFBD_Bool blank)
+{
+    static HostPanel panel, old, shown;
+    bind_counting(&panel, fast_path);
+    host_bind(&old, CFBD_CANVAS_1BPP_PAGE, CFBD_TRUE);
+    host_bind(&shown, CFBD_CANVAS_1BPP_PAGE, CFBD_TRUE);
+    has_contrast = contrast_register;
+
+    for (int round = 0; round < 150; round++) {
+        for (size_t i = 0; i < sizeof(panel.pixels); i++)
+            panel.pixels[i] = (uint8_t) host_random(256);
+        memcpy(old.pixels, panel.pixels, sizeof(panel.pixels));
+        for (size_t i = 0; i < sizeof(page_pixels); i++)
+            page_pixels[i] = (uint8_t) host_random(256);
+
+        const uint16_t x = host_random(HOST_WIDTH - 1), y = host_random(HOST_HEIGHT - 1);
+        CFBDGraphic_MemoryCanvas page = {.buffer = page_pixels,
+                                         .width = 1 + host_random(HOST_WIDTH - x),
+                                         .height = 1 + host_random(HOST_HEIGHT - y)};
+        const CFBD_BaseAnimation timing = {.anim_frames = (uint8_t) host_random(16),
+                                           .anim_frame_delay_ms = 1 + host_random(20)};
+        const uint8_t start_contrast = (uint8_t) (1 + host_random(255));
+        const uint32_t base = host_random(4) ? host_random(1000) : UINT32_MAX - 100;
+        contrast = start_contrast;
+        contrast_sets = 0;
+
+        CFBDGraphic_Transition t;
+        CFBDGraphic_BeginTransition(
+                &t, &panel.device, effect, blank ? NULL : &page, x, y, &timing, base);
+        t.curve = (CFBD_EasingCurve) host_random(4);
+        const CFBD_Bool faded = t.effect == CFBD_TRANSITION_FADE;
+        const CFBD_Bool pushed = fast_path && (effect == CFBD_TRANSITION_PUSH_LEFT ||
+                                               effect == CFBD_TRANSITION_PUSH_RIGHT);
+        HOST_CHECK(faded == (effect == CFBD_TRANSITION_FADE && contrast_register),
+                   "round %d: effect %d played as %d",
+                   round,
+                   effect,
+                   t.effect);
+
+        uint32_t now_ms = base;
+        const uint32_t frames = (timing.anim_frames > 1) ? timing.anim_frames : 1;
+        unsigned total_flushes = 0, ticks = 0;
+        CFBD_Bool rising = CFBD_FALSE, ramp_ok = CFBD_TRUE, turn_write = CFBD_TRUE;
+        CFBD_Bool running = CFBD_TRUE;
+        while (running && ticks++ < 1000) {
+            now_ms += host_random(4) ? host_random(timing.anim_frame_delay_ms + 1)
+                                     : host_random(5 * timing.anim_frame_delay_ms);
+            memcpy(shown.pixels, panel.pixels, sizeof(panel.pixels));
+            const uint16_t before = t.done;
+            const uint8_t frame_before = t.frame;
+            const uint8_t level_before = contrast;
+            const unsigned sets_before = contrast_sets;
+            host_flushes = 0;
+            running = CFBDGraphic_TransitionTick(&t, now_ms);
+            total_flushes += host_flushes;
+
+            // contrast: one write per frame, down to the middle, then up
+            if (faded && contrast_sets != sets_before) {
+                if (contrast_sets != sets_before + 1 || (rising && contrast < level_before))
+                    ramp_ok = CFBD_FALSE;
+                if (contrast > level_before)
+                    rising = CFBD_TRUE;
+            }
+
+            if (t.done == before) {
+                const CFBD_Bool kept = !memcmp(shown.pixels, panel.pixels, sizeof(panel.pixels));
+                HOST_CHECK(host_flushes == 0 && kept,
+                           "round %d: a frame without new columns drew %u flushes",
+                           round,
+                           host_flushes);
+                continue;
+            }
+            // the page goes in on the first frame past the middle
+            if (faded && (2u * t.frame < frames || 2u * frame_before >= frames))
+                turn_write = CFBD_FALSE;
+
+            uint16_t x0, x1;
+            expected_strip(&t, pushed, before, &x0, &x1);
+            const CFBDGraphic_ClipBounds* f = &host_last_flush;
+            HOST_CHECK(host_flushes == 1 && f->x0 == x0 && f->x1 == x1 && f->y0 == t.y &&
+                               f->y1 == t.y + t.height - 1,
+                       "round %d effect %d: columns %u -> %u flushed %u times (%d,%d)-(%d,%d), "
+                       "expected columns %u - %u",
+                       round,
+                       effect,
+                       before,
+                       t.done,
+                       host_flushes,
+                       f->x0,
+                       f->y0,
+                       f->x1,
+                       f->y1,
+                       x0,
+                       x1);
+
+            CFBD_Bool same = CFBD_TRUE, inside = CFBD_TRUE;
+            for (int32_t py = 0; py < HOST_HEIGHT; py++) {
+                for (int32_t px = 0; px < HOST_WIDTH; px++) {
+                    const CFBD_Bool now = host_pixel(&panel, px, py);
+                    if (now != expected_pixel(&t, pushed, &old, px, py))
+                        same = CFBD_FALSE;
+                    if (now != host_pixel(&shown, px, py) &&
+                        (px < f->x0 || px > f->x1 || py < f->y0 || py > f->y1))
+                        inside = CFBD_FALSE;
+                }
+            }
+            HOST_CHECK(same && inside,
+                       "round %d effect %d fast path %d: %u of %u columns at (%d,%d) %dx%d, "
+                       "reference %d, inside the flush %d",
+                       round,
+                       effect,
+                       fast_path,
+                       t.done,
+                       t.width,
+                       t.x,
+                       t.y,
+                       t.width,
+                       t.height,
+                       same,
+                       inside);
+        }
+
+        HOST_CHECK(!running && t.done == t.width, "round %d: stopped at %u columns", round, t.done);
+        if (faded) {
+            HOST_CHECK(ramp_ok && turn_write && total_flushes == 1 && contrast == start_contrast,
+                       "round %d: fade over %d frames, ramp %d, written at the turn %d, "
+                       "%u flushes, contrast %u back to %u",
+                       round,
+                       timing.anim_frames,
+                       ramp_ok,
+                       turn_write,
+                       total_flushes,
+                       contrast,
+                       start_contrast);
+        }
+        else {
+            HOST_CHECK(contrast_sets == 0, "round %d: contrast changed by a %d", round, t.effect);
+        }
+    }
+}
+
+/* On time ticks: 200 * |8 - 2f| / 8, the page written once at level 0 */
+static void check_fade_ramp(void)
+{
+    static const uint8_t ramp[] = {150, 100, 50, 0, 50, 100, 150, 200};
+    static HostPanel panel;
+    bind_counting(&panel, CFBD_TRUE);
+    has_contrast = CFBD_TRUE;
+    contrast = 200;
+    contrast_sets = 0;
+    const CFBD_BaseAnimation timing = {.anim_frames = 8, .anim_frame_delay_ms = 10};
+
+    CFBDGraphic_Transition t;
+    CFBDGraphic_BeginTransition(&t, &panel.device, CFBD_TRANSITION_FADE, NULL, 0, 0, &timing, 0);
+    for (uint32_t f = 1; f <= 8; f++) {
+        host_flushes = 0;
+        CFBDGraphic_TransitionTick(&t, f * 10);
+        HOST_CHECK(contrast_sets == f && levels[f - 1] == ramp[f - 1] && host_flushes == (f == 4),
+                   "fade frame %u: contrast %u, expected %u, %u flushes",
+                   f,
+                   contrast,
+                   ramp[f - 1],
+                   host_flushes);
+    }
+}
+
+/* The blocking flavour ends on the same frame */
+static void check_play(void)
+{
+    static HostPanel panel;
+    bind_counting(&panel, CFBD_TRUE);
+    has_contrast = CFBD_TRUE;
+    for (size_t i = 0; i < sizeof(page_pixels); i++)
+        page_pixels[i] = (uint8_t) host_random(256);
+    CFBDGraphic_MemoryCanvas page = {.buffer = page_pixels, .width = 60, .height = 30};
+    const CFBD_BaseAnimation timing = {.anim_frames = 9, .anim_frame_delay_ms = 15};
+
+    for (int effect = CFBD_TRANSITION_SLIDE_LEFT; effect <= CFBD_TRANSITION_FADE; effect++) {
+        for (size_t i = 0; i < sizeof(panel.pixels); i++)
+            panel.pixels[i] = (uint8_t) host_random(256);
+        contrast = 0x7F;
+        CFBDGraphic_PlayTransition(
+                &panel.device, (CFBDGraphic_TransitionEffect) effect, &page, 20, 10, &timing);
+
+        CFBD_Bool same = CFBD_TRUE;
+        for (int32_t r = 0; r < page.height; r++) {
+            for (int32_t c = 0; c < page.width; c++) {
+                if (host_pixel(&panel, 20 + c, 10 + r) != page_pixel(&page, c, r))
+                    same = CFBD_FALSE;
+            }
+        }
+        HOST_CHECK(same && contrast == 0x7F,
+                   "played effect %d: page shown %d, contrast %u",
+                   effect,
+                   same,
+                   contrast);
+    }
+}
+
+int main(void)
+{
+    for (int effect = CFBD_TRANSITION_SLIDE_LEFT; effect <= CFBD_TRANSITION_FADE; effect++) {
+        const CFBDGraphic_TransitionEffect e = (CFBDGraphic_TransitionEffect) effect;
+        check_effect(e, CFBD_TRUE, CFBD_TRUE, CFBD_FALSE);
+        check_effect(e, CFBD_TRUE, CFBD_TRUE, CFBD_TRUE);
+        check_effect(e, CFBD_FALSE, CFBD_TRUE, CFBD_FALSE);
+    }
+    check_effect(CFBD_TRANSITION_FADE, CFBD_TRUE, CFBD_FALSE, CFBD_FALSE);
+    check_effect(CFBD_TRANSITION_FADE, CFBD_TRUE, CFBD_FALSE, CFBD_TRUE);
+    check_fade_ramp();
+    check_play();
+    return host_report("transition");
+}
@@ -0,0 +1,421 @@
+/*
+    Widget damage and render: touching regions merge, a merge that reaches
+    another region keeps merging, and once every slot is taken a new region
+    joins the one that grows least. Rendering a random widget tree repaints
+    only the merged regions, with the same pixels as a full paint of the
+    tree, paints only the widgets crossing a region and flushes each region
+    once. With the clip stack full the whole visible area is repainted.
+*/
+#include <string.h>
+
+#include "device/graphic_clip.h"
+#include "host_test.h"
+#include "widget/widget/widget.h"
+
+#define WIDGETS (9)
+#define FIELD_WIDTH (160)
+#define FIELD_HEIGHT (96)
+
+static CFBDGraphicRect box(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1)
+{
+    CFBDGraphicRect r = {{x0, y0}, {x1, y1}};
+    return r;
+}
+
+static CFBD_Bool same_box(const CFBDGraphicRect* a, const CFBDGraphicRect* b)
+{
+    return a->tl.x == b->tl.x && a->tl.y == b->tl.y && a->br.x == b->br.x && a->br.y == b->br.y;
+}
+
+static CFBD_Bool has_box(const CFBD_WidgetDamage* damage, CFBDGraphicRect expected)
+{
+    for (uint8_t i = 0; i < damage->count; i++) {
+        if (same_box(&damage->rects[i], &expected))
+            return CFBD_TRUE;
+    }
+    return CFBD_FALSE;
+}
+
+static void check_merge_rules(void)
+{
+    CFBD_WidgetDamage damage;
+    CFBDGraphicRect r;
+
+    // sharing an edge or a corner merges, a one pixel gap does not
+    CFBD_WidgetDamageReset(&damage);
+    r = box(0, 0, 9, 9);
+    CFBD_WidgetDamageAdd(&damage, &r);
+    r = box(19, 0, 10, 9); // corners in any order
+    CFBD_WidgetDamageAdd(&damage, &r);
+    r = box(20, 10, 22, 12);
+    CFBD_WidgetDamageAdd(&damage, &r);
+    HOST_CHECK(damage.count == 1 && has_box(&damage, box(0, 0, 22, 12)),
+               "edge and corner neighbours: %u regions",
+               damage.count);
+    r = box(24, 0, 30, 12);
+    CFBD_WidgetDamageAdd(&damage, &r);
+    HOST_CHECK(damage.count == 2, "a one pixel gap merged: %u regions", damage.count);
+
+    // the union with the first region reaches one the new box missed
+    CFBD_WidgetDamageReset(&damage);
+    r = box(0, 0, 4, 20);
+    CFBD_WidgetDamageAdd(&damage, &r);
+    r = box(8, 18, 12, 22);
+    CFBD_WidgetDamageAdd(&damage, &r);
+    r = box(40, 40, 42, 42);
+    CFBD_WidgetDamageAdd(&damage, &r);
+    r = box(5, 0, 7, 2);
+    CFBD_WidgetDamageAdd(&damage, &r);
+    HOST_CHECK(damage.count == 2 && has_box(&damage, box(0, 0, 12, 22)) &&
+                       has_box(&damage, box(40, 40, 42, 42)),
+               "cascading merge: %u regions",
+               damage.count);
+
+    // all slots taken: the new box joins the region that grows least
+    CFBD_WidgetDamageReset(&damage);
+    const CFBDGraphicRect corners[] = {
+            box(0, 0, 3, 3), box(40, 0, 43, 3), box(0, 40, 3, 43), box(40, 40, 43, 43)};
+    for (size_t i = 0; i < sizeof(corners) / sizeof(corners[0]); i++)
+        CFBD_WidgetDamageAdd(&damage, &corners[i]);
+    r = box(46, 0, 47, 3);
+    CFBD_WidgetDamageAdd(&damage, &r);
+    HOST_CHECK(damage.count == 4 && has_box(&damage, box(40, 0, 47, 3)) &&
+                       has_box(&damage, corners[0]) && has_box(&damage, corners[2]) &&
+                       has_box(&damage, corners[3]),
+               "least growth merge: %u regions",
+               damage.count);
+
+    // the forced union reaches another region and merges again
+    CFBD_WidgetDamageReset(&damage);
+    const CFBDGraphicRect forced[] = {
+            box(0, 0, 3, 3), box(4, 10, 9, 11), box(60, 0, 61, 1), box(60, 40, 61, 41)};
+    for (size_t i = 0; i < sizeof(forced) / sizeof(forced[0]); i++)
+        CFBD_WidgetDamageAdd(&damage, &forced[i]);
+    r = box(6, 3, 9, 6); // grows (4,10)-(9,11) least, the union touches (0,0)-(3,3)
+    CFBD_WidgetDamageAdd(&damage, &r);
+    HOST_CHECK(damage.count == 3 && has_box(&damage, box(0, 0, 9, 11)) &&
+                       has_box(&damage, forced[2]) && has_box(&damage, forced[3]),
+               "forced union did not cascade: %u regions",
+               damage.count);
+}
+
+/* Random additions: bounded, never touching, nothing added is lost */
+static void check_merge_random(void)
+{
+    static uint8_t covered[FIELD_HEIGHT][FIELD_WIDTH];
+    CFBD_WidgetDamage damage;
+
+    for (int round = 0; round < 3000; round++) {
+        CFBD_WidgetDamageReset(&damage);
+        memset(covered, 0, sizeof(covered));
+        const int adds = 1 + (int) host_random(10);
+        for (int n = 0; n < adds; n++) {
+            const uint16_t x = host_random(FIELD_WIDTH), y = host_random(FIELD_HEIGHT);
+            CFBDGraphicRect r = box(x,
+                                    y,
+                                    x + host_random(FIELD_WIDTH - x < 24 ? FIELD_WIDTH - x : 24),
+                                    y + host_random(FIELD_HEIGHT - y < 16 ? FIELD_HEIGHT - y : 16));
+            CFBD_WidgetDamageAdd(&damage, &r);
+            for (int py = r.tl.y; py <= r.br.y; py++)
+                memset(&covered[py][r.tl.x], 1, r.br.x - r.tl.x + 1);
+        }
+
+        CFBD_Bool apart = CFBD_TRUE, kept = CFBD_TRUE;
+        for (uint8_t i = 0; i < damage.count; i++) {
+            for (uint8_t j = i + 1; j < damage.count; j++) {
+                const CFBDGraphicRect* a = &damage.rects[i];
+                const CFBDGraphicRect* b = &damage.rects[j];
+                if (a->tl.x <= b->br.x + 1 && b->tl.x <= a->br.x + 1 && a->tl.y <= b->br.y + 1 &&
+                    b->tl.y <= a->br.y + 1)
+                    apart = CFBD_FALSE;
+            }
+        }
+        for (int py = 0; py < FIELD_HEIGHT; py++) {
+            for (int px = 0; px < FIELD_WIDTH; px++) {
+                if (!covered[py][px])
+                    continue;
+                CFBD_Bool inside = CFBD_FALSE;
+                for (uint8_t i = 0; i < damage.count; i++) {
+                    const CFBDGraphicRect* r = &damage.rects[i];
+                    if (px >= r->tl.x && px <= r->br.x && py >= r->tl.y && py <= r->br.y)
+                        inside = CFBD_TRUE;
+                }
+                if (!inside)
+                    kept = CFBD_FALSE;
+            }
+        }
+        HOST_CHECK(damage.count <= CFBD_WIDGET_DAMAGE_RECTS && apart && kept,
+                   "round %d: %u regions, apart %d, kept %d",
+                   round,
+                   damage.count,
+                   apart,
+                   kept);
+    }
+}
+
+/*
+ Widget tree for the render checks: every widget blanks its box and draws
+ a pattern of its own, so the paint order shows in the pixels.
+*/
+static CFBD_Widget widgets[WIDGETS];
+static CFBD_Widget* slots[WIDGETS][WIDGETS];
+static unsigned paints[WIDGETS];
+
+static void paint_widget(CFBD_Widget* w, CFBD_GraphicDevice* device)
+{
+    const unsigned index = (unsigned) (w - widgets);
+    paints[index]++;
+    device->ops->clear_area(device, w->tl_point.x, w->tl_point.y, w->size.width, w->size.height);
+    for (uint16_t y = 0; y < w->size.height; y++) {
+        for (uint16_t x = 0; x < w->size.width; x++) {
+            const uint16_t px = w->tl_point.x + x, py = w->tl_point.y + y;
+            if (x == 0 || y == 0 || (px + 2 * py + index) % (index + 3) == 0)
+                device->ops->setPixel(device, px, py);
+        }
+    }
+}
+
+static CFBD_WidgetRequestOverrideOperations paint_ops = {.paint = paint_widget};
+
+/* Widget 0 is the root, every other one hangs below an earlier widget */
+static void build_tree(void)
+{
+    memset(slots, 0, sizeof(slots));
+    for (int i = 0; i < WIDGETS; i++) {
+        CFBD_WidgetCreationPack pack = {
+                .children = slots[i],
+                .children_container_sz = WIDGETS,
+                .parent = (i == 0) ? NULL : &widgets[host_random(i)],
+        };
+        if (i == 0) {
+            pack.size.width = HOST_WIDTH;
+            pack.size.height = HOST_HEIGHT;
+        }
+        else {
+            pack.tl_point.x = host_random(HOST_WIDTH + 8);
+            pack.tl_point.y = host_random(HOST_HEIGHT + 8);
+            pack.size.width = host_random(48);
+            pack.size.height = host_random(32);
+        }
+        CFBD_WidgetCreateBase(&widgets[i], &pack);
+        widgets[i].override_ops = &paint_ops;
+    }
+}
+
+/* Parents first, like the render walk */
+static void paint_all(CFBD_Widget* w, CFBD_GraphicDevice* device)
+{
+    paint_widget(w, device);
+    for (size_t i = 0; i < w->children_container_sz; i++) {
+        if (w->children[i])
+            paint_all(w->children[i], device);
+    }
+}
+
+static CFBD_Bool box_of(const CFBD_Widget* w, CFBDGraphicRect* r)
+{
+    if (w->size.width == 0 || w->size.height == 0)
+        return CFBD_FALSE;
+    *r = box(w->tl_point.x,
+             w->tl_point.y,
+             w->tl_point.x + w->size.width - 1,
+             w->tl_point.y + w->size.height - 1);
+    return CFBD_TRUE;
+}
+
+static CFBD_Bool boxes_cross(const CFBDGraphicRect* a, const CFBDGraphicRect* b)
+{
+    return a->tl.x <= b->br.x && b->tl.x <= a->br.x && a->tl.y <= b->br.y && b->tl.y <= a->br.y;
+}
+
+/*
+ Compare a render against the full paint: inside the repainted areas the
+ pixels of @p reference, elsewhere those of @p before; a widget is painted
+ once per area it crosses and each area is flushed once, in order.
+*/
+static void expect_render(const char* what,
+                          int round,
+                          HostPanel* panel,
+                          const HostPanel* before,
+                          const HostPanel* reference,
+                          const CFBDGraphic_ClipBounds* areas,
+                          unsigned area_cnt,
+                          const CFBDGraphicRect* regions)
+{
+    CFBD_Bool same = CFBD_TRUE;
+    for (int32_t y = 0; y < HOST_HEIGHT; y++) {
+        for (int32_t x = 0; x < HOST_WIDTH; x++) {
+            CFBD_Bool repainted = CFBD_FALSE;
+            for (unsigned i = 0; i < area_cnt; i++) {
+                if (x >= areas[i].x0 && x <= areas[i].x1 && y >= areas[i].y0 && y <= areas[i].y1)
+                    repainted = CFBD_TRUE;
+            }
+            const HostPanel* source = repainted ? reference : before;
+            if (host_pixel(panel, x, y) != host_pixel(source, x, y))
+                same = CFBD_FALSE;
+        }
+    }
+    HOST_CHECK(same, "%s round %d: pixels differ from the full paint", what, round);
+
+    HOST_CHECK(host_flushes == area_cnt,
+               "%s round %d: %u flushes for %u areas",
+               what,
+               round,
+               host_flushes,
+               area_cnt);
+    for (unsigned i = 0; i < area_cnt && i < host_flushes && i < HOST_FLUSH_LOG; i++) {
+        HOST_CHECK(memcmp(&host_flush_log[i], &areas[i], sizeof(areas[i])) == 0,
+                   "%s round %d: flush %u is (%d,%d)-(%d,%d), expected (%d,%d)-(%d,%d)",
+                   what,
+                   round,
+                   i,
+                   host_flush_log[i].x0,
+                   host_flush_log[i].y0,
+                   host_flush_log[i].x1,
+                   host_flush_log[i].y1,
+                   areas[i].x0,
+                   areas[i].y0,
+                   areas[i].x1,
+                   areas[i].y1);
+    }
+
+    for (int w = 0; w < WIDGETS; w++) {
+        unsigned expected = 0;
+        CFBDGraphicRect bounds;
+        for (unsigned i = 0; i < area_cnt && box_of(&widgets[w], &bounds); i++) {
+            if (boxes_cross(&bounds, &regions[i]))
+                expected++;
+        }
+        HOST_CHECK(paints[w] == expected,
+                   "%s round %d: widget %d painted %u times, expected %u",
+                   what,
+                   round,
+                   w,
+                   paints[w],
+                   expected);
+    }
+}
+
+static void check_render(CFBDGraphic_CanvasFormat format)
+{
+    static HostPanel panel, before, reference;
+    static CFBD_WidgetDamage damage;
+    host_bind(&panel, format, CFBD_TRUE);
+    host_count_flushes(&panel);
+    host_bind(&before, format, CFBD_TRUE);
+    host_bind(&reference, format, CFBD_TRUE);
+
+    for (int round = 0; round < 1500; round++) {
+        build_tree();
+        CFBD_WidgetAttachDamage(&widgets[0], &damage);
+        host_clear(&reference);
+        paint_all(&widgets[0], &reference.device);
+        for (size_t i = 0; i < sizeof(panel.pixels); i++)
+            panel.pixels[i] = (uint8_t) host_random(256);
+        memcpy(before.pixels, panel.pixels, sizeof(panel.pixels));
+
+        // whole widgets and random boxes, some partly or fully off screen
+        const int invalidations = 1 + (int) host_random(8);
+        for (int n = 0; n < invalidations; n++) {
+            CFBD_Widget* w = &widgets[1 + host_random(WIDGETS - 1)];
+            if (host_random(2) == 0) {
+                CFBD_WidgetInvalidate(w, NULL);
+                continue;
+            }
+            const uint16_t x = host_random(HOST_WIDTH + 16), y = host_random(HOST_HEIGHT + 16);
+            CFBDGraphicRect r = box(x, y, x + host_random(40), y + host_random(24));
+            CFBD_WidgetInvalidate(w, &r);
+        }
+
+        // the visible part of each merged region, in damage order
+        CFBDGraphicRect regions[CFBD_WIDGET_DAMAGE_RECTS];
+        CFBDGraphic_ClipBounds areas[CFBD_WIDGET_DAMAGE_RECTS];
+        unsigned area_cnt = 0;
+        for (uint8_t i = 0; i < damage.count; i++) {
+            const CFBDGraphicRect* r = &damage.rects[i];
+            if (r->tl.x >= HOST_WIDTH || r->tl.y >= HOST_HEIGHT)
+                continue;
+            CFBDGraphic_ClipBounds a = {r->tl.x,
+                                        r->tl.y,
+                                        r->br.x < HOST_WIDTH ? r->br.x : HOST_WIDTH - 1,
+                                        r->br.y < HOST_HEIGHT ? r->br.y : HOST_HEIGHT - 1};
+            regions[area_cnt] = *r;
+            areas[area_cnt++] = a;
+        }
+
+        memset(paints, 0, sizeof(paints));
+        host_flushes = 0;
+        const CFBD_Bool rendered = CFBD_WidgetRender(&widgets[0], &panel.device);
+        HOST_CHECK(rendered == (area_cnt != 0) && damage.count == 0 &&
+                           CFBDGraphic_DeviceRequestUpdateAtOnce(&panel.device),
+                   "round %d: rendered %d, %u regions left, immediate mode lost",
+                   round,
+                   rendered,
+                   damage.count);
+        expect_render("render", round, &panel, &before, &reference, areas, area_cnt, regions);
+
+        host_flushes = 0;
+        HOST_CHECK(!CFBD_WidgetRender(&widgets[0], &panel.device) && host_flushes == 0,
+                   "round %d: rendered again without damage",
+                   round);
+    }
+}
+
+/* Clip stack full: the damage cannot be pushed, the whole visible area is repainted */
+static void check_full_clip_stack(void)
+{
+    static HostPanel panel, before, reference;
+    static CFBD_WidgetDamage damage;
+    host_bind(&panel, CFBD_CANVAS_1BPP_PAGE, CFBD_TRUE);
+    host_count_flushes(&panel);
+    host_bind(&before, CFBD_CANVAS_1BPP_PAGE, CFBD_TRUE);
+    host_bind(&reference, CFBD_CANVAS_1BPP_PAGE, CFBD_TRUE);
+
+    for (int round = 0; round < 300; round++) {
+        build_tree();
+        CFBD_WidgetAttachDamage(&widgets[0], &damage);
+        host_clear(&reference);
+        paint_all(&widgets[0], &reference.device);
+        for (size_t i = 0; i < sizeof(panel.pixels); i++)
+            panel.pixels[i] = (uint8_t) host_random(256);
+        memcpy(before.pixels, panel.pixels, sizeof(panel.pixels));
+
+        CFBDGraphicRect view = box(host_random(HOST_WIDTH / 2),
+                                   host_random(HOST_HEIGHT / 2),
+                                   HOST_WIDTH / 2 + host_random(HOST_WIDTH / 2),
+                                   HOST_HEIGHT / 2 + host_random(HOST_HEIGHT / 2));
+        int depth = 0;
+        while (CFBDGraphic_PushClip(&panel.device, &view))
+            depth++;
+
+        // a small box inside the view
+        const uint16_t x = view.tl.x + host_random(view.br.x - view.tl.x + 1);
+        const uint16_t y = view.tl.y + host_random(view.br.y - view.tl.y + 1);
+        CFBDGraphicRect r = box(x, y, x, y);
+        CFBD_WidgetInvalidate(&widgets[1 + host_random(WIDGETS - 1)], &r);
+
+        const CFBDGraphic_ClipBounds area = {view.tl.x, view.tl.y, view.br.x, view.br.y};
+        memset(paints, 0, sizeof(paints));
+        host_flushes = 0;
+        const CFBD_Bool rendered = CFBD_WidgetRender(&widgets[0], &panel.device);
+        HOST_CHECK(rendered && depth == CFBD_GRAPHIC_CLIP_STACK_DEPTH,
+                   "round %d: rendered %d with %d clips pushed",
+                   round,
+                   rendered,
+                   depth);
+        expect_render("full clip stack", round, &panel, &before, &reference, &area, 1, &view);
+
+        while (depth-- > 0)
+            CFBDGraphic_PopClip(&panel.device);
+    }
+}
+
+int main(void)
+{
+    check_merge_rules();
+    check_merge_random();
+    check_render(CFBD_CANVAS_1BPP_PAGE);
+    check_render(CFBD_CANVAS_4BPP_PACKED);
+    check_full_clip_stack();
+    return host_report("widget_damage");
+}